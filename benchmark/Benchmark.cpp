@@ -0,0 +1,1475 @@
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "BlockRaycast.hpp"
+#include "Camera.hpp"
+#include "ChunkGrid.hpp"
+#include "ChunkScheduler.hpp"
+#include "ChunkStorage.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+#include "DrawList.hpp"
+#include "MeshArena.hpp"
+#include "ChunkCuller.hpp"
+#include "OcclusionCuller.hpp"
+#include "LightEngine.hpp"
+#include "TranslucentMesh.hpp"
+#include "WorldGenerator.hpp"
+#include "BatchedPerlinNoise.hpp"
+#include "vendor/PerlinNoise.hpp"
+
+// Runs the parts of the game that don't need a window or a GPU on fixed scenarios, then prints
+// their timings as JSON. Given a baseline written by an earlier run, flags the scenarios that got slower.
+// Exits with 1 on a regression, or when two scenarios meant to compute the same output didn't.
+//
+//   MinecraftBenchmark [--output results.json] [--baseline baseline.json] [--tolerance 0.1]
+//                      [--repetitions 5] [--filter mesh/]
+
+// Same seed as Minecraft's m_worldGenerator
+constexpr std::uint32_t WORLD_SEED = 1234u;
+
+// The chunks meshed are the inner ones, the outer ring only provides their neighbours' blocks
+constexpr int WORLD_SIDE_CHUNK_COUNT = 18;
+constexpr int WORLD_INNER_CHUNK_COUNT = (WORLD_SIDE_CHUNK_COUNT - 2) * (WORLD_SIDE_CHUNK_COUNT - 2);
+
+// Seeds whose first 8x8 chunks are among the most flooded (about 27% of the columns against 12% for WORLD_SEED), for the translucent faces
+constexpr std::array<std::uint32_t, 3u> OCEAN_WORLD_SEEDS = { 355u, 2037u, 219u };
+constexpr int OCEAN_WORLD_SIDE_CHUNK_COUNT = 8;
+
+// texture_atlas.png
+constexpr std::size_t TEXTURE_ATLAS_WIDTH = 256u;
+
+// A scenario returns a checksum of what it computed, so that a change of output is told apart from a change of speed
+struct BenchmarkScenario {
+    const char*                     name;
+    std::function<std::uint64_t()> run;
+    size_t                          nItems = 0u; // when not 0, the throughput is reported too, e.g. in chunks per second
+    const char*                     sameChecksumAs = nullptr; // a scenario computing the same output another way, the run fails when their checksums differ
+}; // struct BenchmarkScenario
+
+struct BenchmarkResult {
+    std::string   name;
+    double        minMs    = 0.0;
+    double        medianMs = 0.0;
+    std::uint64_t checksum = 0u;
+
+    double itemsPerSecond = 0.0; // at the median, 0 when the scenario doesn't count items
+}; // struct BenchmarkResult
+
+struct BenchmarkOptions {
+    std::optional<std::filesystem::path> outputPath;
+    std::optional<std::filesystem::path> baselinePath;
+
+    double      tolerance    = 0.1; // a scenario regressed when its median is this much slower than the baseline's
+    size_t      nRepetitions = 5u;
+    std::string filter;             // only the scenarios whose name contains it are run
+}; // struct BenchmarkOptions
+
+// A directory of its own under the system's temporary directory, removed with everything in it on destruction
+class BenchmarkTemporaryDirectory {
+private:
+    std::filesystem::path m_path;
+
+public:
+    explicit BenchmarkTemporaryDirectory(const std::string& name) noexcept {
+        std::random_device randomDevice;
+
+        std::error_code errorCode;
+        this->m_path = std::filesystem::temp_directory_path(errorCode) / (name + '-' + std::to_string(randomDevice()));
+        std::filesystem::create_directories(this->m_path, errorCode);
+    }
+
+    BenchmarkTemporaryDirectory(const BenchmarkTemporaryDirectory&) = delete;
+    BenchmarkTemporaryDirectory& operator=(const BenchmarkTemporaryDirectory&) = delete;
+
+    inline ~BenchmarkTemporaryDirectory() noexcept {
+        std::error_code errorCode;
+        std::filesystem::remove_all(this->m_path, errorCode);
+    }
+
+    inline const std::filesystem::path& GetPath() const noexcept { return this->m_path; }
+}; // class BenchmarkTemporaryDirectory
+
+// The blocks of a small world, generated and lit once and shared by the scenarios
+class BenchmarkWorld {
+private:
+    std::vector<std::unique_ptr<Chunk>> m_pChunks;
+    int m_sideChunkCount;
+
+public:
+    explicit BenchmarkWorld(const BatchedPerlinNoise& noise, const int sideChunkCount = WORLD_SIDE_CHUNK_COUNT) noexcept
+        : m_sideChunkCount(sideChunkCount)
+    {
+        LightEngine lightEngine;
+
+        for (int idx = 0; idx < sideChunkCount; ++idx) {
+            for (int idz = 0; idz < sideChunkCount; ++idz) {
+                this->m_pChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }));
+                this->m_pChunks.back()->GenerateDefaultTerrain(noise);
+                lightEngine.ComputeChunkLight(*this->m_pChunks.back());
+            }
+        }
+
+        // as Minecraft::StitchChunkLight does, each side once
+        for (int idx = 0; idx < sideChunkCount; ++idx) {
+            for (int idz = 0; idz < sideChunkCount; ++idz) {
+                LightNeighbourhood neighbourhood = this->GetNeighbourhood(idx, idz);
+
+                if (idx + 1 < sideChunkCount)
+                    lightEngine.StitchSide(neighbourhood, CHUNK_SIDE::CHUNK_SIDE_RIGHT);
+                if (idz + 1 < sideChunkCount)
+                    lightEngine.StitchSide(neighbourhood, CHUNK_SIDE::CHUNK_SIDE_BACK);
+            }
+        }
+    }
+
+    inline int GetSideChunkCount() const noexcept { return this->m_sideChunkCount; }
+
+    inline const Chunk& GetChunk(const int idx, const int idz) const noexcept { return *this->m_pChunks[idx * this->m_sideChunkCount + idz]; }
+
+    inline Chunk& GetChunk(const int idx, const int idz) noexcept { return *this->m_pChunks[idx * this->m_sideChunkCount + idz]; }
+
+    // nullptr outside of the world
+    inline const Chunk* FindChunk(const ChunkCoord& cc) const noexcept {
+        if (cc.idx < 0 || cc.idx >= this->m_sideChunkCount || cc.idz < 0 || cc.idz >= this->m_sideChunkCount)
+            return nullptr;
+
+        return &this->GetChunk(cc.idx, cc.idz);
+    }
+
+    // The chunks outside of the world are missing
+    LightNeighbourhood GetNeighbourhood(const int idx, const int idz) noexcept {
+        std::array<Chunk*, 9u> pChunks{};
+        for (int dx = -1; dx <= 1; ++dx)
+            for (int dz = -1; dz <= 1; ++dz)
+                if (idx + dx >= 0 && idx + dx < this->m_sideChunkCount && idz + dz >= 0 && idz + dz < this->m_sideChunkCount)
+                    pChunks[LightNeighbourhood::GetIndex(dx, dz)] = &this->GetChunk(idx + dx, idz + dz);
+
+        return LightNeighbourhood(pChunks);
+    }
+
+    // LEFT, RIGHT, FRONT and BACK, as in CHUNK_SIDE
+    ChunkNeighbourBlocks CopyNeighbourBlocks(const int idx, const int idz) const noexcept {
+        static constexpr std::array<std::array<int, 2>, static_cast<size_t>(CHUNK_SIDE::_COUNT)> offsets = {{ {{ -1, 0 }}, {{ 1, 0 }}, {{ 0, -1 }}, {{ 0, 1 }} }};
+        static constexpr std::array<CHUNK_SIDE, static_cast<size_t>(CHUNK_SIDE::_COUNT)> oppositeSides = {
+            CHUNK_SIDE::CHUNK_SIDE_RIGHT, CHUNK_SIDE::CHUNK_SIDE_LEFT, CHUNK_SIDE::CHUNK_SIDE_BACK, CHUNK_SIDE::CHUNK_SIDE_FRONT
+        };
+
+        ChunkNeighbourBlocks neighbours;
+        for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT); ++side) {
+            this->GetChunk(idx + offsets[side][0], idz + offsets[side][1]).CopySideBlocks(oppositeSides[side], neighbours.sides[side]);
+            this->GetChunk(idx + offsets[side][0], idz + offsets[side][1]).CopySideLight(oppositeSides[side], neighbours.sideLights[side]);
+            neighbours.sideMask |= static_cast<std::uint8_t>(1u << side);
+        }
+
+        return neighbours;
+    }
+}; // class BenchmarkWorld
+
+// FNV-1a of the chunk's location and of every block of its sections, sections of air included. The hashes of a world's chunks
+// are added, so that the checksum doesn't depend on the order the chunks were generated or loaded in
+static std::uint64_t HashChunkBlocks(const Chunk& chunk) noexcept {
+    std::uint64_t hash = 14695981039346656037ull;
+    const auto Mix = [&hash](const std::uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    Mix(static_cast<std::uint16_t>(chunk.GetLocation().idx));
+    Mix(static_cast<std::uint16_t>(chunk.GetLocation().idz));
+
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        const ChunkSection* pSection = chunk.GetSection(sectionIndex);
+
+        for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex)
+            Mix(static_cast<std::uint64_t>(pSection ? pSection->GetBlock(blockIndex) : BLOCK_TYPE::BLOCK_TYPE_AIR));
+    }
+
+    return hash;
+}
+
+// The allocated sections of a world's chunks, as ChunkSections and as the dense arrays of blocks they replaced.
+// The block indices are visited in order, or in a shuffled order as edits and rays spread over a section do
+struct BenchmarkSections {
+    using DenseBlocks = std::array<BLOCK_TYPE, CHUNK_SECTION_BLOCK_COUNT>;
+
+    std::vector<ChunkSection> sections;
+    std::vector<DenseBlocks>  denseSections;
+
+    std::vector<size_t> sequentialBlockIndices;
+    std::vector<size_t> randomBlockIndices;
+
+    explicit BenchmarkSections(const BenchmarkWorld& world) noexcept {
+        for (int idx = 0; idx < world.GetSideChunkCount(); ++idx) {
+            for (int idz = 0; idz < world.GetSideChunkCount(); ++idz) {
+                for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+                    const ChunkSection* pSection = world.GetChunk(idx, idz).GetSection(sectionIndex);
+                    if (!pSection)
+                        continue;
+
+                    this->sections.push_back(*pSection);
+
+                    DenseBlocks& denseBlocks = this->denseSections.emplace_back();
+                    for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex)
+                        denseBlocks[blockIndex] = pSection->GetBlock(blockIndex);
+                }
+            }
+        }
+
+        for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex)
+            this->sequentialBlockIndices.push_back(blockIndex);
+
+        this->randomBlockIndices = this->sequentialBlockIndices;
+        std::shuffle(this->randomBlockIndices.begin(), this->randomBlockIndices.end(), std::mt19937(WORLD_SEED));
+    }
+}; // struct BenchmarkSections
+
+static inline BLOCK_TYPE GetSectionBlock(const ChunkSection& section, const size_t blockIndex) noexcept { return section.GetBlock(blockIndex); }
+static inline BLOCK_TYPE GetSectionBlock(const BenchmarkSections::DenseBlocks& section, const size_t blockIndex) noexcept { return section[blockIndex]; }
+
+static inline void SetSectionBlock(ChunkSection& section, const size_t blockIndex, const BLOCK_TYPE type) noexcept { section.SetBlock(blockIndex, type); }
+static inline void SetSectionBlock(BenchmarkSections::DenseBlocks& section, const size_t blockIndex, const BLOCK_TYPE type) noexcept { section[blockIndex] = type; }
+
+// Moves every block of the sections one step back along "blockIndices" then forward again, which leaves them as they were:
+// two reads and two writes per block. Returns a checksum of the blocks read
+template <typename TSection>
+static std::uint64_t ShiftSectionBlocks(std::vector<TSection>& sections, const std::vector<size_t>& blockIndices) noexcept {
+    std::uint64_t checksum = 0u;
+    for (TSection& section : sections) {
+        const BLOCK_TYPE firstType = GetSectionBlock(section, blockIndices.front());
+        for (size_t i = 0u; i + 1u < blockIndices.size(); ++i) {
+            const BLOCK_TYPE type = GetSectionBlock(section, blockIndices[i + 1u]);
+            SetSectionBlock(section, blockIndices[i], type);
+            checksum += static_cast<std::uint64_t>(type) * (i + 1u);
+        }
+        SetSectionBlock(section, blockIndices.back(), firstType);
+
+        const BLOCK_TYPE lastType = GetSectionBlock(section, blockIndices.back());
+        for (size_t i = blockIndices.size() - 1u; i > 0u; --i) {
+            const BLOCK_TYPE type = GetSectionBlock(section, blockIndices[i - 1u]);
+            SetSectionBlock(section, blockIndices[i], type);
+            checksum += static_cast<std::uint64_t>(type) * i;
+        }
+        SetSectionBlock(section, blockIndices.front(), lastType);
+    }
+
+    return checksum;
+}
+
+static std::uint64_t MeshInnerChunks(const BenchmarkWorld& world, const std::vector<ChunkNeighbourBlocks>& neighbours,
+                                     const CHUNK_MESHING_MODE meshingMode, const CHUNK_LOD lod) noexcept {
+    std::uint64_t nVertices = 0u;
+
+    for (int idx = 1; idx < WORLD_SIDE_CHUNK_COUNT - 1; ++idx) {
+        for (int idz = 1; idz < WORLD_SIDE_CHUNK_COUNT - 1; ++idz) {
+            const ChunkMesh mesh = world.GetChunk(idx, idz).GenerateMesh(meshingMode, TEXTURE_ATLAS_WIDTH,
+                                                                         neighbours[(idx - 1) * (WORLD_SIDE_CHUNK_COUNT - 2) + idz - 1],
+                                                                         ChunkMesh::ALL_SECTIONS, lod);
+            for (const std::vector<Vertex>& vertices : mesh.sectionVertices)
+                nVertices += vertices.size();
+
+            for (const std::vector<Vertex>& vertices : mesh.sectionTranslucentVertices)
+                nVertices += vertices.size();
+        }
+    }
+
+    return nVertices;
+}
+
+// Minecraft's default m_chunkLodDistances
+constexpr ChunkLodDistances CHUNK_LOD_DISTANCES = { 8, 16, 32 };
+
+// The render distances the whole window is meshed at, and the names of the scenarios without and with LOD
+constexpr std::array<std::pair<int, std::array<const char*, 2u>>, 3u> LOD_RENDER_DISTANCES = {{
+    { 16, {{ "mesh/render_distance_16", "mesh/render_distance_16_lod" }} },
+    { 32, {{ "mesh/render_distance_32", "mesh/render_distance_32_lod" }} },
+    { 64, {{ "mesh/render_distance_64", "mesh/render_distance_64_lod" }} }
+}};
+
+// Meshes every chunk of the render window around a camera in chunk (0, 0), at the LOD SelectChunkLod gives its ring or at
+// CHUNK_LOD_FULL. The window is tiled with the inner chunks of the world. Returns the number of vertices
+static std::uint64_t MeshRenderWindow(const BenchmarkWorld& world, const std::vector<ChunkNeighbourBlocks>& neighbours, const int renderDistance, const bool bLod) noexcept {
+    constexpr int INNER_SIDE_CHUNK_COUNT = WORLD_SIDE_CHUNK_COUNT - 2;
+
+    const Vec4f32 cameraPosition = { 0.5f * CHUNK_X_LENGTH, 100.f * BLOCK_LENGTH, 0.5f * CHUNK_Z_LENGTH, 1.f };
+
+    std::uint64_t nVertices = 0u;
+    for (int idx = -renderDistance; idx <= renderDistance; ++idx) {
+        for (int idz = -renderDistance; idz <= renderDistance; ++idz) {
+            const CHUNK_LOD lod = bLod ? SelectChunkLod(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }, cameraPosition, CHUNK_LOD_DISTANCES)
+                                       : CHUNK_LOD::CHUNK_LOD_FULL;
+
+            const int tileX = (idx % INNER_SIDE_CHUNK_COUNT + INNER_SIDE_CHUNK_COUNT) % INNER_SIDE_CHUNK_COUNT;
+            const int tileZ = (idz % INNER_SIDE_CHUNK_COUNT + INNER_SIDE_CHUNK_COUNT) % INNER_SIDE_CHUNK_COUNT;
+
+            const ChunkMesh mesh = world.GetChunk(tileX + 1, tileZ + 1).GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, TEXTURE_ATLAS_WIDTH,
+                                                                                     neighbours[tileX * INNER_SIDE_CHUNK_COUNT + tileZ], ChunkMesh::ALL_SECTIONS, lod);
+            for (const std::vector<Vertex>& vertices : mesh.sectionVertices)
+                nVertices += vertices.size();
+
+            for (const std::vector<Vertex>& vertices : mesh.sectionTranslucentVertices)
+                nVertices += vertices.size();
+        }
+    }
+
+    return nVertices;
+}
+
+// Digs a shaft down from the surface of the world's middle chunk, lights its bottom and the surface next to the chunk's side
+// with lamps, then puts every block back. Returns the number of cells the light engine went through
+static std::uint64_t EditBlocksAndRelight(BenchmarkWorld& world, LightEngine& lightEngine) noexcept {
+    constexpr int CHUNK_INDEX = WORLD_SIDE_CHUNK_COUNT / 2;
+    constexpr int SHAFT_DEPTH = 12;
+
+    struct BlockEdit {
+        size_t     idx, idy, idz;
+        BLOCK_TYPE type;
+    }; // struct BlockEdit
+
+    Chunk& chunk = world.GetChunk(CHUNK_INDEX, CHUNK_INDEX);
+    LightNeighbourhood neighbourhood = world.GetNeighbourhood(CHUNK_INDEX, CHUNK_INDEX);
+
+    // the top of a column, above its highest block
+    const auto GetSurface = [&chunk](const size_t idx, const size_t idz) {
+        size_t idy = CHUNK_Y_BLOCK_COUNT;
+        while (idy > 0u && chunk.GetBlock(idx, idy - 1u, idz).value() == BLOCK_TYPE::BLOCK_TYPE_AIR)
+            --idy;
+
+        return idy;
+    };
+
+    std::vector<BlockEdit> edits;
+
+    const size_t shaftSurface = GetSurface(8u, 8u);
+    for (size_t depth = 1u; depth <= SHAFT_DEPTH; ++depth)
+        edits.push_back(BlockEdit{ 8u, shaftSurface - depth, 8u, BLOCK_TYPE::BLOCK_TYPE_AIR });
+
+    edits.push_back(BlockEdit{ 8u, shaftSurface - SHAFT_DEPTH - 1u, 8u, BLOCK_TYPE::BLOCK_TYPE_LAMP });
+    edits.push_back(BlockEdit{ 0u, GetSurface(0u, 3u), 3u, BLOCK_TYPE::BLOCK_TYPE_LAMP });
+
+    const std::uint64_t nVisitedCells = lightEngine.GetVisitedCellCount();
+
+    std::vector<BlockEdit> undoEdits;
+    for (const BlockEdit& edit : edits) {
+        undoEdits.push_back(BlockEdit{ edit.idx, edit.idy, edit.idz, chunk.GetBlock(edit.idx, edit.idy, edit.idz).value() });
+
+        chunk.SetBlock(edit.idx, edit.idy, edit.idz, edit.type);
+        lightEngine.UpdateBlock(neighbourhood, edit.idx, edit.idy, edit.idz);
+    }
+
+    for (auto undoEdit = undoEdits.rbegin(); undoEdit != undoEdits.rend(); ++undoEdit) {
+        chunk.SetBlock(undoEdit->idx, undoEdit->idy, undoEdit->idz, undoEdit->type);
+        lightEngine.UpdateBlock(neighbourhood, undoEdit->idx, undoEdit->idy, undoEdit->idz);
+    }
+
+    return lightEngine.GetVisitedCellCount() - nVisitedCells;
+}
+
+// Block edits at a rate of BLOCK_EDITS_PER_SECOND, as a player building fast or an explosion would make them
+constexpr size_t BLOCK_EDITS_PER_SECOND = 1000u;
+
+struct BenchmarkBlockEdit {
+    int        idx, idz; // of the chunk in the BenchmarkWorld
+    size_t     x, y, z;
+    BLOCK_TYPE type;
+}; // struct BenchmarkBlockEdit
+
+// Random blocks of the inner chunks set to random types, or the same with every edit in one 8 blocks wide box.
+// The edits stay off the chunks' sides so that, as in Minecraft::SetBlock, no neighbour's mesh depends on them.
+// The box doesn't touch its section's top or bottom layer either, so its edits only ever dirty that section
+static std::vector<BenchmarkBlockEdit> MakeBenchmarkBlockEdits(const bool bClustered) noexcept {
+    std::mt19937 random(WORLD_SEED);
+    std::uniform_int_distribution<int>    chunks(1, WORLD_SIDE_CHUNK_COUNT - 2);
+    std::uniform_int_distribution<size_t> xzs(1u, CHUNK_X_BLOCK_COUNT - 2u);
+    std::uniform_int_distribution<size_t> ys(0u, CHUNK_Y_BLOCK_COUNT - 1u);
+    std::uniform_int_distribution<size_t> boxOffsets(0u, 7u);
+    std::uniform_int_distribution<size_t> types(0u, static_cast<size_t>(BLOCK_TYPE::_COUNT) - 1u);
+
+    constexpr size_t BOX_Y = SEA_LEVEL / CHUNK_SECTION_Y_BLOCK_COUNT * CHUNK_SECTION_Y_BLOCK_COUNT + 4u;
+
+    std::vector<BenchmarkBlockEdit> edits(BLOCK_EDITS_PER_SECOND);
+    for (BenchmarkBlockEdit& edit : edits) {
+        if (bClustered)
+            edit = BenchmarkBlockEdit{ WORLD_SIDE_CHUNK_COUNT / 2, WORLD_SIDE_CHUNK_COUNT / 2, 4u + boxOffsets(random), BOX_Y + boxOffsets(random), 4u + boxOffsets(random) };
+        else
+            edit = BenchmarkBlockEdit{ chunks(random), chunks(random), xzs(random), ys(random), xzs(random) };
+
+        edit.type = static_cast<BLOCK_TYPE>(types(random));
+    }
+
+    return edits;
+}
+
+// One second of edits over 60 frames. After each frame's edits, the chunks they touched are remeshed as SubmitChunkJob
+// does: only their dirty sections, or whole for "bWholeChunks". The edits are undone at the end, without remeshing.
+// Returns the number of sections meshed, which the time should follow
+static std::uint64_t EditBlocksAndRemesh(BenchmarkWorld& world, const std::vector<BenchmarkBlockEdit>& edits, const bool bWholeChunks) noexcept {
+    constexpr size_t FRAME_COUNT = 60u;
+
+    std::uint64_t nMeshedSections = 0u;
+
+    std::vector<BenchmarkBlockEdit> undoEdits;
+    for (size_t frameIndex = 0u; frameIndex < FRAME_COUNT; ++frameIndex) {
+        std::vector<std::array<int, 2>> editedChunks;
+
+        for (size_t i = edits.size() * frameIndex / FRAME_COUNT; i < edits.size() * (frameIndex + 1u) / FRAME_COUNT; ++i) {
+            const BenchmarkBlockEdit& edit = edits[i];
+            Chunk& chunk = world.GetChunk(edit.idx, edit.idz);
+
+            undoEdits.push_back(BenchmarkBlockEdit{ edit.idx, edit.idz, edit.x, edit.y, edit.z, chunk.GetBlock(edit.x, edit.y, edit.z).value() });
+            chunk.SetBlock(edit.x, edit.y, edit.z, edit.type);
+
+            if (std::find(editedChunks.begin(), editedChunks.end(), std::array<int, 2>{ edit.idx, edit.idz }) == editedChunks.end())
+                editedChunks.push_back(std::array<int, 2>{ edit.idx, edit.idz });
+        }
+
+        for (const std::array<int, 2>& editedChunk : editedChunks) {
+            Chunk& chunk = world.GetChunk(editedChunk[0], editedChunk[1]);
+
+            const std::uint16_t dirtyMeshSections = chunk.TakeDirtyMeshSections(CHUNK_LOD::CHUNK_LOD_FULL);
+            const std::uint16_t sectionMask       = bWholeChunks ? ChunkMesh::ALL_SECTIONS : dirtyMeshSections;
+
+            const ChunkMesh mesh = chunk.GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, TEXTURE_ATLAS_WIDTH,
+                                                      world.CopyNeighbourBlocks(editedChunk[0], editedChunk[1]), sectionMask);
+            for (std::uint16_t mask = mesh.sectionMask; mask != 0u; mask &= mask - 1u)
+                ++nMeshedSections;
+        }
+    }
+
+    for (auto undoEdit = undoEdits.rbegin(); undoEdit != undoEdits.rend(); ++undoEdit) {
+        Chunk& chunk = world.GetChunk(undoEdit->idx, undoEdit->idz);
+        chunk.SetBlock(undoEdit->x, undoEdit->y, undoEdit->z, undoEdit->type);
+
+        for (size_t lod = 0u; lod < static_cast<size_t>(CHUNK_LOD::_COUNT); ++lod)
+            chunk.TakeDirtyMeshSections(static_cast<CHUNK_LOD>(lod));
+    }
+
+    return nMeshedSections;
+}
+
+struct BenchmarkRay {
+    Vec4f32 origin;
+    Vec4f32 direction;
+}; // struct BenchmarkRay
+
+// From random points of the air over the inner chunks, toward random directions
+static std::vector<BenchmarkRay> MakeBenchmarkRays(const size_t nRays) noexcept {
+    std::mt19937 random(WORLD_SEED);
+    std::uniform_real_distribution<float> xzs(CHUNK_X_LENGTH, (WORLD_SIDE_CHUNK_COUNT - 1) * CHUNK_X_LENGTH);
+    std::uniform_real_distribution<float> ys(SEA_LEVEL * BLOCK_LENGTH, CHUNK_Y_LENGTH);
+    std::normal_distribution<float>       directions(0.f, 1.f);
+
+    std::vector<BenchmarkRay> rays(nRays);
+    for (BenchmarkRay& ray : rays) {
+        ray.origin    = Vec4f32{ xzs(random), ys(random), xzs(random), 0.f };
+        ray.direction = Vec4f32{ directions(random), directions(random), directions(random), 0.f };
+    }
+
+    return rays;
+}
+
+// Returns a checksum of the blocks hit, their faces and distances
+static std::uint64_t RaycastWorld(const BenchmarkWorld& world, const std::vector<BenchmarkRay>& rays, const float maxDistance, const BLOCK_RAYCAST_MODE mode) noexcept {
+    const BlockRaycastChunkLookup getChunk = [&world](const ChunkCoord& cc) { return world.FindChunk(cc); };
+
+    std::uint64_t checksum = 0u;
+    for (const BenchmarkRay& ray : rays) {
+        const std::optional<BlockRaycastHit> hit = RaycastBlocks(getChunk, ray.origin, ray.direction, maxDistance, mode);
+
+        if (hit.has_value()) {
+            checksum += static_cast<std::uint64_t>(hit->block[0] * 65536 + hit->block[1] * 256 + hit->block[2]) * 8u + static_cast<std::uint64_t>(hit->face);
+            checksum += static_cast<std::uint64_t>(hit->distance * 1024.f);
+        }
+    }
+
+    return checksum;
+}
+
+// Flies the camera along a scripted path, requesting every chunk of the render window that isn't ready and making a few of them
+// ready each frame, in the order of the ChunkScheduler or in the order they were requested. Chunks that leave the render window are
+// forgotten, the requests for them dropped at no cost with both orders. Returns the number of frames the chunks in the camera's
+// frustum spent waiting to be ready, summed over the chunks: the lower, the sooner the chunks the camera looks at show up
+static std::uint64_t SimulateChunkStreaming(const bool bPrioritized) noexcept {
+    constexpr int    N_FRAMES               = 1200;
+    constexpr size_t CHUNKS_READY_PER_FRAME = 3u;    // about what the job system keeps up with
+    constexpr float  CAMERA_SPEED           = 1.f;   // in blocks per frame, a fast flight
+    constexpr float  TURN_SPEED             = 0.03f; // in radians per frame
+
+    Camera camera(Vec4f32{ 8.f, 100.f, 8.f, 1.f }, static_cast<float>(M_PI_2), 9.f / 16.f, 0.1f, 1000.f);
+    float yaw = 0.f;
+
+    ChunkScheduler         scheduler;
+    std::deque<ChunkCoord> fifo;
+    ChunkCoordMap<bool>    requested; // FIFO only, the scheduler keeps track of its own requests
+    ChunkCoordMap<bool>    ready;
+
+    std::uint64_t nWaitingFrames = 0u;
+
+    for (int frame = 0; frame < N_FRAMES; ++frame) {
+        // straight ahead, a long turn to the right, straight again, then looking around while flying on
+        if ((frame >= 300 && frame < 352) || frame >= 800)
+            yaw += TURN_SPEED;
+
+        camera.SetRotation(Vec4f32{ 0.2f, yaw, 0.f, 0.f });
+        camera.Update();
+
+        if (frame < 800) {
+            Vec4f32 direction = { camera.GetForwardVector().x, 0.f, camera.GetForwardVector().z, 0.f };
+            direction.Normalize3D();
+            camera.Translate(direction * (CAMERA_SPEED * BLOCK_LENGTH));
+        } else {
+            camera.Translate(Vec4f32{ 0.f, 0.f, CAMERA_SPEED * BLOCK_LENGTH, 0.f });
+        }
+
+        const Vec4f32 cameraPosition = camera.GetPosition();
+
+        for (auto it = ready.begin(); it != ready.end(); )
+            it = IsChunkInRenderWindow(it->first, cameraPosition) ? std::next(it) : ready.erase(it);
+
+        // the render window in the order UpdateWorld goes through it
+        ChunkCoord cc;
+        for (cc.idx = (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idx < (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idx) {
+            for (cc.idz = (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idz < (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idz) {
+                if (ready.find(cc) != ready.end())
+                    continue;
+
+                if (bPrioritized) {
+                    scheduler.Request(cc, CHUNK_REQUEST_TYPE::CHUNK_REQUEST_TYPE_GENERATE);
+                } else if (requested.insert({ cc, true }).second) {
+                    fifo.push_back(cc);
+                }
+            }
+        }
+
+        if (bPrioritized)
+            scheduler.Update(cameraPosition, camera.GetForwardVector());
+
+        for (size_t nReadyChunks = 0u; nReadyChunks < CHUNKS_READY_PER_FRAME; ) {
+            std::optional<ChunkCoord> location;
+
+            if (bPrioritized) {
+                const std::optional<ChunkRequest> requestOpt = scheduler.PopNext();
+                if (requestOpt.has_value())
+                    location = requestOpt.value().location;
+            } else {
+                while (!fifo.empty() && !location.has_value()) {
+                    requested.erase(fifo.front());
+                    if (IsChunkInRenderWindow(fifo.front(), cameraPosition))
+                        location = fifo.front();
+
+                    fifo.pop_front();
+                }
+            }
+
+            if (!location.has_value())
+                break;
+
+            ready[location.value()] = true;
+            ++nReadyChunks;
+        }
+
+        for (cc.idx = (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idx < (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idx) {
+            for (cc.idz = (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idz < (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idz) {
+                const Vec4f32 chunkMin = { static_cast<float>(cc.idx) * CHUNK_X_LENGTH, 0.f, static_cast<float>(cc.idz) * CHUNK_Z_LENGTH };
+
+                if (ready.find(cc) == ready.end() &&
+                    camera.GetFrustum().ClassifyBox(chunkMin, chunkMin + Vec4f32{ CHUNK_X_LENGTH, CHUNK_Y_LENGTH, CHUNK_Z_LENGTH }) != FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE)
+                    ++nWaitingFrames;
+            }
+        }
+    }
+
+    return nWaitingFrames;
+}
+
+// The chunks of a render window around (0, 0), empty, in a ChunkGrid and in the ChunkCoordMap it replaced
+struct BenchmarkChunkWindow {
+    ChunkGrid                             chunkGrid;
+    ChunkCoordMap<std::unique_ptr<Chunk>> pChunkMap;
+
+    BenchmarkChunkWindow() noexcept {
+        this->chunkGrid.SetGridOrigin(ChunkGrid::GetGridOrigin(Vec4f32{ 8.f * BLOCK_LENGTH, 80.f * BLOCK_LENGTH, 8.f * BLOCK_LENGTH, 1.f }));
+
+        for (std::int16_t idx = -RENDER_DISTANCE; idx <= RENDER_DISTANCE; ++idx) {
+            for (std::int16_t idz = -RENDER_DISTANCE; idz <= RENDER_DISTANCE; ++idz) {
+                this->chunkGrid.Insert(std::make_unique<Chunk>(ChunkCoord{ idx, idz }));
+                this->pChunkMap[ChunkCoord{ idx, idz }] = std::make_unique<Chunk>(ChunkCoord{ idx, idz });
+            }
+        }
+    }
+}; // struct BenchmarkChunkWindow
+
+constexpr int CHUNK_WINDOW_FIND_REPETITION_COUNT = 64;
+
+// Every chunk of the render window and its four neighbours, as UpdateWorld and the light stitching look them up.
+// The neighbours along the window's border are missing
+template <typename F>
+static std::uint64_t FindWindowChunks(F&& findChunk) noexcept {
+    static constexpr std::array<std::array<std::int16_t, 2>, 5u> offsets = {{ {{ 0, 0 }}, {{ -1, 0 }}, {{ 1, 0 }}, {{ 0, -1 }}, {{ 0, 1 }} }};
+
+    std::uint64_t checksum = 0u;
+    for (int repetition = 0; repetition < CHUNK_WINDOW_FIND_REPETITION_COUNT; ++repetition) {
+        for (std::int16_t idx = -RENDER_DISTANCE; idx <= RENDER_DISTANCE; ++idx) {
+            for (std::int16_t idz = -RENDER_DISTANCE; idz <= RENDER_DISTANCE; ++idz) {
+                for (const std::array<std::int16_t, 2>& offset : offsets) {
+                    const Chunk* pChunk = findChunk(ChunkCoord{ static_cast<std::int16_t>(idx + offset[0]), static_cast<std::int16_t>(idz + offset[1]) });
+                    if (pChunk)
+                        checksum += static_cast<std::uint64_t>(pChunk->GetLocation().idx + 2 * pChunk->GetLocation().idz + 3 * RENDER_DISTANCE);
+                }
+            }
+        }
+    }
+
+    return checksum;
+}
+
+constexpr int CHUNK_WINDOW_SLIDE_STEP_COUNT = 256;
+
+// The render window filled, then moved one chunk at a time around a square, 64 chunks along each side: the chunks entering
+// it are inserted, the ones leaving it erased, as UpdateWorld and the memory budget do. Returns a checksum of the chunks erased
+template <typename FSetOrigin, typename FInsert, typename FErase>
+static std::uint64_t SlideChunkWindow(FSetOrigin&& setOrigin, FInsert&& insert, FErase&& erase) noexcept {
+    static constexpr std::array<std::array<int, 2>, 4u> directions = {{ {{ 1, 0 }}, {{ 0, 1 }}, {{ -1, 0 }}, {{ 0, -1 }} }};
+
+    const auto IsInWindow = [](const int idx, const int idz, const std::array<int, 2>& center) {
+        return std::abs(idx - center[0]) <= RENDER_DISTANCE && std::abs(idz - center[1]) <= RENDER_DISTANCE;
+    };
+
+    std::array<int, 2> center = { 0, 0 };
+    setOrigin(ChunkCoord{ static_cast<std::int16_t>(-RENDER_DISTANCE - 1), static_cast<std::int16_t>(-RENDER_DISTANCE - 1) });
+
+    for (int idx = -RENDER_DISTANCE; idx <= RENDER_DISTANCE; ++idx)
+        for (int idz = -RENDER_DISTANCE; idz <= RENDER_DISTANCE; ++idz)
+            insert(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) });
+
+    std::uint64_t checksum = 0u;
+    for (int step = 0; step < CHUNK_WINDOW_SLIDE_STEP_COUNT; ++step) {
+        const std::array<int, 2>& direction = directions[(step / 64) % directions.size()];
+        const std::array<int, 2>  previousCenter = center;
+
+        center[0] += direction[0];
+        center[1] += direction[1];
+        setOrigin(ChunkCoord{ static_cast<std::int16_t>(center[0] - RENDER_DISTANCE - 1), static_cast<std::int16_t>(center[1] - RENDER_DISTANCE - 1) });
+
+        for (int idx = previousCenter[0] - RENDER_DISTANCE; idx <= previousCenter[0] + RENDER_DISTANCE; ++idx) {
+            for (int idz = previousCenter[1] - RENDER_DISTANCE; idz <= previousCenter[1] + RENDER_DISTANCE; ++idz) {
+                if (!IsInWindow(idx, idz, center)) {
+                    erase(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) });
+                    checksum += static_cast<std::uint64_t>(idx * 1000 + idz + 1000000);
+                }
+            }
+        }
+
+        for (int idx = center[0] - RENDER_DISTANCE; idx <= center[0] + RENDER_DISTANCE; ++idx)
+            for (int idz = center[1] - RENDER_DISTANCE; idz <= center[1] + RENDER_DISTANCE; ++idz)
+                if (!IsInWindow(idx, idz, previousCenter))
+                    insert(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) });
+    }
+
+    return checksum;
+}
+
+// The render distances of the cull/frustum_quadtree scenarios, RENDER_DISTANCE first
+constexpr std::array<std::pair<int, const char*>, 3u> FRUSTUM_QUADTREE_RENDER_DISTANCES = {{
+    { RENDER_DISTANCE, "cull/frustum_quadtree_10" },
+    { 32,              "cull/frustum_quadtree_32" },
+    { 64,              "cull/frustum_quadtree_64" }
+}};
+
+static_assert(RENDER_DISTANCE == 10, "cull/frustum_quadtree_10 is named after it");
+
+static std::vector<BenchmarkScenario> MakeScenarios(const siv::PerlinNoise& noise, const BatchedPerlinNoise& batchedNoise,
+                                                    BenchmarkWorld& world, const std::vector<ChunkNeighbourBlocks>& neighbours) noexcept {
+    std::vector<BenchmarkScenario> scenarios;
+
+    scenarios.push_back({ "terrain/height_map", [&batchedNoise]() {
+        std::uint64_t checksum = 0u;
+        for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx)
+            for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz)
+                for (const std::uint8_t height : ComputeDefaultHeightMap(ChunkCoord{ idx, idz }, batchedNoise))
+                    checksum += height;
+
+        return checksum;
+    }, WORLD_SIDE_CHUNK_COUNT * WORLD_SIDE_CHUNK_COUNT });
+
+    scenarios.push_back({ "terrain/height_map_scalar", [&noise]() {
+        std::uint64_t checksum = 0u;
+        for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx)
+            for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz)
+                for (const std::uint8_t height : ComputeDefaultHeightMap(ChunkCoord{ idx, idz }, noise))
+                    checksum += height;
+
+        return checksum;
+    }, WORLD_SIDE_CHUNK_COUNT * WORLD_SIDE_CHUNK_COUNT });
+
+    scenarios.push_back({ "terrain/generate", [&batchedNoise]() {
+        std::uint64_t checksum = 0u;
+        for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx) {
+            for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz) {
+                Chunk chunk(ChunkCoord{ idx, idz });
+                chunk.GenerateDefaultTerrain(batchedNoise);
+                checksum += chunk.GetBlockMemoryUsage();
+            }
+        }
+
+        return checksum;
+    } });
+
+    // the staged generator over the same chunks, first with its region cache emptied before each run then with it holding
+    // every region the chunks need. Both generate the same blocks
+    const std::shared_ptr<WorldGenerator> pWorldGenerator = std::make_shared<WorldGenerator>(WORLD_SEED);
+
+    for (const bool bColdCache : { true, false }) {
+        scenarios.push_back({ bColdCache ? "terrain/world_generator_cold" : "terrain/world_generator_warm", [pWorldGenerator, bColdCache]() {
+            // row by row from an empty cache, then in a shuffled order with the regions cached: the blocks are the same either way
+            static const std::vector<ChunkCoord> shuffledLocations = []() {
+                std::vector<ChunkCoord> locations;
+                for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx)
+                    for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz)
+                        locations.push_back(ChunkCoord{ idx, idz });
+
+                std::shuffle(locations.begin(), locations.end(), std::mt19937(WORLD_SEED));
+                return locations;
+            }();
+
+            std::uint64_t checksum = 0u;
+            const auto GenerateChunk = [&pWorldGenerator, &checksum](const ChunkCoord& location) {
+                Chunk chunk(location);
+                pWorldGenerator->GenerateChunk(chunk);
+                checksum += HashChunkBlocks(chunk);
+            };
+
+            if (bColdCache) {
+                pWorldGenerator->ClearRegionCache();
+
+                for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx)
+                    for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz)
+                        GenerateChunk(ChunkCoord{ idx, idz });
+            } else {
+                for (const ChunkCoord& location : shuffledLocations)
+                    GenerateChunk(location);
+            }
+
+            return checksum;
+        }, WORLD_SIDE_CHUNK_COUNT * WORLD_SIDE_CHUNK_COUNT, bColdCache ? nullptr : "terrain/world_generator_cold" });
+    }
+
+    // the chunks of the world generator scenarios saved to region files once, then loaded back as revisiting them does,
+    // against generating them again above. The blocks are the same, so is the checksum
+    scenarios.push_back({ "storage/load", [pWorldGenerator]() {
+        static const BenchmarkTemporaryDirectory directory("MinecraftBenchmarkStorage");
+        static const std::unique_ptr<ChunkStorage> pStorage = [&pWorldGenerator]() {
+            std::unique_ptr<ChunkStorage> pSavedStorage = std::make_unique<ChunkStorage>(directory.GetPath());
+
+            std::vector<std::unique_ptr<Chunk>> pChunks;
+            for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx) {
+                for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz) {
+                    pChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ idx, idz }));
+                    pWorldGenerator->GenerateChunk(*pChunks.back());
+                }
+            }
+
+            std::vector<Chunk*> pSavedChunks;
+            for (const std::unique_ptr<Chunk>& pChunk : pChunks)
+                pSavedChunks.push_back(pChunk.get());
+
+            pSavedStorage->SaveChunks(pSavedChunks);
+            return pSavedStorage;
+        }();
+
+        std::uint64_t checksum = 0u;
+        for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx) {
+            for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz) {
+                Chunk chunk(ChunkCoord{ idx, idz });
+                if (pStorage->LoadChunk(chunk))
+                    checksum += HashChunkBlocks(chunk);
+            }
+        }
+
+        return checksum;
+    }, WORLD_SIDE_CHUNK_COUNT * WORLD_SIDE_CHUNK_COUNT, "terrain/world_generator_warm" });
+
+    // the world's sections read and written in place, in block index order then in a shuffled order, in the palette-compressed
+    // ChunkSections and in dense arrays. The same blocks move around, so the checksums of each order are the same
+    const std::shared_ptr<BenchmarkSections> pSections = std::make_shared<BenchmarkSections>(world);
+    for (const bool bRandom : { false, true }) {
+        for (const bool bDense : { false, true }) {
+            const char* name = bRandom ? (bDense ? "storage/section_access_random_dense" : "storage/section_access_random")
+                                       : (bDense ? "storage/section_access_sequential_dense" : "storage/section_access_sequential");
+
+            scenarios.push_back({ name, [pSections, bRandom, bDense]() {
+                const std::vector<size_t>& blockIndices = bRandom ? pSections->randomBlockIndices : pSections->sequentialBlockIndices;
+
+                return bDense ? ShiftSectionBlocks(pSections->denseSections, blockIndices) : ShiftSectionBlocks(pSections->sections, blockIndices);
+            }, pSections->sections.size() * CHUNK_SECTION_BLOCK_COUNT * 4u,
+               bDense ? (bRandom ? "storage/section_access_random" : "storage/section_access_sequential") : nullptr });
+        }
+    }
+
+    scenarios.push_back({ "mesh/naive", [&world, &neighbours]() {
+        return MeshInnerChunks(world, neighbours, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_NAIVE, CHUNK_LOD::CHUNK_LOD_FULL);
+    }, WORLD_INNER_CHUNK_COUNT });
+
+    // the same quads as mesh/naive, so the same checksum
+    scenarios.push_back({ "mesh/bitmask", [&world, &neighbours]() {
+        return MeshInnerChunks(world, neighbours, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_BITMASK, CHUNK_LOD::CHUNK_LOD_FULL);
+    }, WORLD_INNER_CHUNK_COUNT, "mesh/naive" });
+
+    scenarios.push_back({ "mesh/greedy", [&world, &neighbours]() {
+        return MeshInnerChunks(world, neighbours, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, CHUNK_LOD::CHUNK_LOD_FULL);
+    }, WORLD_INNER_CHUNK_COUNT });
+
+    scenarios.push_back({ "mesh/greedy_lod_half", [&world, &neighbours]() {
+        return MeshInnerChunks(world, neighbours, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, CHUNK_LOD::CHUNK_LOD_HALF);
+    }, WORLD_INNER_CHUNK_COUNT });
+
+    scenarios.push_back({ "mesh/greedy_lod_quarter", [&world, &neighbours]() {
+        return MeshInnerChunks(world, neighbours, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, CHUNK_LOD::CHUNK_LOD_QUARTER);
+    }, WORLD_INNER_CHUNK_COUNT });
+
+    // the whole render window meshed at once, as after a teleport, with every chunk at CHUNK_LOD_FULL or at its ring's LOD.
+    // The checksum is the number of vertices
+    for (const auto& [renderDistance, names] : LOD_RENDER_DISTANCES) {
+        for (const bool bLod : { false, true }) {
+            scenarios.push_back({ names[bLod ? 1u : 0u], [&world, &neighbours, renderDistance = renderDistance, bLod]() {
+                return MeshRenderWindow(world, neighbours, renderDistance, bLod);
+            }, static_cast<size_t>((2 * renderDistance + 1) * (2 * renderDistance + 1)) });
+        }
+    }
+
+    // the camera flies over the ocean worlds, overlaid, one block every other step, and the translucent faces of every chunk are sorted
+    // for it as BuildDrawList does. The checksum is the number of places the quads were moved by, most sorts only swap a few of them
+    scenarios.push_back({ "mesh/translucent_sort", []() {
+        constexpr int N_STEPS = 128;
+
+        static const std::vector<std::pair<ChunkCoord, ChunkMesh>> meshes = []() {
+            std::vector<std::pair<ChunkCoord, ChunkMesh>> oceanMeshes;
+
+            for (const std::uint32_t seed : OCEAN_WORLD_SEEDS) {
+                siv::PerlinNoise oceanNoise;
+                oceanNoise.reseed(seed);
+
+                const BenchmarkWorld oceanWorld(BatchedPerlinNoise(oceanNoise), OCEAN_WORLD_SIDE_CHUNK_COUNT);
+                for (int idx = 1; idx < OCEAN_WORLD_SIDE_CHUNK_COUNT - 1; ++idx) {
+                    for (int idz = 1; idz < OCEAN_WORLD_SIDE_CHUNK_COUNT - 1; ++idz) {
+                        const Chunk& chunk = oceanWorld.GetChunk(idx, idz);
+                        oceanMeshes.emplace_back(chunk.GetLocation(), chunk.GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, TEXTURE_ATLAS_WIDTH,
+                                                                                         oceanWorld.CopyNeighbourBlocks(idx, idz)));
+                    }
+                }
+            }
+
+            return oceanMeshes;
+        }();
+
+        std::vector<TranslucentMesh> translucentMeshes(meshes.size());
+        for (size_t i = 0u; i < meshes.size(); ++i)
+            for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+                translucentMeshes[i].SetSectionVertices(sectionIndex, meshes[i].second.sectionTranslucentVertices[sectionIndex]);
+
+        std::uint64_t nMoves = 0u;
+        for (int step = 0; step < N_STEPS; ++step) {
+            // diagonally across the inner chunks, a few blocks above the sea
+            const Vec4f32 cameraPosition = { CHUNK_X_LENGTH + step * 0.5f, (SEA_LEVEL + 4.5f) * BLOCK_LENGTH, CHUNK_Z_LENGTH + step * 0.375f, 1.f };
+
+            for (size_t i = 0u; i < meshes.size(); ++i) {
+                const ChunkCoord& cc = meshes[i].first;
+                const Vec4f32 chunkOrigin = { static_cast<float>(cc.idx) * CHUNK_X_LENGTH, 0.f, static_cast<float>(cc.idz) * CHUNK_Z_LENGTH, 0.f };
+
+                if (translucentMeshes[i].Sort((cameraPosition - chunkOrigin) / BLOCK_LENGTH))
+                    nMoves += translucentMeshes[i].GetLastSortMoveCount();
+            }
+        }
+
+        return nMoves;
+    } });
+
+    // a second of random edits, remeshing the dirty sections then the whole chunks, then as many edits in one small box.
+    // The checksum is the number of sections meshed: the time follows it, so the edited volume rather than the edit count
+    for (const bool bClustered : { false, true }) {
+        for (const bool bWholeChunks : { false, true }) {
+            if (bClustered && bWholeChunks)
+                continue;
+
+            const std::shared_ptr<const std::vector<BenchmarkBlockEdit>> pEdits = std::make_shared<const std::vector<BenchmarkBlockEdit>>(MakeBenchmarkBlockEdits(bClustered));
+            const char* name = bClustered ? "mesh/edits_clustered" : (bWholeChunks ? "mesh/edits_random_whole_chunks" : "mesh/edits_random");
+
+            scenarios.push_back({ name, [&world, pEdits, bWholeChunks]() {
+                return EditBlocksAndRemesh(world, *pEdits, bWholeChunks);
+            }, BLOCK_EDITS_PER_SECOND });
+        }
+    }
+
+    // every chunk lit on its own, as the jobs do after generating them
+    scenarios.push_back({ "light/chunk", [&batchedNoise]() {
+        static const std::vector<std::unique_ptr<Chunk>> pChunks = [&batchedNoise]() {
+            std::vector<std::unique_ptr<Chunk>> pGeneratedChunks;
+            for (std::int16_t idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx) {
+                for (std::int16_t idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz) {
+                    pGeneratedChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ idx, idz }));
+                    pGeneratedChunks.back()->GenerateDefaultTerrain(batchedNoise);
+                }
+            }
+
+            return pGeneratedChunks;
+        }();
+
+        LightEngine lightEngine;
+        std::uint64_t checksum = 0u;
+        for (const std::unique_ptr<Chunk>& pChunk : pChunks) {
+            lightEngine.ComputeChunkLight(*pChunk);
+            checksum += pChunk->GetBlockMemoryUsage();
+        }
+
+        return checksum + lightEngine.GetVisitedCellCount();
+    } });
+
+    // 448 edits relit incrementally, the checksum is the number of cells the light engine went through: about 150
+    // per edit, where relighting the chunks around each edit from scratch would go through 9 * 16 * 16 * 255 cells
+    scenarios.push_back({ "light/set_block", [&world]() {
+        LightEngine lightEngine;
+
+        std::uint64_t nVisitedCells = 0u;
+        for (int i = 0; i < 16; ++i)
+            nVisitedCells += EditBlocksAndRelight(world, lightEngine);
+
+        return nVisitedCells;
+    } });
+
+    // line of sight queries, every block along the rays then only the ones in columns with opaque blocks. Both hit the same blocks
+    const std::shared_ptr<const std::vector<BenchmarkRay>> pRays = std::make_shared<const std::vector<BenchmarkRay>>(MakeBenchmarkRays(65536u));
+    constexpr float RAYCAST_MAX_DISTANCE = 64.f * BLOCK_LENGTH;
+
+    for (const BLOCK_RAYCAST_MODE mode : { BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE, BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_SKIP_EMPTY }) {
+        scenarios.push_back({ mode == BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE ? "raycast/naive" : "raycast/skip_empty", [&world, pRays, mode]() {
+            return RaycastWorld(world, *pRays, RAYCAST_MAX_DISTANCE, mode);
+        }, pRays->size(), mode == BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE ? nullptr : "raycast/naive" });
+    }
+
+    // time to visible along a scripted flight, with the scheduler's order then with the order the chunks were requested in.
+    // The checksum is the number of frames the chunks in view waited for, see SimulateChunkStreaming
+    for (const bool bPrioritized : { true, false }) {
+        scenarios.push_back({ bPrioritized ? "scheduler/time_to_visible" : "scheduler/time_to_visible_fifo", [bPrioritized]() {
+            return SimulateChunkStreaming(bPrioritized);
+        } });
+    }
+
+    // the render window's chunks found by coordinates, then all iterated over as the memory budget does,
+    // in the ChunkGrid then in the ChunkCoordMap it replaced. Both hold the same chunks, so give the same checksums
+    for (const bool bGrid : { true, false }) {
+        scenarios.push_back({ bGrid ? "chunk_grid/find" : "chunk_grid/find_unordered_map", [bGrid]() {
+            static const BenchmarkChunkWindow window;
+
+            if (bGrid)
+                return FindWindowChunks([](const ChunkCoord& cc) -> const Chunk* { return window.chunkGrid.Find(cc); });
+
+            return FindWindowChunks([](const ChunkCoord& cc) -> const Chunk* {
+                const auto it = window.pChunkMap.find(cc);
+                return it != window.pChunkMap.end() ? it->second.get() : nullptr;
+            });
+        }, CHUNK_WINDOW_FIND_REPETITION_COUNT * (2 * RENDER_DISTANCE + 1) * (2 * RENDER_DISTANCE + 1) * 5, bGrid ? nullptr : "chunk_grid/find" });
+
+        scenarios.push_back({ bGrid ? "chunk_grid/for_each" : "chunk_grid/for_each_unordered_map", [bGrid]() {
+            static const BenchmarkChunkWindow window;
+
+            std::uint64_t checksum = 0u;
+            const auto AddChunk = [&checksum](const Chunk* pChunk) {
+                checksum += static_cast<std::uint64_t>(pChunk->GetLocation().idx + 2 * pChunk->GetLocation().idz + 3 * RENDER_DISTANCE);
+            };
+
+            for (int repetition = 0; repetition < 4096; ++repetition) {
+                if (bGrid) {
+                    window.chunkGrid.ForEach(AddChunk);
+                } else {
+                    for (const auto& [cc, pChunk] : window.pChunkMap)
+                        AddChunk(pChunk.get());
+                }
+            }
+
+            return checksum;
+        }, 4096 * (2 * RENDER_DISTANCE + 1) * (2 * RENDER_DISTANCE + 1), bGrid ? nullptr : "chunk_grid/for_each" });
+    }
+
+    // the render window sliding over the world: the chunks entering it inserted in the ChunkGrid, whose grid follows the window,
+    // and the ones leaving it erased, then the same in the ChunkCoordMap it replaced. The items are the inserts and erases
+    for (const bool bGrid : { true, false }) {
+        scenarios.push_back({ bGrid ? "chunk_grid/insert_erase" : "chunk_grid/insert_erase_unordered_map", [bGrid]() {
+            if (bGrid) {
+                ChunkGrid chunkGrid;
+                const std::uint64_t checksum = SlideChunkWindow([&chunkGrid](const ChunkCoord& gridOrigin) { chunkGrid.SetGridOrigin(gridOrigin); },
+                                                                [&chunkGrid](const ChunkCoord& cc) { chunkGrid.Insert(std::make_unique<Chunk>(cc)); },
+                                                                [&chunkGrid](const ChunkCoord& cc) { chunkGrid.Erase(cc); });
+                return checksum + chunkGrid.GetSize();
+            }
+
+            ChunkCoordMap<std::unique_ptr<Chunk>> pChunkMap;
+            const std::uint64_t checksum = SlideChunkWindow([](const ChunkCoord&) {  },
+                                                            [&pChunkMap](const ChunkCoord& cc) { pChunkMap[cc] = std::make_unique<Chunk>(cc); },
+                                                            [&pChunkMap](const ChunkCoord& cc) { pChunkMap.erase(cc); });
+            return checksum + pChunkMap.size();
+        }, (2 * RENDER_DISTANCE + 1) * (2 * RENDER_DISTANCE + 1) + CHUNK_WINDOW_SLIDE_STEP_COUNT * 2 * (2 * RENDER_DISTANCE + 1),
+           bGrid ? nullptr : "chunk_grid/insert_erase" });
+    }
+
+    // a render window of columns seen from its center, turning around over a full circle, at the default render distance and at the
+    // larger ones LOD makes affordable. The camera's far plane is the game's, so part of the largest window is beyond it
+    constexpr int FRUSTUM_QUADTREE_ANGLE_COUNT = 256;
+
+    for (const auto& [renderDistance, name] : FRUSTUM_QUADTREE_RENDER_DISTANCES) {
+        scenarios.push_back({ name, [renderDistance = renderDistance]() {
+            const int sideChunkCount = 2 * renderDistance + 1;
+
+            std::vector<ChunkColumnBounds> columns;
+            for (int idx = -renderDistance; idx <= renderDistance; ++idx)
+                for (int idz = -renderDistance; idz <= renderDistance; ++idz)
+                    columns.push_back(ChunkColumnBounds{ ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) },
+                                                         0.f, static_cast<float>(64 + (idx * 7 + idz * 13) % 64) * BLOCK_LENGTH,
+                                                         static_cast<std::uint32_t>(columns.size()) });
+
+            ChunkColumnQuadTree tree;
+            tree.Build(columns);
+
+            Camera camera(Vec4f32{ 8.f, 80.f, 8.f, 1.f }, static_cast<float>(M_PI_2), 9.f / 16.f, 0.1f, 1000.f);
+            std::vector<std::uint32_t> visibleIndices;
+            visibleIndices.reserve(sideChunkCount * sideChunkCount);
+
+            std::uint64_t nVisible = 0u;
+            for (int angle = 0; angle < FRUSTUM_QUADTREE_ANGLE_COUNT; ++angle) {
+                camera.SetRotation(Vec4f32{ 0.3f, static_cast<float>(angle) * 2.f * static_cast<float>(M_PI) / FRUSTUM_QUADTREE_ANGLE_COUNT, 0.f, 0.f });
+                camera.Update();
+
+                visibleIndices.clear();
+                tree.Cull(camera.GetFrustum(), visibleIndices);
+                nVisible += visibleIndices.size();
+            }
+
+            return nVisible;
+        }, static_cast<size_t>(FRUSTUM_QUADTREE_ANGLE_COUNT * (2 * renderDistance + 1) * (2 * renderDistance + 1)) });
+    }
+
+    // the world seen from two blocks above the ground at its center, turning around over a full circle, culled as
+    // Minecraft::CullChunks does: the chunks in the frustum, then those behind the solid columns of the chunks around the camera.
+    // The checksum is the number of chunks the occlusion culled times 1000000, plus the number of chunks in the frustum
+    scenarios.push_back({ "cull/occlusion", [&world]() {
+        constexpr int N_ANGLES                = 64;
+        constexpr int OCCLUDER_CHUNK_DISTANCE = 3; // as Minecraft::OCCLUDER_CHUNK_DISTANCE
+        constexpr int CENTER_CHUNK_INDEX      = WORLD_SIDE_CHUNK_COUNT / 2;
+
+        // as the meshes keep them once uploaded
+        static const std::vector<ChunkColumnHeights> columnHeights = [&world]() {
+            std::vector<ChunkColumnHeights> heights;
+            for (int idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx)
+                for (int idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz)
+                    heights.push_back(world.GetChunk(idx, idz).ComputeColumnHeights());
+
+            return heights;
+        }();
+
+        const ChunkColumnHeights& centerHeights = columnHeights[CENTER_CHUNK_INDEX * WORLD_SIDE_CHUNK_COUNT + CENTER_CHUNK_INDEX];
+        const float groundHeight = static_cast<float>(centerHeights.solid[(CHUNK_X_BLOCK_COUNT / 2u) * CHUNK_Z_BLOCK_COUNT + CHUNK_Z_BLOCK_COUNT / 2u]);
+
+        Camera camera(Vec4f32{ (CENTER_CHUNK_INDEX * CHUNK_X_BLOCK_COUNT + 8.f) * BLOCK_LENGTH, (groundHeight + 2.f) * BLOCK_LENGTH,
+                               (CENTER_CHUNK_INDEX * CHUNK_Z_BLOCK_COUNT + 8.f) * BLOCK_LENGTH, 1.f },
+                      static_cast<float>(M_PI_2), 9.f / 16.f, 0.1f, 1000.f);
+        OcclusionCuller occlusionCuller;
+
+        std::uint64_t nInFrustum = 0u;
+        std::uint64_t nOccluded  = 0u;
+
+        std::vector<std::pair<int, std::uint32_t>> occluderChunks;
+        std::vector<std::uint32_t> visibleChunkIndices;
+        for (int angle = 0; angle < N_ANGLES; ++angle) {
+            camera.SetRotation(Vec4f32{ 0.f, static_cast<float>(angle) * 2.f * static_cast<float>(M_PI) / N_ANGLES, 0.f, 0.f });
+            camera.Update();
+
+            visibleChunkIndices.clear();
+            occluderChunks.clear();
+            for (int idx = 0; idx < WORLD_SIDE_CHUNK_COUNT; ++idx) {
+                for (int idz = 0; idz < WORLD_SIDE_CHUNK_COUNT; ++idz) {
+                    const std::uint32_t chunkIndex = static_cast<std::uint32_t>(idx * WORLD_SIDE_CHUNK_COUNT + idz);
+
+                    const Vec4f32 boxMin = { static_cast<float>(idx) * CHUNK_X_LENGTH, 0.f, static_cast<float>(idz) * CHUNK_Z_LENGTH };
+                    const Vec4f32 boxMax = boxMin + Vec4f32{ CHUNK_X_LENGTH, columnHeights[chunkIndex].top * BLOCK_LENGTH, CHUNK_Z_LENGTH };
+                    if (camera.GetFrustum().ClassifyBox(boxMin, boxMax) == FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE)
+                        continue;
+
+                    visibleChunkIndices.push_back(chunkIndex);
+
+                    const int dx = idx - CENTER_CHUNK_INDEX;
+                    const int dz = idz - CENTER_CHUNK_INDEX;
+                    if (std::abs(dx) <= OCCLUDER_CHUNK_DISTANCE && std::abs(dz) <= OCCLUDER_CHUNK_DISTANCE)
+                        occluderChunks.emplace_back(dx * dx + dz * dz, chunkIndex);
+                }
+            }
+
+            std::sort(occluderChunks.begin(), occluderChunks.end());
+
+            occlusionCuller.BeginFrame(camera.GetTransform(), camera.GetPosition());
+            for (const auto& [distance, chunkIndex] : occluderChunks)
+                occlusionCuller.RasterizeChunkOccluder(ChunkCoord{ static_cast<std::int16_t>(chunkIndex / WORLD_SIDE_CHUNK_COUNT),
+                                                                   static_cast<std::int16_t>(chunkIndex % WORLD_SIDE_CHUNK_COUNT) }, columnHeights[chunkIndex]);
+
+            for (const std::uint32_t chunkIndex : visibleChunkIndices) {
+                const Vec4f32 boxMin = { static_cast<float>(chunkIndex / WORLD_SIDE_CHUNK_COUNT) * CHUNK_X_LENGTH, 0.f,
+                                         static_cast<float>(chunkIndex % WORLD_SIDE_CHUNK_COUNT) * CHUNK_Z_LENGTH };
+                if (!occlusionCuller.IsBoxVisible(boxMin, boxMin + Vec4f32{ CHUNK_X_LENGTH, columnHeights[chunkIndex].top * BLOCK_LENGTH, CHUNK_Z_LENGTH }))
+                    ++nOccluded;
+            }
+
+            nInFrustum += visibleChunkIndices.size();
+        }
+
+        return nOccluded * 1000000u + nInFrustum;
+    } });
+
+    scenarios.push_back({ "math/mat4_mul", []() {
+        Mat4x4f32 transform = Mat4x4f32::Identity;
+        const Mat4x4f32 rotation = MakeRotationMatrix(Vec4f32{ 0.001f, 0.002f, 0.003f, 0.f });
+
+        for (int i = 0; i < 1000000; ++i)
+            transform = transform * rotation;
+
+        return static_cast<std::uint64_t>(std::llround(std::abs(transform(0)) * 1e6));
+    } });
+
+    scenarios.push_back({ "math/mat4_vec4", []() {
+        const Mat4x4f32 transform = MakeRotationMatrix(Vec4f32{ 0.1f, 0.2f, 0.3f, 0.f }) * MakeTranslationMatrix(Vec4f32{ 1.f, 2.f, 3.f, 0.f });
+
+        Vec4f32 sum;
+        for (int i = 0; i < 4000000; ++i)
+            sum += transform * Vec4f32{ static_cast<float>(i & 255), static_cast<float>((i >> 8) & 255), static_cast<float>(i >> 16), 1.f };
+
+        return static_cast<std::uint64_t>(std::llround(std::abs(sum.x + sum.y + sum.z)));
+    } });
+
+    scenarios.push_back({ "math/transform_points", []() {
+        const Mat4x4f32 transform = MakeRotationMatrix(Vec4f32{ 0.1f, 0.2f, 0.3f, 0.f }) * MakeTranslationMatrix(Vec4f32{ 1.f, 2.f, 3.f, 0.f });
+
+        std::vector<Vec4f32> points(65536u), results(points.size());
+        for (size_t i = 0u; i < points.size(); ++i)
+            points[i] = Vec4f32{ static_cast<float>(i & 255u), static_cast<float>((i >> 8u) & 255u), static_cast<float>(i >> 16u), 1.f };
+
+        Vec4f32 sum;
+        for (int repetition = 0; repetition < 64; ++repetition) {
+            TransformPoints(transform, points.data(), results.data(), points.size());
+            sum += results[static_cast<size_t>(repetition) * 1021u];
+        }
+
+        return static_cast<std::uint64_t>(std::llround(std::abs(sum.x + sum.y + sum.z)));
+    } });
+
+    // the bounds of every section of a render window, as the frustum culling needs them in view space
+    scenarios.push_back({ "math/transform_aabbs", []() {
+        const Mat4x4f32 transform = MakeRotationMatrix(Vec4f32{ 0.1f, 0.2f, 0.3f, 0.f }) * MakeTranslationMatrix(Vec4f32{ 1.f, 2.f, 3.f, 0.f });
+
+        std::vector<Vec4f32> boxMins(65536u), boxMaxs(boxMins.size()), resultMins(boxMins.size()), resultMaxs(boxMins.size());
+        for (size_t i = 0u; i < boxMins.size(); ++i) {
+            boxMins[i] = Vec4f32{ static_cast<float>(i & 255u) * 16.f, static_cast<float>(i >> 12u) * 16.f, static_cast<float>((i >> 8u) & 15u) * 16.f, 1.f };
+            boxMaxs[i] = boxMins[i] + Vec4f32{ 16.f, 16.f, 16.f, 0.f };
+        }
+
+        Vec4f32 sum;
+        for (int repetition = 0; repetition < 64; ++repetition) {
+            TransformAABBs(transform, boxMins.data(), boxMaxs.data(), resultMins.data(), resultMaxs.data(), boxMins.size());
+            sum += resultMaxs[static_cast<size_t>(repetition) * 1021u] - resultMins[static_cast<size_t>(repetition) * 1021u];
+        }
+
+        return static_cast<std::uint64_t>(std::llround(std::abs(sum.x + sum.y + sum.z)));
+    } });
+
+    scenarios.push_back({ "math/mat4_inverse", []() {
+        const Mat4x4f32 transform = MakeRotationMatrix(Vec4f32{ 0.1f, 0.2f, 0.3f, 0.f }) * MakeTranslationMatrix(Vec4f32{ 1.f, 2.f, 3.f, 0.f })
+                                  * MakePerspectiveMatrix(1.f, 0.75f, 0.1f, 1000.f);
+
+        float sum = 0.f;
+        for (int i = 0; i < 1000000; ++i) {
+            Mat4x4f32 m = transform;
+            m(12) += static_cast<float>(i & 1023);
+
+            sum += Inverted(m).value_or(Mat4x4f32::Zeroes)(15);
+        }
+
+        return static_cast<std::uint64_t>(std::llround(std::abs(sum) * 1e3));
+    } });
+
+    // the sections of a render window sorted by page and depth, as BuildDrawList does
+    scenarios.push_back({ "draw_list/sort", []() {
+        std::mt19937 random(WORLD_SEED);
+        std::uniform_real_distribution<float> depths(0.f, 100000.f);
+
+        DrawList drawList;
+        for (std::uint32_t i = 0u; i < 16384u; ++i) {
+            const std::uint16_t page = static_cast<std::uint16_t>(random() % 16u);
+            drawList.Add(DrawCommand{ DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE, page, depths(random)), i, page, 0u, 0u });
+        }
+
+        drawList.Sort();
+
+        std::uint64_t checksum = 0u;
+        for (size_t i = 0u; i < drawList.GetCommands().size(); i += 1024u)
+            checksum += drawList.GetCommands()[i].object;
+
+        return checksum;
+    } });
+
+    // section meshes replaced at random, with the defragmentation UpdateWorld runs each frame
+    scenarios.push_back({ "mesh_arena/churn", []() {
+        std::mt19937 random(WORLD_SEED);
+        std::exponential_distribution<double> sizes(1.0 / 12000.0);
+
+        CpuMeshArenaBackend backend;
+        MeshArena arena(backend);
+        const std::vector<std::uint8_t> vertexData(MeshArena::PAGE_BYTE_SIZE / 4u, 0u);
+
+        std::vector<MeshArenaAllocation> allocations(4096u);
+        for (int frame = 0; frame < 2000; ++frame) {
+            for (int i = 0; i < 8; ++i) {
+                const size_t byteSize = std::clamp<size_t>(static_cast<size_t>(sizes(random)), 32u, vertexData.size()) / 32u * 32u;
+                allocations[random() % allocations.size()] = arena.Allocate(vertexData.data(), byteSize);
+            }
+
+            arena.Defragment(256u * 1024u);
+        }
+
+        const MeshArenaStats stats = arena.GetStats();
+        return static_cast<std::uint64_t>(stats.nPages) * 1000000u + stats.nAllocations;
+    } });
+
+    return scenarios;
+}
+
+static BenchmarkResult RunScenario(const BenchmarkScenario& scenario, const size_t nRepetitions) noexcept {
+    BenchmarkResult result;
+    result.name = scenario.name;
+
+    // one run to warm the caches up, not timed
+    result.checksum = scenario.run();
+
+    std::vector<double> durations;
+    for (size_t i = 0u; i < nRepetitions; ++i) {
+        const std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        const std::uint64_t checksum = scenario.run();
+        durations.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count());
+
+        if (checksum != result.checksum)
+            std::cerr << scenario.name << ": the checksum changed between repetitions\n";
+    }
+
+    std::sort(durations.begin(), durations.end());
+    result.minMs    = durations.front();
+    result.medianMs = durations[durations.size() / 2u];
+
+    if (scenario.nItems != 0u && result.medianMs > 0.0)
+        result.itemsPerSecond = static_cast<double>(scenario.nItems) * 1000.0 / result.medianMs;
+
+    return result;
+}
+
+// One scenario per line, which is all ReadBaseline relies on
+static void WriteResults(std::ostream& stream, const std::vector<BenchmarkResult>& results, const size_t nRepetitions) noexcept {
+    stream << "{\n  \"seed\": " << WORLD_SEED << ",\n  \"repetitions\": " << nRepetitions << ",\n  \"benchmarks\": [\n";
+
+    stream << std::fixed;
+    stream.precision(4);
+
+    for (size_t i = 0u; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        stream << "    { \"name\": \"" << result.name << "\", \"min_ms\": " << result.minMs << ", \"median_ms\": " << result.medianMs
+               << ", \"checksum\": " << result.checksum;
+
+        if (result.itemsPerSecond > 0.0)
+            stream << ", \"items_per_second\": " << result.itemsPerSecond;
+
+        stream << " }" << (i + 1u < results.size() ? ",\n" : "\n");
+    }
+
+    stream << "  ]\n}\n";
+}
+
+// The value of "key" in a line written by WriteResults, without its quotes
+static std::optional<std::string> FindJsonField(const std::string& line, const std::string& key) noexcept {
+    const size_t keyPosition = line.find('"' + key + "\":");
+    if (keyPosition == std::string::npos)
+        return {  };
+
+    size_t begin = line.find_first_not_of(' ', keyPosition + key.size() + 3u);
+    if (begin == std::string::npos)
+        return {  };
+
+    if (line[begin] == '"') {
+        const size_t end = line.find('"', begin + 1u);
+        return end != std::string::npos ? std::optional<std::string>(line.substr(begin + 1u, end - begin - 1u)) : std::nullopt;
+    }
+
+    const size_t end = line.find_first_of(",}", begin);
+    return line.substr(begin, end - begin);
+}
+
+static std::optional<std::vector<BenchmarkResult>> ReadBaseline(const std::filesystem::path& path) noexcept {
+    std::ifstream file(path);
+    if (!file.is_open())
+        return {  };
+
+    std::vector<BenchmarkResult> results;
+    for (std::string line; std::getline(file, line); ) {
+        const std::optional<std::string> name     = FindJsonField(line, "name");
+        const std::optional<std::string> medianMs = FindJsonField(line, "median_ms");
+        const std::optional<std::string> checksum = FindJsonField(line, "checksum");
+        if (!name.has_value() || !medianMs.has_value() || !checksum.has_value())
+            continue;
+
+        BenchmarkResult result;
+        result.name     = name.value();
+        result.medianMs = std::strtod(medianMs.value().c_str(), nullptr);
+        result.checksum = std::strtoull(checksum.value().c_str(), nullptr, 10);
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+// Returns the number of regressions. A changed checksum is reported but isn't one, the output of a scenario may change on purpose
+static size_t CompareWithBaseline(const std::vector<BenchmarkResult>& results, const std::vector<BenchmarkResult>& baseline, const double tolerance) noexcept {
+    size_t nRegressions = 0u;
+
+    std::cerr << std::fixed;
+    std::cerr.precision(3);
+
+    for (const BenchmarkResult& result : results) {
+        const auto it = std::find_if(baseline.begin(), baseline.end(), [&result](const BenchmarkResult& baselineResult) { return baselineResult.name == result.name; });
+        if (it == baseline.end()) {
+            std::cerr << "  new         " << result.name << ": " << result.medianMs << " ms\n";
+            continue;
+        }
+
+        const double ratio = it->medianMs > 0.0 ? result.medianMs / it->medianMs : 1.0;
+
+        const char* status = "  ok        ";
+        if (ratio > 1.0 + tolerance) {
+            status = "  REGRESSION";
+            ++nRegressions;
+        } else if (ratio < 1.0 - tolerance) {
+            status = "  faster    ";
+        }
+
+        std::cerr << status << ' ' << result.name << ": " << it->medianMs << " -> " << result.medianMs << " ms (x" << ratio << ')'
+                  << (result.checksum != it->checksum ? ", CHANGED output" : "") << '\n';
+    }
+
+    return nRegressions;
+}
+
+// Returns the number of scenarios whose checksum differs from the one of their BenchmarkScenario::sameChecksumAs, when both ran
+static size_t CountChecksumMismatches(const std::vector<BenchmarkScenario>& scenarios, const std::vector<BenchmarkResult>& results) noexcept {
+    const auto FindResult = [&results](const std::string& name) {
+        return std::find_if(results.begin(), results.end(), [&name](const BenchmarkResult& result) { return result.name == name; });
+    };
+
+    size_t nMismatches = 0u;
+    for (const BenchmarkScenario& scenario : scenarios) {
+        if (!scenario.sameChecksumAs)
+            continue;
+
+        const auto it      = FindResult(scenario.name);
+        const auto otherIt = FindResult(scenario.sameChecksumAs);
+        if (it == results.end() || otherIt == results.end() || it->checksum == otherIt->checksum)
+            continue;
+
+        std::cerr << "  MISMATCH    " << scenario.name << ": checksum " << it->checksum << ", " << scenario.sameChecksumAs << ": " << otherIt->checksum << '\n';
+        ++nMismatches;
+    }
+
+    return nMismatches;
+}
+
+static std::optional<BenchmarkOptions> ParseOptions(const int argc, char** argv) noexcept {
+    BenchmarkOptions options;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument = argv[i];
+        if (i + 1 >= argc)
+            return {  };
+
+        const std::string value = argv[++i];
+        if (argument == "--output")
+            options.outputPath = value;
+        else if (argument == "--baseline")
+            options.baselinePath = value;
+        else if (argument == "--tolerance")
+            options.tolerance = std::strtod(value.c_str(), nullptr);
+        else if (argument == "--repetitions")
+            options.nRepetitions = std::max<size_t>(std::strtoull(value.c_str(), nullptr, 10), 1u);
+        else if (argument == "--filter")
+            options.filter = value;
+        else
+            return {  };
+    }
+
+    return options;
+}
+
+int main(int argc, char** argv) {
+    const std::optional<BenchmarkOptions> optionsOpt = ParseOptions(argc, argv);
+    if (!optionsOpt.has_value()) {
+        std::cerr << "Usage: " << argv[0] << " [--output results.json] [--baseline baseline.json] [--tolerance 0.1] [--repetitions 5] [--filter name]\n";
+        return 2;
+    }
+
+    const BenchmarkOptions& options = optionsOpt.value();
+
+    siv::PerlinNoise noise;
+    noise.reseed(WORLD_SEED);
+    const BatchedPerlinNoise batchedNoise(noise);
+
+    BenchmarkWorld world(batchedNoise);
+
+    std::vector<ChunkNeighbourBlocks> neighbours;
+    for (int idx = 1; idx < WORLD_SIDE_CHUNK_COUNT - 1; ++idx)
+        for (int idz = 1; idz < WORLD_SIDE_CHUNK_COUNT - 1; ++idz)
+            neighbours.push_back(world.CopyNeighbourBlocks(idx, idz));
+
+    const std::vector<BenchmarkScenario> scenarios = MakeScenarios(noise, batchedNoise, world, neighbours);
+
+    std::vector<BenchmarkResult> results;
+    for (const BenchmarkScenario& scenario : scenarios) {
+        if (std::string(scenario.name).find(options.filter) == std::string::npos)
+            continue;
+
+        std::cerr << scenario.name << "...\n";
+        results.push_back(RunScenario(scenario, options.nRepetitions));
+    }
+
+    if (options.outputPath.has_value()) {
+        std::ofstream file(options.outputPath.value(), std::ios::out | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "Failed to write " << options.outputPath.value() << '\n';
+            return 2;
+        }
+
+        WriteResults(file, results, options.nRepetitions);
+    } else {
+        WriteResults(std::cout, results, options.nRepetitions);
+    }
+
+    // a faster way to the same output that changed it is a bug, whatever the timings
+    const size_t nMismatches = CountChecksumMismatches(scenarios, results);
+    if (nMismatches != 0u) {
+        std::cerr << nMismatches << " scenario(s) didn't compute the same output as the scenario they're compared with\n";
+        return 1;
+    }
+
+    if (options.baselinePath.has_value()) {
+        const std::optional<std::vector<BenchmarkResult>> baseline = ReadBaseline(options.baselinePath.value());
+        if (!baseline.has_value()) {
+            std::cerr << "Failed to read " << options.baselinePath.value() << '\n';
+            return 2;
+        }
+
+        const size_t nRegressions = CompareWithBaseline(results, baseline.value(), options.tolerance);
+        if (nRegressions != 0u) {
+            std::cerr << nRegressions << " scenario(s) regressed by more than " << options.tolerance * 100.0 << "%\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "BatchedPerlinNoise.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MINECRAFT_BATCHED_NOISE_SSE2
+    #include <emmintrin.h>
+#endif
+
+static inline float Fade(const float t) noexcept { return t * t * t * (t * (t * 6.f - 15.f) + 10.f); }
+static inline float Lerp(const float t, const float a, const float b) noexcept { return a + t * (b - a); }
+
+BatchedPerlinNoise::BatchedPerlinNoise(const siv::PerlinNoise& noise) noexcept {
+    std::array<std::uint8_t, 256u> permutation;
+    noise.serialize(permutation);
+
+    for (size_t i = 0u; i < 256u; ++i)
+        this->m_permutation[i] = this->m_permutation[256u + i] = permutation[i];
+
+    // siv::PerlinNoise's Grad with z = 0
+    for (std::uint8_t h = 0u; h < 16u; ++h) {
+        const float ux = h < 8u ? 1.f : 0.f;
+        const float uy = h < 8u ? 0.f : 1.f;
+        const float vx = (h >= 4u && (h == 12u || h == 14u)) ? 1.f : 0.f;
+        const float vy = h < 4u ? 1.f : 0.f;
+
+        const float uSign = (h & 1u) == 0u ? 1.f : -1.f;
+        const float vSign = (h & 2u) == 0u ? 1.f : -1.f;
+
+        this->m_gradientX[h] = uSign * ux + vSign * vx;
+        this->m_gradientY[h] = uSign * uy + vSign * vy;
+    }
+}
+
+void BatchedPerlinNoise::AccumulateNoise2D(const float* xs, const float* ys, const size_t nPoints, const float amplitude, float* out) const noexcept {
+    const std::uint8_t* p = this->m_permutation.data();
+
+    size_t i = 0u;
+
+#ifdef MINECRAFT_BATCHED_NOISE_SSE2
+    const __m128 one       = _mm_set1_ps(1.f);
+    const __m128 six       = _mm_set1_ps(6.f);
+    const __m128 fifteen   = _mm_set1_ps(15.f);
+    const __m128 ten       = _mm_set1_ps(10.f);
+    const __m128 amplitude4 = _mm_set1_ps(amplitude);
+
+    const auto Fade4 = [&](const __m128 t) {
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, six), fifteen)), ten));
+    };
+
+    const auto Lerp4 = [](const __m128 t, const __m128 a, const __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    };
+
+    // floor without SSE4.1: truncate, then step back for the negative values that got rounded up
+    const auto Floor4 = [&](const __m128 v) {
+        const __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+        return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), one));
+    };
+
+    for (; i + 4u <= nPoints; i += 4u) {
+        const __m128 x = _mm_loadu_ps(xs + i);
+        const __m128 y = _mm_loadu_ps(ys + i);
+
+        const __m128 xFloor = Floor4(x);
+        const __m128 yFloor = Floor4(y);
+
+        alignas(16) std::int32_t X[4], Y[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(X), _mm_cvttps_epi32(xFloor));
+        _mm_store_si128(reinterpret_cast<__m128i*>(Y), _mm_cvttps_epi32(yFloor));
+
+        // the permutation lookups can't be vectorized without gathers
+        alignas(16) float gx00[4], gy00[4], gx10[4], gy10[4], gx01[4], gy01[4], gx11[4], gy11[4];
+        for (size_t lane = 0u; lane < 4u; ++lane) {
+            const std::int32_t A = p[X[lane] & 255] + (Y[lane] & 255);
+            const std::int32_t B = p[(X[lane] & 255) + 1] + (Y[lane] & 255);
+
+            const std::uint8_t h00 = p[p[A]]     & 15u;
+            const std::uint8_t h10 = p[p[B]]     & 15u;
+            const std::uint8_t h01 = p[p[A + 1]] & 15u;
+            const std::uint8_t h11 = p[p[B + 1]] & 15u;
+
+            gx00[lane] = this->m_gradientX[h00]; gy00[lane] = this->m_gradientY[h00];
+            gx10[lane] = this->m_gradientX[h10]; gy10[lane] = this->m_gradientY[h10];
+            gx01[lane] = this->m_gradientX[h01]; gy01[lane] = this->m_gradientY[h01];
+            gx11[lane] = this->m_gradientX[h11]; gy11[lane] = this->m_gradientY[h11];
+        }
+
+        const __m128 xf  = _mm_sub_ps(x, xFloor);
+        const __m128 yf  = _mm_sub_ps(y, yFloor);
+        const __m128 xf1 = _mm_sub_ps(xf, one);
+        const __m128 yf1 = _mm_sub_ps(yf, one);
+
+        const __m128 g00 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx00), xf),  _mm_mul_ps(_mm_load_ps(gy00), yf));
+        const __m128 g10 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx10), xf1), _mm_mul_ps(_mm_load_ps(gy10), yf));
+        const __m128 g01 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx01), xf),  _mm_mul_ps(_mm_load_ps(gy01), yf1));
+        const __m128 g11 = _mm_add_ps(_mm_mul_ps(_mm_load_ps(gx11), xf1), _mm_mul_ps(_mm_load_ps(gy11), yf1));
+
+        const __m128 u = Fade4(xf);
+        const __m128 v = Fade4(yf);
+
+        const __m128 noise = Lerp4(v, Lerp4(u, g00, g10), Lerp4(u, g01, g11));
+
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(out + i), _mm_mul_ps(noise, amplitude4)));
+    }
+#endif // MINECRAFT_BATCHED_NOISE_SSE2
+
+    for (; i < nPoints; ++i) {
+        const float xFloor = std::floor(xs[i]);
+        const float yFloor = std::floor(ys[i]);
+
+        const std::int32_t X = static_cast<std::int32_t>(xFloor) & 255;
+        const std::int32_t Y = static_cast<std::int32_t>(yFloor) & 255;
+
+        const std::int32_t A = p[X] + Y;
+        const std::int32_t B = p[X + 1] + Y;
+
+        const std::uint8_t h00 = p[p[A]]     & 15u;
+        const std::uint8_t h10 = p[p[B]]     & 15u;
+        const std::uint8_t h01 = p[p[A + 1]] & 15u;
+        const std::uint8_t h11 = p[p[B + 1]] & 15u;
+
+        const float xf = xs[i] - xFloor;
+        const float yf = ys[i] - yFloor;
+
+        const float g00 = this->m_gradientX[h00] * xf         + this->m_gradientY[h00] * yf;
+        const float g10 = this->m_gradientX[h10] * (xf - 1.f) + this->m_gradientY[h10] * yf;
+        const float g01 = this->m_gradientX[h01] * xf         + this->m_gradientY[h01] * (yf - 1.f);
+        const float g11 = this->m_gradientX[h11] * (xf - 1.f) + this->m_gradientY[h11] * (yf - 1.f);
+
+        const float u = Fade(xf);
+        const float v = Fade(yf);
+
+        out[i] += Lerp(v, Lerp(u, g00, g10), Lerp(u, g01, g11)) * amplitude;
+    }
+}
+
+void BatchedPerlinNoise::NormalizedOctaveNoise2D_0_1(const std::int32_t x0, const std::int32_t y0, const size_t width, const size_t height,
+                                                     const float scale, const std::int32_t octaves, float* out) const noexcept {
+    const size_t nPoints = width * height;
+
+    std::vector<float> xs(nPoints), ys(nPoints);
+    for (size_t i = 0u; i < width; ++i) {
+        for (size_t j = 0u; j < height; ++j) {
+            xs[i * height + j] = (x0 + static_cast<std::int32_t>(i)) / scale;
+            ys[i * height + j] = (y0 + static_cast<std::int32_t>(j)) / scale;
+        }
+    }
+
+    std::fill_n(out, nPoints, 0.f);
+
+    float amplitude = 1.f;
+    float weight    = 0.f;
+
+    for (std::int32_t octave = 0; octave < octaves; ++octave) {
+        this->AccumulateNoise2D(xs.data(), ys.data(), nPoints, amplitude, out);
+
+        for (size_t i = 0u; i < nPoints; ++i) {
+            xs[i] *= 2.f;
+            ys[i] *= 2.f;
+        }
+
+        weight    += amplitude;
+        amplitude /= 2.f;
+    }
+
+    for (size_t i = 0u; i < nPoints; ++i)
+        out[i] = out[i] / weight * 0.5f + 0.5f;
+}
@@ -0,0 +1,34 @@
+#ifndef __MINECRAFT__BATCHED_PERLIN_NOISE_HPP
+#define __MINECRAFT__BATCHED_PERLIN_NOISE_HPP
+
+#include "Pch.hpp"
+#include "vendor/PerlinNoise.hpp"
+
+// Evaluates siv::PerlinNoise's 2D octave noise on whole grids at once, in single precision
+// and 4 points at a time with SSE2 (scalar fallback otherwise).
+// Results match siv::PerlinNoise's up to float rounding.
+class BatchedPerlinNoise {
+private:
+    std::array<std::uint8_t, 512u> m_permutation{};
+
+    // gradients of siv::PerlinNoise's Grad(hash, x, y, 0) along x and y, indexed by hash & 15
+    std::array<float, 16u> m_gradientX{};
+    std::array<float, 16u> m_gradientY{};
+
+private:
+    // out[i] += noise2D(xs[i], ys[i]) * amplitude
+    void AccumulateNoise2D(const float* xs, const float* ys, const size_t nPoints, const float amplitude, float* out) const noexcept;
+
+public:
+    inline BatchedPerlinNoise() noexcept = default;
+
+    // Uses the same permutation as "noise"
+    explicit BatchedPerlinNoise(const siv::PerlinNoise& noise) noexcept;
+
+    // Same as siv::PerlinNoise::normalizedOctaveNoise2D_0_1((x0 + i) / scale, (y0 + j) / scale, octaves)
+    // for every i < width and j < height, written to out[i * height + j]
+    void NormalizedOctaveNoise2D_0_1(const std::int32_t x0, const std::int32_t y0, const size_t width, const size_t height,
+                                     const float scale, const std::int32_t octaves, float* out) const noexcept;
+}; // class BatchedPerlinNoise
+
+#endif // __MINECRAFT__BATCHED_PERLIN_NOISE_HPP
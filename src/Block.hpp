@@ -2,16 +2,7 @@
 #define __MINECRAFT__BLOCK_HPP
 
 #include "Vector.hpp"
-
-struct UV {
-    float u, v;
-}; // struct UV
-
-struct Vertex {
-    Vec4f32 position;
-    UV      uv;
-    float   lighting = 1.0f;
-}; // struct Vertex
+#include "Constants.hpp"
 
 enum class BLOCK_FACE : std::uint8_t {
     BLOCK_FACE_TOP = 0u,
@@ -37,6 +28,7 @@ enum class BLOCK_TYPE : std::uint8_t {
     BLOCK_TYPE_GRASS,
     BLOCK_TYPE_SAND,
     BLOCK_TYPE_WATER, 
+    BLOCK_TYPE_LAMP,
     
     _COUNT // used to know at compile time then umber of block 
 }; // enum class BlockType
@@ -44,17 +36,19 @@ enum class BLOCK_TYPE : std::uint8_t {
 struct BlockProperties {
     BLOCK_TYPE       type;
     BLOCK_VISIBILITY visibility;
+    std::uint8_t     lightEmission; // the block light level of its own cell, in [0, MAX_LIGHT_LEVEL]
 };
 
 inline BlockProperties GetBlockProperties(const BLOCK_TYPE& type) noexcept {
     // can set as constexpr: cl.exe has an internal error
     static std::array<BlockProperties, static_cast<std::size_t>(BLOCK_TYPE::_COUNT)> properties = {
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_AIR,   BLOCK_VISIBILITY::BLOCK_VISIBILITY_TRANSPARENT },
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_DIRT,  BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE      },
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_GRASS, BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE      },
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_SAND,  BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE      },
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_STONE, BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE      },
-        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_WATER, BLOCK_VISIBILITY::BLOCK_VISIBILITY_TRANSLUCENT }
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_AIR,   BLOCK_VISIBILITY::BLOCK_VISIBILITY_TRANSPARENT, 0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_DIRT,  BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE,      0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_GRASS, BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE,      0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_SAND,  BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE,      0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_STONE, BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE,      0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_WATER, BLOCK_VISIBILITY::BLOCK_VISIBILITY_TRANSLUCENT, 0u              },
+        BlockProperties{ BLOCK_TYPE::BLOCK_TYPE_LAMP,  BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE,      MAX_LIGHT_LEVEL }
     };
 
     return properties[static_cast<std::size_t>(type)];
@@ -64,11 +58,11 @@ inline bool IsBlockTransparent(const BLOCK_TYPE& blockType) noexcept { return Ge
 inline bool IsBlockTranslucent(const BLOCK_TYPE& blockType) noexcept { return GetBlockProperties(blockType).visibility == BLOCK_VISIBILITY::BLOCK_VISIBILITY_TRANSLUCENT; }
 inline bool IsBlockOpaque     (const BLOCK_TYPE& blockType) noexcept { return GetBlockProperties(blockType).visibility == BLOCK_VISIBILITY::BLOCK_VISIBILITY_OPAQUE;      }
 
-inline UV   GetBlockFaceBaseUV(const BLOCK_TYPE& blockType, const BLOCK_FACE& blockFace, const UV& textureUVSize) noexcept {
-    return UV{
-        textureUVSize.u * (static_cast<float>(blockType) - 1.f),
-        textureUVSize.v * (static_cast<float>(blockFace))
-    };
+inline std::uint8_t GetBlockLightEmission(const BLOCK_TYPE& blockType) noexcept { return GetBlockProperties(blockType).lightEmission; }
+
+// The texture atlas holds one column per block type and one row per block face
+inline std::uint8_t GetBlockFaceAtlasTile(const BLOCK_TYPE& blockType, const BLOCK_FACE& blockFace, const std::size_t atlasTilesPerRow) noexcept {
+    return static_cast<std::uint8_t>(static_cast<std::size_t>(blockFace) * atlasTilesPerRow + static_cast<std::size_t>(blockType) - 1u);
 }
 
 inline float GetBlockFaceLighting(const BLOCK_FACE& blockFace) noexcept {
@@ -79,4 +73,63 @@ inline float GetBlockFaceLighting(const BLOCK_FACE& blockFace) noexcept {
     return lightingValues[static_cast<std::size_t>(blockFace)];
 }
 
+// How bright a cell lit at "lightLevel" looks, each level is dimmer than the one above it by a growing
+// factor, down to an ambient floor so that unlit caves stay dim rather than black
+inline float GetLightLevelBrightness(const std::uint8_t lightLevel) noexcept {
+    constexpr float AMBIENT_BRIGHTNESS = 0.1f;
+
+    const float level = static_cast<float>(lightLevel) / MAX_LIGHT_LEVEL;
+    return AMBIENT_BRIGHTNESS + (1.f - AMBIENT_BRIGHTNESS) * level / (3.f * (1.f - level) + 1.f);
+}
+
+// GetBlockFaceLighting scaled by the brightness of the cell the face looks into,
+// quantized to the [0, MAX_LIGHT_LEVEL] range stored in vertices
+inline std::uint8_t GetBlockFaceLightLevel(const BLOCK_FACE& blockFace, const std::uint8_t lightLevel) noexcept {
+    return static_cast<std::uint8_t>(std::lround(GetBlockFaceLighting(blockFace) * GetLightLevelBrightness(lightLevel) * MAX_LIGHT_LEVEL));
+}
+
+// A vertex as the mesher sees it, positions are in blocks and relative to the chunk's origin
+struct UnpackedVertex {
+    std::uint16_t x, y, z;
+    BLOCK_FACE    face;
+    std::uint8_t  light; // in [0, MAX_LIGHT_LEVEL]
+    std::uint8_t  tile;  // index of the texture in the atlas, see GetBlockFaceAtlasTile
+    std::uint16_t tilingU, tilingV; // position inside the face, in textures (a greedy quad spanning 3 blocks goes from 0 to 3)
+}; // struct UnpackedVertex
+
+// The vertex sent to the GPU (8 bytes), decoded by vsBlockCode
+//   position: x (5 bits) | y (9 bits) | z (5 bits) | face (3 bits) | light (4 bits)
+//   texture:  tile (8 bits) | tilingU (9 bits) | tilingV (9 bits)
+struct Vertex {
+    std::uint32_t position;
+    std::uint32_t texture;
+}; // struct Vertex
+
+inline Vertex PackVertex(const UnpackedVertex& v) noexcept {
+    return Vertex{
+        (static_cast<std::uint32_t>(v.x)     & 0x1Fu)         |
+        ((static_cast<std::uint32_t>(v.y)    & 0x1FFu) << 5u)  |
+        ((static_cast<std::uint32_t>(v.z)    & 0x1Fu)  << 14u) |
+        ((static_cast<std::uint32_t>(v.face) & 0x7u)   << 19u) |
+        ((static_cast<std::uint32_t>(v.light) & 0xFu)  << 22u),
+
+        (static_cast<std::uint32_t>(v.tile)      & 0xFFu)         |
+        ((static_cast<std::uint32_t>(v.tilingU)  & 0x1FFu) << 8u)  |
+        ((static_cast<std::uint32_t>(v.tilingV)  & 0x1FFu) << 17u)
+    };
+}
+
+inline UnpackedVertex UnpackVertex(const Vertex& v) noexcept {
+    return UnpackedVertex{
+        static_cast<std::uint16_t>(v.position & 0x1Fu),
+        static_cast<std::uint16_t>((v.position >> 5u)  & 0x1FFu),
+        static_cast<std::uint16_t>((v.position >> 14u) & 0x1Fu),
+        static_cast<BLOCK_FACE>   ((v.position >> 19u) & 0x7u),
+        static_cast<std::uint8_t> ((v.position >> 22u) & 0xFu),
+        static_cast<std::uint8_t> (v.texture & 0xFFu),
+        static_cast<std::uint16_t>((v.texture >> 8u)  & 0x1FFu),
+        static_cast<std::uint16_t>((v.texture >> 17u) & 0x1FFu)
+    };
+}
+
 #endif // __MINECRAFT__BLOCK_HPP
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "BlockRaycast.hpp"
+
+// Boxes that are unbounded along y stop at these, far past any distance a ray goes
+static constexpr int UNBOUNDED_Y_MIN = -(1 << 24);
+static constexpr int UNBOUNDED_Y_MAX =  (1 << 24);
+
+// The ray in blocks. The time it crosses a plane is always computed from the origin, never accumulated from
+// one block to the next, so that the naive walk and the skipping one see every crossing at the same time
+struct RaycastRay {
+    std::array<float, 3u> origin;
+    std::array<float, 3u> direction;        // normalized
+    std::array<float, 3u> inverseDirection; // infinite along the axes the ray doesn't move along
+    std::array<int,   3u> step;
+
+    // Only for the axes where step isn't 0
+    inline float GetCrossingTime(const size_t axis, const int plane) const noexcept {
+        return (static_cast<float>(plane) - this->origin[axis]) * this->inverseDirection[axis];
+    }
+}; // struct RaycastRay
+
+// The face of a block a ray moving along "axis" toward "step" goes in through
+static inline BLOCK_FACE GetEntryFace(const size_t axis, const int step) noexcept {
+    constexpr std::array<BLOCK_FACE, 6u> entryFaces = {
+        BLOCK_FACE::BLOCK_FACE_RIGHT, BLOCK_FACE::BLOCK_FACE_LEFT,   // -x, +x
+        BLOCK_FACE::BLOCK_FACE_TOP,   BLOCK_FACE::BLOCK_FACE_BOTTOM, // -y, +y
+        BLOCK_FACE::BLOCK_FACE_BACK,  BLOCK_FACE::BLOCK_FACE_FRONT   // -z, +z
+    };
+
+    return entryFaces[axis * 2u + (step > 0 ? 1u : 0u)];
+}
+
+static bool HasOpaqueBlocks(const Chunk& chunk) noexcept {
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        const ChunkSection* pSection = chunk.GetSection(sectionIndex);
+
+        if (pSection && pSection->HasOpaqueBlocks())
+            return true;
+    }
+
+    return false;
+}
+
+template <bool bSkipEmpty>
+static std::optional<BlockRaycastHit> Raycast(const BlockRaycastChunkLookup& getChunk, const Vec4f32& origin, const Vec4f32& direction, const float maxDistance) noexcept {
+    const float length = direction.GetLength3D();
+    if (!(length > 0.f))
+        return {  };
+
+    RaycastRay ray;
+    const std::array<float, 3u> originComponents    = { origin.x,    origin.y,    origin.z    };
+    const std::array<float, 3u> directionComponents = { direction.x, direction.y, direction.z };
+
+    std::array<int, 3u> block;
+    size_t dominantAxis = 0u;
+
+    for (size_t axis = 0u; axis < 3u; ++axis) {
+        ray.origin[axis]           = originComponents[axis] / BLOCK_LENGTH;
+        ray.direction[axis]        = directionComponents[axis] / length;
+        ray.inverseDirection[axis] = 1.f / ray.direction[axis];
+        ray.step[axis]             = (ray.direction[axis] > 0.f) ? 1 : (ray.direction[axis] < 0.f) ? -1 : 0;
+
+        block[axis] = static_cast<int>(std::floor(ray.origin[axis]));
+
+        if (std::abs(ray.direction[axis]) > std::abs(ray.direction[dominantAxis]))
+            dominantAxis = axis;
+    }
+
+    const float maxTime = maxDistance / BLOCK_LENGTH;
+
+    float      time = 0.f;
+    BLOCK_FACE face = GetEntryFace(dominantAxis, ray.step[dominantAxis]);
+
+    // the chunk the ray is in, it only changes every few blocks
+    const Chunk* pChunk = nullptr;
+    ChunkCoord   chunkLocation{ 0, 0 };
+    bool         bHasChunk = false;
+    bool         bChunkHasOpaqueBlocks = false;
+
+    for (;;) {
+        // nothing to hit above or below the world
+        if ((block[1] < 0 && ray.step[1] <= 0) || (block[1] >= CHUNK_Y_BLOCK_COUNT && ray.step[1] >= 0))
+            return {  };
+
+        const ChunkCoord blockChunkLocation = GetBlockChunkLocation(block[0], block[2]);
+        if (!bHasChunk || !(blockChunkLocation == chunkLocation)) {
+            pChunk        = getChunk(blockChunkLocation);
+            chunkLocation = blockChunkLocation;
+            bHasChunk     = true;
+
+            if constexpr (bSkipEmpty)
+                bChunkHasOpaqueBlocks = pChunk && HasOpaqueBlocks(*pChunk);
+        }
+
+        const int chunkX = chunkLocation.idx * CHUNK_X_BLOCK_COUNT;
+        const int chunkZ = chunkLocation.idz * CHUNK_Z_BLOCK_COUNT;
+
+        const size_t idx          = static_cast<size_t>(block[0] - chunkX);
+        const size_t idz          = static_cast<size_t>(block[2] - chunkZ);
+        const size_t sectionIndex = static_cast<size_t>(block[1]) / CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t sectionY     = static_cast<size_t>(block[1]) % CHUNK_SECTION_Y_BLOCK_COUNT;
+
+        const bool bIsInWorld = block[1] >= 0 && block[1] < CHUNK_Y_BLOCK_COUNT;
+        const ChunkSection* pSection = (pChunk && bIsInWorld) ? pChunk->GetSection(sectionIndex) : nullptr;
+
+        // the box of blocks without opaque blocks the ray is in, [boxMin, boxMax] along each axis
+        std::array<int, 3u> boxMin = block;
+        std::array<int, 3u> boxMax = block;
+
+        if constexpr (bSkipEmpty) {
+            if (!bChunkHasOpaqueBlocks || !bIsInWorld) {
+                boxMin = { chunkX,                           UNBOUNDED_Y_MIN, chunkZ                           };
+                boxMax = { chunkX + CHUNK_X_BLOCK_COUNT - 1, UNBOUNDED_Y_MAX, chunkZ + CHUNK_Z_BLOCK_COUNT - 1 };
+
+                // only the part above or below the world is empty in a chunk with blocks
+                if (bChunkHasOpaqueBlocks && block[1] < 0)                    boxMax[1] = -1;
+                if (bChunkHasOpaqueBlocks && block[1] >= CHUNK_Y_BLOCK_COUNT) boxMin[1] = CHUNK_Y_BLOCK_COUNT;
+            } else if (!pSection || !pSection->HasOpaqueBlocks()) {
+                boxMin = { chunkX,                           static_cast<int>(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT),            chunkZ                           };
+                boxMax = { chunkX + CHUNK_X_BLOCK_COUNT - 1, static_cast<int>((sectionIndex + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT) - 1, chunkZ + CHUNK_Z_BLOCK_COUNT - 1 };
+            } else if (!pSection->HasOpaqueBlockInColumn(idx, idz)) {
+                boxMin[1] = static_cast<int>(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT);
+                boxMax[1] = static_cast<int>((sectionIndex + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT) - 1;
+            }
+        }
+
+        // a box of one block is one the ray has to look into
+        if (pSection && boxMin == boxMax) {
+            const BLOCK_TYPE type = pSection->GetBlock(ChunkSection::GetBlockIndex(idx, sectionY, idz));
+
+            if (IsBlockOpaque(type))
+                return BlockRaycastHit{ block, type, face, time * BLOCK_LENGTH };
+        }
+
+        // the ray leaves the box through the plane it crosses first, the lowest axis first when it crosses several at once
+        size_t exitAxis = 3u;
+        float  exitTime = std::numeric_limits<float>::infinity();
+
+        for (size_t axis = 0u; axis < 3u; ++axis) {
+            if (ray.step[axis] == 0)
+                continue;
+
+            const float crossingTime = ray.GetCrossingTime(axis, ray.step[axis] > 0 ? boxMax[axis] + 1 : boxMin[axis]);
+            if (crossingTime < exitTime) {
+                exitTime = crossingTime;
+                exitAxis = axis;
+            }
+        }
+
+        if (exitAxis == 3u || exitTime > maxTime)
+            return {  };
+
+        // along the other axes, the block the ray is in when it leaves the box is the one a block by block walk would be in:
+        // the planes crossed before, or at the same time along a lower axis (which the walk steps first), are behind it
+        for (size_t axis = 0u; axis < 3u; ++axis) {
+            if (axis == exitAxis || ray.step[axis] == 0 || boxMin[axis] == boxMax[axis])
+                continue;
+
+            const auto IsCrossed = [&ray, axis, exitAxis, exitTime](const int plane) {
+                const float crossingTime = ray.GetCrossingTime(axis, plane);
+                return crossingTime < exitTime || (crossingTime == exitTime && axis < exitAxis);
+            };
+
+            // the ray only moves forward, the block it entered the box in bounds the search from behind
+            const int entryBlock = block[axis];
+            const int minBlock   = ray.step[axis] > 0 ? entryBlock   : boxMin[axis];
+            const int maxBlock   = ray.step[axis] > 0 ? boxMax[axis] : entryBlock;
+
+            int& b = block[axis];
+            b = std::clamp(static_cast<int>(std::floor(ray.origin[axis] + ray.direction[axis] * exitTime)), minBlock, maxBlock);
+
+            if (ray.step[axis] > 0) {
+                while (b < maxBlock &&  IsCrossed(b + 1)) ++b;
+                while (b > minBlock && !IsCrossed(b))     --b;
+            } else {
+                while (b > minBlock &&  IsCrossed(b))     --b;
+                while (b < maxBlock && !IsCrossed(b + 1)) ++b;
+            }
+        }
+
+        block[exitAxis] = ray.step[exitAxis] > 0 ? boxMax[exitAxis] + 1 : boxMin[exitAxis] - 1;
+        time = std::max(0.f, exitTime); // not -0 when the origin is on the plane
+        face = GetEntryFace(exitAxis, ray.step[exitAxis]);
+    }
+}
+
+std::optional<BlockRaycastHit> RaycastBlocks(const BlockRaycastChunkLookup& getChunk, const Vec4f32& origin, const Vec4f32& direction, const float maxDistance,
+                                             const BLOCK_RAYCAST_MODE mode) noexcept
+{
+    if (mode == BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE)
+        return Raycast<false>(getChunk, origin, direction, maxDistance);
+
+    return Raycast<true>(getChunk, origin, direction, maxDistance);
+}
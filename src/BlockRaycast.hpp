@@ -0,0 +1,57 @@
+#ifndef __MINECRAFT__BLOCK_RAYCAST_HPP
+#define __MINECRAFT__BLOCK_RAYCAST_HPP
+
+#include "Pch.hpp"
+#include "Block.hpp"
+#include "Chunk.hpp"
+#include "Vector.hpp"
+#include "Constants.hpp"
+
+enum class BLOCK_RAYCAST_MODE : std::uint8_t {
+    BLOCK_RAYCAST_MODE_NAIVE = 0u, // every block along the ray is looked at
+    BLOCK_RAYCAST_MODE_SKIP_EMPTY  // chunks, sections and columns without opaque blocks are crossed in one step
+}; // enum class BLOCK_RAYCAST_MODE
+
+// World block coordinates are in blocks, block (x, y, z) spans [x, x + 1) * BLOCK_LENGTH along x and so on
+inline ChunkCoord GetBlockChunkLocation(const int x, const int z) noexcept {
+    const auto FloorDiv = [](const int a, const int b) { return (a >= 0 ? a : a - b + 1) / b; };
+
+    return ChunkCoord{ static_cast<std::int16_t>(FloorDiv(x, CHUNK_X_BLOCK_COUNT)), static_cast<std::int16_t>(FloorDiv(z, CHUNK_Z_BLOCK_COUNT)) };
+}
+
+struct BlockRaycastHit {
+    std::array<int, 3u> block; // world coordinates of the block hit
+    BLOCK_TYPE          type;
+    BLOCK_FACE          face;     // the face the ray went in through
+    float               distance; // from the ray's origin to where it went in, 0 when the origin is inside the block
+
+    // The block in front of "face", where a block placed against the one hit goes
+    inline std::array<int, 3u> GetAdjacentBlock() const noexcept {
+        std::array<int, 3u> adjacentBlock = this->block;
+
+        switch (this->face) {
+        case BLOCK_FACE::BLOCK_FACE_TOP:    ++adjacentBlock[1]; break;
+        case BLOCK_FACE::BLOCK_FACE_BOTTOM: --adjacentBlock[1]; break;
+        case BLOCK_FACE::BLOCK_FACE_LEFT:   --adjacentBlock[0]; break;
+        case BLOCK_FACE::BLOCK_FACE_RIGHT:  ++adjacentBlock[0]; break;
+        case BLOCK_FACE::BLOCK_FACE_FRONT:  --adjacentBlock[2]; break;
+        case BLOCK_FACE::BLOCK_FACE_BACK:   ++adjacentBlock[2]; break;
+        default: break;
+        }
+
+        return adjacentBlock;
+    }
+}; // struct BlockRaycastHit
+
+// nullptr when the chunk's blocks can't be read, the ray goes through such chunks as if they were empty
+using BlockRaycastChunkLookup = std::function<const Chunk*(const ChunkCoord&)>;
+
+// Finds the first opaque block along the ray, up to "maxDistance" from "origin" (both in world units), by walking
+// the blocks the ray goes through in order (Amanatides & Woo's DDA). Air and translucent blocks are seen through.
+// BLOCK_RAYCAST_MODE_SKIP_EMPTY leaves the chunks, sections and section columns without opaque blocks
+// (see ChunkSection::HasOpaqueBlockInColumn) as a whole, and gives the same hit as BLOCK_RAYCAST_MODE_NAIVE, bit for bit.
+// "direction" doesn't have to be normalized
+std::optional<BlockRaycastHit> RaycastBlocks(const BlockRaycastChunkLookup& getChunk, const Vec4f32& origin, const Vec4f32& direction, const float maxDistance,
+                                             const BLOCK_RAYCAST_MODE mode = BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_SKIP_EMPTY) noexcept;
+
+#endif // __MINECRAFT__BLOCK_RAYCAST_HPP
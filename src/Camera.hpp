@@ -26,10 +26,35 @@ enum class CAMERA_FRUSTUM_PLANE {
     _COUNT
 }; // enum class CAMERA_FRUSTUM_PLANE
 
+enum class FRUSTUM_INTERSECTION : std::uint8_t {
+    FRUSTUM_INTERSECTION_OUTSIDE = 0u,
+    FRUSTUM_INTERSECTION_INTERSECTING,
+    FRUSTUM_INTERSECTION_INSIDE
+}; // enum class FRUSTUM_INTERSECTION
+
 struct CameraFrustum {
     std::array<CameraFrustumPlane, static_cast<std::size_t>(CAMERA_FRUSTUM_PLANE::_COUNT)> planes;
 
-    inline bool IsChunkInFrustum(const Chunk& chunk) const noexcept {        
+    // Box-plane test against the box's corner furthest along each plane's normal (p-vertex),
+    // and the one furthest against it (n-vertex) to know if the box is fully inside
+    inline FRUSTUM_INTERSECTION ClassifyBox(const Vec4f32& boxMin, const Vec4f32& boxMax) const noexcept {
+        FRUSTUM_INTERSECTION intersection = FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_INSIDE;
+
+        for (const CameraFrustumPlane& plane : this->planes) {
+            const Vec4f32 pVertex = { plane.x > 0.f ? boxMax.x : boxMin.x, plane.y > 0.f ? boxMax.y : boxMin.y, plane.z > 0.f ? boxMax.z : boxMin.z };
+            const Vec4f32 nVertex = { plane.x > 0.f ? boxMin.x : boxMax.x, plane.y > 0.f ? boxMin.y : boxMax.y, plane.z > 0.f ? boxMin.z : boxMax.z };
+
+            if (IsPointOutsideFrustumOfPlane(pVertex, plane))
+                return FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE;
+
+            if (IsPointOutsideFrustumOfPlane(nVertex, plane))
+                intersection = FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_INTERSECTING;
+        }
+
+        return intersection;
+    }
+
+    inline bool IsChunkInFrustum(const Chunk& chunk) const noexcept {
         const auto& cc = chunk.GetLocation();
 
         const Vec4f32 chunkBaseXZAxis = {
@@ -38,42 +63,8 @@ struct CameraFrustum {
             static_cast<float>(cc.idz) * CHUNK_Z_LENGTH
         };
 
-        const auto& checkFrustumPlanes = {
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_LEFT,
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_RIGHT,
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_BOTTOM,
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_TOP,
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_NEAR,
-            CAMERA_FRUSTUM_PLANE::CAMERA_FRUSTUM_PLANE_FAR
-        };
-
-        const auto& checkPoints = {
-            chunkBaseXZAxis + Vec4f32{0.f,            0.f,            0.f },
-            chunkBaseXZAxis + Vec4f32{CHUNK_X_LENGTH, 0.f,            0.f },
-            chunkBaseXZAxis + Vec4f32{CHUNK_X_LENGTH, CHUNK_Y_LENGTH, 0.f },
-            chunkBaseXZAxis + Vec4f32{0.f,            CHUNK_Y_LENGTH, 0.f },
-
-            chunkBaseXZAxis + Vec4f32{0.f,            0.f,            CHUNK_Z_LENGTH },
-            chunkBaseXZAxis + Vec4f32{CHUNK_X_LENGTH, 0.f,            CHUNK_Z_LENGTH },
-            chunkBaseXZAxis + Vec4f32{CHUNK_X_LENGTH, CHUNK_Y_LENGTH, CHUNK_Z_LENGTH },
-            chunkBaseXZAxis + Vec4f32{0.f,            CHUNK_Y_LENGTH, CHUNK_Z_LENGTH }
-        };
-
-        for (const auto& planeEnum : checkFrustumPlanes) {
-            const CameraFrustumPlane& plane = this->planes[static_cast<std::size_t>(planeEnum)];
-
-            bool bOneIn = false;
-            for (const auto& point : checkPoints) {
-                if (IsPointInsideFrustumOfPlane(point, plane)) {
-                    bOneIn = true;
-                    break;
-                }
-            }
-            if (!bOneIn)
-                return false;
-        }
-
-        return true;
+        return this->ClassifyBox(chunkBaseXZAxis, chunkBaseXZAxis + Vec4f32{ CHUNK_X_LENGTH, CHUNK_Y_LENGTH, CHUNK_Z_LENGTH })
+            != FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE;
     }
 
     inline const CameraFrustumPlane& operator()(const CAMERA_FRUSTUM_PLANE& planeLocation) const noexcept {
@@ -124,7 +115,7 @@ public:
     inline void SetRotation(const Vec4f32& rotation) noexcept { this->m_rotation  = rotation; }
 
     inline Mat4x4f32     GetTransform() const noexcept { return this->m_transform; }
-    inline CameraFrustum GetFrustum()   const noexcept { return this->m_frustum;   }
+    inline const CameraFrustum& GetFrustum() const noexcept { return this->m_frustum; }
 
     void Update() noexcept;
 };
@@ -0,0 +1,101 @@
+#include "CaveCuller.hpp"
+
+static inline BLOCK_FACE GetOppositeFace(const BLOCK_FACE& face) noexcept {
+    switch (face) {
+    case BLOCK_FACE::BLOCK_FACE_TOP:    return BLOCK_FACE::BLOCK_FACE_BOTTOM;
+    case BLOCK_FACE::BLOCK_FACE_BOTTOM: return BLOCK_FACE::BLOCK_FACE_TOP;
+    case BLOCK_FACE::BLOCK_FACE_FRONT:  return BLOCK_FACE::BLOCK_FACE_BACK;
+    case BLOCK_FACE::BLOCK_FACE_BACK:   return BLOCK_FACE::BLOCK_FACE_FRONT;
+    case BLOCK_FACE::BLOCK_FACE_LEFT:   return BLOCK_FACE::BLOCK_FACE_RIGHT;
+    default:                            return BLOCK_FACE::BLOCK_FACE_LEFT;
+    }
+}
+
+void CaveCuller::Update(const Vec4f32& cameraPosition, const CameraFrustum& frustum, const SectionConnectivityLookup& getSectionConnectivity) noexcept {
+    this->m_reachedChunks.Clear();
+    this->m_queue.clear();
+    this->m_nVisibleChunks = 0u;
+
+    const ChunkCoord cameraChunk = {
+        static_cast<std::int16_t>(std::floor(cameraPosition.x / CHUNK_X_LENGTH)),
+        static_cast<std::int16_t>(std::floor(cameraPosition.z / CHUNK_Z_LENGTH))
+    };
+
+    const float cameraSection = std::floor(cameraPosition.y / (CHUNK_SECTION_Y_BLOCK_COUNT * BLOCK_LENGTH));
+    const ChunkSectionConnectivity* pCameraChunkConnectivity = getSectionConnectivity(cameraChunk);
+
+    this->m_bIsEnabled = cameraSection >= 0.f && cameraSection < static_cast<float>(CHUNK_SECTION_COUNT) && pCameraChunkConnectivity != nullptr;
+    if (!this->m_bIsEnabled)
+        return;
+
+    // the camera sees through every face of its own section
+    const std::uint8_t cameraSectionIndex = static_cast<std::uint8_t>(cameraSection);
+    this->m_reachedChunks.Insert(cameraChunk, ReachedChunk{ pCameraChunkConnectivity, static_cast<std::uint16_t>(1u << cameraSectionIndex) });
+    this->m_nVisibleChunks = 1u;
+
+    const auto VisitNeighbour = [this, &frustum, &getSectionConnectivity](const QueuedSection& from, const BLOCK_FACE& direction) {
+        QueuedSection to = from;
+        switch (direction) {
+        case BLOCK_FACE::BLOCK_FACE_TOP:    ++to.sectionIndex;  break;
+        case BLOCK_FACE::BLOCK_FACE_BOTTOM: --to.sectionIndex;  break;
+        case BLOCK_FACE::BLOCK_FACE_FRONT:  --to.location.idz;  break;
+        case BLOCK_FACE::BLOCK_FACE_BACK:   ++to.location.idz;  break;
+        case BLOCK_FACE::BLOCK_FACE_LEFT:   --to.location.idx;  break;
+        default:                            ++to.location.idx;  break;
+        }
+
+        // the section index wraps around below 0
+        if (to.sectionIndex >= CHUNK_SECTION_COUNT)
+            return;
+
+        ReachedChunk* pReachedChunk = this->m_reachedChunks.Find(to.location);
+        if (!pReachedChunk)
+            pReachedChunk = &this->m_reachedChunks.Insert(to.location, ReachedChunk{ getSectionConnectivity(to.location), 0u });
+
+        if (!pReachedChunk->pConnectivity || (pReachedChunk->sectionMask & (1u << to.sectionIndex)))
+            return;
+
+        const Vec4f32 sectionMin = {
+            static_cast<float>(to.location.idx) * CHUNK_X_LENGTH,
+            static_cast<float>(to.sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT) * BLOCK_LENGTH,
+            static_cast<float>(to.location.idz) * CHUNK_Z_LENGTH
+        };
+
+        if (frustum.ClassifyBox(sectionMin, sectionMin + Vec4f32{ CHUNK_X_LENGTH, CHUNK_SECTION_Y_BLOCK_COUNT * BLOCK_LENGTH, CHUNK_Z_LENGTH })
+            == FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE)
+            return;
+
+        if (pReachedChunk->sectionMask == 0u)
+            ++this->m_nVisibleChunks;
+
+        pReachedChunk->sectionMask |= static_cast<std::uint16_t>(1u << to.sectionIndex);
+
+        to.entryFace   = GetOppositeFace(direction);
+        to.directions |= static_cast<std::uint8_t>(1u << static_cast<size_t>(direction));
+        this->m_queue.push_back(to);
+    };
+
+    const QueuedSection cameraQueuedSection = { cameraChunk, cameraSectionIndex, BLOCK_FACE::BLOCK_FACE_TOP, 0u };
+    for (size_t face = 0u; face < static_cast<size_t>(BLOCK_FACE::_COUNT); ++face)
+        VisitNeighbour(cameraQueuedSection, static_cast<BLOCK_FACE>(face));
+
+    for (size_t queueIndex = 0u; queueIndex < this->m_queue.size(); ++queueIndex) {
+        // VisitNeighbour may reallocate the queue
+        const QueuedSection section = this->m_queue[queueIndex];
+
+        const SectionConnectivity connectivity = (*this->m_reachedChunks.Find(section.location)->pConnectivity)[section.sectionIndex];
+
+        for (size_t face = 0u; face < static_cast<size_t>(BLOCK_FACE::_COUNT); ++face) {
+            const BLOCK_FACE direction = static_cast<BLOCK_FACE>(face);
+
+            // the entry face is the opposite of the last direction
+            if (section.directions & (1u << static_cast<size_t>(GetOppositeFace(direction))))
+                continue;
+
+            if (!connectivity.AreFacesConnected(section.entryFace, direction))
+                continue;
+
+            VisitNeighbour(section, direction);
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef __MINECRAFT__CAVE_CULLER_HPP
+#define __MINECRAFT__CAVE_CULLER_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "ChunkGrid.hpp"
+#include "Camera.hpp"
+#include "Vector.hpp"
+
+// Finds the chunk sections that can be seen from the camera's section through the non-opaque blocks of the sections in between.
+// The search goes from section to section, entering each one by a face and leaving by the faces connected to it (see SectionConnectivity),
+// and never goes back in a direction opposite to one it already took, so that it only reaches the sections a line of sight could.
+// Every section is entered at most once, by the first path that reaches it, and sections outside of the frustum aren't entered at all.
+class CaveCuller {
+public:
+    // nullptr when the chunk isn't rendered, the search doesn't go through such chunks
+    using SectionConnectivityLookup = std::function<const ChunkSectionConnectivity*(const ChunkCoord&)>;
+
+private:
+    struct QueuedSection {
+        ChunkCoord   location;
+        std::uint8_t sectionIndex;
+        BLOCK_FACE   entryFace;
+        std::uint8_t directions; // one bit per BLOCK_FACE the search moved toward so far
+    }; // struct QueuedSection
+
+    struct ReachedChunk {
+        const ChunkSectionConnectivity* pConnectivity = nullptr;
+        std::uint16_t                   sectionMask   = 0u; // one bit per section reached
+    }; // struct ReachedChunk
+
+    // Also holds the chunks the search looked up without reaching any of their sections
+    FlatChunkCoordMap<ReachedChunk> m_reachedChunks;
+    size_t                          m_nVisibleChunks = 0u;
+
+    std::vector<QueuedSection> m_queue;
+
+    // False when the camera's chunk isn't rendered or the camera is outside of the world's height, everything is visible then
+    bool m_bIsEnabled = false;
+
+public:
+    inline CaveCuller() noexcept = default;
+
+    void Update(const Vec4f32& cameraPosition, const CameraFrustum& frustum, const SectionConnectivityLookup& getSectionConnectivity) noexcept;
+
+    // Bit i is set when the chunk's i-th section was reached by the last Update
+    inline std::uint16_t GetVisibleSectionMask(const ChunkCoord& location) const noexcept {
+        if (!this->m_bIsEnabled)
+            return static_cast<std::uint16_t>((1u << CHUNK_SECTION_COUNT) - 1u);
+
+        const ReachedChunk* pReachedChunk = this->m_reachedChunks.Find(location);
+        return pReachedChunk ? pReachedChunk->sectionMask : 0u;
+    }
+
+    inline bool IsChunkVisible(const ChunkCoord& location) const noexcept { return this->GetVisibleSectionMask(location) != 0u; }
+
+    inline bool IsEnabled() const noexcept { return this->m_bIsEnabled; }
+
+    inline size_t GetVisibleChunkCount() const noexcept { return this->m_nVisibleChunks; }
+}; // class CaveCuller
+
+#endif // __MINECRAFT__CAVE_CULLER_HPP
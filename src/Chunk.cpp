@@ -1,137 +1,1077 @@
 #include "Chunk.hpp"
 
-void Chunk::GenerateDefaultTerrain(const siv::PerlinNoise &noise) noexcept {
-    std::memset(this->m_blocks.data(), (int)BLOCK_TYPE::BLOCK_TYPE_AIR, this->m_blocks.size() * sizeof(BLOCK_TYPE));
+ChunkHeightMap ComputeDefaultHeightMap(const ChunkCoord& cc, const siv::PerlinNoise& noise) noexcept {
+    ChunkHeightMap heightMap;
 
     for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
         for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
-            const size_t yMax = static_cast<size_t>(noise.normalizedOctaveNoise2D_0_1((this->m_location.idx * CHUNK_X_BLOCK_COUNT + (std::int16_t)x) / 50.f,
-                                                                                      (this->m_location.idz * CHUNK_X_BLOCK_COUNT + (std::int16_t)z) / 50.f, 3) * CHUNK_Y_BLOCK_COUNT / 2u);
-
-            for (size_t y = 0u; y <= yMax; ++y) {
-                if (y == yMax) {
-                    if (y > CHUNK_Y_BLOCK_COUNT / 5)
-                        this->m_blocks[x][y][z] = BLOCK_TYPE::BLOCK_TYPE_GRASS;
-                    else
-                        this->m_blocks[x][y][z] = BLOCK_TYPE::BLOCK_TYPE_SAND;
-                } else if (y > yMax - 2)
-                    this->m_blocks[x][y][z] = BLOCK_TYPE::BLOCK_TYPE_DIRT;
+            heightMap[x * CHUNK_Z_BLOCK_COUNT + z] = static_cast<std::uint8_t>(noise.normalizedOctaveNoise2D_0_1((cc.idx * CHUNK_X_BLOCK_COUNT + (std::int16_t)x) / 50.f,
+                                                                                                                (cc.idz * CHUNK_X_BLOCK_COUNT + (std::int16_t)z) / 50.f, 3) * CHUNK_Y_BLOCK_COUNT / 2u);
+        }
+    }
+
+    return heightMap;
+}
+
+ChunkHeightMap ComputeDefaultHeightMap(const ChunkCoord& cc, const BatchedPerlinNoise& noise) noexcept {
+    PROFILE_SCOPE("ComputeDefaultHeightMap");
+
+    std::array<float, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT> noiseValues;
+    noise.NormalizedOctaveNoise2D_0_1(cc.idx * CHUNK_X_BLOCK_COUNT, cc.idz * CHUNK_Z_BLOCK_COUNT, CHUNK_X_BLOCK_COUNT, CHUNK_Z_BLOCK_COUNT, 50.f, 3, noiseValues.data());
+
+    ChunkHeightMap heightMap;
+    for (size_t i = 0u; i < heightMap.size(); ++i)
+        heightMap[i] = static_cast<std::uint8_t>(noiseValues[i] * CHUNK_Y_BLOCK_COUNT / 2u);
+
+    return heightMap;
+}
+
+void Chunk::FillColumn(const size_t idx, const size_t idz, const size_t idyBegin, const size_t idyEnd, const BLOCK_TYPE& type) noexcept {
+    if (idx >= CHUNK_X_BLOCK_COUNT || idz >= CHUNK_Z_BLOCK_COUNT)
+        return;
+
+    const size_t end = std::min(idyEnd, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT));
+
+    size_t idy = idyBegin;
+    while (idy < end) {
+        const size_t sectionIndex = idy / CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t runEnd       = std::min(end, (sectionIndex + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT);
+
+        std::unique_ptr<ChunkSection>& pSection = this->m_pSections[sectionIndex];
+
+        if (!pSection && type != BLOCK_TYPE::BLOCK_TYPE_AIR)
+            pSection = std::make_unique<ChunkSection>();
+
+        if (pSection) {
+            pSection->FillRun(ChunkSection::GetBlockIndex(idx, idy % CHUNK_SECTION_Y_BLOCK_COUNT, idz), runEnd - idy, type);
+
+            if (pSection->IsEmpty())
+                pSection.reset();
+        }
+
+        idy = runEnd;
+    }
+
+    this->MarkBlocksChanged(idyBegin, end);
+    this->m_bIsDirty = true;
+}
+
+void Chunk::GenerateDefaultTerrain(const ChunkHeightMap& heightMap) noexcept {
+    PROFILE_SCOPE("GenerateDefaultTerrain");
+
+    for (std::unique_ptr<ChunkSection>& pSection : this->m_pSections)
+        pSection.reset();
+
+    this->MarkAllSectionsDirty();
+
+    // every column is stone up to two blocks below its surface (except the lowest ones)
+    const auto GetStoneEnd = [](const size_t yMax) { return yMax >= 2u ? yMax - 1u : yMax; };
+
+    // sections under the lowest stone run are all stone and don't need a palette
+    size_t stoneEnd = static_cast<size_t>(CHUNK_Y_BLOCK_COUNT);
+    for (const std::uint8_t yMax : heightMap)
+        stoneEnd = std::min(stoneEnd, GetStoneEnd(yMax));
+
+    const size_t nStoneSections = stoneEnd / CHUNK_SECTION_Y_BLOCK_COUNT;
+    for (size_t sectionIndex = 0u; sectionIndex < nStoneSections; ++sectionIndex)
+        this->m_pSections[sectionIndex] = std::make_unique<ChunkSection>(BLOCK_TYPE::BLOCK_TYPE_STONE);
+
+    const size_t yBegin = nStoneSections * CHUNK_SECTION_Y_BLOCK_COUNT;
+
+    for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+        for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+            const size_t yMax = heightMap[x * CHUNK_Z_BLOCK_COUNT + z];
+
+            this->FillColumn(x, z, yBegin,                              GetStoneEnd(yMax), BLOCK_TYPE::BLOCK_TYPE_STONE);
+            this->FillColumn(x, z, std::max(yBegin, GetStoneEnd(yMax)), yMax,              BLOCK_TYPE::BLOCK_TYPE_DIRT);
+            this->FillColumn(x, z, yMax, yMax + 1u, yMax > SEA_LEVEL ? BLOCK_TYPE::BLOCK_TYPE_GRASS : BLOCK_TYPE::BLOCK_TYPE_SAND);
+
+            // the columns below the sea are flooded up to it
+            this->FillColumn(x, z, yMax + 1u, SEA_LEVEL + 1u, BLOCK_TYPE::BLOCK_TYPE_WATER);
+        }
+    }
+
+    this->m_bIsGenerated = true;
+    this->m_bIsDirty     = true;
+}
+
+// Layout: a 16 bits mask of the allocated sections, then for each of them its number of runs (16 bits)
+// and the runs themselves, a block type (8 bits) and a length (16 bits), in block index order
+std::vector<std::uint8_t> Chunk::Serialize() const noexcept {
+    static_assert(CHUNK_SECTION_COUNT <= 16, "The section mask is 16 bits wide");
+
+    if (this->m_bIsCompressed)
+        return this->m_compressedBlocks;
+
+    std::vector<std::uint8_t> data;
+
+    const auto Write16 = [&data](const std::uint16_t value) {
+        data.push_back(static_cast<std::uint8_t>(value & 0xFFu));
+        data.push_back(static_cast<std::uint8_t>(value >> 8u));
+    };
+
+    std::uint16_t sectionMask = 0u;
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+        if (this->m_pSections[sectionIndex])
+            sectionMask |= static_cast<std::uint16_t>(1u << sectionIndex);
+
+    Write16(sectionMask);
+
+    std::vector<std::pair<BLOCK_TYPE, std::uint16_t>> runs;
+    for (const std::unique_ptr<ChunkSection>& pSection : this->m_pSections) {
+        if (!pSection)
+            continue;
+
+        runs.clear();
+
+        if (pSection->IsUniform()) {
+            runs.emplace_back(pSection->GetBlock(0u), static_cast<std::uint16_t>(CHUNK_SECTION_BLOCK_COUNT));
+        } else {
+            for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex) {
+                const BLOCK_TYPE type = pSection->GetBlock(blockIndex);
+
+                if (!runs.empty() && runs.back().first == type)
+                    ++runs.back().second;
                 else
-                    this->m_blocks[x][y][z] = BLOCK_TYPE::BLOCK_TYPE_STONE;
+                    runs.emplace_back(type, 1u);
+            }
+        }
+
+        Write16(static_cast<std::uint16_t>(runs.size()));
+        for (const auto& [type, length] : runs) {
+            data.push_back(static_cast<std::uint8_t>(type));
+            Write16(length);
+        }
+    }
+
+    return data;
+}
+
+bool Chunk::Deserialize(const std::uint8_t* pData, const size_t size) noexcept {
+    for (std::unique_ptr<ChunkSection>& pSection : this->m_pSections)
+        pSection.reset();
+
+    this->m_bIsCompressed = false;
+    this->m_compressedBlocks.clear();
+    this->m_compressedBlocks.shrink_to_fit();
+
+    this->m_bIsGenerated = false;
+    this->m_bIsDirty     = false;
+
+    this->MarkAllSectionsDirty();
+
+    size_t offset = 0u;
+
+    const auto Read16 = [pData, size, &offset](std::uint16_t& value) {
+        if (offset + 2u > size)
+            return false;
+
+        value   = static_cast<std::uint16_t>(pData[offset] | (pData[offset + 1u] << 8u));
+        offset += 2u;
+        return true;
+    };
+
+    const auto Fail = [this]() {
+        for (std::unique_ptr<ChunkSection>& pSection : this->m_pSections)
+            pSection.reset();
+
+        return false;
+    };
+
+    std::uint16_t sectionMask;
+    if (!Read16(sectionMask))
+        return Fail();
+
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        if ((sectionMask & (1u << sectionIndex)) == 0u)
+            continue;
+
+        std::uint16_t nRuns;
+        if (!Read16(nRuns))
+            return Fail();
+
+        // uniform sections don't need to be unpacked
+        if (nRuns == 1u && offset + 3u <= size && pData[offset] < static_cast<std::uint8_t>(BLOCK_TYPE::_COUNT)
+                        && (pData[offset + 1u] | (pData[offset + 2u] << 8u)) == CHUNK_SECTION_BLOCK_COUNT) {
+            const BLOCK_TYPE type = static_cast<BLOCK_TYPE>(pData[offset]);
+            offset += 3u;
+
+            if (type != BLOCK_TYPE::BLOCK_TYPE_AIR)
+                this->m_pSections[sectionIndex] = std::make_unique<ChunkSection>(type);
+
+            continue;
+        }
+
+        std::array<BLOCK_TYPE, CHUNK_SECTION_BLOCK_COUNT> blocks;
+
+        size_t blockIndex = 0u;
+        for (std::uint16_t run = 0u; run < nRuns; ++run) {
+            if (offset + 1u > size || pData[offset] >= static_cast<std::uint8_t>(BLOCK_TYPE::_COUNT))
+                return Fail();
+
+            const BLOCK_TYPE type = static_cast<BLOCK_TYPE>(pData[offset++]);
+
+            std::uint16_t length;
+            if (!Read16(length) || blockIndex + length > CHUNK_SECTION_BLOCK_COUNT)
+                return Fail();
+
+            std::fill_n(blocks.begin() + blockIndex, length, type);
+            blockIndex += length;
+        }
+
+        if (blockIndex != CHUNK_SECTION_BLOCK_COUNT)
+            return Fail();
+
+        std::unique_ptr<ChunkSection> pSection = std::make_unique<ChunkSection>();
+        pSection->Assign(blocks);
+
+        if (!pSection->IsEmpty())
+            this->m_pSections[sectionIndex] = std::move(pSection);
+    }
+
+    this->m_bIsGenerated = true;
+
+    return true;
+}
+
+void Chunk::Compress() noexcept {
+    if (this->m_bIsCompressed || !this->m_bIsGenerated)
+        return;
+
+    this->m_compressedBlocks = this->Serialize();
+    this->m_compressedBlocks.shrink_to_fit();
+    this->m_bIsCompressed = true;
+
+    for (std::unique_ptr<ChunkSection>& pSection : this->m_pSections)
+        pSection.reset();
+}
+
+void Chunk::Decompress() noexcept {
+    if (!this->m_bIsCompressed)
+        return;
+
+    // Deserialize clears the compressed blocks and the dirty flag
+    const std::vector<std::uint8_t> compressedBlocks = std::move(this->m_compressedBlocks);
+    const bool bIsDirty = this->m_bIsDirty;
+
+    this->Deserialize(compressedBlocks.data(), compressedBlocks.size());
+    this->m_bIsDirty = bIsDirty;
+}
+
+ChunkColumnHeights Chunk::ComputeColumnHeights() const noexcept {
+    ChunkColumnHeights heights;
+    heights.solid.fill(0u);
+    heights.top = 0u;
+
+    // the columns of uniform opaque sections are all solid, the others are walked up to their first gap
+    std::array<bool, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT> bIsColumnSolid;
+    bIsColumnSolid.fill(true);
+
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        const ChunkSection* pSection = this->m_pSections[sectionIndex].get();
+        if (!pSection)
+            break;
+
+        const size_t yBegin = sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t yEnd   = std::min(yBegin + CHUNK_SECTION_Y_BLOCK_COUNT, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT));
+
+        const bool bIsUniformlyOpaque = pSection->IsUniform() && IsBlockOpaque(pSection->GetBlock(0u));
+
+        bool bHasSolidColumn = false;
+        for (size_t column = 0u; column < heights.solid.size(); ++column) {
+            if (!bIsColumnSolid[column])
+                continue;
+
+            size_t y = yBegin;
+            if (bIsUniformlyOpaque) {
+                y = yEnd;
+            } else {
+                const size_t x = column / CHUNK_Z_BLOCK_COUNT;
+                const size_t z = column % CHUNK_Z_BLOCK_COUNT;
+
+                while (y < yEnd && IsBlockOpaque(pSection->GetBlock(ChunkSection::GetBlockIndex(x, y - yBegin, z))))
+                    ++y;
             }
+
+            heights.solid[column] = static_cast<std::uint8_t>(y);
+            bIsColumnSolid[column] = y == yEnd;
+            bHasSolidColumn |= bIsColumnSolid[column];
         }
+
+        if (!bHasSolidColumn)
+            break;
+    }
+
+    for (size_t sectionIndex = CHUNK_SECTION_COUNT; sectionIndex-- > 0u; ) {
+        const ChunkSection* pSection = this->m_pSections[sectionIndex].get();
+        if (!pSection)
+            continue;
+
+        const size_t yBegin = sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t yEnd   = std::min(yBegin + CHUNK_SECTION_Y_BLOCK_COUNT, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT));
+
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x)
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z)
+                for (size_t y = yEnd; y > std::max<size_t>(yBegin, heights.top); --y)
+                    if (pSection->GetBlock(ChunkSection::GetBlockIndex(x, y - 1u - yBegin, z)) != BLOCK_TYPE::BLOCK_TYPE_AIR) {
+                        heights.top = static_cast<std::uint8_t>(y);
+                        break;
+                    }
+
+        break;
     }
+
+    return heights;
+}
+
+const ChunkSectionConnectivity& Chunk::UpdateSectionConnectivity() noexcept {
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        if ((this->m_dirtyConnectivitySections & (1u << sectionIndex)) == 0u)
+            continue;
+
+        const ChunkSection* pSection = this->m_pSections[sectionIndex].get();
+
+        this->m_sectionConnectivity[sectionIndex] = pSection ? pSection->ComputeConnectivity()
+                                                             : SectionConnectivity(SectionConnectivity::ALL_FACE_PAIRS);
+    }
+
+    this->m_dirtyConnectivitySections = 0u;
+
+    return this->m_sectionConnectivity;
+}
+
+// corner of a quad, in blocks and relative to the chunk's origin
+struct QuadCorner {
+    std::uint16_t x, y, z;
+}; // struct QuadCorner
+
+// in clockwise order with "a" in the top left position, "width" and "height" being the number of blocks covered along each side of the quad
+// quads are drawn through the shared quad index buffer (a, b, c) (a, c, e)
+// "light" is the vertices' light level, see FaceLightLevels
+static void AddQuad(std::vector<Vertex>& vertices, const QuadCorner& a, const QuadCorner& b, const QuadCorner& c, const QuadCorner& e, const std::uint16_t width, const std::uint16_t height,
+                    const BLOCK_TYPE& blockType, const BLOCK_FACE& blockFace, const std::uint8_t light, const std::size_t atlasTilesPerRow) noexcept {
+    const std::uint8_t tile = GetBlockFaceAtlasTile(blockType, blockFace, atlasTilesPerRow);
+
+    vertices.push_back(PackVertex(UnpackedVertex{a.x, a.y, a.z, blockFace, light, tile, 0u,    0u    }));
+    vertices.push_back(PackVertex(UnpackedVertex{b.x, b.y, b.z, blockFace, light, tile, width, 0u    }));
+    vertices.push_back(PackVertex(UnpackedVertex{c.x, c.y, c.z, blockFace, light, tile, width, height}));
+    vertices.push_back(PackVertex(UnpackedVertex{e.x, e.y, e.z, blockFace, light, tile, 0u,    height}));
 }
 
-void Chunk::GenerateDXMesh(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const std::size_t textureAtlasWidth, const std::size_t textureAtlasHeight) noexcept {
-    std::vector<Vertex> vertices(CHUNK_X_BLOCK_COUNT * CHUNK_Y_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT * 3u);
-    size_t nVertices = 0u;
+// GetBlockFaceLightLevel for every face and cell light level, computed once
+class FaceLightLevels {
+private:
+    std::array<std::array<std::uint8_t, MAX_LIGHT_LEVEL + 1>, static_cast<size_t>(BLOCK_FACE::_COUNT)> m_levels;
+
+    inline FaceLightLevels() noexcept {
+        for (size_t face = 0u; face < this->m_levels.size(); ++face)
+            for (size_t lightLevel = 0u; lightLevel <= MAX_LIGHT_LEVEL; ++lightLevel)
+                this->m_levels[face][lightLevel] = GetBlockFaceLightLevel(static_cast<BLOCK_FACE>(face), static_cast<std::uint8_t>(lightLevel));
+    }
+
+public:
+    static inline const FaceLightLevels& Get() noexcept {
+        static const FaceLightLevels levels;
+        return levels;
+    }
+
+    inline std::uint8_t operator()(const BLOCK_FACE& blockFace, const std::uint8_t lightLevel) const noexcept {
+        return this->m_levels[static_cast<size_t>(blockFace)][lightLevel];
+    }
+}; // class FaceLightLevels
+
+// The layers [begin, end) of the chunk covered by a section
+static inline size_t GetSectionYBegin(const size_t sectionIndex) noexcept { return sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT; }
+static inline size_t GetSectionYEnd  (const size_t sectionIndex) noexcept { return std::min((sectionIndex + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT)); }
+
+// The faces of a block in the order the naive meshers add them: the cell each one looks into, the face its texture and light
+// are for (the back face uses the front face's texture) and its corners, relative to the block's top left corner (x, y + 1, z)
+struct NaiveBlockFace {
+    std::array<int, 3u>                 neighbour;
+    BLOCK_FACE                          blockFace;
+    std::array<std::array<int, 3u>, 4u> corners;
+}; // struct NaiveBlockFace
+
+static constexpr std::array<NaiveBlockFace, 6u> NAIVE_BLOCK_FACES = {{
+    { {{  0,  0, -1 }}, BLOCK_FACE::BLOCK_FACE_FRONT,  {{ {{ 0,  0, 0 }}, {{ 1,  0, 0 }}, {{ 1, -1, 0 }}, {{ 0, -1, 0 }} }} }, // front
+    { {{  0,  0,  1 }}, BLOCK_FACE::BLOCK_FACE_FRONT,  {{ {{ 1,  0, 1 }}, {{ 0,  0, 1 }}, {{ 0, -1, 1 }}, {{ 1, -1, 1 }} }} }, // back
+    { {{ -1,  0,  0 }}, BLOCK_FACE::BLOCK_FACE_LEFT,   {{ {{ 0,  0, 1 }}, {{ 0,  0, 0 }}, {{ 0, -1, 0 }}, {{ 0, -1, 1 }} }} }, // left
+    { {{  1,  0,  0 }}, BLOCK_FACE::BLOCK_FACE_RIGHT,  {{ {{ 1,  0, 0 }}, {{ 1,  0, 1 }}, {{ 1, -1, 1 }}, {{ 1, -1, 0 }} }} }, // right
+    { {{  0,  1,  0 }}, BLOCK_FACE::BLOCK_FACE_TOP,    {{ {{ 0,  0, 1 }}, {{ 1,  0, 1 }}, {{ 1,  0, 0 }}, {{ 0,  0, 0 }} }} }, // top
+    { {{  0, -1,  0 }}, BLOCK_FACE::BLOCK_FACE_BOTTOM, {{ {{ 1, -1, 1 }}, {{ 0, -1, 1 }}, {{ 0, -1, 0 }}, {{ 1, -1, 0 }} }} }  // bottom
+}};
 
-    BLOCK_TYPE dummyAirBlock = BLOCK_TYPE::BLOCK_TYPE_AIR;
+// NAIVE_BLOCK_FACES[FACE] of the block (x, y, z), "lightLevel" is the one of the cell the face looks into
+template <size_t FACE>
+static inline void AddNaiveBlockFace(std::vector<Vertex>& vertices, const size_t x, const size_t y, const size_t z, const BLOCK_TYPE& blockType,
+                                     const std::uint8_t lightLevel, const FaceLightLevels& faceLightLevels, const std::size_t atlasTilesPerRow) noexcept {
+    constexpr NaiveBlockFace face = NAIVE_BLOCK_FACES[FACE];
 
-    const UV uvTextureSize = {
-        TEXTURE_SIDE_LENGTH / static_cast<float>(textureAtlasWidth),
-        TEXTURE_SIDE_LENGTH / static_cast<float>(textureAtlasHeight)
+    const auto Corner = [x, y, z](const std::array<int, 3u>& offset) {
+        return QuadCorner{
+            static_cast<std::uint16_t>(x + offset[0]),
+            static_cast<std::uint16_t>(y + 1 + offset[1]),
+            static_cast<std::uint16_t>(z + offset[2])
+        };
     };
 
+    AddQuad(vertices, Corner(face.corners[0]), Corner(face.corners[1]), Corner(face.corners[2]), Corner(face.corners[3]), 1u, 1u,
+            blockType, face.blockFace, faceLightLevels(face.blockFace, lightLevel), atlasTilesPerRow);
+}
+
+// Calls f(std::integral_constant<size_t, FACE>) for every face of NAIVE_BLOCK_FACES, in order
+template <typename F, size_t... FACES>
+static inline void ForEachNaiveBlockFace(F&& f, std::index_sequence<FACES...>) noexcept { (f(std::integral_constant<size_t, FACES>{}), ...); }
+
+template <typename F>
+static inline void ForEachNaiveBlockFace(F&& f) noexcept { ForEachNaiveBlockFace(std::forward<F>(f), std::make_index_sequence<NAIVE_BLOCK_FACES.size()>{}); }
+
+void Chunk::GenerateNaiveMesh(std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                              const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept {
+    const FaceLightLevels& faceLightLevels = FaceLightLevels::Get();
+
     for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
-        for (size_t y = 0u; y < CHUNK_Y_BLOCK_COUNT; ++y) {
+        for (size_t y = GetSectionYBegin(sectionIndex); y < GetSectionYEnd(sectionIndex); ++y) {
             for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
-                const BLOCK_TYPE& blockType = *this->GetBlock(x, y, z).value();
-
-                if (IsBlockOpaque(blockType)) {
-                    // top left corner point of the current block
-                    const Vec4f32 baseCornerPoint = {
-                        BLOCK_LENGTH * ((std::int16_t)x + this->m_location.idx * (std::int16_t)CHUNK_X_BLOCK_COUNT),
-                        (y + 1) * BLOCK_LENGTH,
-                        BLOCK_LENGTH * ((std::int16_t)z + this->m_location.idz * (std::int16_t)CHUNK_Z_BLOCK_COUNT),
-                        1.f
-                    };
-
-                    // in clockwise order with "a" in the top left position
-                    const auto AddFace = [&uvTextureSize, &nVertices, &blockType, &vertices, this](const Vec4f32 &a, const Vec4f32 &b, const Vec4f32 &c, const Vec4f32 &e, const BLOCK_FACE &blockFace) {
-                        const UV baseFaceUV = GetBlockFaceBaseUV(blockType, blockFace, uvTextureSize);
-                        const float faceLighting = GetBlockFaceLighting(blockFace);
-
-                        vertices[nVertices++] = Vertex{a, UV{baseFaceUV.u, baseFaceUV.v}, faceLighting};
-                        vertices[nVertices++] = Vertex{b, UV{baseFaceUV.u + uvTextureSize.u, baseFaceUV.v}, faceLighting};
-                        vertices[nVertices++] = Vertex{c, UV{baseFaceUV.u + uvTextureSize.u, baseFaceUV.v + uvTextureSize.v}, faceLighting};
-
-                        vertices[nVertices++] = Vertex{a, UV{baseFaceUV.u, baseFaceUV.v}, faceLighting};
-                        vertices[nVertices++] = Vertex{c, UV{baseFaceUV.u + uvTextureSize.u, baseFaceUV.v + uvTextureSize.v}, faceLighting};
-                        vertices[nVertices++] = Vertex{e, UV{baseFaceUV.u, baseFaceUV.v + uvTextureSize.v}, faceLighting};
-                    };
-
-                    // Front
-                    if (!IsBlockOpaque(*this->GetBlock(x, y, z - 1).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint,
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +0},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +0},
-                                baseCornerPoint + Vec4f32{+0.f, -BLOCK_LENGTH, +0}, BLOCK_FACE::BLOCK_FACE_FRONT);
-                    }
+                const BLOCK_TYPE blockType = blocks.GetBlock(x, y, z);
 
-                    // Back
-                    if (!IsBlockOpaque(*this->GetBlock(x, y, z + 1).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+0, +0, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+0.f, -BLOCK_LENGTH, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +BLOCK_LENGTH}, BLOCK_FACE::BLOCK_FACE_FRONT);
-                    }
+                const bool bIsOpaque = IsBlockOpaque(blockType);
+                if (!bIsOpaque && (!pTranslucentVertices || !IsBlockTranslucent(blockType)))
+                    continue;
 
-                    // Left
-                    if (!IsBlockOpaque(*this->GetBlock(x - 1, y, z).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint + Vec4f32{0, +0, +BLOCK_LENGTH},
-                                baseCornerPoint,
-                                baseCornerPoint + Vec4f32{0, -BLOCK_LENGTH, +0},
-                                baseCornerPoint + Vec4f32{0, -BLOCK_LENGTH, +BLOCK_LENGTH}, BLOCK_FACE::BLOCK_FACE_LEFT);
-                    }
+                std::vector<Vertex>& blockVertices = bIsOpaque ? vertices : *pTranslucentVertices;
 
-                    // Right
-                    if (!IsBlockOpaque(*this->GetBlock(x + 1, y, z).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +0},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +0}, BLOCK_FACE::BLOCK_FACE_RIGHT);
-                    }
+                ForEachNaiveBlockFace([&](const auto face) {
+                    constexpr std::array<int, 3u> offset = NAIVE_BLOCK_FACES[face].neighbour;
+                    const size_t nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
 
-                    // Top
-                    if (!IsBlockOpaque(*this->GetBlock(x, y + 1, z).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint + Vec4f32{+0, +0, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, +0, +0},
-                                baseCornerPoint, BLOCK_FACE::BLOCK_FACE_TOP);
-                    }
+                    // faces are hidden by opaque blocks, and the ones of translucent blocks by blocks of their own type too
+                    if (!blocks.IsOpaque(nx, ny, nz) && (bIsOpaque || blocks.GetBlock(nx, ny, nz) != blockType))
+                        AddNaiveBlockFace<face>(blockVertices, x, y, z, blockType, blocks.GetLightLevel(nx, ny, nz), faceLightLevels, atlasTilesPerRow);
+                });
+            }
+        }
+    }
+}
+
+// The index of the lowest set bit, "mask" isn't 0
+static inline size_t CountTrailingZeros(const std::uint32_t mask) noexcept {
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<size_t>(index);
+#else
+    return static_cast<size_t>(__builtin_ctz(mask));
+#endif // _MSC_VER
+}
+
+void Chunk::GenerateBitmaskMesh(std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                                const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept {
+    static_assert(CHUNK_SECTION_Y_BLOCK_COUNT + 2 <= 32, "A section's column and the blocks above and below it fit in 32 bits");
+    static_assert(CHUNK_Z_BLOCK_COUNT <= 32, "A row of blocks along z fits in 32 bits");
 
-                    // Bottom
-                    if (!IsBlockOpaque(*this->GetBlock(x, y - 1, z).value_or(&dummyAirBlock))) {
-                        AddFace(baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+0, -BLOCK_LENGTH, +BLOCK_LENGTH},
-                                baseCornerPoint + Vec4f32{+0, -BLOCK_LENGTH, +0},
-                                baseCornerPoint + Vec4f32{+BLOCK_LENGTH, -BLOCK_LENGTH, +0}, BLOCK_FACE::BLOCK_FACE_BOTTOM);
+    const FaceLightLevels& faceLightLevels = FaceLightLevels::Get();
+
+    const size_t        yBegin      = GetSectionYBegin(sectionIndex);
+    const size_t        yCount      = GetSectionYEnd(sectionIndex) - yBegin;
+    const std::uint32_t sectionBits = (std::uint32_t(1u) << yCount) - 1u;
+
+    // bit i of a column is the block yBegin - 1 + i, for the section's layers and the ones above and below it.
+    // Columns are indexed by (x + 1) * PaddedChunkBlocks::Z_BLOCK_COUNT + (z + 1), as the padded blocks are
+    constexpr size_t PADDED_COLUMN_COUNT = PaddedChunkBlocks::X_BLOCK_COUNT * PaddedChunkBlocks::Z_BLOCK_COUNT;
+    using Columns = std::array<std::uint32_t, PADDED_COLUMN_COUNT>;
+    Columns opaqueColumns, translucentColumns;
+
+    for (size_t paddedX = 0u; paddedX < PaddedChunkBlocks::X_BLOCK_COUNT; ++paddedX)
+        for (size_t paddedZ = 0u; paddedZ < PaddedChunkBlocks::Z_BLOCK_COUNT; ++paddedZ)
+            blocks.GetColumnMasks(paddedX - 1u, yBegin - 1u, paddedZ - 1u, yCount + 2u, opaqueColumns     [paddedX * PaddedChunkBlocks::Z_BLOCK_COUNT + paddedZ],
+                                                                                        translucentColumns[paddedX * PaddedChunkBlocks::Z_BLOCK_COUNT + paddedZ]);
+
+    const auto GetColumn = [](const Columns& columns, const size_t x, const size_t z) {
+        return columns[(x + 1u) * PaddedChunkBlocks::Z_BLOCK_COUNT + (z + 1u)];
+    };
+
+    // A translucent face is hidden by a block of its own type as well, so each translucent type gets columns of its own.
+    // Only the sections with translucent blocks pay for them
+    struct TranslucentTypeColumns {
+        Columns blocks;
+        Columns hiding; // the opaque blocks and the blocks of the type
+    };
+    std::vector<TranslucentTypeColumns> translucentTypeColumns;
+
+    if (pTranslucentVertices && std::any_of(translucentColumns.begin(), translucentColumns.end(), [](const std::uint32_t column) { return column != 0u; })) {
+        for (const BLOCK_TYPE type : blocks.GetTranslucentBlockTypes()) {
+            TranslucentTypeColumns& typeColumns = translucentTypeColumns.emplace_back();
+            for (size_t paddedX = 0u; paddedX < PaddedChunkBlocks::X_BLOCK_COUNT; ++paddedX) {
+                for (size_t paddedZ = 0u; paddedZ < PaddedChunkBlocks::Z_BLOCK_COUNT; ++paddedZ) {
+                    const size_t i = paddedX * PaddedChunkBlocks::Z_BLOCK_COUNT + paddedZ;
+                    typeColumns.blocks[i] = blocks.GetColumnTypeMask(paddedX - 1u, yBegin - 1u, paddedZ - 1u, yCount + 2u, type);
+                    typeColumns.hiding[i] = typeColumns.blocks[i] | opaqueColumns[i];
+                }
+            }
+        }
+    }
+
+    // the faces of one slice along x, one mask of the section's layers per column and NAIVE_BLOCK_FACES entry
+    using ColumnFaces = std::array<std::uint32_t, NAIVE_BLOCK_FACES.size()>;
+
+    std::array<ColumnFaces,   CHUNK_Z_BLOCK_COUNT>         opaqueFaces, translucentFaces;
+    std::array<std::uint32_t, CHUNK_SECTION_Y_BLOCK_COUNT> opaqueRows, translucentRows; // bit z is set when the block (x, yBegin + j, z) has a face
+
+    // The masks of the faces of the column (x, z) of "columns" that no block of "hidingColumns" hides, in the order of NAIVE_BLOCK_FACES,
+    // shifted down to the section's layers. They are or'ed into "faces", whose union is returned
+    const auto ComputeFaces = [&GetColumn, sectionBits](const Columns& columns, const Columns& hidingColumns, const size_t x, const size_t z, ColumnFaces& faces) {
+        const std::uint32_t blocks = (GetColumn(columns, x, z) >> 1u) & sectionBits;
+        const std::uint32_t hiding = GetColumn(hidingColumns, x, z);
+
+        faces[0] |= blocks & ~(GetColumn(hidingColumns, x, z - 1u) >> 1u);
+        faces[1] |= blocks & ~(GetColumn(hidingColumns, x, z + 1u) >> 1u);
+        faces[2] |= blocks & ~(GetColumn(hidingColumns, x - 1u, z) >> 1u);
+        faces[3] |= blocks & ~(GetColumn(hidingColumns, x + 1u, z) >> 1u);
+        faces[4] |= blocks & ~(hiding >> 2u);
+        faces[5] |= blocks & ~hiding;
+
+        return faces[0] | faces[1] | faces[2] | faces[3] | faces[4] | faces[5];
+    };
+
+    // transposed so that the faces are added in the same order as GenerateNaiveMesh does: x, then y, then z
+    const auto AddToRows = [](std::uint32_t columnFaces, const size_t z, std::array<std::uint32_t, CHUNK_SECTION_Y_BLOCK_COUNT>& rows) {
+        for (; columnFaces != 0u; columnFaces &= columnFaces - 1u)
+            rows[CountTrailingZeros(columnFaces)] |= std::uint32_t(1u) << z;
+    };
+
+    for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+        opaqueRows.fill(0u);
+        translucentRows.fill(0u);
+
+        for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+            opaqueFaces[z].fill(0u);
+            AddToRows(ComputeFaces(opaqueColumns, opaqueColumns, x, z, opaqueFaces[z]), z, opaqueRows);
+
+            translucentFaces[z].fill(0u);
+            for (const TranslucentTypeColumns& typeColumns : translucentTypeColumns)
+                AddToRows(ComputeFaces(typeColumns.blocks, typeColumns.hiding, x, z, translucentFaces[z]), z, translucentRows);
+        }
+
+        for (size_t j = 0u; j < yCount; ++j) {
+            const size_t y = yBegin + j;
+
+            for (std::uint32_t row = opaqueRows[j]; row != 0u; row &= row - 1u) {
+                const size_t     z         = CountTrailingZeros(row);
+                const BLOCK_TYPE blockType = blocks.GetBlock(x, y, z);
+
+                ForEachNaiveBlockFace([&](const auto face) {
+                    constexpr std::array<int, 3u> offset = NAIVE_BLOCK_FACES[face].neighbour;
+
+                    if ((opaqueFaces[z][face] >> j) & 1u)
+                        AddNaiveBlockFace<face>(vertices, x, y, z, blockType, blocks.GetLightLevel(x + offset[0], y + offset[1], z + offset[2]), faceLightLevels, atlasTilesPerRow);
+                });
+            }
+
+            for (std::uint32_t row = translucentRows[j]; row != 0u; row &= row - 1u) {
+                const size_t     z         = CountTrailingZeros(row);
+                const BLOCK_TYPE blockType = blocks.GetBlock(x, y, z);
+
+                ForEachNaiveBlockFace([&](const auto face) {
+                    constexpr std::array<int, 3u> offset = NAIVE_BLOCK_FACES[face].neighbour;
+
+                    if ((translucentFaces[z][face] >> j) & 1u)
+                        AddNaiveBlockFace<face>(*pTranslucentVertices, x, y, z, blockType, blocks.GetLightLevel(x + offset[0], y + offset[1], z + offset[2]), faceLightLevels, atlasTilesPerRow);
+                });
+            }
+        }
+    }
+}
+
+// A visible face as the greedy mesher merges them: faces only merge with faces of the same type and vertex light.
+// Packed in 16 bits so that comparing two is a single compare, 0 (air) when there is no face
+using GreedyFace = std::uint16_t;
+
+static inline GreedyFace MakeGreedyFace(const BLOCK_TYPE& type, const std::uint8_t light) noexcept {
+    return static_cast<GreedyFace>(static_cast<std::uint16_t>(type) | (light << 8u));
+}
+
+static inline BLOCK_TYPE   GetGreedyFaceType (const GreedyFace face) noexcept { return static_cast<BLOCK_TYPE>(face & 0xFFu); }
+static inline std::uint8_t GetGreedyFaceLight(const GreedyFace face) noexcept { return static_cast<std::uint8_t>(face >> 8u); }
+
+// Greedy meshing of the cells [0, xCount) x [yBegin, yEnd) x [0, zCount) of "blocks", which only has to provide
+// GetBlock, IsOpaque (and IsTranslucent for "bTranslucent") and GetLightLevel for these cells and the ones around them.
+// Quads are scaled by the number of blocks along a cell's side. Only the faces of opaque blocks are meshed, or of translucent ones for "bTranslucent"
+template <bool bTranslucent, typename Blocks>
+static void GenerateGreedyQuads(std::vector<Vertex>& vertices, const Blocks& blocks, const size_t xCount, const size_t yBegin, const size_t yEnd, const size_t zCount,
+                                const std::uint16_t scale, const std::size_t atlasTilesPerRow) noexcept {
+    const FaceLightLevels& faceLightLevels = FaceLightLevels::Get();
+
+    // the face of the cell (x, y, z) that looks into the cell (nx, ny, nz), if it is visible
+    const auto GetFace = [&blocks, &faceLightLevels](const size_t x, const size_t y, const size_t z, const size_t nx, const size_t ny, const size_t nz, const BLOCK_FACE& blockFace) {
+        if constexpr (bTranslucent) {
+            if (!blocks.IsTranslucent(x, y, z) || blocks.IsOpaque(nx, ny, nz) || blocks.GetBlock(nx, ny, nz) == blocks.GetBlock(x, y, z))
+                return GreedyFace{ 0u };
+        } else {
+            if (!blocks.IsOpaque(x, y, z) || blocks.IsOpaque(nx, ny, nz))
+                return GreedyFace{ 0u };
+        }
+
+        return MakeGreedyFace(blocks.GetBlock(x, y, z), faceLightLevels(blockFace, blocks.GetLightLevel(nx, ny, nz)));
+    };
+
+    // For every slice, "mask" holds the visible faces of the slice, in rows of "width" faces
+    std::vector<GreedyFace> mask(CHUNK_SECTION_Y_BLOCK_COUNT * std::max(CHUNK_X_BLOCK_COUNT, CHUNK_Z_BLOCK_COUNT));
+
+    // Merges the faces of the mask into rectangles as wide as possible first, then as tall as possible.
+    // Quads are given to "EmitQuad" in blocks, along with their size in blocks
+    const auto MergeMask = [&mask, scale](const size_t width, const size_t height, const auto& EmitQuad) {
+        for (size_t j = 0u; j < height; ++j) {
+            for (size_t i = 0u; i < width; ) {
+                const GreedyFace face = mask[j * width + i];
+
+                if (face == 0u) {
+                    ++i;
+                    continue;
+                }
+
+                size_t w = 1u;
+                while (i + w < width && mask[j * width + i + w] == face)
+                    ++w;
+
+                size_t h = 1u;
+                for (; j + h < height; ++h) {
+                    bool bIsRowMergeable = true;
+                    for (size_t k = 0u; k < w && bIsRowMergeable; ++k)
+                        bIsRowMergeable = mask[(j + h) * width + i + k] == face;
+
+                    if (!bIsRowMergeable)
+                        break;
+                }
+
+                for (size_t dj = 0u; dj < h; ++dj)
+                    std::fill_n(mask.begin() + (j + dj) * width + i, w, GreedyFace{ 0u });
+
+                EmitQuad(static_cast<std::uint16_t>(i * scale), static_cast<std::uint16_t>(j * scale),
+                         static_cast<std::uint16_t>(w * scale), static_cast<std::uint16_t>(h * scale), face);
+                i += w;
+            }
+        }
+    };
+
+    const std::uint16_t blockYBegin = static_cast<std::uint16_t>(yBegin * scale);
+
+    // Top & Bottom: slices along y, faces indexed by (x, z)
+    for (size_t y = yBegin; y < yEnd; ++y) {
+        for (const BLOCK_FACE blockFace : { BLOCK_FACE::BLOCK_FACE_TOP, BLOCK_FACE::BLOCK_FACE_BOTTOM }) {
+            const size_t neighbourY = blockFace == BLOCK_FACE::BLOCK_FACE_TOP ? y + 1u : y - 1u;
+
+            for (size_t z = 0u; z < zCount; ++z)
+                for (size_t x = 0u; x < xCount; ++x)
+                    mask[z * xCount + x] = GetFace(x, y, z, x, neighbourY, z, blockFace);
+
+            const std::uint16_t planeY = static_cast<std::uint16_t>((blockFace == BLOCK_FACE::BLOCK_FACE_TOP ? y + 1u : y) * scale);
+
+            MergeMask(xCount, zCount, [&](const std::uint16_t i, const std::uint16_t j, const std::uint16_t w, const std::uint16_t h, const GreedyFace face) {
+                const std::uint16_t x0 = i, x1 = i + w;
+                const std::uint16_t z0 = j, z1 = j + h;
+
+                if (blockFace == BLOCK_FACE::BLOCK_FACE_TOP)
+                    AddQuad(vertices, {x0, planeY, z1}, {x1, planeY, z1}, {x1, planeY, z0}, {x0, planeY, z0}, w, h, GetGreedyFaceType(face), blockFace, GetGreedyFaceLight(face), atlasTilesPerRow);
+                else
+                    AddQuad(vertices, {x1, planeY, z1}, {x0, planeY, z1}, {x0, planeY, z0}, {x1, planeY, z0}, w, h, GetGreedyFaceType(face), blockFace, GetGreedyFaceLight(face), atlasTilesPerRow);
+            });
+        }
+    }
+
+    // Front & Back: slices along z, faces indexed by (x, y - yBegin)
+    for (size_t z = 0u; z < zCount; ++z) {
+        for (const bool bIsFront : { true, false }) {
+            const size_t neighbourZ = bIsFront ? z - 1u : z + 1u;
+
+            for (size_t y = yBegin; y < yEnd; ++y)
+                for (size_t x = 0u; x < xCount; ++x)
+                    mask[(y - yBegin) * xCount + x] = GetFace(x, y, z, x, y, neighbourZ, BLOCK_FACE::BLOCK_FACE_FRONT);
+
+            const std::uint16_t planeZ = static_cast<std::uint16_t>((bIsFront ? z : z + 1u) * scale);
+
+            MergeMask(xCount, yEnd - yBegin, [&](const std::uint16_t i, const std::uint16_t j, const std::uint16_t w, const std::uint16_t h, const GreedyFace face) {
+                const std::uint16_t x0 = i, x1 = i + w;
+                const std::uint16_t y0 = static_cast<std::uint16_t>(blockYBegin + j), y1 = static_cast<std::uint16_t>(blockYBegin + j + h);
+
+                // the back face uses the front face's texture, like the naive mesher does
+                if (bIsFront)
+                    AddQuad(vertices, {x0, y1, planeZ}, {x1, y1, planeZ}, {x1, y0, planeZ}, {x0, y0, planeZ}, w, h, GetGreedyFaceType(face), BLOCK_FACE::BLOCK_FACE_FRONT, GetGreedyFaceLight(face), atlasTilesPerRow);
+                else
+                    AddQuad(vertices, {x1, y1, planeZ}, {x0, y1, planeZ}, {x0, y0, planeZ}, {x1, y0, planeZ}, w, h, GetGreedyFaceType(face), BLOCK_FACE::BLOCK_FACE_FRONT, GetGreedyFaceLight(face), atlasTilesPerRow);
+            });
+        }
+    }
+
+    // Left & Right: slices along x, faces indexed by (z, y - yBegin)
+    for (size_t x = 0u; x < xCount; ++x) {
+        for (const BLOCK_FACE blockFace : { BLOCK_FACE::BLOCK_FACE_LEFT, BLOCK_FACE::BLOCK_FACE_RIGHT }) {
+            const size_t neighbourX = blockFace == BLOCK_FACE::BLOCK_FACE_LEFT ? x - 1u : x + 1u;
+
+            for (size_t y = yBegin; y < yEnd; ++y)
+                for (size_t z = 0u; z < zCount; ++z)
+                    mask[(y - yBegin) * zCount + z] = GetFace(x, y, z, neighbourX, y, z, blockFace);
+
+            const std::uint16_t planeX = static_cast<std::uint16_t>((blockFace == BLOCK_FACE::BLOCK_FACE_LEFT ? x : x + 1u) * scale);
+
+            MergeMask(zCount, yEnd - yBegin, [&](const std::uint16_t i, const std::uint16_t j, const std::uint16_t w, const std::uint16_t h, const GreedyFace face) {
+                const std::uint16_t z0 = i, z1 = i + w;
+                const std::uint16_t y0 = static_cast<std::uint16_t>(blockYBegin + j), y1 = static_cast<std::uint16_t>(blockYBegin + j + h);
+
+                if (blockFace == BLOCK_FACE::BLOCK_FACE_LEFT)
+                    AddQuad(vertices, {planeX, y1, z1}, {planeX, y1, z0}, {planeX, y0, z0}, {planeX, y0, z1}, w, h, GetGreedyFaceType(face), blockFace, GetGreedyFaceLight(face), atlasTilesPerRow);
+                else
+                    AddQuad(vertices, {planeX, y1, z0}, {planeX, y1, z1}, {planeX, y0, z1}, {planeX, y0, z0}, w, h, GetGreedyFaceType(face), blockFace, GetGreedyFaceLight(face), atlasTilesPerRow);
+            });
+        }
+    }
+}
+
+void Chunk::GenerateGreedyMesh(std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                               const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept {
+    // quads are merged inside of the section only, so that it can be rebuilt on its own
+    GenerateGreedyQuads<false>(vertices, blocks, CHUNK_X_BLOCK_COUNT, GetSectionYBegin(sectionIndex), GetSectionYEnd(sectionIndex), CHUNK_Z_BLOCK_COUNT, 1u, atlasTilesPerRow);
+
+    if (pTranslucentVertices)
+        GenerateGreedyQuads<true>(*pTranslucentVertices, blocks, CHUNK_X_BLOCK_COUNT, GetSectionYBegin(sectionIndex), GetSectionYEnd(sectionIndex), CHUNK_Z_BLOCK_COUNT, 1u, atlasTilesPerRow);
+}
+
+// A section downsampled to the cells of a LOD, surrounded by one layer of cells like PaddedChunkBlocks.
+// x and z are relative to the chunk, y is in cells from the bottom of the chunk
+class LodSectionCells {
+private:
+    static constexpr size_t MAX_SIDE_CELL_COUNT = CHUNK_SECTION_Y_BLOCK_COUNT / 2u + 2u;
+
+    size_t m_sideCellCount; // including the padding
+    size_t m_yBegin;
+
+    std::array<BLOCK_TYPE, MAX_SIDE_CELL_COUNT * MAX_SIDE_CELL_COUNT * MAX_SIDE_CELL_COUNT> m_cells;
+
+    inline size_t GetIndex(const size_t x, const size_t y, const size_t z) const noexcept {
+        return ((x + 1u) * this->m_sideCellCount + (z + 1u)) * this->m_sideCellCount + (y - this->m_yBegin + 1u);
+    }
+
+public:
+    LodSectionCells(const PaddedChunkBlocks& blocks, const size_t sectionIndex, const size_t scale) noexcept;
+
+    inline size_t GetYBegin() const noexcept { return this->m_yBegin; }
+    inline size_t GetYEnd()   const noexcept { return this->m_yBegin + this->m_sideCellCount - 2u; }
+
+    inline BLOCK_TYPE GetBlock(const size_t x, const size_t y, const size_t z) const noexcept { return this->m_cells[this->GetIndex(x, y, z)]; }
+
+    // cells only hold air or opaque types
+    inline bool IsOpaque(const size_t x, const size_t y, const size_t z) const noexcept { return this->GetBlock(x, y, z) != BLOCK_TYPE::BLOCK_TYPE_AIR; }
+
+    // distant terrain is shaded as if under the open sky, a cell's worth of light would mostly be the light of its surface anyway
+    inline std::uint8_t GetLightLevel(const size_t, const size_t, const size_t) const noexcept { return MAX_LIGHT_LEVEL; }
+}; // class LodSectionCells
+
+LodSectionCells::LodSectionCells(const PaddedChunkBlocks& blocks, const size_t sectionIndex, const size_t scale) noexcept
+    : m_sideCellCount(CHUNK_SECTION_Y_BLOCK_COUNT / scale + 2u),
+      m_yBegin(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT / scale)
+{
+    static_assert(CHUNK_X_BLOCK_COUNT == CHUNK_SECTION_Y_BLOCK_COUNT && CHUNK_Z_BLOCK_COUNT == CHUNK_SECTION_Y_BLOCK_COUNT, "Sections are cubes");
+
+    // the cells around the section stay air on the sides
+    std::fill(this->m_cells.begin(), this->m_cells.end(), BLOCK_TYPE::BLOCK_TYPE_AIR);
+
+    const size_t cellCount = this->m_sideCellCount - 2u;
+
+    for (size_t x = 0u; x < cellCount; ++x) {
+        for (size_t z = 0u; z < cellCount; ++z) {
+            // the cells of the sections above and below are needed to cull the top and bottom faces
+            for (size_t y = this->m_yBegin - 1u; y != this->GetYEnd() + 1u; ++y) {
+                // below the world is opaque, like in PaddedChunkBlocks
+                if (y == size_t(-1)) {
+                    this->m_cells[this->GetIndex(x, y, z)] = BLOCK_TYPE::BLOCK_TYPE_STONE;
+                    continue;
+                }
+
+                const size_t blockYBegin = y * scale;
+                const size_t blockYEnd   = std::min(blockYBegin + scale, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT));
+
+                std::array<std::uint8_t, static_cast<size_t>(BLOCK_TYPE::_COUNT)> topBlockCounts{};
+                bool bIsSolid = false;
+
+                for (size_t blockX = x * scale; blockX < (x + 1u) * scale; ++blockX) {
+                    for (size_t blockZ = z * scale; blockZ < (z + 1u) * scale; ++blockZ) {
+                        for (size_t blockY = blockYEnd; blockY > blockYBegin; --blockY) {
+                            if (blocks.IsOpaque(blockX, blockY - 1u, blockZ)) {
+                                ++topBlockCounts[static_cast<size_t>(blocks.GetBlock(blockX, blockY - 1u, blockZ))];
+                                bIsSolid = true;
+                                break;
+                            }
+                        }
                     }
                 }
+
+                if (bIsSolid)
+                    this->m_cells[this->GetIndex(x, y, z)] = static_cast<BLOCK_TYPE>(std::max_element(topBlockCounts.begin(), topBlockCounts.end()) - topBlockCounts.begin());
             }
         }
     }
+}
 
-    D3D11_BUFFER_DESC bufferDesc = {};
-    bufferDesc.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_VERTEX_BUFFER;
-    bufferDesc.ByteWidth = static_cast<UINT>(nVertices * sizeof(Vertex));
-    bufferDesc.CPUAccessFlags = 0;
-    bufferDesc.MiscFlags = 0;
-    bufferDesc.StructureByteStride = sizeof(Vertex);
-    bufferDesc.Usage = D3D11_USAGE::D3D11_USAGE_DEFAULT;
+void Chunk::GenerateLodMesh(std::vector<Vertex>& vertices, const PaddedChunkBlocks& blocks, const size_t sectionIndex, const CHUNK_LOD lod, const std::size_t atlasTilesPerRow) noexcept {
+    const size_t scale = GetChunkLodScale(lod);
+    const LodSectionCells cells(blocks, sectionIndex, scale);
 
-    D3D11_SUBRESOURCE_DATA sd = {};
-    sd.pSysMem = vertices.data();
-    sd.SysMemPitch = 0;
-    sd.SysMemSlicePitch = 0;
-    
-    Chunk::Chunk_DX_Data newDXData;
-    newDXData.nVertices = nVertices;
+    GenerateGreedyQuads<false>(vertices, cells, CHUNK_X_BLOCK_COUNT / scale, cells.GetYBegin(), cells.GetYEnd(), CHUNK_Z_BLOCK_COUNT / scale,
+                        static_cast<std::uint16_t>(scale), atlasTilesPerRow);
+}
 
-    if (device->CreateBuffer(&bufferDesc, &sd, &newDXData.pVertexBuffer) != S_OK)
-        FATAL_ERROR("Failed to create a vertex buffer");
+void Chunk::CopySideBlocks(const CHUNK_SIDE side, ChunkSideBlocks& blocks) const noexcept {
+    for (size_t y = 0u; y < CHUNK_Y_BLOCK_COUNT; ++y) {
+        const ChunkSection* pSection = this->m_pSections[y / CHUNK_SECTION_Y_BLOCK_COUNT].get();
 
-    this->m_dxData.emplace(std::move(newDXData));
-}
\ No newline at end of file
+        for (size_t i = 0u; i < CHUNK_X_BLOCK_COUNT; ++i) {
+            size_t x = i, z = i;
+            switch (side) {
+            case CHUNK_SIDE::CHUNK_SIDE_LEFT:  x = 0u;                       break;
+            case CHUNK_SIDE::CHUNK_SIDE_RIGHT: x = CHUNK_X_BLOCK_COUNT - 1u; break;
+            case CHUNK_SIDE::CHUNK_SIDE_FRONT: z = 0u;                       break;
+            default:                           z = CHUNK_Z_BLOCK_COUNT - 1u; break;
+            }
+
+            blocks[y * CHUNK_X_BLOCK_COUNT + i] = pSection ? pSection->GetBlock(ChunkSection::GetBlockIndex(x, y % CHUNK_SECTION_Y_BLOCK_COUNT, z))
+                                                           : BLOCK_TYPE::BLOCK_TYPE_AIR;
+        }
+    }
+}
+
+void Chunk::CopySideLight(const CHUNK_SIDE side, ChunkSideLight& light) const noexcept {
+    for (size_t y = 0u; y < CHUNK_Y_BLOCK_COUNT; ++y) {
+        const SectionLight& sectionLight = this->m_sectionLights[y / CHUNK_SECTION_Y_BLOCK_COUNT];
+
+        for (size_t i = 0u; i < CHUNK_X_BLOCK_COUNT; ++i) {
+            size_t x = i, z = i;
+            switch (side) {
+            case CHUNK_SIDE::CHUNK_SIDE_LEFT:  x = 0u;                       break;
+            case CHUNK_SIDE::CHUNK_SIDE_RIGHT: x = CHUNK_X_BLOCK_COUNT - 1u; break;
+            case CHUNK_SIDE::CHUNK_SIDE_FRONT: z = 0u;                       break;
+            default:                           z = CHUNK_Z_BLOCK_COUNT - 1u; break;
+            }
+
+            light[y * CHUNK_X_BLOCK_COUNT + i] = sectionLight.GetLight(ChunkSection::GetBlockIndex(x, y % CHUNK_SECTION_Y_BLOCK_COUNT, z));
+        }
+    }
+}
+
+void Chunk::CopyPaddedBlocks(PaddedChunkBlocks& blocks, const ChunkNeighbourBlocks& neighbours, const size_t yBegin, const size_t yEnd) const noexcept {
+    // the layer below the world, any opaque type will do
+    if (yBegin == 0u)
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x)
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z)
+                blocks.m_blocks[PaddedChunkBlocks::GetIndex(x, size_t(-1), z)] = BLOCK_TYPE::BLOCK_TYPE_STONE;
+
+    const size_t chunkYBegin = yBegin;
+    const size_t chunkYEnd   = std::min<size_t>(yEnd, CHUNK_Y_BLOCK_COUNT);
+
+    for (size_t sectionIndex = chunkYBegin / CHUNK_SECTION_Y_BLOCK_COUNT; sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT < chunkYEnd; ++sectionIndex) {
+        const size_t sectionYBegin = std::max(chunkYBegin, sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT);
+        const size_t sectionYEnd   = std::min(chunkYEnd, (sectionIndex + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT);
+
+        // sections of air can still be lit unevenly
+        const SectionLight& sectionLight = this->m_sectionLights[sectionIndex];
+
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+                std::uint8_t* pColumn = blocks.m_light.data() + PaddedChunkBlocks::GetIndex(x, 0u, z);
+
+                if (sectionLight.IsUniform()) {
+                    std::fill(pColumn + sectionYBegin, pColumn + sectionYEnd, sectionLight.GetLight(0u));
+                } else {
+                    for (size_t y = sectionYBegin; y < sectionYEnd; ++y)
+                        pColumn[y] = sectionLight.GetLight(ChunkSection::GetBlockIndex(x, y % CHUNK_SECTION_Y_BLOCK_COUNT, z));
+                }
+            }
+        }
+
+        // the padded blocks start as air
+        const ChunkSection* pSection = this->m_pSections[sectionIndex].get();
+        if (!pSection)
+            continue;
+
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+                BLOCK_TYPE* pColumn = blocks.m_blocks.data() + PaddedChunkBlocks::GetIndex(x, 0u, z);
+
+                if (pSection->IsUniform()) {
+                    std::fill(pColumn + sectionYBegin, pColumn + sectionYEnd, pSection->GetBlock(0u));
+                } else {
+                    for (size_t y = sectionYBegin; y < sectionYEnd; ++y)
+                        pColumn[y] = pSection->GetBlock(ChunkSection::GetBlockIndex(x, y % CHUNK_SECTION_Y_BLOCK_COUNT, z));
+                }
+            }
+        }
+    }
+
+    for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT); ++side) {
+        if ((neighbours.sideMask & (1u << side)) == 0u)
+            continue;
+
+        const ChunkSideBlocks& sideBlocks = neighbours.sides[side];
+        const ChunkSideLight&  sideLight  = neighbours.sideLights[side];
+
+        for (size_t i = 0u; i < CHUNK_X_BLOCK_COUNT; ++i) {
+            size_t x = i, z = i;
+            switch (static_cast<CHUNK_SIDE>(side)) {
+            case CHUNK_SIDE::CHUNK_SIDE_LEFT:  x = size_t(-1);          break;
+            case CHUNK_SIDE::CHUNK_SIDE_RIGHT: x = CHUNK_X_BLOCK_COUNT; break;
+            case CHUNK_SIDE::CHUNK_SIDE_FRONT: z = size_t(-1);          break;
+            default:                           z = CHUNK_Z_BLOCK_COUNT; break;
+            }
+
+            BLOCK_TYPE*   pColumn      = blocks.m_blocks.data() + PaddedChunkBlocks::GetIndex(x, 0u, z);
+            std::uint8_t* pLightColumn = blocks.m_light.data()  + PaddedChunkBlocks::GetIndex(x, 0u, z);
+            for (size_t y = chunkYBegin; y < chunkYEnd; ++y) {
+                pColumn[y]      = sideBlocks[y * CHUNK_X_BLOCK_COUNT + i];
+                pLightColumn[y] = sideLight[y * CHUNK_X_BLOCK_COUNT + i];
+            }
+        }
+    }
+}
+
+// The palette may still list types that were overwritten since, the section is then meshed for nothing
+static bool MayContainTranslucentBlocks(const ChunkSection& section) noexcept {
+    for (size_t type = 0u; type < static_cast<size_t>(BLOCK_TYPE::_COUNT); ++type)
+        if (IsBlockTranslucent(static_cast<BLOCK_TYPE>(type)) && section.MayContain(static_cast<BLOCK_TYPE>(type)))
+            return true;
+
+    return false;
+}
+
+ChunkMesh Chunk::GenerateMesh(const CHUNK_MESHING_MODE meshingMode, const std::size_t textureAtlasWidth, const ChunkNeighbourBlocks& neighbours,
+                              const std::uint16_t sectionMask, const CHUNK_LOD lod) const noexcept {
+    PROFILE_SCOPE("GenerateMesh");
+
+    const std::size_t atlasTilesPerRow = textureAtlasWidth / TEXTURE_SIDE_LENGTH;
+
+    ChunkMesh mesh;
+    mesh.sectionMask   = sectionMask;
+    mesh.neighbourMask = lod == CHUNK_LOD::CHUNK_LOD_FULL ? neighbours.sideMask : 0u;
+    mesh.lod           = lod;
+
+    // faces belong to opaque and translucent blocks, sections of air have none
+    std::uint16_t meshedSections = 0u, translucentSections = 0u;
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        if ((sectionMask & (1u << sectionIndex)) && this->m_pSections[sectionIndex]) {
+            meshedSections |= static_cast<std::uint16_t>(1u << sectionIndex);
+
+            if (lod == CHUNK_LOD::CHUNK_LOD_FULL && MayContainTranslucentBlocks(*this->m_pSections[sectionIndex]))
+                translucentSections |= static_cast<std::uint16_t>(1u << sectionIndex);
+        }
+    }
+
+    if (meshedSections == 0u)
+        return mesh;
+
+    // only the meshed sections and the layers around them (a cell's worth for coarser LODs) are copied
+    size_t firstSection = 0u, lastSection = CHUNK_SECTION_COUNT - 1u;
+    while ((meshedSections & (1u << firstSection)) == 0u) ++firstSection;
+    while ((meshedSections & (1u << lastSection))  == 0u) --lastSection;
+
+    const size_t scale  = GetChunkLodScale(lod);
+    const size_t yBegin = firstSection * CHUNK_SECTION_Y_BLOCK_COUNT;
+
+    static const ChunkNeighbourBlocks noNeighbours{  };
+
+    PaddedChunkBlocks blocks;
+    this->CopyPaddedBlocks(blocks, lod == CHUNK_LOD::CHUNK_LOD_FULL ? neighbours : noNeighbours, yBegin < scale ? 0u : yBegin - scale,
+                           (lastSection + 1u) * CHUNK_SECTION_Y_BLOCK_COUNT + scale);
+
+    for (size_t sectionIndex = firstSection; sectionIndex <= lastSection; ++sectionIndex) {
+        if ((meshedSections & (1u << sectionIndex)) == 0u)
+            continue;
+
+        std::vector<Vertex>& vertices = mesh.sectionVertices[sectionIndex];
+
+        if (lod != CHUNK_LOD::CHUNK_LOD_FULL) {
+            GenerateLodMesh(vertices, blocks, sectionIndex, lod, atlasTilesPerRow);
+            continue;
+        }
+
+        // the sections without translucent blocks skip looking for their faces
+        std::vector<Vertex>* pTranslucentVertices = (translucentSections & (1u << sectionIndex)) ? &mesh.sectionTranslucentVertices[sectionIndex] : nullptr;
+
+        switch (meshingMode) {
+        case CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_NAIVE:
+            GenerateNaiveMesh(vertices, pTranslucentVertices, blocks, sectionIndex, atlasTilesPerRow);
+            break;
+        case CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY:
+            GenerateGreedyMesh(vertices, pTranslucentVertices, blocks, sectionIndex, atlasTilesPerRow);
+            break;
+        case CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_BITMASK:
+            GenerateBitmaskMesh(vertices, pTranslucentVertices, blocks, sectionIndex, atlasTilesPerRow);
+            break;
+        }
+    }
+
+    return mesh;
+}
+
+void Chunk::UploadDXMesh(MeshArena& arena, const ChunkMesh& mesh) noexcept {
+    PROFILE_SCOPE("UploadDXMesh");
+
+    std::optional<Chunk_DX_Data>& dxData = this->m_dxData[static_cast<size_t>(mesh.lod)];
+    if (!dxData.has_value())
+        dxData.emplace();
+
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        if ((mesh.sectionMask & (1u << sectionIndex)) == 0u)
+            continue;
+
+        const std::vector<Vertex>& vertices = mesh.sectionVertices[sectionIndex];
+
+        Chunk::Chunk_DX_Data::Section newSection;
+        newSection.nVertices = vertices.size();
+
+        if (!vertices.empty()) {
+            newSection.allocation = arena.Allocate(vertices.data(), vertices.size() * sizeof(Vertex));
+
+            if (!newSection.allocation.IsValid())
+                FATAL_ERROR("A section's mesh doesn't fit in a mesh arena page");
+        }
+
+        dxData.value().sections[sectionIndex] = std::move(newSection);
+
+        // uploaded once sorted, see SortTranslucentDXMesh
+        if (mesh.lod == CHUNK_LOD::CHUNK_LOD_FULL)
+            this->m_translucentMesh.SetSectionVertices(sectionIndex, mesh.sectionTranslucentVertices[sectionIndex]);
+    }
+}
+
+void Chunk::SortTranslucentDXMesh(MeshArena& arena, const Vec4f32& cameraPosition) noexcept {
+    std::optional<Chunk_DX_Data>& dxData = this->m_dxData[static_cast<size_t>(CHUNK_LOD::CHUNK_LOD_FULL)];
+    if (!dxData.has_value())
+        return;
+
+    const Vec4f32 chunkOrigin = { static_cast<float>(this->m_location.idx) * CHUNK_X_LENGTH, 0.f, static_cast<float>(this->m_location.idz) * CHUNK_Z_LENGTH, 0.f };
+    if (!this->m_translucentMesh.Sort((cameraPosition - chunkOrigin) / BLOCK_LENGTH))
+        return;
+
+    const std::vector<Vertex>& vertices = this->m_translucentMesh.GetSortedVertices();
+    Chunk_DX_Data::Section& translucent = dxData.value().translucent;
+
+    // most sorts only reorder the same quads, their allocation is written over
+    if (translucent.allocation.IsValid() && translucent.nVertices == vertices.size()) {
+        arena.Write(translucent.allocation.GetHandle(), vertices.data());
+        return;
+    }
+
+    translucent = Chunk_DX_Data::Section{  };
+    translucent.nVertices = vertices.size();
+
+    if (!vertices.empty()) {
+        translucent.allocation = arena.Allocate(vertices.data(), vertices.size() * sizeof(Vertex));
+
+        if (!translucent.allocation.IsValid())
+            FATAL_ERROR("A chunk's translucent mesh doesn't fit in a mesh arena page");
+    }
+}
+
+void Chunk::GenerateDXMesh(MeshArena& arena, const std::size_t textureAtlasWidth, const CHUNK_MESHING_MODE meshingMode) noexcept {
+    PROFILE_SCOPE("GenerateDXMesh");
+
+    this->UploadDXMesh(arena, this->GenerateMesh(meshingMode, textureAtlasWidth, ChunkNeighbourBlocks{  }));
+}
@@ -4,10 +4,19 @@
 #include "Pch.hpp"
 #include "Block.hpp"
 #include "Constants.hpp"
+#include "ChunkSection.hpp"
+#include "ChunkLight.hpp"
+#include "MeshArena.hpp"
+#include "TranslucentMesh.hpp"
+#include "Profiler.hpp"
 #include "ErrorHandler.hpp"
+#include "BatchedPerlinNoise.hpp"
 #include "vendor/PerlinNoise.hpp"
 
 class Minecraft;
+class ChunkStorage;
+class LightEngine;
+class WorldGenerator;
 
 struct ChunkCoord {
     std::int16_t idx;
@@ -30,19 +39,310 @@ public:
 template <typename T>
 using ChunkCoordMap = std::unordered_map<ChunkCoord, T, ChunkCoordHash>;
 
+// The render window spans RENDER_DISTANCE chunks on each side of the camera's chunk
+inline bool IsChunkInRenderWindow(const ChunkCoord& cc, const Vec4f32& cameraPosition) noexcept {
+    return cc.idx >= (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT - RENDER_DISTANCE - 1 &&
+           cc.idx <  (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT + RENDER_DISTANCE     &&
+           cc.idz >= (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT - RENDER_DISTANCE - 1 &&
+           cc.idz <  (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT + RENDER_DISTANCE;
+}
+
+enum class CHUNK_LOD : std::uint8_t {
+    CHUNK_LOD_FULL = 0u, // one block per cell
+    CHUNK_LOD_HALF,      // cells of 2x2x2 blocks
+    CHUNK_LOD_QUARTER,   // cells of 4x4x4 blocks
+    CHUNK_LOD_EIGHTH,    // cells of 8x8x8 blocks
+
+    _COUNT
+}; // enum class CHUNK_LOD
+
+// Number of blocks along each side of the LOD's cells
+inline size_t GetChunkLodScale(const CHUNK_LOD lod) noexcept { return static_cast<size_t>(1u) << static_cast<size_t>(lod); }
+
+static_assert(CHUNK_X_BLOCK_COUNT % 8 == 0 && CHUNK_Z_BLOCK_COUNT % 8 == 0 && CHUNK_SECTION_Y_BLOCK_COUNT % 8 == 0,
+              "Sections are made of whole cells at every LOD");
+
+// The distance (in chunks, from the camera's chunk) from which each LOD but CHUNK_LOD_FULL is used, in increasing order
+using ChunkLodDistances = std::array<int, static_cast<size_t>(CHUNK_LOD::_COUNT) - 1u>;
+
+inline CHUNK_LOD SelectChunkLod(const ChunkCoord& cc, const Vec4f32& cameraPosition, const ChunkLodDistances& lodDistances) noexcept {
+    const int distance = std::max(std::abs(cc.idx - static_cast<int>(std::floor(cameraPosition.x / CHUNK_X_LENGTH))),
+                                  std::abs(cc.idz - static_cast<int>(std::floor(cameraPosition.z / CHUNK_Z_LENGTH))));
+
+    size_t lod = 0u;
+    while (lod < lodDistances.size() && distance >= lodDistances[lod])
+        ++lod;
+
+    return static_cast<CHUNK_LOD>(lod);
+}
+
+// Height of the terrain's surface in each column, indexed by x * CHUNK_Z_BLOCK_COUNT + z
+using ChunkHeightMap = std::array<std::uint8_t, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT>;
+
+// One noise evaluation per column
+ChunkHeightMap ComputeDefaultHeightMap(const ChunkCoord& cc, const siv::PerlinNoise& noise) noexcept;
+
+// The whole chunk at once, the heights may differ by one block from the scalar version where float rounding lands on a boundary
+ChunkHeightMap ComputeDefaultHeightMap(const ChunkCoord& cc, const BatchedPerlinNoise& noise) noexcept;
+
+// Summary of the chunk's columns for culling
+struct ChunkColumnHeights {
+    ChunkHeightMap solid; // number of opaque blocks at the bottom of each column, up to the first gap
+    std::uint8_t   top = CHUNK_Y_BLOCK_COUNT; // above the highest block of the chunk
+}; // struct ChunkColumnHeights
+
+// Connectivity of each of the chunk's sections, from the bottom up
+using ChunkSectionConnectivity = std::array<SectionConnectivity, CHUNK_SECTION_COUNT>;
+
+// Every face of every section connected, as for a chunk without blocks
+inline ChunkSectionConnectivity MakeOpenSectionConnectivity() noexcept {
+    ChunkSectionConnectivity connectivity;
+    connectivity.fill(SectionConnectivity(SectionConnectivity::ALL_FACE_PAIRS));
+    return connectivity;
+}
+
+// Vertices built by Chunk::GenerateMesh, section by section
+struct ChunkMesh {
+    std::array<std::vector<Vertex>, CHUNK_SECTION_COUNT> sectionVertices;
+    std::array<std::vector<Vertex>, CHUNK_SECTION_COUNT> sectionTranslucentVertices; // the faces of translucent blocks, CHUNK_LOD_FULL only
+    std::uint16_t sectionMask = 0u; // the sections that were built, Chunk::UploadDXMesh leaves the others as they are
+    std::uint8_t  neighbourMask = 0u; // ChunkNeighbourBlocks::sideMask of the neighbours' blocks the sections were built with
+    CHUNK_LOD     lod = CHUNK_LOD::CHUNK_LOD_FULL;
+
+    static constexpr std::uint16_t ALL_SECTIONS = static_cast<std::uint16_t>((1u << CHUNK_SECTION_COUNT) - 1u);
+}; // struct ChunkMesh
+
+enum class CHUNK_SIDE : std::uint8_t {
+    CHUNK_SIDE_LEFT = 0u, // -x
+    CHUNK_SIDE_RIGHT,     // +x
+    CHUNK_SIDE_FRONT,     // -z
+    CHUNK_SIDE_BACK,      // +z
+
+    _COUNT
+}; // enum class CHUNK_SIDE
+
+static_assert(CHUNK_X_BLOCK_COUNT == CHUNK_Z_BLOCK_COUNT, "Every side of a chunk has as many blocks");
+
+// The layer of blocks of a chunk along one of its sides, indexed by y * CHUNK_X_BLOCK_COUNT + the position along the side (z or x)
+using ChunkSideBlocks = std::array<BLOCK_TYPE, CHUNK_Y_BLOCK_COUNT * CHUNK_X_BLOCK_COUNT>;
+
+// The light of those same cells, see ChunkLight.hpp
+using ChunkSideLight = std::array<std::uint8_t, CHUNK_Y_BLOCK_COUNT * CHUNK_X_BLOCK_COUNT>;
+
+// The layers of the neighbouring chunks that touch a chunk, indexed by CHUNK_SIDE, for meshing
+struct ChunkNeighbourBlocks {
+    std::array<ChunkSideBlocks, static_cast<size_t>(CHUNK_SIDE::_COUNT)> sides;
+    std::array<ChunkSideLight,  static_cast<size_t>(CHUNK_SIDE::_COUNT)> sideLights;
+    std::uint8_t sideMask = 0u; // one bit per side whose neighbour is known, the blocks of the others are seen as air under the open sky
+}; // struct ChunkNeighbourBlocks
+
+// A chunk's blocks surrounded by one layer of its neighbours' blocks, so that the meshers can look at
+// the neighbours of any block without bound checks. Coordinates are relative to the chunk and go from -1,
+// which can be passed as size_t(-1). Below the world is opaque, since nothing can see faces from there.
+// The cells' light comes along, a face is lit by the cell it looks into
+class PaddedChunkBlocks {
+    friend class Chunk;
+public:
+    static constexpr size_t X_BLOCK_COUNT = CHUNK_X_BLOCK_COUNT + 2u;
+    static constexpr size_t Y_BLOCK_COUNT = CHUNK_Y_BLOCK_COUNT + 2u;
+    static constexpr size_t Z_BLOCK_COUNT = CHUNK_Z_BLOCK_COUNT + 2u;
+
+private:
+    // columns are contiguous, like in sections
+    std::vector<BLOCK_TYPE> m_blocks = std::vector<BLOCK_TYPE>(X_BLOCK_COUNT * Y_BLOCK_COUNT * Z_BLOCK_COUNT, BLOCK_TYPE::BLOCK_TYPE_AIR);
+    std::vector<std::uint8_t> m_light = std::vector<std::uint8_t>(X_BLOCK_COUNT * Y_BLOCK_COUNT * Z_BLOCK_COUNT, SKY_LIGHT);
+
+    std::array<bool, static_cast<size_t>(BLOCK_TYPE::_COUNT)> m_bIsBlockTypeOpaque;
+    std::array<bool, static_cast<size_t>(BLOCK_TYPE::_COUNT)> m_bIsBlockTypeTranslucent;
+    std::vector<BLOCK_TYPE> m_translucentBlockTypes;
+
+    static inline size_t GetIndex(const size_t x, const size_t y, const size_t z) noexcept {
+        return ((x + 1u) * Z_BLOCK_COUNT + (z + 1u)) * Y_BLOCK_COUNT + (y + 1u);
+    }
+
+public:
+    inline PaddedChunkBlocks() noexcept {
+        for (size_t type = 0u; type < this->m_bIsBlockTypeOpaque.size(); ++type) {
+            this->m_bIsBlockTypeOpaque[type]      = IsBlockOpaque(static_cast<BLOCK_TYPE>(type));
+            this->m_bIsBlockTypeTranslucent[type] = IsBlockTranslucent(static_cast<BLOCK_TYPE>(type));
+
+            if (this->m_bIsBlockTypeTranslucent[type])
+                this->m_translucentBlockTypes.push_back(static_cast<BLOCK_TYPE>(type));
+        }
+    }
+
+    inline const std::vector<BLOCK_TYPE>& GetTranslucentBlockTypes() const noexcept { return this->m_translucentBlockTypes; }
+
+    inline BLOCK_TYPE GetBlock(const size_t x, const size_t y, const size_t z) const noexcept { return this->m_blocks[GetIndex(x, y, z)]; }
+
+    inline bool IsOpaque(const size_t x, const size_t y, const size_t z) const noexcept {
+        return this->m_bIsBlockTypeOpaque[static_cast<size_t>(this->m_blocks[GetIndex(x, y, z)])];
+    }
+
+    inline bool IsTranslucent(const size_t x, const size_t y, const size_t z) const noexcept {
+        return this->m_bIsBlockTypeTranslucent[static_cast<size_t>(this->m_blocks[GetIndex(x, y, z)])];
+    }
+
+    // In [0, MAX_LIGHT_LEVEL], the brighter of the cell's sky and block light
+    inline std::uint8_t GetLightLevel(const size_t x, const size_t y, const size_t z) const noexcept { return ::GetLightLevel(this->m_light[GetIndex(x, y, z)]); }
+
+    // Bit i of "opaqueMask" and "translucentMask" is set when the block (x, y + i, z) is opaque or translucent, for i < nBlocks <= 32
+    inline void GetColumnMasks(const size_t x, const size_t y, const size_t z, const size_t nBlocks, std::uint32_t& opaqueMask, std::uint32_t& translucentMask) const noexcept {
+        const BLOCK_TYPE* pBlocks = this->m_blocks.data() + GetIndex(x, y, z);
+
+        opaqueMask = translucentMask = 0u;
+        for (size_t i = 0u; i < nBlocks; ++i) {
+            opaqueMask      |= static_cast<std::uint32_t>(this->m_bIsBlockTypeOpaque     [static_cast<size_t>(pBlocks[i])]) << i;
+            translucentMask |= static_cast<std::uint32_t>(this->m_bIsBlockTypeTranslucent[static_cast<size_t>(pBlocks[i])]) << i;
+        }
+    }
+
+    // Bit i is set when the block (x, y + i, z) is of type "type", for i < nBlocks <= 32
+    inline std::uint32_t GetColumnTypeMask(const size_t x, const size_t y, const size_t z, const size_t nBlocks, const BLOCK_TYPE type) const noexcept {
+        const BLOCK_TYPE* pBlocks = this->m_blocks.data() + GetIndex(x, y, z);
+
+        std::uint32_t mask = 0u;
+        for (size_t i = 0u; i < nBlocks; ++i)
+            mask |= static_cast<std::uint32_t>(pBlocks[i] == type) << i;
+
+        return mask;
+    }
+}; // class PaddedChunkBlocks
+
+enum class CHUNK_MESHING_MODE : std::uint8_t {
+    CHUNK_MESHING_MODE_NAIVE = 0u, // one quad per visible block face
+    CHUNK_MESHING_MODE_GREEDY,     // coplanar faces of the same block type and face are merged into rectangles
+    CHUNK_MESHING_MODE_BITMASK     // the quads of CHUNK_MESHING_MODE_NAIVE, in the same order, with the visible faces found a column at a time
+}; // enum class CHUNK_MESHING_MODE
+
 class Chunk {
     friend Minecraft;
+    friend ChunkStorage;
+    friend LightEngine;
+    friend WorldGenerator;
 private:
     ChunkCoord m_location;
 
-    std::array<std::array<std::array<BLOCK_TYPE, CHUNK_Z_BLOCK_COUNT>, CHUNK_Y_BLOCK_COUNT>, CHUNK_X_BLOCK_COUNT> m_blocks{};
+    // Sections that only contain air aren't allocated
+    std::array<std::unique_ptr<ChunkSection>, CHUNK_SECTION_COUNT> m_pSections;
 
+    // One allocation of Minecraft's mesh arena per section, so that a block edit only rebuilds the sections around it.
+    // Vertices are relative to the chunk's origin and come 4 per quad,
+    // they are drawn through Minecraft's shared quad index buffer
     struct Chunk_DX_Data {
-        Microsoft::WRL::ComPtr<ID3D11Buffer> pVertexBuffer;
-        size_t nVertices = 0u;
+        struct Section {
+            MeshArenaAllocation allocation; // invalid when the section has no faces
+            size_t nVertices = 0u;
+        }; // struct Section
+
+        std::array<Section, CHUNK_SECTION_COUNT> sections;
+
+        // The faces of the translucent blocks of every section, back to front as of the last SortTranslucentDXMesh. CHUNK_LOD_FULL only
+        Section translucent;
+
+        inline size_t GetQuadCount() const noexcept {
+            size_t nVertices = 0u;
+            for (const Section& section : this->sections)
+                nVertices += section.nVertices;
+
+            return nVertices / 4u;
+        }
     };
 
-    std::optional<Chunk_DX_Data> m_dxData;
+    // One mesh per LOD, Minecraft keeps the ones the camera may soon need again cached
+    std::array<std::optional<Chunk_DX_Data>, static_cast<size_t>(CHUNK_LOD::_COUNT)> m_dxData;
+
+    // The translucent faces of the CHUNK_LOD_FULL mesh, kept on the CPU to be sorted as the camera moves
+    TranslucentMesh m_translucentMesh;
+
+    // Set by Minecraft, on the main thread only, while a job is generating or meshing the chunk
+    bool m_bHasPendingJob = false;
+
+    bool m_bIsGenerated = false;
+
+    // The blocks changed since the chunk was last saved or loaded
+    bool m_bIsDirty = false;
+
+    // Cold chunks keep their blocks serialized (see Serialize) instead of in sections
+    bool                      m_bIsCompressed = false;
+    std::vector<std::uint8_t> m_compressedBlocks;
+
+    // Last frame the chunk was in the render window, for the memory budget's LRU
+    std::uint64_t m_lastUsedFrame = 0u;
+
+    // Set by Minecraft along with the mesh, so that both describe the same blocks
+    ChunkColumnHeights m_columnHeights{};
+
+    // Kept up to date by UpdateSectionConnectivity, which only recomputes the sections
+    // whose bit is set in m_dirtyConnectivitySections. Sections without blocks see through all of their faces
+    ChunkSectionConnectivity m_sectionConnectivity = MakeOpenSectionConnectivity();
+    std::uint16_t            m_dirtyConnectivitySections = 0u;
+
+    // Set by Minecraft along with the mesh, like m_columnHeights
+    ChunkSectionConnectivity m_meshSectionConnectivity = MakeOpenSectionConnectivity();
+
+    // Sections whose mesh is out of date, for each LOD. A block's faces depend on its neighbours so an edit
+    // on a section's top or bottom layer also marks the section above or below it
+    std::array<std::uint16_t, static_cast<size_t>(CHUNK_LOD::_COUNT)> m_dirtyMeshSections{};
+
+    // The sides whose neighbour's blocks were known by every section of the CHUNK_LOD_FULL mesh, set by Minecraft along with the mesh
+    std::uint8_t m_meshNeighbourMask = 0u;
+
+    // Written by LightEngine only. It isn't serialized: a loaded chunk is relit on its own by the job
+    // that loads it, then Minecraft lets the light through each side once the neighbour there is loaded
+    std::array<SectionLight, CHUNK_SECTION_COUNT> m_sectionLights;
+    std::uint8_t                                  m_litSideMask = 0u; // the sides the light went through, see LightEngine::StitchSide
+
+    static_assert(CHUNK_SECTION_COUNT <= 16, "The dirty section masks are 16 bits wide");
+
+private:
+    // The blocks [idyBegin, idyEnd) of a column changed
+    inline void MarkBlocksChanged(const size_t idyBegin, const size_t idyEnd) noexcept {
+        if (idyBegin >= idyEnd)
+            return;
+
+        const size_t firstSection = idyBegin / CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t lastSection  = (idyEnd - 1u) / CHUNK_SECTION_Y_BLOCK_COUNT;
+
+        const std::uint16_t sectionMask = static_cast<std::uint16_t>(((1u << (lastSection + 1u)) - 1u) & ~((1u << firstSection) - 1u));
+        this->m_dirtyConnectivitySections |= sectionMask;
+
+        std::uint16_t meshSectionMask = sectionMask;
+        if (idyBegin % CHUNK_SECTION_Y_BLOCK_COUNT == 0u && firstSection > 0u)
+            meshSectionMask |= static_cast<std::uint16_t>(1u << (firstSection - 1u));
+
+        if ((idyEnd - 1u) % CHUNK_SECTION_Y_BLOCK_COUNT == CHUNK_SECTION_Y_BLOCK_COUNT - 1u && lastSection + 1u < CHUNK_SECTION_COUNT)
+            meshSectionMask |= static_cast<std::uint16_t>(1u << (lastSection + 1u));
+
+        for (std::uint16_t& dirtyMeshSections : this->m_dirtyMeshSections)
+            dirtyMeshSections |= meshSectionMask;
+    }
+
+    inline void MarkAllSectionsDirty() noexcept {
+        this->m_dirtyConnectivitySections = ChunkMesh::ALL_SECTIONS;
+        this->m_dirtyMeshSections.fill(ChunkMesh::ALL_SECTIONS);
+    }
+
+    // Copies the layers [yBegin, yEnd) of the chunk and of its neighbours into "blocks", plus the layer below the world when yBegin is 0.
+    // yEnd may go past the top of the chunk
+    void CopyPaddedBlocks(PaddedChunkBlocks& blocks, const ChunkNeighbourBlocks& neighbours, const size_t yBegin, const size_t yEnd) const noexcept;
+
+    // Append the faces of the section's opaque blocks to "vertices", and the ones of its translucent blocks to "pTranslucentVertices" unless it is nullptr.
+    // Translucent faces are hidden by opaque blocks and by blocks of the same type, so that a body of water only shows its outline
+    static void GenerateNaiveMesh (std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                                   const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept;
+    static void GenerateGreedyMesh(std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                                   const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept;
+
+    // Same output as GenerateNaiveMesh. Each column of the section is a bitmask of its opaque blocks (and one of its translucent blocks),
+    // the faces of the whole column that no opaque block hides come from shifts and AND-NOTs with the columns around it
+    static void GenerateBitmaskMesh(std::vector<Vertex>& vertices, std::vector<Vertex>* pTranslucentVertices, const PaddedChunkBlocks& blocks,
+                                    const size_t sectionIndex, const std::size_t atlasTilesPerRow) noexcept;
+
+    // Same as GenerateGreedyMesh, on the section downsampled to the LOD's cells. A cell is solid when any of its blocks is opaque,
+    // so that the surface never sinks below the real one, and takes the most common type of its columns' highest opaque block.
+    // The neighbouring chunks are seen as air, the faces left along the sides are skirts that hide the seams between LODs
+    static void GenerateLodMesh(std::vector<Vertex>& vertices, const PaddedChunkBlocks& blocks, const size_t sectionIndex, const CHUNK_LOD lod, const std::size_t atlasTilesPerRow) noexcept;
 
 public:
     inline Chunk() noexcept = default;
@@ -53,35 +353,190 @@ public:
 
     inline ChunkCoord GetLocation() const noexcept { return this->m_location; }
 
-    inline std::optional<const BLOCK_TYPE*> GetBlock(const size_t idx, const size_t idy, const size_t idz) const noexcept {
+    inline std::optional<BLOCK_TYPE> GetBlock(const size_t idx, const size_t idy, const size_t idz) const noexcept {
         if (idx >= 0 && idy >= 0 && idz >= 0 && idx < CHUNK_X_BLOCK_COUNT && idy < CHUNK_Y_BLOCK_COUNT && idz < CHUNK_Z_BLOCK_COUNT) {
-            return &this->m_blocks[idx][idy][idz];
+            const ChunkSection* pSection = this->m_pSections[idy / CHUNK_SECTION_Y_BLOCK_COUNT].get();
+
+            if (!pSection)
+                return BLOCK_TYPE::BLOCK_TYPE_AIR;
+
+            return pSection->GetBlock(ChunkSection::GetBlockIndex(idx, idy % CHUNK_SECTION_Y_BLOCK_COUNT, idz));
         }
 
         return {  };
     }
 
-    inline std::optional<BLOCK_TYPE*> GetBlock(const size_t idx, const size_t idy, const size_t idz) noexcept {
+    inline void SetBlock(const size_t idx, const size_t idy, const size_t idz, const BLOCK_TYPE& type) noexcept {
         if (idx >= 0 && idy >= 0 && idz >= 0 && idx < CHUNK_X_BLOCK_COUNT && idy < CHUNK_Y_BLOCK_COUNT && idz < CHUNK_Z_BLOCK_COUNT) {
-            return &this->m_blocks[idx][idy][idz];
+            std::unique_ptr<ChunkSection>& pSection = this->m_pSections[idy / CHUNK_SECTION_Y_BLOCK_COUNT];
+
+            if (!pSection) {
+                if (type == BLOCK_TYPE::BLOCK_TYPE_AIR)
+                    return;
+
+                pSection = std::make_unique<ChunkSection>();
+            }
+
+            pSection->SetBlock(ChunkSection::GetBlockIndex(idx, idy % CHUNK_SECTION_Y_BLOCK_COUNT, idz), type);
+            this->m_bIsDirty = true;
+            this->MarkBlocksChanged(idy, idy + 1u);
+
+            if (pSection->IsEmpty())
+                pSection.reset();
         }
+    }
 
-        return {  };
+    // Sets the blocks [idyBegin, idyEnd) of the (idx, idz) column to "type"
+    void FillColumn(const size_t idx, const size_t idz, const size_t idyBegin, const size_t idyEnd, const BLOCK_TYPE& type) noexcept;
+
+    // nullptr when the section only contains air
+    inline const ChunkSection* GetSection(const size_t sectionIndex) const noexcept { return this->m_pSections[sectionIndex].get(); }
+
+    // Packed as in ChunkLight.hpp, cells above the chunk are under the open sky.
+    // Minecraft::SetBlock keeps it up to date, Chunk::SetBlock doesn't
+    inline std::uint8_t GetLight(const size_t idx, const size_t idy, const size_t idz) const noexcept {
+        if (idy >= CHUNK_Y_BLOCK_COUNT)
+            return SKY_LIGHT;
+
+        return this->m_sectionLights[idy / CHUNK_SECTION_Y_BLOCK_COUNT].GetLight(ChunkSection::GetBlockIndex(idx, idy % CHUNK_SECTION_Y_BLOCK_COUNT, idz));
     }
 
-    inline void SetBlock(const size_t idx, const size_t idy, const size_t idz, const BLOCK_TYPE& type) noexcept {
-        if (idx >= 0 && idy >= 0 && idz >= 0 && idx < CHUNK_X_BLOCK_COUNT && idy < CHUNK_Y_BLOCK_COUNT && idz < CHUNK_Z_BLOCK_COUNT) {
-            this->m_blocks[idx][idy][idz] = type;
+    inline const SectionLight& GetSectionLight(const size_t sectionIndex) const noexcept { return this->m_sectionLights[sectionIndex]; }
+
+    inline std::uint8_t GetLitSideMask() const noexcept { return this->m_litSideMask; }
+
+    // In bytes, for the chunk's blocks and the light cells it allocated
+    inline size_t GetBlockMemoryUsage() const noexcept {
+        size_t memoryUsage = sizeof(this->m_pSections) + this->m_compressedBlocks.capacity();
+
+        for (const std::unique_ptr<ChunkSection>& pSection : this->m_pSections)
+            if (pSection)
+                memoryUsage += pSection->GetMemoryUsage();
+
+        for (const SectionLight& sectionLight : this->m_sectionLights)
+            memoryUsage += sectionLight.GetMemoryUsage();
+
+        return memoryUsage;
+    }
+
+    void GenerateDefaultTerrain(const ChunkHeightMap& heightMap) noexcept;
+
+    inline void GenerateDefaultTerrain(const siv::PerlinNoise& noise) noexcept {
+        this->GenerateDefaultTerrain(ComputeDefaultHeightMap(this->m_location, noise));
+    }
+
+    inline void GenerateDefaultTerrain(const BatchedPerlinNoise& noise) noexcept {
+        this->GenerateDefaultTerrain(ComputeDefaultHeightMap(this->m_location, noise));
+    }
+
+    inline bool IsGenerated() const noexcept { return this->m_bIsGenerated; }
+
+    inline bool IsDirty() const noexcept { return this->m_bIsDirty; }
+
+    inline bool IsCompressed() const noexcept { return this->m_bIsCompressed; }
+
+    // The blocks of a compressed chunk can't be accessed until it is decompressed
+    void Compress() noexcept;
+
+    void Decompress() noexcept;
+
+    inline std::uint64_t GetLastUsedFrame() const noexcept { return this->m_lastUsedFrame; }
+
+    inline void MarkUsed(const std::uint64_t frameIndex) noexcept { this->m_lastUsedFrame = frameIndex; }
+
+    // The allocated sections' blocks, run length encoded
+    std::vector<std::uint8_t> Serialize() const noexcept;
+
+    // Replaces the chunk's blocks with the ones from Serialize, returns false (leaving the chunk empty) if "pData" is invalid
+    bool Deserialize(const std::uint8_t* pData, const size_t size) noexcept;
+
+    ChunkColumnHeights ComputeColumnHeights() const noexcept;
+
+    // As of the last mesh uploaded
+    inline const ChunkColumnHeights& GetColumnHeights() const noexcept { return this->m_columnHeights; }
+
+    // Recomputes the connectivity of the sections whose blocks changed since the last call
+    const ChunkSectionConnectivity& UpdateSectionConnectivity() noexcept;
+
+    // As of the last mesh uploaded
+    inline const ChunkSectionConnectivity& GetSectionConnectivity() const noexcept { return this->m_meshSectionConnectivity; }
+
+    // At any LOD
+    inline bool HasDXMesh() const noexcept {
+        return std::any_of(this->m_dxData.begin(), this->m_dxData.end(), [](const std::optional<Chunk_DX_Data>& dxData) { return dxData.has_value(); });
+    }
+
+    inline bool HasDXMesh(const CHUNK_LOD lod) const noexcept { return this->m_dxData[static_cast<size_t>(lod)].has_value(); }
+
+    // The LOD closest to "lod" that has a mesh, the finer one first when two are as close
+    inline std::optional<CHUNK_LOD> FindDXMeshLod(const CHUNK_LOD lod) const noexcept {
+        for (size_t distance = 0u; distance < this->m_dxData.size(); ++distance) {
+            if (static_cast<size_t>(lod) >= distance && this->m_dxData[static_cast<size_t>(lod) - distance].has_value())
+                return static_cast<CHUNK_LOD>(static_cast<size_t>(lod) - distance);
+
+            if (static_cast<size_t>(lod) + distance < this->m_dxData.size() && this->m_dxData[static_cast<size_t>(lod) + distance].has_value())
+                return static_cast<CHUNK_LOD>(static_cast<size_t>(lod) + distance);
         }
+
+        return {  };
+    }
+
+    inline void UnloadDXMesh() noexcept {
+        for (std::optional<Chunk_DX_Data>& dxData : this->m_dxData)
+            dxData.reset();
+
+        this->m_translucentMesh.Clear();
+    }
+
+    inline void UnloadDXMesh(const CHUNK_LOD lod) noexcept {
+        this->m_dxData[static_cast<size_t>(lod)].reset();
+
+        if (lod == CHUNK_LOD::CHUNK_LOD_FULL)
+            this->m_translucentMesh.Clear();
+    }
+
+    inline size_t GetDXMeshQuadCount(const CHUNK_LOD lod) const noexcept {
+        const std::optional<Chunk_DX_Data>& dxData = this->m_dxData[static_cast<size_t>(lod)];
+        return dxData.has_value() ? dxData.value().GetQuadCount() : 0u;
+    }
+
+    // The sections whose mesh changed since the last call, see m_dirtyMeshSections
+    inline std::uint16_t GetDirtyMeshSections(const CHUNK_LOD lod) const noexcept { return this->m_dirtyMeshSections[static_cast<size_t>(lod)]; }
+
+    // The sections' meshes depend on blocks of other chunks too, see ChunkNeighbourBlocks. Only CHUNK_LOD_FULL meshes do
+    inline void MarkMeshSectionsDirty(const std::uint16_t sectionMask) noexcept {
+        this->m_dirtyMeshSections[static_cast<size_t>(CHUNK_LOD::CHUNK_LOD_FULL)] |= sectionMask;
+    }
+
+    inline std::uint8_t GetMeshNeighbourMask() const noexcept { return this->m_meshNeighbourMask; }
+
+    // Copies the chunk's layer of blocks along "side", for its neighbour on that side
+    void CopySideBlocks(const CHUNK_SIDE side, ChunkSideBlocks& blocks) const noexcept;
+
+    // Same as CopySideBlocks, for the light of those cells
+    void CopySideLight(const CHUNK_SIDE side, ChunkSideLight& light) const noexcept;
+
+    inline std::uint16_t TakeDirtyMeshSections(const CHUNK_LOD lod) noexcept {
+        const std::uint16_t dirtyMeshSections = this->m_dirtyMeshSections[static_cast<size_t>(lod)];
+        this->m_dirtyMeshSections[static_cast<size_t>(lod)] = 0u;
+        return dirtyMeshSections;
     }
 
-    void GenerateDefaultTerrain(const siv::PerlinNoise& noise) noexcept;
+    // Builds the vertices of the sections in "sectionMask" on the CPU, without touching the GPU.
+    // Faces hidden by the neighbours' blocks are culled too. Coarser LODs are always meshed greedily, ignore "neighbours" and leave out translucent blocks
+    ChunkMesh GenerateMesh(const CHUNK_MESHING_MODE meshingMode, const std::size_t textureAtlasWidth, const ChunkNeighbourBlocks& neighbours,
+                           const std::uint16_t sectionMask = ChunkMesh::ALL_SECTIONS, const CHUNK_LOD lod = CHUNK_LOD::CHUNK_LOD_FULL) const noexcept;
 
-    inline bool HasDXMesh() const noexcept { return this->m_dxData.has_value(); }
+    // Replaces the arena allocations of the sections built by GenerateMesh, in the mesh of its LOD.
+    // A partial mesh only makes sense on top of the one the chunk already has
+    void UploadDXMesh(MeshArena& arena, const ChunkMesh& mesh) noexcept;
 
-    inline void UnloadDXMesh() noexcept { this->m_dxData.reset(); }
+    // Orders the translucent faces of the CHUNK_LOD_FULL mesh back to front for the camera, see TranslucentMesh::Sort,
+    // and writes them to the arena when their order changed
+    void SortTranslucentDXMesh(MeshArena& arena, const Vec4f32& cameraPosition) noexcept;
 
-    void GenerateDXMesh(const Microsoft::WRL::ComPtr<ID3D11Device>& device, const std::size_t textureAtlasWidth, const std::size_t textureAtlasHeight) noexcept;
+    void GenerateDXMesh(MeshArena& arena, const std::size_t textureAtlasWidth,
+                        const CHUNK_MESHING_MODE meshingMode = CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY) noexcept;
 }; // class Chunk
 
 #endif // __MINECRAFT__CHUNK_HPP
\ No newline at end of file
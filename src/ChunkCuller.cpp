@@ -0,0 +1,225 @@
+#include "ChunkCuller.hpp"
+
+#if defined(__AVX__)
+    #define MINECRAFT_CHUNK_CULLER_AVX
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MINECRAFT_CHUNK_CULLER_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Spreads the 16 low bits of "v" over the even bits
+static inline std::uint32_t SpreadBits(std::uint32_t v) noexcept {
+    v &= 0x0000FFFFu;
+    v = (v | (v << 8u)) & 0x00FF00FFu;
+    v = (v | (v << 4u)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2u)) & 0x33333333u;
+    v = (v | (v << 1u)) & 0x55555555u;
+    return v;
+}
+
+static inline std::uint32_t GetMortonCode(const std::uint32_t x, const std::uint32_t z) noexcept {
+    return (SpreadBits(x) << 1u) | SpreadBits(z);
+}
+
+void CullBoxes(const CameraFrustum& frustum, const BoxesSoA& boxes, const size_t begin, const size_t end,
+               std::vector<std::uint32_t>& visibleIndices) noexcept {
+    // The p-vertex, the box's corner furthest along the plane's normal, is picked once per plane for every box
+    struct PVertexPlane {
+        const float* xs;
+        const float* ys;
+        const float* zs;
+        CameraFrustumPlane plane;
+    };
+
+    std::array<PVertexPlane, static_cast<std::size_t>(CAMERA_FRUSTUM_PLANE::_COUNT)> pVertexPlanes;
+    for (size_t i = 0u; i < pVertexPlanes.size(); ++i) {
+        const CameraFrustumPlane& plane = frustum.planes[i];
+
+        pVertexPlanes[i].xs    = plane.x > 0.f ? boxes.maxX.data() : boxes.minX.data();
+        pVertexPlanes[i].ys    = plane.y > 0.f ? boxes.maxY.data() : boxes.minY.data();
+        pVertexPlanes[i].zs    = plane.z > 0.f ? boxes.maxZ.data() : boxes.minZ.data();
+        pVertexPlanes[i].plane = plane;
+    }
+
+    size_t i = begin;
+
+#if defined(MINECRAFT_CHUNK_CULLER_AVX)
+    for (; i + 8u <= end; i += 8u) {
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (const PVertexPlane& p : pVertexPlanes) {
+            const __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(p.xs + i), _mm256_set1_ps(p.plane.x)),
+                                                                              _mm256_mul_ps(_mm256_loadu_ps(p.ys + i), _mm256_set1_ps(p.plane.y))),
+                                                                _mm256_mul_ps(_mm256_loadu_ps(p.zs + i), _mm256_set1_ps(p.plane.z))),
+                                                  _mm256_set1_ps(p.plane.w));
+
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GT_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for (std::uint32_t lane = 0u; lane < 8u; ++lane)
+            if (mask & (1 << lane))
+                visibleIndices.push_back(static_cast<std::uint32_t>(i) + lane);
+    }
+#elif defined(MINECRAFT_CHUNK_CULLER_SSE2)
+    for (; i + 4u <= end; i += 4u) {
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const PVertexPlane& p : pVertexPlanes) {
+            const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p.xs + i), _mm_set1_ps(p.plane.x)),
+                                                                     _mm_mul_ps(_mm_loadu_ps(p.ys + i), _mm_set1_ps(p.plane.y))),
+                                                          _mm_mul_ps(_mm_loadu_ps(p.zs + i), _mm_set1_ps(p.plane.z))),
+                                               _mm_set1_ps(p.plane.w));
+
+            inside = _mm_and_ps(inside, _mm_cmpgt_ps(distance, _mm_setzero_ps()));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (std::uint32_t lane = 0u; lane < 4u; ++lane)
+            if (mask & (1 << lane))
+                visibleIndices.push_back(static_cast<std::uint32_t>(i) + lane);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        bool bIsInside = true;
+
+        for (const PVertexPlane& p : pVertexPlanes) {
+            if (IsPointOutsideFrustumOfPlane(Vec4f32{ p.xs[i], p.ys[i], p.zs[i] }, p.plane)) {
+                bIsInside = false;
+                break;
+            }
+        }
+
+        if (bIsInside)
+            visibleIndices.push_back(static_cast<std::uint32_t>(i));
+    }
+}
+
+void ChunkColumnQuadTree::Build(const std::vector<ChunkColumnBounds>& columns) noexcept {
+    this->m_nodes.clear();
+    this->m_boxes.Clear();
+    this->m_indices.clear();
+
+    if (columns.empty())
+        return;
+
+    std::int32_t minIdx = columns.front().location.idx, maxIdx = minIdx;
+    std::int32_t minIdz = columns.front().location.idz, maxIdz = minIdz;
+    for (const ChunkColumnBounds& column : columns) {
+        minIdx = std::min<std::int32_t>(minIdx, column.location.idx); maxIdx = std::max<std::int32_t>(maxIdx, column.location.idx);
+        minIdz = std::min<std::int32_t>(minIdz, column.location.idz); maxIdz = std::max<std::int32_t>(maxIdz, column.location.idz);
+    }
+
+    // the root is the smallest power of two square covering every column
+    std::uint32_t sideChunkCount = LEAF_SIDE_CHUNK_COUNT;
+    while (sideChunkCount <= static_cast<std::uint32_t>(std::max(maxIdx - minIdx, maxIdz - minIdz)))
+        sideChunkCount *= 2u;
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> sortedColumns(columns.size()); // (Morton code, column)
+    for (size_t i = 0u; i < columns.size(); ++i) {
+        sortedColumns[i].first  = GetMortonCode(static_cast<std::uint32_t>(columns[i].location.idx - minIdx),
+                                                static_cast<std::uint32_t>(columns[i].location.idz - minIdz));
+        sortedColumns[i].second = static_cast<std::uint32_t>(i);
+    }
+
+    std::sort(sortedColumns.begin(), sortedColumns.end());
+
+    this->m_boxes.Reserve(columns.size());
+    this->m_indices.reserve(columns.size());
+
+    std::vector<std::uint32_t> mortonCodes(sortedColumns.size());
+    for (size_t i = 0u; i < sortedColumns.size(); ++i) {
+        const ChunkColumnBounds& column = columns[sortedColumns[i].second];
+
+        const Vec4f32 boxMin = { static_cast<float>(column.location.idx) * CHUNK_X_LENGTH, column.minY, static_cast<float>(column.location.idz) * CHUNK_Z_LENGTH };
+
+        mortonCodes[i] = sortedColumns[i].first;
+        this->m_boxes.PushBack(boxMin, boxMin + Vec4f32{ CHUNK_X_LENGTH, column.maxY - column.minY, CHUNK_Z_LENGTH });
+        this->m_indices.push_back(column.index);
+    }
+
+    this->m_nodes.emplace_back();
+    this->BuildNode(0u, mortonCodes, 0u, static_cast<std::uint32_t>(mortonCodes.size()), 0u, sideChunkCount);
+}
+
+void ChunkColumnQuadTree::BuildNode(const std::uint32_t nodeIndex, const std::vector<std::uint32_t>& mortonCodes, const std::uint32_t begin, const std::uint32_t end,
+                                    const std::uint32_t firstMortonCode, const std::uint32_t sideChunkCount) noexcept {
+    Node node;
+    node.begin      = begin;
+    node.end        = end;
+    node.firstChild = NO_CHILDREN;
+    node.boxMin     = Vec4f32{ +INFINITY, +INFINITY, +INFINITY };
+    node.boxMax     = Vec4f32{ -INFINITY, -INFINITY, -INFINITY };
+
+    if (sideChunkCount > LEAF_SIDE_CHUNK_COUNT && begin != end) {
+        node.firstChild = static_cast<std::uint32_t>(this->m_nodes.size());
+        this->m_nodes.resize(this->m_nodes.size() + 4u);
+
+        const std::uint64_t childMortonCodeCount = static_cast<std::uint64_t>(sideChunkCount / 2u) * (sideChunkCount / 2u);
+
+        std::uint32_t childBegin = begin;
+        for (std::uint32_t child = 0u; child < 4u; ++child) {
+            const std::uint64_t childFirstMortonCode = firstMortonCode + child * childMortonCodeCount;
+
+            const std::uint32_t childEnd = static_cast<std::uint32_t>(std::lower_bound(mortonCodes.begin() + childBegin, mortonCodes.begin() + end,
+                                                                                       childFirstMortonCode + childMortonCodeCount,
+                                                                                       [](const std::uint32_t code, const std::uint64_t value) { return code < value; })
+                                                                      - mortonCodes.begin());
+
+            this->BuildNode(node.firstChild + child, mortonCodes, childBegin, childEnd, static_cast<std::uint32_t>(childFirstMortonCode), sideChunkCount / 2u);
+            childBegin = childEnd;
+
+            // empty children have an inverted box, which doesn't change the union
+            const Node& childNode = this->m_nodes[node.firstChild + child];
+            node.boxMin.x = std::min(node.boxMin.x, childNode.boxMin.x); node.boxMax.x = std::max(node.boxMax.x, childNode.boxMax.x);
+            node.boxMin.y = std::min(node.boxMin.y, childNode.boxMin.y); node.boxMax.y = std::max(node.boxMax.y, childNode.boxMax.y);
+            node.boxMin.z = std::min(node.boxMin.z, childNode.boxMin.z); node.boxMax.z = std::max(node.boxMax.z, childNode.boxMax.z);
+        }
+    } else {
+        for (std::uint32_t i = begin; i < end; ++i) {
+            node.boxMin.x = std::min(node.boxMin.x, this->m_boxes.minX[i]); node.boxMax.x = std::max(node.boxMax.x, this->m_boxes.maxX[i]);
+            node.boxMin.y = std::min(node.boxMin.y, this->m_boxes.minY[i]); node.boxMax.y = std::max(node.boxMax.y, this->m_boxes.maxY[i]);
+            node.boxMin.z = std::min(node.boxMin.z, this->m_boxes.minZ[i]); node.boxMax.z = std::max(node.boxMax.z, this->m_boxes.maxZ[i]);
+        }
+    }
+
+    this->m_nodes[nodeIndex] = node;
+}
+
+void ChunkColumnQuadTree::Cull(const CameraFrustum& frustum, std::vector<std::uint32_t>& visibleIndices) const noexcept {
+    if (this->m_nodes.empty())
+        return;
+
+    this->m_nodeStack.clear();
+    this->m_nodeStack.push_back(0u);
+
+    while (!this->m_nodeStack.empty()) {
+        const Node& node = this->m_nodes[this->m_nodeStack.back()];
+        this->m_nodeStack.pop_back();
+
+        if (node.begin == node.end)
+            continue;
+
+        switch (frustum.ClassifyBox(node.boxMin, node.boxMax)) {
+        case FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE:
+            break;
+        case FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_INSIDE:
+            visibleIndices.insert(visibleIndices.end(), this->m_indices.begin() + node.begin, this->m_indices.begin() + node.end);
+            break;
+        case FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_INTERSECTING:
+            if (node.firstChild == NO_CHILDREN) {
+                this->m_visibleBoxes.clear();
+                CullBoxes(frustum, this->m_boxes, node.begin, node.end, this->m_visibleBoxes);
+
+                for (const std::uint32_t box : this->m_visibleBoxes)
+                    visibleIndices.push_back(this->m_indices[box]);
+            } else {
+                for (std::uint32_t child = 0u; child < 4u; ++child)
+                    this->m_nodeStack.push_back(node.firstChild + child);
+            }
+            break;
+        }
+    }
+}
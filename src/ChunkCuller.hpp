@@ -0,0 +1,92 @@
+#ifndef __MINECRAFT__CHUNK_CULLER_HPP
+#define __MINECRAFT__CHUNK_CULLER_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "Camera.hpp"
+#include "Vector.hpp"
+
+// Axis aligned boxes stored as a structure of arrays so that several of them are tested per instruction
+struct BoxesSoA {
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+
+    inline size_t GetSize() const noexcept { return this->minX.size(); }
+
+    inline void Clear() noexcept {
+        this->minX.clear(); this->minY.clear(); this->minZ.clear();
+        this->maxX.clear(); this->maxY.clear(); this->maxZ.clear();
+    }
+
+    inline void Reserve(const size_t capacity) noexcept {
+        this->minX.reserve(capacity); this->minY.reserve(capacity); this->minZ.reserve(capacity);
+        this->maxX.reserve(capacity); this->maxY.reserve(capacity); this->maxZ.reserve(capacity);
+    }
+
+    inline void PushBack(const Vec4f32& boxMin, const Vec4f32& boxMax) noexcept {
+        this->minX.push_back(boxMin.x); this->minY.push_back(boxMin.y); this->minZ.push_back(boxMin.z);
+        this->maxX.push_back(boxMax.x); this->maxY.push_back(boxMax.y); this->maxZ.push_back(boxMax.z);
+    }
+}; // struct BoxesSoA
+
+// Appends to "visibleIndices" the index of every box of [begin, end) that isn't entirely outside of the frustum.
+// Boxes are tested 8 at a time with AVX, 4 at a time with SSE, one at a time otherwise.
+void CullBoxes(const CameraFrustum& frustum, const BoxesSoA& boxes, const size_t begin, const size_t end,
+               std::vector<std::uint32_t>& visibleIndices) noexcept;
+
+// Column of blocks covered by a chunk's mesh
+struct ChunkColumnBounds {
+    ChunkCoord    location;
+    float         minY;
+    float         maxY;
+    std::uint32_t index; // reported by ChunkColumnQuadTree::Cull when the column is visible
+}; // struct ChunkColumnBounds
+
+// Quadtree over chunk columns, so that whole regions of chunks are accepted or rejected with a single box test.
+// Columns are stored in Morton order so that every node covers a contiguous range of them,
+// leaves that intersect the frustum are finished with CullBoxes.
+class ChunkColumnQuadTree {
+public:
+    // Leaves cover LEAF_SIDE_CHUNK_COUNT x LEAF_SIDE_CHUNK_COUNT columns
+    static constexpr std::uint32_t LEAF_SIDE_CHUNK_COUNT = 4;
+
+private:
+    static constexpr std::uint32_t NO_CHILDREN = 0xFFFFFFFFu;
+
+    struct Node {
+        Vec4f32       boxMin;
+        Vec4f32       boxMax;
+        std::uint32_t begin;
+        std::uint32_t end;
+        std::uint32_t firstChild; // the 4 children are contiguous, NO_CHILDREN for leaves
+    }; // struct Node
+
+    std::vector<Node> m_nodes;
+
+    // Same order as the columns
+    BoxesSoA                   m_boxes;
+    std::vector<std::uint32_t> m_indices;
+
+    // Scratch space for Cull
+    mutable std::vector<std::uint32_t> m_nodeStack;
+    mutable std::vector<std::uint32_t> m_visibleBoxes;
+
+private:
+    // Fills m_nodes[nodeIndex], which covers the Morton codes [firstMortonCode, firstMortonCode + sideChunkCount^2)
+    // and the columns [begin, end). "mortonCodes" are the sorted codes of the columns relative to the tree's origin.
+    void BuildNode(const std::uint32_t nodeIndex, const std::vector<std::uint32_t>& mortonCodes, const std::uint32_t begin, const std::uint32_t end,
+                   const std::uint32_t firstMortonCode, const std::uint32_t sideChunkCount) noexcept;
+
+public:
+    inline ChunkColumnQuadTree() noexcept = default;
+
+    void Build(const std::vector<ChunkColumnBounds>& columns) noexcept;
+
+    // Appends to "visibleIndices" the index of every column that isn't entirely outside of the frustum, in no particular order
+    void Cull(const CameraFrustum& frustum, std::vector<std::uint32_t>& visibleIndices) const noexcept;
+
+    inline size_t GetColumnCount() const noexcept { return this->m_indices.size(); }
+    inline size_t GetNodeCount()   const noexcept { return this->m_nodes.size();   }
+}; // class ChunkColumnQuadTree
+
+#endif // __MINECRAFT__CHUNK_CULLER_HPP
@@ -0,0 +1,52 @@
+#include "ChunkGrid.hpp"
+
+void ChunkGrid::SetGridOrigin(const ChunkCoord& gridOrigin) noexcept {
+    if (gridOrigin == this->m_gridOrigin)
+        return;
+
+    this->m_gridOrigin = gridOrigin;
+
+    // chunks that left the grid first, so that their slots are free for the ones entering it
+    for (std::unique_ptr<Chunk>& pChunk : this->m_pGridChunks) {
+        if (pChunk && !this->IsInGrid(pChunk->GetLocation())) {
+            const ChunkCoord cc = pChunk->GetLocation();
+            this->m_pOtherChunks.Insert(cc, std::move(pChunk));
+        }
+    }
+
+    ChunkCoord cc;
+    for (cc.idx = gridOrigin.idx; cc.idx < gridOrigin.idx + static_cast<std::int16_t>(GRID_SIDE_CHUNK_COUNT); ++cc.idx) {
+        for (cc.idz = gridOrigin.idz; cc.idz < gridOrigin.idz + static_cast<std::int16_t>(GRID_SIDE_CHUNK_COUNT); ++cc.idz) {
+            std::unique_ptr<Chunk>& pGridChunk = this->m_pGridChunks[GetGridIndex(cc)];
+
+            if (!pGridChunk && this->m_pOtherChunks.Find(cc))
+                pGridChunk = this->m_pOtherChunks.Erase(cc);
+        }
+    }
+}
+
+Chunk* ChunkGrid::Insert(std::unique_ptr<Chunk>&& pChunk) noexcept {
+    const ChunkCoord cc = pChunk->GetLocation();
+
+    if (this->IsInGrid(cc)) {
+        std::unique_ptr<Chunk>& pGridChunk = this->m_pGridChunks[GetGridIndex(cc)];
+        pGridChunk = std::move(pChunk);
+
+        return pGridChunk.get();
+    }
+
+    return this->m_pOtherChunks.Insert(cc, std::move(pChunk)).get();
+}
+
+void ChunkGrid::Erase(const ChunkCoord& cc) noexcept {
+    if (this->IsInGrid(cc)) {
+        std::unique_ptr<Chunk>& pGridChunk = this->m_pGridChunks[GetGridIndex(cc)];
+
+        if (pGridChunk && pGridChunk->GetLocation() == cc)
+            pGridChunk.reset();
+
+        return;
+    }
+
+    this->m_pOtherChunks.Erase(cc);
+}
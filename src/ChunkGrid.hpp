@@ -0,0 +1,221 @@
+#ifndef __MINECRAFT__CHUNK_GRID_HPP
+#define __MINECRAFT__CHUNK_GRID_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "Vector.hpp"
+#include "Constants.hpp"
+
+// Open addressing hash map from chunk coordinates, with linear probing and
+// backward shift deletion so that no tombstones are left behind.
+// The values are stored inline, references are invalidated by Insert and Erase.
+template <typename T>
+class FlatChunkCoordMap {
+private:
+    struct Slot {
+        ChunkCoord key;
+        T          value;
+        bool       bIsOccupied = false;
+    }; // struct Slot
+
+    std::vector<Slot> m_slots;
+    size_t            m_size = 0u;
+
+private:
+    // Chunk coordinates are small and close to each other, they are spread over the whole table
+    inline size_t GetIdealSlotIndex(const ChunkCoord& key) const noexcept {
+        const std::uint64_t packedKey = (static_cast<std::uint64_t>(static_cast<std::uint16_t>(key.idx)) << 16u) | static_cast<std::uint16_t>(key.idz);
+
+        return static_cast<size_t>((packedKey * 0x9E3779B97F4A7C15ull) >> 32u) & (this->m_slots.size() - 1u);
+    }
+
+    inline size_t FindSlotIndex(const ChunkCoord& key) const noexcept {
+        if (this->m_slots.empty())
+            return this->m_slots.size();
+
+        for (size_t slotIndex = this->GetIdealSlotIndex(key);; slotIndex = (slotIndex + 1u) & (this->m_slots.size() - 1u)) {
+            const Slot& slot = this->m_slots[slotIndex];
+
+            if (!slot.bIsOccupied)
+                return this->m_slots.size();
+
+            if (slot.key == key)
+                return slotIndex;
+        }
+    }
+
+    // The table is kept at most half full
+    void Grow() noexcept {
+        std::vector<Slot> slots(std::max<size_t>(this->m_slots.size() * 2u, 16u));
+        slots.swap(this->m_slots);
+
+        this->m_size = 0u;
+        for (Slot& slot : slots)
+            if (slot.bIsOccupied)
+                this->Insert(slot.key, std::move(slot.value));
+    }
+
+public:
+    inline size_t GetSize() const noexcept { return this->m_size; }
+
+    inline T* Find(const ChunkCoord& key) noexcept {
+        const size_t slotIndex = this->FindSlotIndex(key);
+
+        return slotIndex == this->m_slots.size() ? nullptr : &this->m_slots[slotIndex].value;
+    }
+
+    inline const T* Find(const ChunkCoord& key) const noexcept {
+        const size_t slotIndex = this->FindSlotIndex(key);
+
+        return slotIndex == this->m_slots.size() ? nullptr : &this->m_slots[slotIndex].value;
+    }
+
+    // Replaces the value if "key" is already in the map
+    T& Insert(const ChunkCoord& key, T&& value) noexcept {
+        if ((this->m_size + 1u) * 2u > this->m_slots.size())
+            this->Grow();
+
+        size_t slotIndex = this->GetIdealSlotIndex(key);
+        while (this->m_slots[slotIndex].bIsOccupied && !(this->m_slots[slotIndex].key == key))
+            slotIndex = (slotIndex + 1u) & (this->m_slots.size() - 1u);
+
+        Slot& slot = this->m_slots[slotIndex];
+        if (!slot.bIsOccupied)
+            ++this->m_size;
+
+        slot.key         = key;
+        slot.value       = std::move(value);
+        slot.bIsOccupied = true;
+
+        return slot.value;
+    }
+
+    // Returns the erased value, or a default constructed one if "key" wasn't in the map
+    T Erase(const ChunkCoord& key) noexcept {
+        size_t slotIndex = this->FindSlotIndex(key);
+        if (slotIndex == this->m_slots.size())
+            return T{  };
+
+        T value = std::move(this->m_slots[slotIndex].value);
+        --this->m_size;
+
+        // the following slots of the cluster are shifted back into the hole when that brings them closer to their ideal slot
+        const size_t mask = this->m_slots.size() - 1u;
+        for (size_t nextSlotIndex = (slotIndex + 1u) & mask;; nextSlotIndex = (nextSlotIndex + 1u) & mask) {
+            Slot& nextSlot = this->m_slots[nextSlotIndex];
+            if (!nextSlot.bIsOccupied)
+                break;
+
+            const size_t idealSlotIndex = this->GetIdealSlotIndex(nextSlot.key);
+            if (((nextSlotIndex - idealSlotIndex) & mask) >= ((nextSlotIndex - slotIndex) & mask)) {
+                this->m_slots[slotIndex] = std::move(nextSlot);
+                slotIndex = nextSlotIndex;
+            }
+        }
+
+        this->m_slots[slotIndex].value       = T{  };
+        this->m_slots[slotIndex].bIsOccupied = false;
+
+        return value;
+    }
+
+    // Keeps the table's capacity
+    inline void Clear() noexcept {
+        for (Slot& slot : this->m_slots) {
+            slot.value       = T{  };
+            slot.bIsOccupied = false;
+        }
+
+        this->m_size = 0u;
+    }
+
+    template <typename F>
+    inline void ForEach(F&& f) const noexcept {
+        for (const Slot& slot : this->m_slots)
+            if (slot.bIsOccupied)
+                f(slot.key, slot.value);
+    }
+}; // class FlatChunkCoordMap
+
+// Owns the chunks in memory.
+// The chunks around the camera live in a toroidal grid, indexed by their coordinates modulo GRID_SIDE_CHUNK_COUNT,
+// so that finding them doesn't involve any hashing. The other ones live in a FlatChunkCoordMap.
+// Chunks are never moved in memory, only their ownership is.
+class ChunkGrid {
+public:
+    // The render window is 2 * RENDER_DISTANCE + 1 chunks wide, one more chunk covers
+    // the way UpdateWorld rounds the camera's position
+    static constexpr size_t GRID_SIDE_CHUNK_COUNT = 2u * RENDER_DISTANCE + 2u;
+
+private:
+    std::array<std::unique_ptr<Chunk>, GRID_SIDE_CHUNK_COUNT * GRID_SIDE_CHUNK_COUNT> m_pGridChunks;
+
+    FlatChunkCoordMap<std::unique_ptr<Chunk>> m_pOtherChunks;
+
+    // Lowest coordinates covered by the grid
+    ChunkCoord m_gridOrigin{ 0, 0 };
+
+private:
+    inline bool IsInGrid(const ChunkCoord& cc) const noexcept {
+        return cc.idx >= this->m_gridOrigin.idx && cc.idx < this->m_gridOrigin.idx + static_cast<std::int16_t>(GRID_SIDE_CHUNK_COUNT) &&
+               cc.idz >= this->m_gridOrigin.idz && cc.idz < this->m_gridOrigin.idz + static_cast<std::int16_t>(GRID_SIDE_CHUNK_COUNT);
+    }
+
+    static inline size_t GetGridIndex(const ChunkCoord& cc) noexcept {
+        const auto Wrap = [](const std::int16_t a) {
+            const int side = static_cast<int>(GRID_SIDE_CHUNK_COUNT);
+            return static_cast<size_t>(((a % side) + side) % side);
+        };
+
+        return Wrap(cc.idx) * GRID_SIDE_CHUNK_COUNT + Wrap(cc.idz);
+    }
+
+public:
+    // Grid origin that covers the render window around "cameraPosition"
+    static inline ChunkCoord GetGridOrigin(const Vec4f32& cameraPosition) noexcept {
+        return ChunkCoord{
+            static_cast<std::int16_t>(std::floor((cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT) - RENDER_DISTANCE - 1),
+            static_cast<std::int16_t>(std::floor((cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT) - RENDER_DISTANCE - 1)
+        };
+    }
+
+    // Moves the chunks between the grid and the map when the grid covers a new area
+    void SetGridOrigin(const ChunkCoord& gridOrigin) noexcept;
+
+    inline Chunk* Find(const ChunkCoord& cc) const noexcept {
+        if (this->IsInGrid(cc)) {
+            Chunk* pChunk = this->m_pGridChunks[GetGridIndex(cc)].get();
+
+            return (pChunk && pChunk->GetLocation() == cc) ? pChunk : nullptr;
+        }
+
+        const std::unique_ptr<Chunk>* ppChunk = this->m_pOtherChunks.Find(cc);
+        return ppChunk ? ppChunk->get() : nullptr;
+    }
+
+    // Replaces the chunk with the same location if any
+    Chunk* Insert(std::unique_ptr<Chunk>&& pChunk) noexcept;
+
+    void Erase(const ChunkCoord& cc) noexcept;
+
+    inline size_t GetSize() const noexcept {
+        size_t size = this->m_pOtherChunks.GetSize();
+
+        for (const std::unique_ptr<Chunk>& pChunk : this->m_pGridChunks)
+            if (pChunk)
+                ++size;
+
+        return size;
+    }
+
+    template <typename F>
+    inline void ForEach(F&& f) const noexcept {
+        for (const std::unique_ptr<Chunk>& pChunk : this->m_pGridChunks)
+            if (pChunk)
+                f(pChunk.get());
+
+        this->m_pOtherChunks.ForEach([&f](const ChunkCoord&, const std::unique_ptr<Chunk>& pChunk) { f(pChunk.get()); });
+    }
+}; // class ChunkGrid
+
+#endif // __MINECRAFT__CHUNK_GRID_HPP
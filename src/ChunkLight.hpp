@@ -0,0 +1,66 @@
+#ifndef __MINECRAFT__CHUNK_LIGHT_HPP
+#define __MINECRAFT__CHUNK_LIGHT_HPP
+
+#include "Pch.hpp"
+#include "Constants.hpp"
+
+// A cell's light fits in a byte: the sky light in the high nibble, the block light (from emitters) in the low one
+inline std::uint8_t PackLight(const std::uint8_t skyLight, const std::uint8_t blockLight) noexcept {
+    return static_cast<std::uint8_t>((skyLight << 4u) | blockLight);
+}
+
+inline std::uint8_t GetSkyLight  (const std::uint8_t light) noexcept { return static_cast<std::uint8_t>(light >> 4u);  }
+inline std::uint8_t GetBlockLight(const std::uint8_t light) noexcept { return static_cast<std::uint8_t>(light & 0xFu); }
+
+// What the mesher shades a face with
+inline std::uint8_t GetLightLevel(const std::uint8_t light) noexcept { return std::max(GetSkyLight(light), GetBlockLight(light)); }
+
+// Under the open sky, away from any emitter
+constexpr std::uint8_t SKY_LIGHT = static_cast<std::uint8_t>((MAX_LIGHT_LEVEL << 4u) | 0u);
+
+// The light of a section's cells, indexed like its blocks (see ChunkSection::GetBlockIndex).
+// Most sections are either fully above the terrain or fully buried, so a section whose cells
+// all have the same light only stores that value and only allocates its cells once one differs
+class SectionLight {
+private:
+    std::unique_ptr<std::array<std::uint8_t, CHUNK_SECTION_BLOCK_COUNT>> m_pCells; // nullptr while every cell is m_uniformLight
+    std::uint8_t m_uniformLight = 0u;
+
+public:
+    inline explicit SectionLight(const std::uint8_t light = 0u) noexcept
+        : m_uniformLight(light)
+    {  }
+
+    inline std::uint8_t GetLight(const size_t blockIndex) const noexcept {
+        return this->m_pCells ? (*this->m_pCells)[blockIndex] : this->m_uniformLight;
+    }
+
+    inline void SetLight(const size_t blockIndex, const std::uint8_t light) noexcept {
+        if (!this->m_pCells) {
+            if (light == this->m_uniformLight)
+                return;
+
+            this->m_pCells = std::make_unique<std::array<std::uint8_t, CHUNK_SECTION_BLOCK_COUNT>>();
+            this->m_pCells->fill(this->m_uniformLight);
+        }
+
+        (*this->m_pCells)[blockIndex] = light;
+    }
+
+    inline void Fill(const std::uint8_t light) noexcept {
+        this->m_pCells.reset();
+        this->m_uniformLight = light;
+    }
+
+    // Frees the cells when they all ended up with the same light
+    inline void Compact() noexcept {
+        if (this->m_pCells && std::all_of(this->m_pCells->begin(), this->m_pCells->end(), [&](const std::uint8_t light) { return light == (*this->m_pCells)[0]; }))
+            this->Fill((*this->m_pCells)[0]);
+    }
+
+    inline bool IsUniform() const noexcept { return !this->m_pCells; }
+
+    inline size_t GetMemoryUsage() const noexcept { return this->m_pCells ? sizeof(*this->m_pCells) : 0u; }
+}; // class SectionLight
+
+#endif // __MINECRAFT__CHUNK_LIGHT_HPP
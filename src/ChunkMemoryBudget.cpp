@@ -0,0 +1,79 @@
+#include "ChunkMemoryBudget.hpp"
+
+void ChunkMemoryBudget::Enforce(ChunkGrid& chunkGrid, ChunkStorage& storage, const std::function<bool(const Chunk&)>& hasPendingJob,
+                                const std::function<bool(const Chunk&)>& isEvictable) noexcept {
+    size_t memoryUsage = 0u;
+    std::vector<Chunk*> pCandidates;
+
+    this->m_stats.nPendingChunks = 0u;
+
+    chunkGrid.ForEach([&](Chunk* pChunk) {
+        // their sections and light may be reallocated by the job right now, their blocks are counted once it's done
+        if (hasPendingJob(*pChunk)) {
+            memoryUsage += sizeof(Chunk);
+            ++this->m_stats.nPendingChunks;
+            return;
+        }
+
+        memoryUsage += GetChunkMemoryUsage(*pChunk);
+
+        if (isEvictable(*pChunk))
+            pCandidates.push_back(pChunk);
+    });
+
+    if (memoryUsage > this->m_budget) {
+        std::sort(pCandidates.begin(), pCandidates.end(), [](const Chunk* pA, const Chunk* pB) {
+            return pA->GetLastUsedFrame() < pB->GetLastUsedFrame();
+        });
+
+        // compressing is cheap to undo, so every candidate is compressed before any is removed
+        for (Chunk* pChunk : pCandidates) {
+            if (memoryUsage <= this->m_budget)
+                break;
+
+            if (pChunk->IsCompressed())
+                continue;
+
+            const size_t previousMemoryUsage = GetChunkMemoryUsage(*pChunk);
+            pChunk->Compress();
+            memoryUsage = memoryUsage - previousMemoryUsage + GetChunkMemoryUsage(*pChunk);
+        }
+
+        std::vector<Chunk*> pEvictedChunks;
+        for (Chunk* pChunk : pCandidates) {
+            if (memoryUsage <= this->m_budget)
+                break;
+
+            memoryUsage -= GetChunkMemoryUsage(*pChunk);
+            pEvictedChunks.push_back(pChunk);
+        }
+
+        // all the dirty chunks are saved in one go, those that couldn't be saved stay in memory
+        std::vector<Chunk*> pDirtyChunks;
+        for (Chunk* pChunk : pEvictedChunks)
+            if (pChunk->IsDirty())
+                pDirtyChunks.push_back(pChunk);
+
+        if (!pDirtyChunks.empty())
+            storage.SaveChunks(pDirtyChunks);
+
+        for (Chunk* pChunk : pEvictedChunks) {
+            if (pChunk->IsDirty()) {
+                memoryUsage += GetChunkMemoryUsage(*pChunk);
+                continue;
+            }
+
+            chunkGrid.Erase(pChunk->GetLocation());
+            ++this->m_stats.nEvictedChunks;
+        }
+    }
+
+    this->m_stats.nResidentChunks   = 0u;
+    this->m_stats.nCompressedChunks = 0u;
+    this->m_stats.memoryUsage       = memoryUsage;
+
+    chunkGrid.ForEach([this, &hasPendingJob](const Chunk* pChunk) {
+        if (!hasPendingJob(*pChunk))
+            ++(pChunk->IsCompressed() ? this->m_stats.nCompressedChunks : this->m_stats.nResidentChunks);
+    });
+}
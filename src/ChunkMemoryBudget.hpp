@@ -0,0 +1,53 @@
+#ifndef __MINECRAFT__CHUNK_MEMORY_BUDGET_HPP
+#define __MINECRAFT__CHUNK_MEMORY_BUDGET_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "ChunkGrid.hpp"
+#include "ChunkStorage.hpp"
+
+struct ChunkMemoryStats {
+    size_t nResidentChunks   = 0u; // blocks stored in sections
+    size_t nCompressedChunks = 0u;
+    size_t nPendingChunks    = 0u; // that a job may be writing, see Enforce
+    size_t nEvictedChunks    = 0u; // since the beginning, saved and removed from memory
+
+    size_t memoryUsage = 0u; // in bytes, for every chunk in memory. The blocks of the pending chunks aren't counted
+}; // struct ChunkMemoryStats
+
+// Keeps the chunks under a memory budget by first compressing, then saving and removing,
+// the least recently used ones
+class ChunkMemoryBudget {
+private:
+    size_t m_budget;
+
+    ChunkMemoryStats m_stats;
+
+private:
+    static inline size_t GetChunkMemoryUsage(const Chunk& chunk) noexcept {
+        return sizeof(Chunk) + chunk.GetBlockMemoryUsage();
+    }
+
+public:
+    static constexpr size_t DEFAULT_BUDGET = 64u * 1024u * 1024u;
+
+    inline explicit ChunkMemoryBudget(const size_t budget = DEFAULT_BUDGET) noexcept
+        : m_budget(budget)
+    {  }
+
+    inline size_t GetBudget() const noexcept { return this->m_budget; }
+
+    inline void SetBudget(const size_t budget) noexcept { this->m_budget = budget; }
+
+    // As of the last call to Enforce
+    inline const ChunkMemoryStats& GetStats() const noexcept { return this->m_stats; }
+
+    // Only the chunks for which "isEvictable" returns true are compressed or removed,
+    // the removed chunks are saved to "storage" first if they are dirty.
+    // A job may be generating, loading or lighting the chunks for which "hasPendingJob" returns true: nothing
+    // of theirs but their location is read, "isEvictable" isn't called for them and they are left as they are
+    void Enforce(ChunkGrid& chunkGrid, ChunkStorage& storage, const std::function<bool(const Chunk&)>& hasPendingJob,
+                 const std::function<bool(const Chunk&)>& isEvictable) noexcept;
+}; // class ChunkMemoryBudget
+
+#endif // __MINECRAFT__CHUNK_MEMORY_BUDGET_HPP
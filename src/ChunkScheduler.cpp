@@ -0,0 +1,76 @@
+#include "ChunkScheduler.hpp"
+
+static bool IsRequestLessUrgent(const ChunkRequest& lhs, const ChunkRequest& rhs) noexcept {
+    return lhs.priority > rhs.priority;
+}
+
+void ChunkScheduler::Request(const ChunkCoord& location, const CHUNK_REQUEST_TYPE type) noexcept {
+    if (!this->m_requests.insert({ location, type }).second)
+        return;
+
+    this->m_queue.push_back(ChunkRequest{ location, type, this->ComputePriority(location) });
+    std::push_heap(this->m_queue.begin(), this->m_queue.end(), IsRequestLessUrgent);
+}
+
+float ChunkScheduler::ComputePriority(const ChunkCoord& location) const noexcept {
+    const Vec4f32 predictedPosition = this->m_cameraPosition + this->m_cameraVelocity * PREDICTION_UPDATE_COUNT;
+
+    // from the predicted camera position to the chunk's center, in chunks
+    const Vec4f32 toChunk = {
+        (static_cast<float>(location.idx) + 0.5f) - predictedPosition.x / CHUNK_X_LENGTH,
+        0.f,
+        (static_cast<float>(location.idz) + 0.5f) - predictedPosition.z / CHUNK_Z_LENGTH,
+        0.f
+    };
+
+    const float distance = toChunk.GetLength3D();
+    if (distance < NEAR_DISTANCE)
+        return distance;
+
+    const Vec4f32 forward = Vec4f32{ this->m_cameraForward.x, 0.f, this->m_cameraForward.z, 0.f };
+    const float   forwardLength = forward.GetLength3D();
+
+    // looking straight up or down: every direction is as good as the others
+    if (forwardLength < 0.0001f)
+        return distance;
+
+    // 0 when the chunk is straight ahead, 1 when it is right behind
+    const float angleFactor = (1.f - DotProduct3D(forward, toChunk) / (forwardLength * distance)) * 0.5f;
+
+    return distance * (1.f + (BEHIND_CAMERA_PENALTY - 1.f) * angleFactor);
+}
+
+void ChunkScheduler::Update(const Vec4f32& cameraPosition, const Vec4f32& cameraForward) noexcept {
+    this->m_cameraVelocity     = this->m_bHasCameraPosition ? cameraPosition - this->m_cameraPosition : Vec4f32{};
+    this->m_cameraPosition     = cameraPosition;
+    this->m_cameraForward      = cameraForward;
+    this->m_bHasCameraPosition = true;
+
+    this->m_queue.clear();
+
+    for (auto it = this->m_requests.begin(); it != this->m_requests.end(); ) {
+        if (!IsChunkInRenderWindow(it->first, cameraPosition)) {
+            it = this->m_requests.erase(it);
+            ++this->m_nCancelledRequests;
+            continue;
+        }
+
+        this->m_queue.push_back(ChunkRequest{ it->first, it->second, this->ComputePriority(it->first) });
+        ++it;
+    }
+
+    std::make_heap(this->m_queue.begin(), this->m_queue.end(), IsRequestLessUrgent);
+}
+
+std::optional<ChunkRequest> ChunkScheduler::PopNext() noexcept {
+    if (this->m_queue.empty())
+        return {  };
+
+    std::pop_heap(this->m_queue.begin(), this->m_queue.end(), IsRequestLessUrgent);
+
+    const ChunkRequest request = this->m_queue.back();
+    this->m_queue.pop_back();
+    this->m_requests.erase(request.location);
+
+    return request;
+}
@@ -0,0 +1,68 @@
+#ifndef __MINECRAFT__CHUNK_SCHEDULER_HPP
+#define __MINECRAFT__CHUNK_SCHEDULER_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "Vector.hpp"
+
+enum class CHUNK_REQUEST_TYPE : std::uint8_t {
+    CHUNK_REQUEST_TYPE_GENERATE = 0u, // generate the blocks, then build the mesh
+    CHUNK_REQUEST_TYPE_MESH           // the blocks are there, only build the mesh
+}; // enum class CHUNK_REQUEST_TYPE
+
+struct ChunkRequest {
+    ChunkCoord         location;
+    CHUNK_REQUEST_TYPE type;
+    float              priority; // lower is more urgent
+}; // struct ChunkRequest
+
+// Holds the chunk requests that haven't been handed to the job system yet.
+// Requests are ordered by how soon the camera is going to see the chunk:
+// the distance to where the camera is heading and the angle to where it is looking at.
+// Requests for chunks that left the render window are dropped before costing any work.
+class ChunkScheduler {
+private:
+    ChunkCoordMap<CHUNK_REQUEST_TYPE> m_requests;
+
+    // min-heap on priority, rebuilt by Update
+    std::vector<ChunkRequest> m_queue;
+
+    Vec4f32 m_cameraPosition;
+    Vec4f32 m_cameraForward = {0.f, 0.f, 1.f, 0.f};
+    Vec4f32 m_cameraVelocity; // in blocks per update
+    bool    m_bHasCameraPosition = false;
+
+    size_t m_nCancelledRequests = 0u;
+
+public:
+    // How many updates ahead the camera's position is predicted
+    static constexpr float PREDICTION_UPDATE_COUNT = 30.f;
+
+    // A chunk right behind the camera is treated as if it were this many times further away
+    static constexpr float BEHIND_CAMERA_PENALTY = 3.f;
+
+    // Chunks closer than this (in chunks) are urgent whatever the camera is looking at
+    static constexpr float NEAR_DISTANCE = 2.f;
+
+public:
+    inline ChunkScheduler() noexcept = default;
+
+    inline bool IsRequested(const ChunkCoord& location) const noexcept { return this->m_requests.find(location) != this->m_requests.end(); }
+
+    inline size_t GetRequestCount()          const noexcept { return this->m_requests.size();     }
+    inline size_t GetCancelledRequestCount() const noexcept { return this->m_nCancelledRequests; }
+
+    inline Vec4f32 GetCameraVelocity() const noexcept { return this->m_cameraVelocity; }
+
+    // Does nothing if the chunk is already requested
+    void Request(const ChunkCoord& location, const CHUNK_REQUEST_TYPE type) noexcept;
+
+    float ComputePriority(const ChunkCoord& location) const noexcept;
+
+    // Tracks the camera, drops the requests outside of the render window and reorders the others
+    void Update(const Vec4f32& cameraPosition, const Vec4f32& cameraForward) noexcept;
+
+    std::optional<ChunkRequest> PopNext() noexcept;
+}; // class ChunkScheduler
+
+#endif // __MINECRAFT__CHUNK_SCHEDULER_HPP
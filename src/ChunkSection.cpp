@@ -0,0 +1,219 @@
+#include "ChunkSection.hpp"
+
+void ChunkSection::Repack(const std::uint8_t bitsPerIndex) noexcept {
+    std::vector<std::uint64_t> packedIndices(CHUNK_SECTION_BLOCK_COUNT * bitsPerIndex / 64u, 0u);
+
+    for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex) {
+        const size_t paletteIndex = (this->m_bitsPerIndex == 0u) ? 0u : this->GetPaletteIndex(blockIndex);
+        const size_t bitIndex     = blockIndex * bitsPerIndex;
+
+        packedIndices[bitIndex / 64u] |= static_cast<std::uint64_t>(paletteIndex) << (bitIndex % 64u);
+    }
+
+    this->m_packedIndices = std::move(packedIndices);
+    this->m_bitsPerIndex  = bitsPerIndex;
+}
+
+void ChunkSection::SetBlock(const size_t blockIndex, const BLOCK_TYPE& type) noexcept {
+    const BLOCK_TYPE previousType = this->GetBlock(blockIndex);
+    if (previousType == type)
+        return;
+
+    if (previousType == BLOCK_TYPE::BLOCK_TYPE_AIR) ++this->m_nNonAirBlocks;
+    if (type         == BLOCK_TYPE::BLOCK_TYPE_AIR) --this->m_nNonAirBlocks;
+
+    this->SetPaletteIndex(blockIndex, this->FindOrAddPaletteEntry(type));
+
+    // only clearing a column's last opaque block needs a scan
+    const size_t column = blockIndex / CHUNK_SECTION_Y_BLOCK_COUNT;
+
+    if (IsBlockOpaque(type))
+        this->m_opaqueColumns[column / 64u] |= std::uint64_t(1u) << (column % 64u);
+    else if (IsBlockOpaque(previousType))
+        this->UpdateOpaqueColumn(column);
+}
+
+void ChunkSection::UpdateOpaqueColumn(const size_t column) noexcept {
+    bool bHasOpaqueBlock = false;
+    for (size_t y = 0u; y < CHUNK_SECTION_Y_BLOCK_COUNT && !bHasOpaqueBlock; ++y)
+        bHasOpaqueBlock = IsBlockOpaque(this->GetBlock(column * CHUNK_SECTION_Y_BLOCK_COUNT + y));
+
+    const std::uint64_t bit = std::uint64_t(1u) << (column % 64u);
+    this->m_opaqueColumns[column / 64u] = bHasOpaqueBlock ? (this->m_opaqueColumns[column / 64u] | bit) : (this->m_opaqueColumns[column / 64u] & ~bit);
+}
+
+size_t ChunkSection::FindOrAddPaletteEntry(const BLOCK_TYPE& type) noexcept {
+    const size_t paletteIndex = static_cast<size_t>(std::find(this->m_palette.begin(), this->m_palette.end(), type) - this->m_palette.begin());
+
+    if (paletteIndex == this->m_palette.size()) {
+        // 1 -> 2 -> 4 -> 8 bits so that an index never straddles two words
+        if (this->m_palette.size() >= (size_t(1u) << this->m_bitsPerIndex))
+            this->Repack(this->m_bitsPerIndex == 0u ? 1u : this->m_bitsPerIndex * 2u);
+
+        this->m_palette.push_back(type);
+    }
+
+    return paletteIndex;
+}
+
+void ChunkSection::FillRun(const size_t firstBlockIndex, const size_t nBlocks, const BLOCK_TYPE& type) noexcept {
+    if (nBlocks == CHUNK_SECTION_BLOCK_COUNT) {
+        this->Fill(type);
+        return;
+    }
+
+    if (this->m_bitsPerIndex == 0u && this->m_palette[0] == type)
+        return;
+
+    const size_t paletteIndex = this->FindOrAddPaletteEntry(type);
+
+    for (size_t blockIndex = firstBlockIndex; blockIndex < firstBlockIndex + nBlocks; ++blockIndex) {
+        const bool bWasAir = this->m_palette[this->GetPaletteIndex(blockIndex)] == BLOCK_TYPE::BLOCK_TYPE_AIR;
+
+        if (bWasAir && type != BLOCK_TYPE::BLOCK_TYPE_AIR) ++this->m_nNonAirBlocks;
+        if (!bWasAir && type == BLOCK_TYPE::BLOCK_TYPE_AIR) --this->m_nNonAirBlocks;
+
+        this->SetPaletteIndex(blockIndex, paletteIndex);
+    }
+
+    for (size_t column = firstBlockIndex / CHUNK_SECTION_Y_BLOCK_COUNT; column <= (firstBlockIndex + nBlocks - 1u) / CHUNK_SECTION_Y_BLOCK_COUNT; ++column)
+        this->UpdateOpaqueColumn(column);
+}
+
+void ChunkSection::Assign(const std::array<BLOCK_TYPE, CHUNK_SECTION_BLOCK_COUNT>& blocks) noexcept {
+    // the palette is built first so that the indices are packed only once
+    std::array<std::uint8_t, static_cast<size_t>(BLOCK_TYPE::_COUNT)> paletteIndices;
+    paletteIndices.fill(0xFFu);
+
+    // the types present are only flagged, the palette then takes them in the order they first appear.
+    // Counting them instead would chain each block's increment to the previous one's
+    std::array<bool, 256u> bIsTypePresent{};
+    for (const BLOCK_TYPE& type : blocks)
+        bIsTypePresent[static_cast<size_t>(type)] = true;
+
+    const size_t nTypes = static_cast<size_t>(std::count(bIsTypePresent.begin(), bIsTypePresent.end(), true));
+    const size_t nAir   = static_cast<size_t>(std::count(blocks.begin(), blocks.end(), BLOCK_TYPE::BLOCK_TYPE_AIR));
+
+    this->m_palette.clear();
+    this->m_nNonAirBlocks = CHUNK_SECTION_BLOCK_COUNT - nAir;
+
+    for (size_t blockIndex = 0u; this->m_palette.size() < nTypes; ++blockIndex) {
+        std::uint8_t& paletteIndex = paletteIndices[static_cast<size_t>(blocks[blockIndex])];
+
+        if (paletteIndex == 0xFFu) {
+            paletteIndex = static_cast<std::uint8_t>(this->m_palette.size());
+            this->m_palette.push_back(blocks[blockIndex]);
+        }
+    }
+
+    if (this->m_palette.size() == 1u) {
+        this->Fill(this->m_palette[0]);
+        return;
+    }
+
+    std::array<bool, static_cast<size_t>(BLOCK_TYPE::_COUNT)> bIsTypeOpaque;
+    for (size_t type = 0u; type < bIsTypeOpaque.size(); ++type)
+        bIsTypeOpaque[type] = IsBlockOpaque(static_cast<BLOCK_TYPE>(type));
+
+    this->m_opaqueColumns.fill(0u);
+    for (size_t column = 0u; column < COLUMN_COUNT; ++column) {
+        const BLOCK_TYPE* pColumnBlocks = blocks.data() + column * CHUNK_SECTION_Y_BLOCK_COUNT;
+
+        bool bHasOpaqueBlock = false;
+        for (size_t y = 0u; y < CHUNK_SECTION_Y_BLOCK_COUNT; ++y)
+            bHasOpaqueBlock |= bIsTypeOpaque[static_cast<size_t>(pColumnBlocks[y])];
+
+        this->m_opaqueColumns[column / 64u] |= static_cast<std::uint64_t>(bHasOpaqueBlock) << (column % 64u);
+    }
+
+    std::uint8_t bitsPerIndex = 1u;
+    while ((size_t(1u) << bitsPerIndex) < this->m_palette.size())
+        bitsPerIndex *= 2u;
+
+    this->m_bitsPerIndex = bitsPerIndex;
+    this->m_packedIndices.resize(CHUNK_SECTION_BLOCK_COUNT * bitsPerIndex / 64u);
+
+    // each word is packed in a register, the indices never straddle two words
+    const size_t indicesPerWord = 64u / bitsPerIndex;
+
+    for (size_t word = 0u; word < this->m_packedIndices.size(); ++word) {
+        const BLOCK_TYPE* pBlocks = blocks.data() + word * indicesPerWord;
+
+        std::uint64_t packed = 0u;
+        for (size_t i = 0u; i < indicesPerWord; ++i)
+            packed |= static_cast<std::uint64_t>(paletteIndices[static_cast<size_t>(pBlocks[i])]) << (i * bitsPerIndex);
+
+        this->m_packedIndices[word] = packed;
+    }
+}
+
+void ChunkSection::Fill(const BLOCK_TYPE& type) noexcept {
+    this->m_palette.assign(1u, type);
+    this->m_packedIndices.clear();
+    this->m_packedIndices.shrink_to_fit();
+    this->m_bitsPerIndex  = 0u;
+    this->m_nNonAirBlocks = (type == BLOCK_TYPE::BLOCK_TYPE_AIR) ? 0u : CHUNK_SECTION_BLOCK_COUNT;
+    this->m_opaqueColumns.fill(IsBlockOpaque(type) ? ~std::uint64_t(0u) : 0u);
+}
+
+SectionConnectivity ChunkSection::ComputeConnectivity() const noexcept {
+    if (this->IsUniform())
+        return SectionConnectivity(IsBlockOpaque(this->m_palette[0]) ? 0u : SectionConnectivity::ALL_FACE_PAIRS);
+
+    static_assert(CHUNK_X_BLOCK_COUNT == 16 && CHUNK_Z_BLOCK_COUNT == 16 && CHUNK_SECTION_Y_BLOCK_COUNT == 16,
+                  "Block indices are decoded with shifts and masks");
+
+    // opaque blocks are marked as visited from the start
+    std::array<bool, CHUNK_SECTION_BLOCK_COUNT> bIsVisited;
+    for (size_t blockIndex = 0u; blockIndex < CHUNK_SECTION_BLOCK_COUNT; ++blockIndex)
+        bIsVisited[blockIndex] = IsBlockOpaque(this->GetBlock(blockIndex));
+
+    SectionConnectivity connectivity;
+
+    std::vector<std::uint16_t> stack;
+    stack.reserve(CHUNK_SECTION_BLOCK_COUNT);
+
+    for (size_t seedIndex = 0u; seedIndex < CHUNK_SECTION_BLOCK_COUNT; ++seedIndex) {
+        if (bIsVisited[seedIndex])
+            continue;
+
+        // faces reached by the region of "seedIndex", one bit per BLOCK_FACE
+        std::uint8_t faces = 0u;
+
+        bIsVisited[seedIndex] = true;
+        stack.push_back(static_cast<std::uint16_t>(seedIndex));
+
+        while (!stack.empty()) {
+            const size_t blockIndex = stack.back();
+            stack.pop_back();
+
+            const size_t x = blockIndex >> 8u;
+            const size_t z = (blockIndex >> 4u) & 15u;
+            const size_t y = blockIndex & 15u;
+
+            const auto Visit = [&bIsVisited, &stack](const size_t neighbourIndex) {
+                if (!bIsVisited[neighbourIndex]) {
+                    bIsVisited[neighbourIndex] = true;
+                    stack.push_back(static_cast<std::uint16_t>(neighbourIndex));
+                }
+            };
+
+            if (x == 0u)  faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_LEFT);   else Visit(blockIndex - 256u);
+            if (x == 15u) faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_RIGHT);  else Visit(blockIndex + 256u);
+            if (z == 0u)  faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_FRONT);  else Visit(blockIndex - 16u);
+            if (z == 15u) faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_BACK);   else Visit(blockIndex + 16u);
+            if (y == 0u)  faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_BOTTOM); else Visit(blockIndex - 1u);
+            if (y == 15u) faces |= 1u << static_cast<size_t>(BLOCK_FACE::BLOCK_FACE_TOP);    else Visit(blockIndex + 1u);
+        }
+
+        for (size_t a = 0u; a < static_cast<size_t>(BLOCK_FACE::_COUNT); ++a)
+            for (size_t b = a + 1u; b < static_cast<size_t>(BLOCK_FACE::_COUNT); ++b)
+                if ((faces & (1u << a)) && (faces & (1u << b)))
+                    connectivity.ConnectFaces(static_cast<BLOCK_FACE>(a), static_cast<BLOCK_FACE>(b));
+
+        if (connectivity.GetFacePairs() == SectionConnectivity::ALL_FACE_PAIRS)
+            break;
+    }
+
+    return connectivity;
+}
@@ -0,0 +1,149 @@
+#ifndef __MINECRAFT__CHUNK_SECTION_HPP
+#define __MINECRAFT__CHUNK_SECTION_HPP
+
+#include "Pch.hpp"
+#include "Block.hpp"
+#include "Constants.hpp"
+
+// Which faces of a section (see BLOCK_FACE) are connected to each other through its non-opaque blocks, one bit per pair of faces
+class SectionConnectivity {
+private:
+    std::uint16_t m_facePairs = 0u;
+
+private:
+    // The 15 pairs (a, b) with a < b are numbered in lexicographic order
+    static inline std::uint16_t GetFacePairBit(const BLOCK_FACE& a, const BLOCK_FACE& b) noexcept {
+        const size_t i = std::min(static_cast<size_t>(a), static_cast<size_t>(b));
+        const size_t j = std::max(static_cast<size_t>(a), static_cast<size_t>(b));
+
+        return static_cast<std::uint16_t>(1u << (i * (11u - i) / 2u + j - i - 1u));
+    }
+
+public:
+    static constexpr std::uint16_t ALL_FACE_PAIRS = 0x7FFFu;
+
+    inline SectionConnectivity() noexcept = default;
+
+    inline explicit SectionConnectivity(const std::uint16_t facePairs) noexcept
+        : m_facePairs(facePairs)
+    {  }
+
+    // A face is always connected to itself
+    inline bool AreFacesConnected(const BLOCK_FACE& a, const BLOCK_FACE& b) const noexcept {
+        return a == b || (this->m_facePairs & GetFacePairBit(a, b)) != 0u;
+    }
+
+    inline void ConnectFaces(const BLOCK_FACE& a, const BLOCK_FACE& b) noexcept {
+        if (a != b)
+            this->m_facePairs |= GetFacePairBit(a, b);
+    }
+
+    inline std::uint16_t GetFacePairs() const noexcept { return this->m_facePairs; }
+
+    inline bool operator==(const SectionConnectivity& rhs) const noexcept { return this->m_facePairs == rhs.m_facePairs; }
+}; // class SectionConnectivity
+
+// A 16x16x16 slice of a chunk's blocks.
+// A section filled with a single block type only stores that type. Otherwise every
+// block is an index in a small palette of the section's block types, packed on
+// 1, 2, 4 or 8 bits depending on the palette's size.
+// The columns that hold an opaque block are tracked in a bitmask, so that rays (see BlockRaycast.hpp) skip the others whole.
+class ChunkSection {
+public:
+    static constexpr size_t COLUMN_COUNT = CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT;
+
+    // One bit per column, column x * CHUNK_Z_BLOCK_COUNT + z is bit (column % 64) of word (column / 64)
+    using ColumnMask = std::array<std::uint64_t, COLUMN_COUNT / 64u>;
+
+private:
+    std::vector<BLOCK_TYPE>    m_palette;
+    std::vector<std::uint64_t> m_packedIndices;
+    std::uint8_t               m_bitsPerIndex  = 0u; // 0 when the whole section is m_palette[0]
+    std::uint16_t              m_nNonAirBlocks = 0u;
+    ColumnMask                 m_opaqueColumns{};
+
+private:
+    inline size_t GetPaletteIndex(const size_t blockIndex) const noexcept {
+        const size_t bitIndex = blockIndex * this->m_bitsPerIndex;
+
+        return static_cast<size_t>((this->m_packedIndices[bitIndex / 64u] >> (bitIndex % 64u)) & ((std::uint64_t(1u) << this->m_bitsPerIndex) - 1u));
+    }
+
+    inline void SetPaletteIndex(const size_t blockIndex, const size_t paletteIndex) noexcept {
+        const size_t        bitIndex = blockIndex * this->m_bitsPerIndex;
+        const std::uint64_t mask     = ((std::uint64_t(1u) << this->m_bitsPerIndex) - 1u) << (bitIndex % 64u);
+
+        std::uint64_t& word = this->m_packedIndices[bitIndex / 64u];
+        word = (word & ~mask) | (static_cast<std::uint64_t>(paletteIndex) << (bitIndex % 64u));
+    }
+
+    // Stores every index on "bitsPerIndex" bits instead
+    void Repack(const std::uint8_t bitsPerIndex) noexcept;
+
+    // Adds "type" to the palette if needed, repacking the indices when they get too small
+    size_t FindOrAddPaletteEntry(const BLOCK_TYPE& type) noexcept;
+
+    // Rescans the column's blocks for m_opaqueColumns
+    void UpdateOpaqueColumn(const size_t column) noexcept;
+
+public:
+    inline explicit ChunkSection(const BLOCK_TYPE& type = BLOCK_TYPE::BLOCK_TYPE_AIR) noexcept {
+        this->Fill(type);
+    }
+
+    // (x, y, z) are relative to the section.
+    // Columns are contiguous so that a vertical run of blocks is a contiguous run of indices
+    static inline size_t GetBlockIndex(const size_t x, const size_t y, const size_t z) noexcept {
+        return (x * CHUNK_Z_BLOCK_COUNT + z) * CHUNK_SECTION_Y_BLOCK_COUNT + y;
+    }
+
+    inline BLOCK_TYPE GetBlock(const size_t blockIndex) const noexcept {
+        if (this->m_bitsPerIndex == 0u)
+            return this->m_palette[0];
+
+        return this->m_palette[this->GetPaletteIndex(blockIndex)];
+    }
+
+    void SetBlock(const size_t blockIndex, const BLOCK_TYPE& type) noexcept;
+
+    // Sets the blocks [firstBlockIndex, firstBlockIndex + nBlocks) to "type"
+    void FillRun(const size_t firstBlockIndex, const size_t nBlocks, const BLOCK_TYPE& type) noexcept;
+
+    // Replaces every block at once, in block index order
+    void Assign(const std::array<BLOCK_TYPE, CHUNK_SECTION_BLOCK_COUNT>& blocks) noexcept;
+
+    // Turns the section back into a single block type section
+    void Fill(const BLOCK_TYPE& type) noexcept;
+
+    // Flood fills the section's non-opaque blocks to find which faces can see each other
+    SectionConnectivity ComputeConnectivity() const noexcept;
+
+    inline bool IsEmpty() const noexcept { return this->m_nNonAirBlocks == 0u; }
+
+    // (x, z) are relative to the section
+    inline bool HasOpaqueBlockInColumn(const size_t x, const size_t z) const noexcept {
+        const size_t column = x * CHUNK_Z_BLOCK_COUNT + z;
+        return (this->m_opaqueColumns[column / 64u] >> (column % 64u)) & 1u;
+    }
+
+    inline bool HasOpaqueBlocks() const noexcept {
+        return std::any_of(this->m_opaqueColumns.begin(), this->m_opaqueColumns.end(), [](const std::uint64_t word) { return word != 0u; });
+    }
+
+    inline const ColumnMask& GetOpaqueColumns() const noexcept { return this->m_opaqueColumns; }
+
+    inline bool IsUniform() const noexcept { return this->m_bitsPerIndex == 0u; }
+
+    inline size_t GetPaletteSize() const noexcept { return this->m_palette.size(); }
+
+    // May be true for a type that was since overwritten, the palette only shrinks on Fill and Assign
+    inline bool MayContain(const BLOCK_TYPE& type) const noexcept {
+        return std::find(this->m_palette.begin(), this->m_palette.end(), type) != this->m_palette.end();
+    }
+
+    inline size_t GetMemoryUsage() const noexcept {
+        return sizeof(ChunkSection) + this->m_palette.capacity() * sizeof(BLOCK_TYPE) + this->m_packedIndices.capacity() * sizeof(std::uint64_t);
+    }
+}; // class ChunkSection
+
+#endif // __MINECRAFT__CHUNK_SECTION_HPP
@@ -0,0 +1,43 @@
+#include "ChunkStorage.hpp"
+
+ChunkStorage::ChunkStorage(const std::filesystem::path& directory) noexcept
+    : m_directory(directory)
+{
+    std::error_code errorCode;
+    std::filesystem::create_directories(this->m_directory, errorCode);
+}
+
+RegionFile& ChunkStorage::GetRegionFile(const ChunkCoord& regionCoord) noexcept {
+    std::unique_ptr<RegionFile>& pRegionFile = this->m_pRegionFiles[regionCoord];
+
+    if (!pRegionFile) {
+        const std::string fileName = "r." + std::to_string(regionCoord.idx) + "." + std::to_string(regionCoord.idz) + ".mcr";
+
+        pRegionFile = std::make_unique<RegionFile>(this->m_directory / fileName);
+    }
+
+    return *pRegionFile;
+}
+
+bool ChunkStorage::LoadChunk(Chunk& chunk) noexcept {
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    return this->GetRegionFile(RegionFile::GetRegionCoord(chunk.GetLocation())).ReadChunk(chunk);
+}
+
+void ChunkStorage::SaveChunks(const std::vector<Chunk*>& pChunks) noexcept {
+    ChunkCoordMap<std::vector<Chunk*>> pChunksByRegion;
+    for (Chunk* pChunk : pChunks)
+        pChunksByRegion[RegionFile::GetRegionCoord(pChunk->GetLocation())].push_back(pChunk);
+
+    std::lock_guard<std::mutex> lock(this->m_mutex);
+
+    for (const auto& [regionCoord, pRegionChunks] : pChunksByRegion) {
+        // the chunks stay dirty when the file couldn't be written, they will be saved again later
+        if (!this->GetRegionFile(regionCoord).WriteChunks(std::vector<const Chunk*>(pRegionChunks.begin(), pRegionChunks.end())))
+            continue;
+
+        for (Chunk* pChunk : pRegionChunks)
+            pChunk->m_bIsDirty = false;
+    }
+}
@@ -0,0 +1,33 @@
+#ifndef __MINECRAFT__CHUNK_STORAGE_HPP
+#define __MINECRAFT__CHUNK_STORAGE_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "RegionFile.hpp"
+
+// Saves chunks to, and loads them from, the region files of a directory.
+// Can be used from any thread.
+class ChunkStorage {
+private:
+    std::filesystem::path m_directory;
+
+    std::mutex m_mutex;
+
+    // Opened on first use, by region location
+    ChunkCoordMap<std::unique_ptr<RegionFile>> m_pRegionFiles;
+
+private:
+    // m_mutex must be locked
+    RegionFile& GetRegionFile(const ChunkCoord& regionCoord) noexcept;
+
+public:
+    explicit ChunkStorage(const std::filesystem::path& directory) noexcept;
+
+    // Returns false when the chunk was never saved, it should be generated instead
+    bool LoadChunk(Chunk& chunk) noexcept;
+
+    // Each region file is rewritten once for all of its chunks, the saved chunks aren't dirty anymore
+    void SaveChunks(const std::vector<Chunk*>& pChunks) noexcept;
+}; // class ChunkStorage
+
+#endif // __MINECRAFT__CHUNK_STORAGE_HPP
@@ -8,9 +8,19 @@ constexpr int         CHUNK_Y_BLOCK_COUNT = 255;
 constexpr int         CHUNK_Z_BLOCK_COUNT = 16;
 constexpr float       BLOCK_LENGTH        = 1.f;
 constexpr std::size_t TEXTURE_SIDE_LENGTH = 16u; // in pixels
+constexpr int         MAX_LIGHT_LEVEL     = 15;
+constexpr int         SEA_LEVEL           = CHUNK_Y_BLOCK_COUNT / 5; // the top layer of water, the shores up to it are sand
 
 constexpr int RENDER_DISTANCE = 10; // in chunks
 
+// How much of what is behind them translucent blocks hide, the texture atlas has no alpha channel
+constexpr float TRANSLUCENT_BLOCK_OPACITY = 0.6f;
+
+// Chunks are stored as a stack of sections, the last one being only partially used
+constexpr int CHUNK_SECTION_Y_BLOCK_COUNT = 16;
+constexpr int CHUNK_SECTION_COUNT         = (CHUNK_Y_BLOCK_COUNT + CHUNK_SECTION_Y_BLOCK_COUNT - 1) / CHUNK_SECTION_Y_BLOCK_COUNT;
+constexpr int CHUNK_SECTION_BLOCK_COUNT   = CHUNK_X_BLOCK_COUNT * CHUNK_SECTION_Y_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT;
+
 // Meta constants
 constexpr float CHUNK_X_LENGTH = CHUNK_X_BLOCK_COUNT * BLOCK_LENGTH;
 constexpr float CHUNK_Y_LENGTH = CHUNK_Y_BLOCK_COUNT * BLOCK_LENGTH;
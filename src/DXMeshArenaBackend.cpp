@@ -0,0 +1,47 @@
+#include "DXMeshArenaBackend.hpp"
+
+DXMeshArenaBackend::DXMeshArenaBackend(const Microsoft::WRL::ComPtr<ID3D11Device>& pDevice, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& pDeviceContext) noexcept
+    : m_pDevice(pDevice), m_pDeviceContext(pDeviceContext)
+{  }
+
+void DXMeshArenaBackend::CreatePage(const std::uint32_t page, const size_t byteSize) noexcept {
+    if (page >= this->m_pPageBuffers.size())
+        this->m_pPageBuffers.resize(page + 1u);
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_VERTEX_BUFFER;
+    bufferDesc.ByteWidth = static_cast<UINT>(byteSize);
+    bufferDesc.CPUAccessFlags = 0;
+    bufferDesc.MiscFlags = 0;
+    bufferDesc.StructureByteStride = 0;
+    bufferDesc.Usage = D3D11_USAGE::D3D11_USAGE_DEFAULT;
+
+    if (this->m_pDevice->CreateBuffer(&bufferDesc, nullptr, &this->m_pPageBuffers[page]) != S_OK)
+        FATAL_ERROR("Failed to create a mesh arena page");
+}
+
+void DXMeshArenaBackend::Write(const std::uint32_t page, const size_t byteOffset, const void* pData, const size_t byteSize) noexcept {
+    D3D11_BOX box = {};
+    box.left   = static_cast<UINT>(byteOffset);
+    box.right  = static_cast<UINT>(byteOffset + byteSize);
+    box.top    = 0u;
+    box.bottom = 1u;
+    box.front  = 0u;
+    box.back   = 1u;
+
+    this->m_pDeviceContext->UpdateSubresource(this->m_pPageBuffers[page].Get(), 0u, &box, pData, 0u, 0u);
+}
+
+void DXMeshArenaBackend::Copy(const std::uint32_t sourcePage, const size_t sourceByteOffset,
+                              const std::uint32_t destinationPage, const size_t destinationByteOffset, const size_t byteSize) noexcept {
+    D3D11_BOX box = {};
+    box.left   = static_cast<UINT>(sourceByteOffset);
+    box.right  = static_cast<UINT>(sourceByteOffset + byteSize);
+    box.top    = 0u;
+    box.bottom = 1u;
+    box.front  = 0u;
+    box.back   = 1u;
+
+    this->m_pDeviceContext->CopySubresourceRegion(this->m_pPageBuffers[destinationPage].Get(), 0u, static_cast<UINT>(destinationByteOffset), 0u, 0u,
+                                                  this->m_pPageBuffers[sourcePage].Get(), 0u, &box);
+}
@@ -0,0 +1,31 @@
+#ifndef __MINECRAFT__DX_MESH_ARENA_BACKEND_HPP
+#define __MINECRAFT__DX_MESH_ARENA_BACKEND_HPP
+
+#include "Pch.hpp"
+#include "MeshArena.hpp"
+#include "ErrorHandler.hpp"
+
+// Every page is a vertex buffer, written and copied on the GPU through the device context
+class DXMeshArenaBackend final : public MeshArenaBackend {
+private:
+    Microsoft::WRL::ComPtr<ID3D11Device>        m_pDevice;
+    Microsoft::WRL::ComPtr<ID3D11DeviceContext> m_pDeviceContext;
+
+    std::vector<Microsoft::WRL::ComPtr<ID3D11Buffer>> m_pPageBuffers;
+
+public:
+    DXMeshArenaBackend(const Microsoft::WRL::ComPtr<ID3D11Device>& pDevice, const Microsoft::WRL::ComPtr<ID3D11DeviceContext>& pDeviceContext) noexcept;
+
+    void CreatePage(const std::uint32_t page, const size_t byteSize) noexcept override;
+
+    inline void DestroyPage(const std::uint32_t page) noexcept override { this->m_pPageBuffers[page].Reset(); }
+
+    void Write(const std::uint32_t page, const size_t byteOffset, const void* pData, const size_t byteSize) noexcept override;
+
+    void Copy(const std::uint32_t sourcePage, const size_t sourceByteOffset,
+              const std::uint32_t destinationPage, const size_t destinationByteOffset, const size_t byteSize) noexcept override;
+
+    inline const Microsoft::WRL::ComPtr<ID3D11Buffer>& GetPageBuffer(const std::uint32_t page) const noexcept { return this->m_pPageBuffers[page]; }
+}; // class DXMeshArenaBackend
+
+#endif // __MINECRAFT__DX_MESH_ARENA_BACKEND_HPP
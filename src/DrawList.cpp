@@ -0,0 +1,60 @@
+#include "DrawList.hpp"
+
+std::uint64_t DrawList::MakeSortKey(const DRAW_PASS pass, const std::uint16_t state, const float depth, const bool bBackToFront) noexcept {
+    // the bits of non-negative floats are ordered like their values
+    std::uint32_t depthBits;
+    std::memcpy(&depthBits, &depth, sizeof(depthBits));
+
+    if (depth <= 0.f)
+        depthBits = 0u;
+
+    if (bBackToFront)
+        depthBits = ~depthBits;
+
+    return (static_cast<std::uint64_t>(pass)  << 56u)
+         | (static_cast<std::uint64_t>(state) << 40u)
+         | (static_cast<std::uint64_t>(depthBits) << 8u);
+}
+
+void DrawList::Sort() noexcept {
+    constexpr size_t DIGIT_COUNT  = sizeof(std::uint64_t);
+    constexpr size_t BUCKET_COUNT = 256u;
+
+    const size_t nCommands = this->m_commands.size();
+
+    // clearing the histograms costs more than sorting a short list
+    if (nCommands < SMALL_LIST_COMMAND_COUNT) {
+        std::stable_sort(this->m_commands.begin(), this->m_commands.end(), [](const DrawCommand& lhs, const DrawCommand& rhs) {
+            return lhs.key < rhs.key;
+        });
+        return;
+    }
+
+    // every digit's histogram in a single pass over the keys
+    std::array<std::array<std::uint32_t, BUCKET_COUNT>, DIGIT_COUNT> histograms = {  };
+    for (const DrawCommand& command : this->m_commands)
+        for (size_t digit = 0u; digit < DIGIT_COUNT; ++digit)
+            ++histograms[digit][(command.key >> (digit * 8u)) & 0xFFu];
+
+    this->m_sortBuffer.resize(nCommands);
+
+    for (size_t digit = 0u; digit < DIGIT_COUNT; ++digit) {
+        std::array<std::uint32_t, BUCKET_COUNT>& histogram = histograms[digit];
+
+        const size_t shift = digit * 8u;
+        if (histogram[(this->m_commands.front().key >> shift) & 0xFFu] == nCommands)
+            continue;
+
+        std::uint32_t offset = 0u;
+        for (std::uint32_t& bucket : histogram) {
+            const std::uint32_t count = bucket;
+            bucket  = offset;
+            offset += count;
+        }
+
+        for (const DrawCommand& command : this->m_commands)
+            this->m_sortBuffer[histogram[(command.key >> shift) & 0xFFu]++] = command;
+
+        this->m_commands.swap(this->m_sortBuffer);
+    }
+}
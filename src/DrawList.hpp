@@ -0,0 +1,51 @@
+#ifndef __MINECRAFT__DRAW_LIST_HPP
+#define __MINECRAFT__DRAW_LIST_HPP
+
+#include "Pch.hpp"
+
+// Draws are replayed pass by pass, in this order
+enum class DRAW_PASS : std::uint8_t {
+    DRAW_PASS_OPAQUE = 0u,
+    DRAW_PASS_TRANSLUCENT, // blended over the opaque pass without writing depth, back to front
+
+    _COUNT
+}; // enum class DRAW_PASS
+
+// One indexed draw of quads, without anything graphics API specific so that lists can be built and sorted anywhere
+struct DrawCommand {
+    std::uint64_t key; // see DrawList::MakeSortKey
+
+    std::uint32_t object;     // what the executor fetches the per-draw constants of, e.g. a chunk's index
+    std::uint32_t state;      // the vertex buffer to bind, e.g. a mesh arena page
+    std::uint32_t baseVertex;
+    std::uint32_t nIndices;
+}; // struct DrawCommand
+
+// Collects the draws of a frame, then orders them by pass, state and depth so that
+// state changes are rare and, within a state, the closest draws fill the depth buffer first
+class DrawList {
+private:
+    std::vector<DrawCommand> m_commands;
+
+    // The other half of the radix sort's ping-pong, kept to not reallocate each frame
+    std::vector<DrawCommand> m_sortBuffer;
+
+    // Shorter lists are sorted by comparisons
+    static constexpr size_t SMALL_LIST_COMMAND_COUNT = 256u;
+
+public:
+    // Bits 56-63: the pass, 40-55: the state, 8-39: the depth, front to back unless "bBackToFront".
+    // "depth" is any non-negative measure of the distance to the camera, such as the squared distance
+    static std::uint64_t MakeSortKey(const DRAW_PASS pass, const std::uint16_t state, const float depth, const bool bBackToFront = false) noexcept;
+
+    inline void Clear() noexcept { this->m_commands.clear(); }
+
+    inline void Add(const DrawCommand& command) noexcept { this->m_commands.push_back(command); }
+
+    // Least significant digit radix sort on 8-bit digits, stable. Digits that are the same for every key are skipped
+    void Sort() noexcept;
+
+    inline const std::vector<DrawCommand>& GetCommands() const noexcept { return this->m_commands; }
+}; // class DrawList
+
+#endif // __MINECRAFT__DRAW_LIST_HPP
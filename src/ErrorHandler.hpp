@@ -7,6 +7,11 @@
 
     #define FATAL_ERROR(errorMsg) { MessageBoxA(NULL, errorMsg, "Minecraft: Fatal Error", MB_ICONERROR); std::exit(-1); }
 
+#else
+
+    // the portable parts are also built headless, e.g. by the benchmark
+    #define FATAL_ERROR(errorMsg) { std::cerr << "Minecraft: Fatal Error: " << errorMsg << '\n'; std::exit(-1); }
+
 #endif // _WIN32
 
 #endif // __MINECRAFT__ERROR_HANDLER_HPP
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "JobSystem.hpp"
+
+// Lets jobs submitted from a worker thread land on that worker's own deque
+static thread_local const JobSystem* tl_pCurrentJobSystem = nullptr;
+static thread_local size_t           tl_currentWorkerIndex = 0u;
+
+JobSystem::JobSystem(const size_t nThreads) noexcept {
+    const size_t nWorkers = std::max<size_t>(nThreads, 1u);
+
+    for (size_t i = 0u; i < nWorkers; ++i)
+        this->m_workers.push_back(std::make_unique<Worker>());
+
+    for (size_t i = 0u; i < nWorkers; ++i)
+        this->m_threads.emplace_back(&JobSystem::WorkerMain, this, i);
+}
+
+JobSystem::~JobSystem() noexcept {
+    {
+        std::lock_guard<std::mutex> lock(this->m_sleepMutex);
+        this->m_bIsRunning = false;
+    }
+
+    this->m_sleepCondition.notify_all();
+
+    for (std::thread& thread : this->m_threads)
+        thread.join();
+}
+
+bool JobSystem::TryPopJob(const size_t workerIndex, Job& job) noexcept {
+    {
+        Worker& worker = *this->m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+
+        if (!worker.jobs.empty()) {
+            job = std::move(worker.jobs.back());
+            worker.jobs.pop_back();
+            --this->m_nQueuedJobs;
+            return true;
+        }
+    }
+
+    for (size_t i = 1u; i < this->m_workers.size(); ++i) {
+        Worker& victim = *this->m_workers[(workerIndex + i) % this->m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+
+        if (!victim.jobs.empty()) {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            --this->m_nQueuedJobs;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::RunJob(Job& job) noexcept {
+    job();
+    job = nullptr;
+
+    --this->m_nUnfinishedJobs;
+}
+
+void JobSystem::WorkerMain(const size_t workerIndex) noexcept {
+    tl_pCurrentJobSystem  = this;
+    tl_currentWorkerIndex = workerIndex;
+
+    Job job;
+    while (true) {
+        if (this->TryPopJob(workerIndex, job)) {
+            this->RunJob(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(this->m_sleepMutex);
+        this->m_sleepCondition.wait(lock, [this]() { return !this->m_bIsRunning || this->m_nQueuedJobs > 0u; });
+
+        if (!this->m_bIsRunning)
+            break;
+    }
+}
+
+void JobSystem::Submit(Job job) noexcept {
+    const size_t workerIndex = (tl_pCurrentJobSystem == this) ? tl_currentWorkerIndex
+                                                              : this->m_nextWorkerIndex++ % this->m_workers.size();
+
+    ++this->m_nUnfinishedJobs;
+
+    {
+        // incremented under the lock so that a worker can't miss the wake up, and before the job is pushed
+        // so that a thief that pops it right away can't take the counter below 0
+        std::lock_guard<std::mutex> lock(this->m_sleepMutex);
+        ++this->m_nQueuedJobs;
+    }
+
+    {
+        Worker& worker = *this->m_workers[workerIndex];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.jobs.push_back(std::move(job));
+    }
+
+    this->m_sleepCondition.notify_one();
+}
+
+void JobSystem::WaitIdle() noexcept {
+    Job job;
+    while (this->m_nUnfinishedJobs > 0u) {
+        if (this->TryPopJob(this->m_nextWorkerIndex % this->m_workers.size(), job))
+            this->RunJob(job);
+        else
+            std::this_thread::yield();
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef __MINECRAFT__JOB_SYSTEM_HPP
+#define __MINECRAFT__JOB_SYSTEM_HPP
+
+#include "Pch.hpp"
+
+using Job = std::function<void()>;
+
+// A fixed pool of worker threads, each owning a deque of jobs.
+// A worker pops its own jobs from the back (most recently submitted first) and,
+// once its deque is empty, steals from the front of the other workers' deques.
+class JobSystem {
+private:
+    struct Worker {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    }; // struct Worker
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread>             m_threads;
+
+    // used to put the workers to sleep when there is nothing to do
+    std::mutex              m_sleepMutex;
+    std::condition_variable m_sleepCondition;
+    bool                    m_bIsRunning = true;
+
+    std::atomic<size_t> m_nQueuedJobs     = 0u; // submitted but not yet picked up by a worker
+    std::atomic<size_t> m_nUnfinishedJobs = 0u; // submitted but not yet done
+
+    // jobs submitted from outside the pool are spread over the workers in round robin
+    std::atomic<size_t> m_nextWorkerIndex = 0u;
+
+private:
+    bool TryPopJob(const size_t workerIndex, Job& job) noexcept;
+
+    void RunJob(Job& job) noexcept;
+
+    void WorkerMain(const size_t workerIndex) noexcept;
+
+public:
+    // Keeps one core for the main (render) thread by default
+    explicit JobSystem(const size_t nThreads = std::max(std::thread::hardware_concurrency(), 2u) - 1u) noexcept;
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // Runs every queued job, including the ones they submit, before stopping the workers:
+    // the workers only check for the stop once their queues are empty
+    ~JobSystem() noexcept;
+
+    inline size_t GetThreadCount() const noexcept { return this->m_threads.size(); }
+
+    inline size_t GetUnfinishedJobCount() const noexcept { return this->m_nUnfinishedJobs.load(); }
+
+    inline size_t GetQueuedJobCount() const noexcept { return this->m_nQueuedJobs.load(); }
+
+    void Submit(Job job) noexcept;
+
+    // Blocks until every submitted job is done, running jobs on the calling thread in the meantime
+    void WaitIdle() noexcept;
+}; // class JobSystem
+
+#endif // __MINECRAFT__JOB_SYSTEM_HPP
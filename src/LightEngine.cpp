@@ -0,0 +1,365 @@
+#include "LightEngine.hpp"
+
+// The 6 neighbours of a cell, going down first
+struct LightDirection {
+    int dx, dy, dz;
+}; // struct LightDirection
+
+static constexpr std::array<LightDirection, 6u> LIGHT_DIRECTIONS = {
+    LightDirection{  0, -1,  0 },
+    LightDirection{  0,  1,  0 },
+    LightDirection{ -1,  0,  0 },
+    LightDirection{  1,  0,  0 },
+    LightDirection{  0,  0, -1 },
+    LightDirection{  0,  0,  1 }
+};
+
+static constexpr size_t LIGHT_DIRECTION_DOWN = 0u;
+
+// The sky light keeps its level going down through air, every other step dims light by one level
+static inline std::uint8_t GetPropagatedLevel(const LIGHT_CHANNEL channel, const size_t direction, const std::uint8_t level, const BLOCK_TYPE& target) noexcept {
+    if (channel == LIGHT_CHANNEL::LIGHT_CHANNEL_SKY && direction == LIGHT_DIRECTION_DOWN && level == MAX_LIGHT_LEVEL && IsBlockTransparent(target))
+        return MAX_LIGHT_LEVEL;
+
+    return static_cast<std::uint8_t>(level - 1u);
+}
+
+// The light a cell has on its own, whatever its neighbours: the glow of an emitter,
+// or the sky's light for the top layer as if it came down from above the world
+static inline std::uint8_t GetSourceLevel(const LIGHT_CHANNEL channel, const BLOCK_TYPE& type, const int y) noexcept {
+    if (channel == LIGHT_CHANNEL::LIGHT_CHANNEL_BLOCK)
+        return GetBlockLightEmission(type);
+
+    if (y != CHUNK_Y_BLOCK_COUNT - 1 || IsBlockOpaque(type))
+        return 0u;
+
+    return GetPropagatedLevel(channel, LIGHT_DIRECTION_DOWN, MAX_LIGHT_LEVEL, type);
+}
+
+std::optional<LightEngine::LightCell> LightEngine::FindCell(const LightNeighbourhood& neighbourhood, const int x, const int y, const int z) noexcept {
+    if (y < 0 || y >= CHUNK_Y_BLOCK_COUNT ||
+        x < -CHUNK_X_BLOCK_COUNT || x >= 2 * CHUNK_X_BLOCK_COUNT ||
+        z < -CHUNK_Z_BLOCK_COUNT || z >= 2 * CHUNK_Z_BLOCK_COUNT)
+        return {  };
+
+    const int    dx         = (x + CHUNK_X_BLOCK_COUNT) / CHUNK_X_BLOCK_COUNT - 1;
+    const int    dz         = (z + CHUNK_Z_BLOCK_COUNT) / CHUNK_Z_BLOCK_COUNT - 1;
+    const size_t chunkIndex = LightNeighbourhood::GetIndex(dx, dz);
+
+    Chunk* pChunk = neighbourhood.m_pChunks[chunkIndex];
+    if (!pChunk)
+        return {  };
+
+    const size_t idx = static_cast<size_t>(x - dx * CHUNK_X_BLOCK_COUNT);
+    const size_t idz = static_cast<size_t>(z - dz * CHUNK_Z_BLOCK_COUNT);
+
+    return LightCell{
+        pChunk,
+        chunkIndex,
+        static_cast<size_t>(y) / CHUNK_SECTION_Y_BLOCK_COUNT,
+        ChunkSection::GetBlockIndex(idx, static_cast<size_t>(y) % CHUNK_SECTION_Y_BLOCK_COUNT, idz)
+    };
+}
+
+void LightEngine::SetLight(LightNeighbourhood& neighbourhood, const LightCell& cell, const int x, const int y, const int z,
+                           const LIGHT_CHANNEL channel, const std::uint8_t level) noexcept {
+    SectionLight& sectionLight = cell.pChunk->m_sectionLights[cell.sectionIndex];
+    const std::uint8_t light = sectionLight.GetLight(cell.blockIndex);
+
+    sectionLight.SetLight(cell.blockIndex, channel == LIGHT_CHANNEL::LIGHT_CHANNEL_SKY ? PackLight(level, GetBlockLight(light))
+                                                                                       : PackLight(GetSkyLight(light), level));
+
+    // the faces looking into the cell belong to its own section and to the ones of its neighbours
+    const std::uint16_t sectionBit = static_cast<std::uint16_t>(1u << cell.sectionIndex);
+    std::uint16_t sectionMask = sectionBit;
+    if (y % CHUNK_SECTION_Y_BLOCK_COUNT == 0 && cell.sectionIndex > 0u)
+        sectionMask |= static_cast<std::uint16_t>(sectionBit >> 1u);
+    if (y % CHUNK_SECTION_Y_BLOCK_COUNT == CHUNK_SECTION_Y_BLOCK_COUNT - 1 && cell.sectionIndex + 1u < CHUNK_SECTION_COUNT)
+        sectionMask |= static_cast<std::uint16_t>(sectionBit << 1u);
+
+    neighbourhood.m_changedSections[cell.chunkIndex] |= sectionMask;
+
+    const int idx = (x + CHUNK_X_BLOCK_COUNT) % CHUNK_X_BLOCK_COUNT;
+    const int idz = (z + CHUNK_Z_BLOCK_COUNT) % CHUNK_Z_BLOCK_COUNT;
+    const int dx  = (x + CHUNK_X_BLOCK_COUNT) / CHUNK_X_BLOCK_COUNT - 1;
+    const int dz  = (z + CHUNK_Z_BLOCK_COUNT) / CHUNK_Z_BLOCK_COUNT - 1;
+
+    if (idx == 0 && dx > -1)
+        neighbourhood.m_changedSections[LightNeighbourhood::GetIndex(dx - 1, dz)] |= sectionBit;
+    if (idx == CHUNK_X_BLOCK_COUNT - 1 && dx < 1)
+        neighbourhood.m_changedSections[LightNeighbourhood::GetIndex(dx + 1, dz)] |= sectionBit;
+    if (idz == 0 && dz > -1)
+        neighbourhood.m_changedSections[LightNeighbourhood::GetIndex(dx, dz - 1)] |= sectionBit;
+    if (idz == CHUNK_Z_BLOCK_COUNT - 1 && dz < 1)
+        neighbourhood.m_changedSections[LightNeighbourhood::GetIndex(dx, dz + 1)] |= sectionBit;
+}
+
+void LightEngine::PropagateAdd(LightNeighbourhood& neighbourhood, const LIGHT_CHANNEL channel) noexcept {
+    // a vector read from the front, the nodes are only dropped once the queue is empty
+    for (size_t nodeIndex = 0u; nodeIndex < this->m_addQueue.size(); ++nodeIndex) {
+        const LightNode node = this->m_addQueue[nodeIndex];
+        ++this->m_nVisitedCells;
+
+        if (node.level <= 1u)
+            continue;
+
+        // the cell was relit brighter, or went out, since it was queued
+        const std::optional<LightCell> cell = FindCell(neighbourhood, node.x, node.y, node.z);
+        if (!cell.has_value() || GetLight(cell.value(), channel) != node.level)
+            continue;
+
+        for (size_t direction = 0u; direction < LIGHT_DIRECTIONS.size(); ++direction) {
+            const int x = node.x + LIGHT_DIRECTIONS[direction].dx;
+            const int y = node.y + LIGHT_DIRECTIONS[direction].dy;
+            const int z = node.z + LIGHT_DIRECTIONS[direction].dz;
+
+            const std::optional<LightCell> target = FindCell(neighbourhood, x, y, z);
+            if (!target.has_value())
+                continue;
+
+            const BLOCK_TYPE targetType = GetBlock(target.value());
+            if (IsBlockOpaque(targetType))
+                continue;
+
+            const std::uint8_t level = GetPropagatedLevel(channel, direction, node.level, targetType);
+            if (GetLight(target.value(), channel) >= level)
+                continue;
+
+            SetLight(neighbourhood, target.value(), x, y, z, channel, level);
+            this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), level });
+        }
+    }
+
+    this->m_addQueue.clear();
+}
+
+void LightEngine::PropagateRemove(LightNeighbourhood& neighbourhood, const LIGHT_CHANNEL channel) noexcept {
+    for (size_t nodeIndex = 0u; nodeIndex < this->m_removeQueue.size(); ++nodeIndex) {
+        const LightNode node = this->m_removeQueue[nodeIndex];
+        ++this->m_nVisitedCells;
+
+        for (size_t direction = 0u; direction < LIGHT_DIRECTIONS.size(); ++direction) {
+            const int x = node.x + LIGHT_DIRECTIONS[direction].dx;
+            const int y = node.y + LIGHT_DIRECTIONS[direction].dy;
+            const int z = node.z + LIGHT_DIRECTIONS[direction].dz;
+
+            const std::optional<LightCell> target = FindCell(neighbourhood, x, y, z);
+            if (!target.has_value())
+                continue;
+
+            const std::uint8_t level = GetLight(target.value(), channel);
+            if (level == 0u)
+                continue;
+
+            const LightNode targetNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), level };
+
+            // dimmer neighbours (and the sky light below) may have been lit by the removed light and go out too,
+            // the others have their own source and light the hole back once the removal is over
+            const bool bIsLitByNode = level < node.level ||
+                (channel == LIGHT_CHANNEL::LIGHT_CHANNEL_SKY && direction == LIGHT_DIRECTION_DOWN && node.level == MAX_LIGHT_LEVEL && level == MAX_LIGHT_LEVEL);
+
+            if (!bIsLitByNode) {
+                this->m_addQueue.push_back(targetNode);
+                continue;
+            }
+
+            SetLight(neighbourhood, target.value(), x, y, z, channel, 0u);
+            this->m_removeQueue.push_back(targetNode);
+
+            // a source loses the light it got from elsewhere, not its own
+            const std::uint8_t sourceLevel = GetSourceLevel(channel, GetBlock(target.value()), y);
+            if (sourceLevel > 0u) {
+                SetLight(neighbourhood, target.value(), x, y, z, channel, sourceLevel);
+                this->m_addQueue.push_back(LightNode{ targetNode.x, targetNode.y, targetNode.z, sourceLevel });
+            }
+        }
+    }
+
+    this->m_removeQueue.clear();
+}
+
+void LightEngine::ComputeChunkLight(Chunk& chunk) noexcept {
+    PROFILE_SCOPE("ComputeChunkLight");
+
+    LightNeighbourhood neighbourhood({ nullptr, nullptr, nullptr, nullptr, &chunk, nullptr, nullptr, nullptr, nullptr });
+
+    // the lowest cell of each column that the sky reaches through air only, indexed like ChunkHeightMap
+    ChunkHeightMap skyBottoms;
+    for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+        for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+            size_t y = CHUNK_Y_BLOCK_COUNT;
+            while (y > 0u && IsBlockTransparent(chunk.GetBlock(x, y - 1u, z).value()))
+                --y;
+
+            skyBottoms[x * CHUNK_Z_BLOCK_COUNT + z] = static_cast<std::uint8_t>(y);
+        }
+    }
+
+    const size_t highestSkyBottom = *std::max_element(skyBottoms.begin(), skyBottoms.end());
+
+    // the sections above every column's bottom are under the open sky, they stay uniform
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        SectionLight& sectionLight = chunk.m_sectionLights[sectionIndex];
+        const size_t  yBegin       = sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT;
+
+        if (yBegin >= highestSkyBottom) {
+            sectionLight.Fill(SKY_LIGHT);
+            continue;
+        }
+
+        sectionLight.Fill(0u);
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x)
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z)
+                for (size_t y = std::max<size_t>(yBegin, skyBottoms[x * CHUNK_Z_BLOCK_COUNT + z]); y < yBegin + CHUNK_SECTION_Y_BLOCK_COUNT; ++y)
+                    sectionLight.SetLight(ChunkSection::GetBlockIndex(x, y - yBegin, z), SKY_LIGHT);
+    }
+
+    // the sky light only spreads from where it meets something: the bottom of each column, and the cells
+    // along a column that sees deeper than one of its neighbours, in case there is a way in below an overhang
+    for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+        for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+            const size_t skyBottom = skyBottoms[x * CHUNK_Z_BLOCK_COUNT + z];
+
+            size_t yEnd = skyBottom + 1u;
+            if (x > 0u)                       yEnd = std::max<size_t>(yEnd, skyBottoms[(x - 1u) * CHUNK_Z_BLOCK_COUNT + z]);
+            if (x + 1u < CHUNK_X_BLOCK_COUNT) yEnd = std::max<size_t>(yEnd, skyBottoms[(x + 1u) * CHUNK_Z_BLOCK_COUNT + z]);
+            if (z > 0u)                       yEnd = std::max<size_t>(yEnd, skyBottoms[x * CHUNK_Z_BLOCK_COUNT + z - 1u]);
+            if (z + 1u < CHUNK_Z_BLOCK_COUNT) yEnd = std::max<size_t>(yEnd, skyBottoms[x * CHUNK_Z_BLOCK_COUNT + z + 1u]);
+
+            for (size_t y = skyBottom; y < std::min<size_t>(yEnd, CHUNK_Y_BLOCK_COUNT); ++y)
+                this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), MAX_LIGHT_LEVEL });
+
+            // or from the top layer when the sky doesn't get through it undimmed
+            const int topY = CHUNK_Y_BLOCK_COUNT - 1;
+            const std::uint8_t sourceLevel = GetSourceLevel(LIGHT_CHANNEL::LIGHT_CHANNEL_SKY, chunk.GetBlock(x, topY, z).value(), topY);
+            if (skyBottom == CHUNK_Y_BLOCK_COUNT && sourceLevel > 0u) {
+                const LightCell cell{ &chunk, LightNeighbourhood::GetIndex(0, 0), topY / CHUNK_SECTION_Y_BLOCK_COUNT,
+                                      ChunkSection::GetBlockIndex(x, topY % CHUNK_SECTION_Y_BLOCK_COUNT, z) };
+
+                SetLight(neighbourhood, cell, static_cast<int>(x), topY, static_cast<int>(z), LIGHT_CHANNEL::LIGHT_CHANNEL_SKY, sourceLevel);
+                this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(topY), static_cast<std::int16_t>(z), sourceLevel });
+            }
+        }
+    }
+
+    this->PropagateAdd(neighbourhood, LIGHT_CHANNEL::LIGHT_CHANNEL_SKY);
+
+    // emitters are looked for in the sections whose palette has one
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        const ChunkSection* pSection = chunk.m_pSections[sectionIndex].get();
+        if (!pSection)
+            continue;
+
+        bool bMayEmit = false;
+        for (size_t type = 0u; type < static_cast<size_t>(BLOCK_TYPE::_COUNT) && !bMayEmit; ++type)
+            bMayEmit = GetBlockLightEmission(static_cast<BLOCK_TYPE>(type)) > 0u && pSection->MayContain(static_cast<BLOCK_TYPE>(type));
+
+        if (!bMayEmit)
+            continue;
+
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+                for (size_t y = 0u; y < CHUNK_SECTION_Y_BLOCK_COUNT; ++y) {
+                    const std::uint8_t emission = GetBlockLightEmission(pSection->GetBlock(ChunkSection::GetBlockIndex(x, y, z)));
+                    if (emission == 0u)
+                        continue;
+
+                    const int idy = static_cast<int>(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT + y);
+                    const LightCell cell{ &chunk, LightNeighbourhood::GetIndex(0, 0), sectionIndex, ChunkSection::GetBlockIndex(x, y, z) };
+
+                    SetLight(neighbourhood, cell, static_cast<int>(x), idy, static_cast<int>(z), LIGHT_CHANNEL::LIGHT_CHANNEL_BLOCK, emission);
+                    this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(idy), static_cast<std::int16_t>(z), emission });
+                }
+            }
+        }
+    }
+
+    this->PropagateAdd(neighbourhood, LIGHT_CHANNEL::LIGHT_CHANNEL_BLOCK);
+
+    for (SectionLight& sectionLight : chunk.m_sectionLights)
+        sectionLight.Compact();
+
+    // the neighbours' light has to be let in again
+    chunk.m_litSideMask = 0u;
+}
+
+void LightEngine::StitchSide(LightNeighbourhood& neighbourhood, const CHUNK_SIDE side) noexcept {
+    PROFILE_SCOPE("StitchSide");
+
+    for (const LIGHT_CHANNEL channel : { LIGHT_CHANNEL::LIGHT_CHANNEL_SKY, LIGHT_CHANNEL::LIGHT_CHANNEL_BLOCK }) {
+        for (int y = 0; y < CHUNK_Y_BLOCK_COUNT; ++y) {
+            for (int i = 0; i < CHUNK_X_BLOCK_COUNT; ++i) {
+                // the cell of the center chunk along the side, and the one across it
+                int x = i, z = i, acrossX = i, acrossZ = i;
+                switch (side) {
+                case CHUNK_SIDE::CHUNK_SIDE_LEFT:  x = 0;                       acrossX = -1;                  break;
+                case CHUNK_SIDE::CHUNK_SIDE_RIGHT: x = CHUNK_X_BLOCK_COUNT - 1; acrossX = CHUNK_X_BLOCK_COUNT; break;
+                case CHUNK_SIDE::CHUNK_SIDE_FRONT: z = 0;                       acrossZ = -1;                  break;
+                default:                           z = CHUNK_Z_BLOCK_COUNT - 1; acrossZ = CHUNK_Z_BLOCK_COUNT; break;
+                }
+
+                const std::optional<LightCell> cell   = FindCell(neighbourhood, x, y, z);
+                const std::optional<LightCell> across = FindCell(neighbourhood, acrossX, y, acrossZ);
+                if (!cell.has_value() || !across.has_value())
+                    return;
+
+                // only the cells that can brighten the other side are spread
+                const std::uint8_t level       = GetLight(cell.value(), channel);
+                const std::uint8_t acrossLevel = GetLight(across.value(), channel);
+
+                if (level > acrossLevel + 1u && !IsBlockOpaque(GetBlock(across.value())))
+                    this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), level });
+                else if (acrossLevel > level + 1u && !IsBlockOpaque(GetBlock(cell.value())))
+                    this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(acrossX), static_cast<std::int16_t>(y), static_cast<std::int16_t>(acrossZ), acrossLevel });
+            }
+        }
+
+        this->PropagateAdd(neighbourhood, channel);
+    }
+}
+
+void LightEngine::UpdateBlock(LightNeighbourhood& neighbourhood, const size_t idx, const size_t idy, const size_t idz) noexcept {
+    PROFILE_SCOPE("UpdateBlockLight");
+
+    const int x = static_cast<int>(idx), y = static_cast<int>(idy), z = static_cast<int>(idz);
+
+    const std::optional<LightCell> cell = FindCell(neighbourhood, x, y, z);
+    if (!cell.has_value())
+        return;
+
+    const BLOCK_TYPE type = GetBlock(cell.value());
+
+    for (const LIGHT_CHANNEL channel : { LIGHT_CHANNEL::LIGHT_CHANNEL_SKY, LIGHT_CHANNEL::LIGHT_CHANNEL_BLOCK }) {
+        // whatever the block was, the light it let through or gave goes out first
+        const std::uint8_t level = GetLight(cell.value(), channel);
+        if (level > 0u) {
+            SetLight(neighbourhood, cell.value(), x, y, z, channel, 0u);
+            this->m_removeQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), level });
+        }
+
+        this->PropagateRemove(neighbourhood, channel);
+
+        // then the neighbours light the cell back when it lets light through
+        if (!IsBlockOpaque(type)) {
+            for (const LightDirection& direction : LIGHT_DIRECTIONS) {
+                const std::optional<LightCell> neighbour = FindCell(neighbourhood, x + direction.dx, y + direction.dy, z + direction.dz);
+                if (!neighbour.has_value())
+                    continue;
+
+                const std::uint8_t neighbourLevel = GetLight(neighbour.value(), channel);
+                if (neighbourLevel > 0u)
+                    this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x + direction.dx), static_cast<std::int16_t>(y + direction.dy),
+                                                          static_cast<std::int16_t>(z + direction.dz), neighbourLevel });
+            }
+
+        }
+
+        const std::uint8_t sourceLevel = GetSourceLevel(channel, type, y);
+        if (sourceLevel > 0u) {
+            SetLight(neighbourhood, cell.value(), x, y, z, channel, sourceLevel);
+            this->m_addQueue.push_back(LightNode{ static_cast<std::int16_t>(x), static_cast<std::int16_t>(y), static_cast<std::int16_t>(z), sourceLevel });
+        }
+
+        this->PropagateAdd(neighbourhood, channel);
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef __MINECRAFT__LIGHT_ENGINE_HPP
+#define __MINECRAFT__LIGHT_ENGINE_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+
+enum class LIGHT_CHANNEL : std::uint8_t {
+    LIGHT_CHANNEL_SKY = 0u, // from the top of the world, undimmed straight down through air
+    LIGHT_CHANNEL_BLOCK,    // from emitters, see GetBlockLightEmission
+
+    _COUNT
+}; // enum class LIGHT_CHANNEL
+
+static_assert(MAX_LIGHT_LEVEL < CHUNK_X_BLOCK_COUNT && MAX_LIGHT_LEVEL < CHUNK_Z_BLOCK_COUNT,
+              "Light from a chunk's cells never goes past the chunks around it");
+
+// A chunk and the 8 chunks around it, which is as far as the light of its cells can reach.
+// Coordinates are relative to the center chunk and go from -CHUNK_X_BLOCK_COUNT.
+// Missing chunks (nullptr) are seen as opaque, their light is exchanged once they are loaded, see LightEngine::StitchSide
+class LightNeighbourhood {
+    friend class LightEngine;
+private:
+    std::array<Chunk*, 9u>        m_pChunks;            // indexed by GetIndex
+    std::array<std::uint16_t, 9u> m_changedSections{};  // the sections whose meshes saw a cell's light change
+
+public:
+    // (dx, dz) in [-1, 1]
+    static inline size_t GetIndex(const int dx, const int dz) noexcept { return static_cast<size_t>((dx + 1) * 3 + (dz + 1)); }
+
+    inline explicit LightNeighbourhood(const std::array<Chunk*, 9u>& pChunks) noexcept
+        : m_pChunks(pChunks)
+    {  }
+
+    inline Chunk* GetChunk(const int dx, const int dz) const noexcept { return this->m_pChunks[GetIndex(dx, dz)]; }
+
+    inline std::uint16_t GetChangedSections(const int dx, const int dz) const noexcept { return this->m_changedSections[GetIndex(dx, dz)]; }
+}; // class LightNeighbourhood
+
+// Breadth first propagation of the sky and block light, with one queue for the light being spread and one for the light
+// going out. An edit only relights the cells whose light depended on the edited block, plus the border they are relit from.
+// Not thread safe, each thread needs its own engine
+class LightEngine {
+private:
+    struct LightNode {
+        std::int16_t x, y, z; // in the neighbourhood
+        std::uint8_t level;   // when the node was queued
+    }; // struct LightNode
+
+    struct LightCell {
+        Chunk* pChunk;
+        size_t chunkIndex; // in the neighbourhood
+        size_t sectionIndex;
+        size_t blockIndex;
+    }; // struct LightCell
+
+    std::vector<LightNode> m_addQueue;    // lit cells whose light has to reach their neighbours
+    std::vector<LightNode> m_removeQueue; // cells whose light went out, and the level it had
+
+    size_t m_nVisitedCells = 0u;
+
+private:
+    // std::nullopt outside of the world or in a missing chunk
+    static std::optional<LightCell> FindCell(const LightNeighbourhood& neighbourhood, const int x, const int y, const int z) noexcept;
+
+    static inline BLOCK_TYPE GetBlock(const LightCell& cell) noexcept {
+        const ChunkSection* pSection = cell.pChunk->m_pSections[cell.sectionIndex].get();
+        return pSection ? pSection->GetBlock(cell.blockIndex) : BLOCK_TYPE::BLOCK_TYPE_AIR;
+    }
+
+    static inline std::uint8_t GetLight(const LightCell& cell, const LIGHT_CHANNEL channel) noexcept {
+        const std::uint8_t light = cell.pChunk->m_sectionLights[cell.sectionIndex].GetLight(cell.blockIndex);
+        return channel == LIGHT_CHANNEL::LIGHT_CHANNEL_SKY ? GetSkyLight(light) : GetBlockLight(light);
+    }
+
+    // Marks the sections of the cell at (x, y, z) and of its neighbours as changed too
+    static void SetLight(LightNeighbourhood& neighbourhood, const LightCell& cell, const int x, const int y, const int z,
+                         const LIGHT_CHANNEL channel, const std::uint8_t level) noexcept;
+
+    // Empty the queues
+    void PropagateAdd   (LightNeighbourhood& neighbourhood, const LIGHT_CHANNEL channel) noexcept;
+    void PropagateRemove(LightNeighbourhood& neighbourhood, const LIGHT_CHANNEL channel) noexcept;
+
+public:
+    // Relights the chunk from scratch on its own: the sky light comes down the columns and the emitters glow,
+    // without going through the chunk's sides. Thread safe as long as no one else touches the chunk
+    void ComputeChunkLight(Chunk& chunk) noexcept;
+
+    // Lets the light through the side shared by the center chunk and its neighbour on "side", both being lit
+    void StitchSide(LightNeighbourhood& neighbourhood, const CHUNK_SIDE side) noexcept;
+
+    // Relights around the block at (idx, idy, idz) of the center chunk, once the block was changed
+    void UpdateBlock(LightNeighbourhood& neighbourhood, const size_t idx, const size_t idy, const size_t idz) noexcept;
+
+    // The number of cells the queues went through, as a measure of the work done
+    inline size_t GetVisitedCellCount() const noexcept { return this->m_nVisitedCells; }
+
+    inline void ResetVisitedCellCount() noexcept { this->m_nVisitedCells = 0u; }
+}; // class LightEngine
+
+#endif // __MINECRAFT__LIGHT_ENGINE_HPP
@@ -12,4 +12,157 @@ Mat4x4f32 Mat4x4f32::Identity = Mat4x4f32{ std::array<float, 16u>{
     0.f, 1.f, 0.f, 0.f,
     0.f, 0.f, 1.f, 0.f,
     0.f, 0.f, 0.f, 1.f,
-} };
\ No newline at end of file
+} };
+
+void TransformPoints(const Mat4x4f32& m, const Vec4f32* pPoints, Vec4f32* pResults, const size_t count) noexcept {
+    size_t i = 0u;
+
+#if defined(MINECRAFT_MATH_SSE2) && defined(__AVX__)
+    // two points per iteration, one per 128-bit lane
+    const __m256 wideRow0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m.data() + 0u));
+    const __m256 wideRow1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m.data() + 4u));
+    const __m256 wideRow2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m.data() + 8u));
+    const __m256 wideRow3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(m.m.data() + 12u));
+
+    for (; i + 2u <= count; i += 2u) {
+        const __m256 points = _mm256_loadu_ps(&pPoints[i].x);
+
+        __m256 results = _mm256_mul_ps(_mm256_permute_ps(points, 0x00), wideRow0);
+#ifdef MINECRAFT_MATH_FMA
+        results = _mm256_fmadd_ps(_mm256_permute_ps(points, 0x55), wideRow1, results);
+        results = _mm256_fmadd_ps(_mm256_permute_ps(points, 0xAA), wideRow2, results);
+        results = _mm256_fmadd_ps(_mm256_permute_ps(points, 0xFF), wideRow3, results);
+#else
+        results = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(points, 0x55), wideRow1), results);
+        results = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(points, 0xAA), wideRow2), results);
+        results = _mm256_add_ps(_mm256_mul_ps(_mm256_permute_ps(points, 0xFF), wideRow3), results);
+#endif // MINECRAFT_MATH_FMA
+
+        _mm256_storeu_ps(&pResults[i].x, results);
+    }
+#endif // MINECRAFT_MATH_SSE2 && __AVX__
+
+#ifdef MINECRAFT_MATH_SSE2
+    const __m128 row0 = m.LoadRow(0u), row1 = m.LoadRow(1u), row2 = m.LoadRow(2u), row3 = m.LoadRow(3u);
+
+    for (; i < count; ++i) {
+        const __m128 point = pPoints[i].Load();
+
+        __m128 result = _mm_mul_ps(_mm_shuffle_ps(point, point, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+        result = MultiplyAdd(_mm_shuffle_ps(point, point, _MM_SHUFFLE(1, 1, 1, 1)), row1, result);
+        result = MultiplyAdd(_mm_shuffle_ps(point, point, _MM_SHUFFLE(2, 2, 2, 2)), row2, result);
+        result = MultiplyAdd(_mm_shuffle_ps(point, point, _MM_SHUFFLE(3, 3, 3, 3)), row3, result);
+
+        _mm_store_ps(&pResults[i].x, result);
+    }
+#else
+    for (; i < count; ++i)
+        pResults[i] = pPoints[i] * m;
+#endif // MINECRAFT_MATH_SSE2
+}
+
+// Arvo's method: each axis of the box moves the transformed bounds by the smaller or the larger of
+// the matrix row scaled by the box's min and max on that axis, starting from the translation
+void TransformAABBs(const Mat4x4f32& m, const Vec4f32* pBoxMins, const Vec4f32* pBoxMaxs,
+                    Vec4f32* pResultMins, Vec4f32* pResultMaxs, const size_t count) noexcept
+{
+#ifdef MINECRAFT_MATH_SSE2
+    const __m128 row0 = m.LoadRow(0u), row1 = m.LoadRow(1u), row2 = m.LoadRow(2u), row3 = m.LoadRow(3u);
+
+    for (size_t i = 0u; i < count; ++i) {
+        const __m128 boxMin = pBoxMins[i].Load();
+        const __m128 boxMax = pBoxMaxs[i].Load();
+
+        const __m128 xMin = _mm_mul_ps(_mm_shuffle_ps(boxMin, boxMin, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+        const __m128 xMax = _mm_mul_ps(_mm_shuffle_ps(boxMax, boxMax, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+        const __m128 yMin = _mm_mul_ps(_mm_shuffle_ps(boxMin, boxMin, _MM_SHUFFLE(1, 1, 1, 1)), row1);
+        const __m128 yMax = _mm_mul_ps(_mm_shuffle_ps(boxMax, boxMax, _MM_SHUFFLE(1, 1, 1, 1)), row1);
+        const __m128 zMin = _mm_mul_ps(_mm_shuffle_ps(boxMin, boxMin, _MM_SHUFFLE(2, 2, 2, 2)), row2);
+        const __m128 zMax = _mm_mul_ps(_mm_shuffle_ps(boxMax, boxMax, _MM_SHUFFLE(2, 2, 2, 2)), row2);
+
+        __m128 resultMin = _mm_add_ps(row3, _mm_min_ps(xMin, xMax));
+        __m128 resultMax = _mm_add_ps(row3, _mm_max_ps(xMin, xMax));
+        resultMin = _mm_add_ps(resultMin, _mm_min_ps(yMin, yMax));
+        resultMax = _mm_add_ps(resultMax, _mm_max_ps(yMin, yMax));
+        resultMin = _mm_add_ps(resultMin, _mm_min_ps(zMin, zMax));
+        resultMax = _mm_add_ps(resultMax, _mm_max_ps(zMin, zMax));
+
+        _mm_store_ps(&pResultMins[i].x, resultMin);
+        _mm_store_ps(&pResultMaxs[i].x, resultMax);
+    }
+#else
+    for (size_t i = 0u; i < count; ++i) {
+        const float boxMin[3] = { pBoxMins[i].x, pBoxMins[i].y, pBoxMins[i].z };
+        const float boxMax[3] = { pBoxMaxs[i].x, pBoxMaxs[i].y, pBoxMaxs[i].z };
+
+        float resultMin[4] = { m(12), m(13), m(14), m(15) };
+        float resultMax[4] = { m(12), m(13), m(14), m(15) };
+
+        for (size_t r = 0u; r < 3u; ++r) {
+            for (size_t c = 0u; c < 4u; ++c) {
+                const float a = boxMin[r] * m(r * 4u + c);
+                const float b = boxMax[r] * m(r * 4u + c);
+
+                resultMin[c] += std::min(a, b);
+                resultMax[c] += std::max(a, b);
+            }
+        }
+
+        pResultMins[i] = Vec4f32{ resultMin[0], resultMin[1], resultMin[2], resultMin[3] };
+        pResultMaxs[i] = Vec4f32{ resultMax[0], resultMax[1], resultMax[2], resultMax[3] };
+    }
+#endif // MINECRAFT_MATH_SSE2
+}
+
+// "a * d - b * c" with its rounding error added back, so that it is exactly 0 when both products are equal even if the
+// compiler contracts it into a fused multiply-add, which otherwise leaves the rounding error of one product alone
+static float DifferenceOfProducts(const float a, const float d, const float b, const float c) noexcept {
+    const float bc = b * c;
+    return std::fma(a, d, -bc) + std::fma(-b, c, bc);
+}
+
+// Cofactors over the determinant, it is called a few times per frame at most so it stays scalar
+std::optional<Mat4x4f32> Inverted(const Mat4x4f32& m) noexcept {
+    // 2x2 determinants of the two bottom rows, then of the two top rows
+    const float b0 = DifferenceOfProducts(m(8),  m(13), m(9),  m(12));
+    const float b1 = DifferenceOfProducts(m(8),  m(14), m(10), m(12));
+    const float b2 = DifferenceOfProducts(m(8),  m(15), m(11), m(12));
+    const float b3 = DifferenceOfProducts(m(9),  m(14), m(10), m(13));
+    const float b4 = DifferenceOfProducts(m(9),  m(15), m(11), m(13));
+    const float b5 = DifferenceOfProducts(m(10), m(15), m(11), m(14));
+
+    const float a0 = DifferenceOfProducts(m(0), m(5), m(1), m(4));
+    const float a1 = DifferenceOfProducts(m(0), m(6), m(2), m(4));
+    const float a2 = DifferenceOfProducts(m(0), m(7), m(3), m(4));
+    const float a3 = DifferenceOfProducts(m(1), m(6), m(2), m(5));
+    const float a4 = DifferenceOfProducts(m(1), m(7), m(3), m(5));
+    const float a5 = DifferenceOfProducts(m(2), m(7), m(3), m(6));
+
+    const float determinant = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0;
+    if (determinant == 0.f || !std::isfinite(determinant))
+        return std::nullopt;
+
+    const float inverseDeterminant = 1.f / determinant;
+
+    return Mat4x4f32{{
+        (+m(5)  * b5 - m(6)  * b4 + m(7)  * b3) * inverseDeterminant,
+        (-m(1)  * b5 + m(2)  * b4 - m(3)  * b3) * inverseDeterminant,
+        (+m(13) * a5 - m(14) * a4 + m(15) * a3) * inverseDeterminant,
+        (-m(9)  * a5 + m(10) * a4 - m(11) * a3) * inverseDeterminant,
+
+        (-m(4)  * b5 + m(6)  * b2 - m(7)  * b1) * inverseDeterminant,
+        (+m(0)  * b5 - m(2)  * b2 + m(3)  * b1) * inverseDeterminant,
+        (-m(12) * a5 + m(14) * a2 - m(15) * a1) * inverseDeterminant,
+        (+m(8)  * a5 - m(10) * a2 + m(11) * a1) * inverseDeterminant,
+
+        (+m(4)  * b4 - m(5)  * b2 + m(7)  * b0) * inverseDeterminant,
+        (-m(0)  * b4 + m(1)  * b2 - m(3)  * b0) * inverseDeterminant,
+        (+m(12) * a4 - m(13) * a2 + m(15) * a0) * inverseDeterminant,
+        (-m(8)  * a4 + m(9)  * a2 - m(11) * a0) * inverseDeterminant,
+
+        (-m(4)  * b3 + m(5)  * b1 - m(6)  * b0) * inverseDeterminant,
+        (+m(0)  * b3 - m(1)  * b1 + m(2)  * b0) * inverseDeterminant,
+        (-m(12) * a3 + m(13) * a1 - m(14) * a0) * inverseDeterminant,
+        (+m(8)  * a3 - m(9)  * a1 + m(10) * a0) * inverseDeterminant
+    }};
+}
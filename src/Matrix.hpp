@@ -4,7 +4,8 @@
 #include "Pch.hpp"
 #include "Vector.hpp"
 
-struct Mat4x4f32 {
+// Row major, points are row vectors multiplied on the left like in the shaders, see TransformPoints
+struct alignas(16) Mat4x4f32 {
     std::array<float, 16> m = { 0.f };
 
     inline       float& operator()(const size_t i)       noexcept { return this->m[i]; }
@@ -13,30 +14,92 @@ struct Mat4x4f32 {
     inline       float& operator()(const size_t r, const size_t c)       noexcept { return (*this)((r - 1u) * 4u + c - 1u); }
     inline const float& operator()(const size_t r, const size_t c) const noexcept { return (*this)((r - 1u) * 4u + c - 1u); }
 
+#ifdef MINECRAFT_MATH_SSE2
+    // 0-based, unlike operator()(r, c)
+    inline __m128 LoadRow(const size_t r) const noexcept { return _mm_load_ps(this->m.data() + r * 4u); }
+#endif // MINECRAFT_MATH_SSE2
+
     static Mat4x4f32 Zeroes;
     static Mat4x4f32 Identity;
 }; // struct Mat4x4f32
 
+// "rhs" as a column vector. Kept scalar: the compiler vectorizes loops of these across iterations,
+// which beats a transpose per call
+inline Vec4f32 operator*(const Mat4x4f32& lhs, const Vec4f32& rhs) noexcept {
+    return Vec4f32{
+        lhs(0)  * rhs.x + lhs(1)  * rhs.y + lhs(2)  * rhs.z + lhs(3)  * rhs.w,
+        lhs(4)  * rhs.x + lhs(5)  * rhs.y + lhs(6)  * rhs.z + lhs(7)  * rhs.w,
+        lhs(8)  * rhs.x + lhs(9)  * rhs.y + lhs(10) * rhs.z + lhs(11) * rhs.w,
+        lhs(12) * rhs.x + lhs(13) * rhs.y + lhs(14) * rhs.z + lhs(15) * rhs.w
+    };
+}
+
+#ifdef MINECRAFT_MATH_SSE2
+
+// Each row of the result is a combination of the rows of "rhs"
 inline Mat4x4f32 operator*(const Mat4x4f32& lhs, const Mat4x4f32& rhs) noexcept {
-    Mat4x4f32 result{};
+    const __m128 rhsRow0 = rhs.LoadRow(0u), rhsRow1 = rhs.LoadRow(1u), rhsRow2 = rhs.LoadRow(2u), rhsRow3 = rhs.LoadRow(3u);
+
+    Mat4x4f32 result;
+    for (size_t r = 0u; r < 4u; ++r) {
+        const float* pLhsRow = lhs.m.data() + r * 4u;
+
+        __m128 row = _mm_mul_ps(_mm_set1_ps(pLhsRow[0]), rhsRow0);
+        row = MultiplyAdd(_mm_set1_ps(pLhsRow[1]), rhsRow1, row);
+        row = MultiplyAdd(_mm_set1_ps(pLhsRow[2]), rhsRow2, row);
+        row = MultiplyAdd(_mm_set1_ps(pLhsRow[3]), rhsRow3, row);
 
-    for (char r = 1; r < 5u; ++r)
-        for (char c = 1; c < 5u; ++c) // :-)
-            for (char k = 1; k < 5u; ++k)
-                result(r, c) += lhs(r, k) * rhs(k, c);
+        _mm_store_ps(result.m.data() + r * 4u, row);
+    }
 
     return result;
 }
 
-inline Vec4f32 operator*(const Mat4x4f32& lhs, const Vec4f32& rhs) noexcept {
+// "lhs" as a row vector, like the points of TransformPoints
+inline Vec4f32 operator*(const Vec4f32& lhs, const Mat4x4f32& rhs) noexcept {
+    __m128 result = _mm_mul_ps(_mm_set1_ps(lhs.x), rhs.LoadRow(0u));
+    result = MultiplyAdd(_mm_set1_ps(lhs.y), rhs.LoadRow(1u), result);
+    result = MultiplyAdd(_mm_set1_ps(lhs.z), rhs.LoadRow(2u), result);
+    result = MultiplyAdd(_mm_set1_ps(lhs.w), rhs.LoadRow(3u), result);
+
+    return Vec4f32(result);
+}
+
+#else
+
+inline Mat4x4f32 operator*(const Mat4x4f32& lhs, const Mat4x4f32& rhs) noexcept {
+    Mat4x4f32 result;
+
+    for (size_t r = 0u; r < 4u; ++r)
+        for (size_t c = 0u; c < 4u; ++c)
+            result.m[r * 4u + c] = lhs.m[r * 4u + 0u] * rhs.m[0u * 4u + c] + lhs.m[r * 4u + 1u] * rhs.m[1u * 4u + c]
+                                 + lhs.m[r * 4u + 2u] * rhs.m[2u * 4u + c] + lhs.m[r * 4u + 3u] * rhs.m[3u * 4u + c];
+
+    return result;
+}
+
+// "lhs" as a row vector, like the points of TransformPoints
+inline Vec4f32 operator*(const Vec4f32& lhs, const Mat4x4f32& rhs) noexcept {
     return Vec4f32{
-        lhs(0)  * rhs.x + lhs(1)  * rhs.y + lhs(2)  * rhs.z + lhs(3)  * rhs.w,
-        lhs(4)  * rhs.x + lhs(5)  * rhs.y + lhs(6)  * rhs.z + lhs(7)  * rhs.w,
-        lhs(8)  * rhs.x + lhs(9)  * rhs.y + lhs(10) * rhs.z + lhs(11) * rhs.w,
-        lhs(12) * rhs.x + lhs(13) * rhs.y + lhs(14) * rhs.z + lhs(15) * rhs.w
+        lhs.x * rhs(0) + lhs.y * rhs(4) + lhs.z * rhs(8)  + lhs.w * rhs(12),
+        lhs.x * rhs(1) + lhs.y * rhs(5) + lhs.z * rhs(9)  + lhs.w * rhs(13),
+        lhs.x * rhs(2) + lhs.y * rhs(6) + lhs.z * rhs(10) + lhs.w * rhs(14),
+        lhs.x * rhs(3) + lhs.y * rhs(7) + lhs.z * rhs(11) + lhs.w * rhs(15)
     };
 }
 
+#endif // MINECRAFT_MATH_SSE2
+
+// "pResults[i] = pPoints[i] * m", the arrays may be the same
+void TransformPoints(const Mat4x4f32& m, const Vec4f32* pPoints, Vec4f32* pResults, const size_t count) noexcept;
+
+// The bounds of the boxes once transformed by "m", which must be affine. The w of the boxes is ignored
+void TransformAABBs(const Mat4x4f32& m, const Vec4f32* pBoxMins, const Vec4f32* pBoxMaxs,
+                    Vec4f32* pResultMins, Vec4f32* pResultMaxs, const size_t count) noexcept;
+
+// std::nullopt when "m" is singular
+std::optional<Mat4x4f32> Inverted(const Mat4x4f32& m) noexcept;
+
 inline Mat4x4f32 Transposed(const Mat4x4f32& m) noexcept {
     return Mat4x4f32{ {
         m(0), m(4), m(8),  m(12),
@@ -47,8 +110,8 @@ inline Mat4x4f32 Transposed(const Mat4x4f32& m) noexcept {
 }
 
 inline Mat4x4f32 MakeRotationXMatrix(const float& angle) noexcept {
-    const float sinAngle = std::sinf(angle);
-    const float cosAngle = std::cosf(angle);
+    const float sinAngle = std::sin(angle);
+    const float cosAngle = std::cos(angle);
 
     return Mat4x4f32{{
         1.f, 0.f,      0.f,       0.f,
@@ -59,8 +122,8 @@ inline Mat4x4f32 MakeRotationXMatrix(const float& angle) noexcept {
 }
 
 inline Mat4x4f32 MakeRotationYMatrix(const float& angle) noexcept {
-    const float sinAngle = std::sinf(angle);
-    const float cosAngle = std::cosf(angle);
+    const float sinAngle = std::sin(angle);
+    const float cosAngle = std::cos(angle);
 
     return Mat4x4f32{{
         +cosAngle, 0.f, sinAngle, 0.f,
@@ -71,8 +134,8 @@ inline Mat4x4f32 MakeRotationYMatrix(const float& angle) noexcept {
 }
 
 inline Mat4x4f32 MakeRotationZMatrix(const float& angle) noexcept {
-    const float sinAngle = std::sinf(angle);
-    const float cosAngle = std::cosf(angle);
+    const float sinAngle = std::sin(angle);
+    const float cosAngle = std::cos(angle);
 
     return Mat4x4f32{{
         cosAngle, -sinAngle, 0.f, 0.f,
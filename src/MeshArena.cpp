@@ -0,0 +1,296 @@
+#include "MeshArena.hpp"
+
+BuddyAllocator::BuddyAllocator(const std::uint32_t orderCount) noexcept
+    : m_orderCount(orderCount),
+      m_blockOrders(static_cast<size_t>(1u) << (orderCount - 1u), 0u),
+      m_nextFreeBlocks(static_cast<size_t>(1u) << (orderCount - 1u), NO_BLOCK),
+      m_previousFreeBlocks(static_cast<size_t>(1u) << (orderCount - 1u), NO_BLOCK),
+      m_freeBlockHeads(orderCount, NO_BLOCK),
+      m_nFreeUnits(0u)
+{
+    this->PushFreeBlock(0u, orderCount - 1u);
+}
+
+void BuddyAllocator::PushFreeBlock(const std::uint32_t unit, const std::uint32_t order) noexcept {
+    const std::uint32_t head = this->m_freeBlockHeads[order];
+
+    this->m_blockOrders[unit]        = static_cast<std::uint8_t>(order) | FREE_FLAG;
+    this->m_nextFreeBlocks[unit]     = head;
+    this->m_previousFreeBlocks[unit] = NO_BLOCK;
+
+    if (head != NO_BLOCK)
+        this->m_previousFreeBlocks[head] = unit;
+
+    this->m_freeBlockHeads[order] = unit;
+    this->m_nFreeUnits += static_cast<size_t>(1u) << order;
+}
+
+void BuddyAllocator::RemoveFreeBlock(const std::uint32_t unit, const std::uint32_t order) noexcept {
+    const std::uint32_t next     = this->m_nextFreeBlocks[unit];
+    const std::uint32_t previous = this->m_previousFreeBlocks[unit];
+
+    if (previous != NO_BLOCK)
+        this->m_nextFreeBlocks[previous] = next;
+    else
+        this->m_freeBlockHeads[order] = next;
+
+    if (next != NO_BLOCK)
+        this->m_previousFreeBlocks[next] = previous;
+
+    this->m_blockOrders[unit] = static_cast<std::uint8_t>(order);
+    this->m_nFreeUnits -= static_cast<size_t>(1u) << order;
+}
+
+std::optional<std::uint32_t> BuddyAllocator::Allocate(const std::uint32_t order) noexcept {
+    // the smallest free block large enough is split down to the requested order
+    std::uint32_t blockOrder = order;
+    while (blockOrder < this->m_orderCount && this->m_freeBlockHeads[blockOrder] == NO_BLOCK)
+        ++blockOrder;
+
+    if (blockOrder >= this->m_orderCount)
+        return {  };
+
+    const std::uint32_t unit = this->m_freeBlockHeads[blockOrder];
+    this->RemoveFreeBlock(unit, blockOrder);
+
+    while (blockOrder > order) {
+        --blockOrder;
+        this->PushFreeBlock(unit + (1u << blockOrder), blockOrder);
+    }
+
+    this->m_blockOrders[unit] = static_cast<std::uint8_t>(order);
+
+    return unit;
+}
+
+void BuddyAllocator::Free(const std::uint32_t unit) noexcept {
+    std::uint32_t blockUnit  = unit;
+    std::uint32_t blockOrder = this->GetBlockOrder(unit);
+
+    while (blockOrder + 1u < this->m_orderCount) {
+        const std::uint32_t buddy = blockUnit ^ (1u << blockOrder);
+
+        // a buddy that was split starts with a smaller block
+        if (this->m_blockOrders[buddy] != (static_cast<std::uint8_t>(blockOrder) | FREE_FLAG))
+            break;
+
+        this->RemoveFreeBlock(buddy, blockOrder);
+        blockUnit = std::min(blockUnit, buddy);
+        ++blockOrder;
+    }
+
+    this->PushFreeBlock(blockUnit, blockOrder);
+}
+
+size_t BuddyAllocator::GetLargestFreeBlockSize() const noexcept {
+    for (std::uint32_t order = this->m_orderCount; order-- > 0u; )
+        if (this->m_freeBlockHeads[order] != NO_BLOCK)
+            return static_cast<size_t>(1u) << order;
+
+    return 0u;
+}
+
+MeshArenaAllocation& MeshArenaAllocation::operator=(MeshArenaAllocation&& other) noexcept {
+    if (this != &other) {
+        this->Reset();
+        this->m_pArena = std::exchange(other.m_pArena, nullptr);
+        this->m_handle = std::exchange(other.m_handle, INVALID_HANDLE);
+    }
+
+    return *this;
+}
+
+void MeshArenaAllocation::Reset() noexcept {
+    if (this->m_pArena && this->m_handle != INVALID_HANDLE)
+        this->m_pArena->Free(this->m_handle);
+
+    this->m_pArena = nullptr;
+    this->m_handle = INVALID_HANDLE;
+}
+
+MeshArena::MeshArena(MeshArenaBackend& backend) noexcept
+    : m_backend(backend)
+{  }
+
+std::uint32_t MeshArena::GetBlockOrder(const size_t byteSize) noexcept {
+    std::uint32_t order = 0u;
+    while ((MIN_BLOCK_BYTE_SIZE << order) < byteSize)
+        ++order;
+
+    return order;
+}
+
+std::optional<MeshArenaLocation> MeshArena::AllocateBlock(const std::uint32_t order, const std::uint32_t excludedPage, const bool bUseEmptyPages) noexcept {
+    // the first pages are filled first, so that the last ones empty out and can be released
+    for (std::uint32_t page = 0u; page < this->m_pages.size(); ++page) {
+        std::optional<Page>& pageOpt = this->m_pages[page];
+        if (!pageOpt.has_value() || page == excludedPage || (!bUseEmptyPages && pageOpt.value().nAllocatedBytes == 0u))
+            continue;
+
+        const std::optional<std::uint32_t> unitOpt = pageOpt.value().allocator.Allocate(order);
+        if (!unitOpt.has_value())
+            continue;
+
+        pageOpt.value().nAllocatedBytes += MIN_BLOCK_BYTE_SIZE << order;
+
+        return MeshArenaLocation{ page, static_cast<std::uint32_t>(unitOpt.value() * MIN_BLOCK_BYTE_SIZE), 0u };
+    }
+
+    return {  };
+}
+
+void MeshArena::FreeBlock(const MeshArenaLocation& location) noexcept {
+    Page& page = this->m_pages[location.page].value();
+
+    const std::uint32_t unit = static_cast<std::uint32_t>(location.byteOffset / MIN_BLOCK_BYTE_SIZE);
+
+    page.nAllocatedBytes -= MIN_BLOCK_BYTE_SIZE << page.allocator.GetBlockOrder(unit);
+    page.allocator.Free(unit);
+}
+
+MeshArenaAllocation MeshArena::Allocate(const void* pData, const size_t byteSize) noexcept {
+    if (byteSize == 0u || byteSize > PAGE_BYTE_SIZE)
+        return {  };
+
+    const std::uint32_t order = GetBlockOrder(byteSize);
+
+    std::optional<MeshArenaLocation> locationOpt = this->AllocateBlock(order, this->m_evacuatedPage, true);
+    if (!locationOpt.has_value()) {
+        const std::uint32_t page = static_cast<std::uint32_t>(std::find_if(this->m_pages.begin(), this->m_pages.end(), [](const std::optional<Page>& pageOpt) {
+            return !pageOpt.has_value();
+        }) - this->m_pages.begin());
+
+        if (page == this->m_pages.size())
+            this->m_pages.emplace_back();
+
+        this->m_pages[page].emplace();
+        this->m_backend.CreatePage(page, PAGE_BYTE_SIZE);
+
+        locationOpt = this->AllocateBlock(order, this->m_evacuatedPage, true);
+    }
+
+    MeshArenaLocation location = locationOpt.value();
+    location.byteSize = static_cast<std::uint32_t>(byteSize);
+
+    this->m_backend.Write(location.page, location.byteOffset, pData, byteSize);
+
+    Handle handle;
+    if (!this->m_freeHandles.empty()) {
+        handle = this->m_freeHandles.back();
+        this->m_freeHandles.pop_back();
+        this->m_locations[handle] = location;
+    } else {
+        handle = static_cast<Handle>(this->m_locations.size());
+        this->m_locations.push_back(location);
+    }
+
+    ++this->m_nAllocations;
+    this->m_nRequestedBytes += byteSize;
+
+    return MeshArenaAllocation(this, handle);
+}
+
+void MeshArena::Free(const Handle handle) noexcept {
+    MeshArenaLocation& location = this->m_locations[handle];
+
+    this->FreeBlock(location);
+
+    --this->m_nAllocations;
+    this->m_nRequestedBytes -= location.byteSize;
+
+    location = MeshArenaLocation{ NO_PAGE, 0u, 0u };
+    this->m_freeHandles.push_back(handle);
+}
+
+size_t MeshArena::Defragment(const size_t maxMovedBytes) noexcept {
+    // allocations are only moved to pages that are already used, moving them to an empty page wouldn't free anything
+    if (this->m_evacuatedPage == NO_PAGE) {
+        std::uint32_t leastOccupiedPage = NO_PAGE;
+        size_t        freeBytes         = 0u;
+
+        for (std::uint32_t page = 0u; page < this->m_pages.size(); ++page) {
+            if (!this->m_pages[page].has_value() || this->m_pages[page].value().nAllocatedBytes == 0u)
+                continue;
+
+            const size_t nAllocatedBytes = this->m_pages[page].value().nAllocatedBytes;
+            freeBytes += PAGE_BYTE_SIZE - nAllocatedBytes;
+
+            if (leastOccupiedPage == NO_PAGE || nAllocatedBytes < this->m_pages[leastOccupiedPage].value().nAllocatedBytes)
+                leastOccupiedPage = page;
+        }
+
+        if (leastOccupiedPage != NO_PAGE) {
+            const size_t nAllocatedBytes = this->m_pages[leastOccupiedPage].value().nAllocatedBytes;
+
+            if (nAllocatedBytes < PAGE_BYTE_SIZE * EVACUATION_OCCUPANCY && freeBytes - (PAGE_BYTE_SIZE - nAllocatedBytes) >= nAllocatedBytes)
+                this->m_evacuatedPage = leastOccupiedPage;
+        }
+    }
+
+    size_t movedBytes = 0u;
+
+    if (this->m_evacuatedPage != NO_PAGE) {
+        for (Handle handle = 0u; handle < this->m_locations.size() && movedBytes < maxMovedBytes; ++handle) {
+            MeshArenaLocation& location = this->m_locations[handle];
+            if (location.byteSize == 0u || location.page != this->m_evacuatedPage)
+                continue;
+
+            const std::uint32_t order = this->m_pages[location.page].value().allocator.GetBlockOrder(static_cast<std::uint32_t>(location.byteOffset / MIN_BLOCK_BYTE_SIZE));
+
+            // the other pages are too fragmented after all, another page is tried next time
+            const std::optional<MeshArenaLocation> newLocationOpt = this->AllocateBlock(order, this->m_evacuatedPage, false);
+            if (!newLocationOpt.has_value()) {
+                this->m_evacuatedPage = NO_PAGE;
+                break;
+            }
+
+            MeshArenaLocation newLocation = newLocationOpt.value();
+            newLocation.byteSize = location.byteSize;
+
+            this->m_backend.Copy(location.page, location.byteOffset, newLocation.page, newLocation.byteOffset, location.byteSize);
+            this->FreeBlock(location);
+
+            location    = newLocation;
+            movedBytes += location.byteSize;
+        }
+    }
+
+    // one empty page is kept, so that a mesh rebuilt right after doesn't create a page again
+    bool bHasSparePage = false;
+    for (std::uint32_t page = 0u; page < this->m_pages.size(); ++page) {
+        std::optional<Page>& pageOpt = this->m_pages[page];
+        if (!pageOpt.has_value() || pageOpt.value().nAllocatedBytes != 0u)
+            continue;
+
+        if (page == this->m_evacuatedPage)
+            this->m_evacuatedPage = NO_PAGE;
+
+        if (!bHasSparePage) {
+            bHasSparePage = true;
+            continue;
+        }
+
+        this->m_backend.DestroyPage(page);
+        pageOpt.reset();
+    }
+
+    return movedBytes;
+}
+
+MeshArenaStats MeshArena::GetStats() const noexcept {
+    MeshArenaStats stats;
+    stats.nAllocations   = this->m_nAllocations;
+    stats.requestedBytes = this->m_nRequestedBytes;
+
+    for (const std::optional<Page>& pageOpt : this->m_pages) {
+        if (!pageOpt.has_value())
+            continue;
+
+        ++stats.nPages;
+        stats.capacity        += PAGE_BYTE_SIZE;
+        stats.allocatedBytes  += pageOpt.value().nAllocatedBytes;
+        stats.largestFreeBlock = std::max(stats.largestFreeBlock, pageOpt.value().allocator.GetLargestFreeBlockSize() * MIN_BLOCK_BYTE_SIZE);
+    }
+
+    return stats;
+}
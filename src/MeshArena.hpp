@@ -0,0 +1,231 @@
+#ifndef __MINECRAFT__MESH_ARENA_HPP
+#define __MINECRAFT__MESH_ARENA_HPP
+
+#include "Pch.hpp"
+
+// Splits 2^(orderCount - 1) units into power of two blocks, a freed block is merged back with its buddy
+// (the other half of the block it was split from) whenever the buddy is free too
+class BuddyAllocator {
+private:
+    static constexpr std::uint32_t NO_BLOCK  = 0xFFFFFFFFu;
+    static constexpr std::uint8_t  FREE_FLAG = 0x80u;
+
+    std::uint32_t m_orderCount;
+
+    // The order of the block starting at each unit, with FREE_FLAG when the block is free.
+    // Only the entries of the units blocks start at are meaningful
+    std::vector<std::uint8_t> m_blockOrders;
+
+    // Free blocks are linked per order through the units they start at
+    std::vector<std::uint32_t> m_nextFreeBlocks;
+    std::vector<std::uint32_t> m_previousFreeBlocks;
+    std::vector<std::uint32_t> m_freeBlockHeads;
+
+    size_t m_nFreeUnits;
+
+private:
+    void PushFreeBlock(const std::uint32_t unit, const std::uint32_t order) noexcept;
+
+    void RemoveFreeBlock(const std::uint32_t unit, const std::uint32_t order) noexcept;
+
+public:
+    explicit BuddyAllocator(const std::uint32_t orderCount) noexcept;
+
+    inline size_t GetUnitCount()     const noexcept { return this->m_blockOrders.size(); }
+    inline size_t GetFreeUnitCount() const noexcept { return this->m_nFreeUnits; }
+
+    // The first unit of a block of 2^order units, std::nullopt when there is no free block large enough
+    std::optional<std::uint32_t> Allocate(const std::uint32_t order) noexcept;
+
+    // "unit" is the first unit of a block returned by Allocate
+    void Free(const std::uint32_t unit) noexcept;
+
+    inline std::uint32_t GetBlockOrder(const std::uint32_t unit) const noexcept { return this->m_blockOrders[unit] & ~FREE_FLAG; }
+
+    // In units, 0 when every unit is allocated
+    size_t GetLargestFreeBlockSize() const noexcept;
+}; // class BuddyAllocator
+
+// Stores the bytes of the arena's pages, so that the allocator doesn't depend on a graphics API
+class MeshArenaBackend {
+public:
+    virtual ~MeshArenaBackend() noexcept = default;
+
+    // Page indices are reused once their page was destroyed
+    virtual void CreatePage (const std::uint32_t page, const size_t byteSize) noexcept = 0;
+    virtual void DestroyPage(const std::uint32_t page) noexcept = 0;
+
+    virtual void Write(const std::uint32_t page, const size_t byteOffset, const void* pData, const size_t byteSize) noexcept = 0;
+
+    // The source and destination are always in different pages
+    virtual void Copy(const std::uint32_t sourcePage, const size_t sourceByteOffset,
+                      const std::uint32_t destinationPage, const size_t destinationByteOffset, const size_t byteSize) noexcept = 0;
+}; // class MeshArenaBackend
+
+// Keeps the pages in memory, for tests and benchmarks away from the GPU
+class CpuMeshArenaBackend final : public MeshArenaBackend {
+private:
+    std::vector<std::vector<std::uint8_t>> m_pages;
+
+public:
+    inline void CreatePage(const std::uint32_t page, const size_t byteSize) noexcept override {
+        if (page >= this->m_pages.size())
+            this->m_pages.resize(page + 1u);
+
+        this->m_pages[page].assign(byteSize, 0u);
+    }
+
+    inline void DestroyPage(const std::uint32_t page) noexcept override {
+        this->m_pages[page].clear();
+        this->m_pages[page].shrink_to_fit();
+    }
+
+    inline void Write(const std::uint32_t page, const size_t byteOffset, const void* pData, const size_t byteSize) noexcept override {
+        std::memcpy(this->m_pages[page].data() + byteOffset, pData, byteSize);
+    }
+
+    inline void Copy(const std::uint32_t sourcePage, const size_t sourceByteOffset,
+                     const std::uint32_t destinationPage, const size_t destinationByteOffset, const size_t byteSize) noexcept override {
+        std::memcpy(this->m_pages[destinationPage].data() + destinationByteOffset, this->m_pages[sourcePage].data() + sourceByteOffset, byteSize);
+    }
+
+    inline const std::uint8_t* GetPageData(const std::uint32_t page) const noexcept { return this->m_pages[page].data(); }
+}; // class CpuMeshArenaBackend
+
+// Where an allocation currently is, it may move when the arena is defragmented
+struct MeshArenaLocation {
+    std::uint32_t page;
+    std::uint32_t byteOffset;
+    std::uint32_t byteSize; // as requested, 0 for freed handles
+}; // struct MeshArenaLocation
+
+struct MeshArenaStats {
+    size_t nPages       = 0u;
+    size_t nAllocations = 0u;
+
+    size_t capacity         = 0u; // in bytes, for every page
+    size_t requestedBytes   = 0u; // the sizes the allocations were made with
+    size_t allocatedBytes   = 0u; // the blocks given to them, rounded up to powers of two
+    size_t largestFreeBlock = 0u; // in bytes
+
+    // The part of the pages used by the allocations' data
+    inline float GetOccupancy() const noexcept { return this->capacity != 0u ? static_cast<float>(this->requestedBytes) / this->capacity : 0.f; }
+
+    // 0 when the free space is a single block, close to 1 when it is scattered in small blocks
+    inline float GetFragmentation() const noexcept {
+        const size_t freeBytes = this->capacity - this->allocatedBytes;
+        return freeBytes != 0u ? 1.f - static_cast<float>(this->largestFreeBlock) / freeBytes : 0.f;
+    }
+}; // struct MeshArenaStats
+
+class MeshArena;
+
+// Frees its block of the arena when destroyed, like a ComPtr releases its buffer
+class MeshArenaAllocation {
+    friend MeshArena;
+public:
+    using Handle = std::uint32_t;
+
+    static constexpr Handle INVALID_HANDLE = 0xFFFFFFFFu;
+
+private:
+    MeshArena* m_pArena = nullptr;
+    Handle     m_handle = INVALID_HANDLE;
+
+    inline MeshArenaAllocation(MeshArena* pArena, const Handle handle) noexcept
+        : m_pArena(pArena), m_handle(handle)
+    {  }
+
+public:
+    inline MeshArenaAllocation() noexcept = default;
+
+    inline MeshArenaAllocation(MeshArenaAllocation&& other) noexcept
+        : m_pArena(std::exchange(other.m_pArena, nullptr)), m_handle(std::exchange(other.m_handle, INVALID_HANDLE))
+    {  }
+
+    MeshArenaAllocation& operator=(MeshArenaAllocation&& other) noexcept;
+
+    MeshArenaAllocation(const MeshArenaAllocation&) = delete;
+    MeshArenaAllocation& operator=(const MeshArenaAllocation&) = delete;
+
+    inline ~MeshArenaAllocation() noexcept { this->Reset(); }
+
+    void Reset() noexcept;
+
+    inline bool IsValid() const noexcept { return this->m_handle != INVALID_HANDLE; }
+
+    inline Handle GetHandle() const noexcept { return this->m_handle; }
+}; // class MeshArenaAllocation
+
+// Suballocates vertex data from a few large pages instead of a buffer per mesh. Each page is split by a BuddyAllocator,
+// allocations are referred to by handles, so that Defragment can move them to empty the least used pages
+class MeshArena {
+    friend MeshArenaAllocation;
+public:
+    using Handle = MeshArenaAllocation::Handle;
+
+    static constexpr size_t        MIN_BLOCK_BYTE_SIZE = 256u;
+    static constexpr std::uint32_t PAGE_ORDER_COUNT    = 15u;
+    static constexpr size_t        PAGE_BYTE_SIZE      = MIN_BLOCK_BYTE_SIZE << (PAGE_ORDER_COUNT - 1u); // 4 MiB
+
+    // Pages less occupied than this are emptied by Defragment when the other pages have room for their allocations
+    static constexpr float EVACUATION_OCCUPANCY = 0.5f;
+
+private:
+    static constexpr std::uint32_t NO_PAGE = 0xFFFFFFFFu;
+
+    MeshArenaBackend& m_backend;
+
+    struct Page {
+        BuddyAllocator allocator = BuddyAllocator(PAGE_ORDER_COUNT);
+        size_t         nAllocatedBytes = 0u;
+    }; // struct Page
+
+    // Destroyed pages leave an empty slot, reused by the next page created
+    std::vector<std::optional<Page>> m_pages;
+
+    // Indexed by handle, freed handles are reused
+    std::vector<MeshArenaLocation> m_locations;
+    std::vector<Handle>            m_freeHandles;
+
+    size_t m_nAllocations   = 0u;
+    size_t m_nRequestedBytes = 0u;
+
+    // The page Defragment is emptying, nothing is allocated in it in the meantime
+    std::uint32_t m_evacuatedPage = NO_PAGE;
+
+private:
+    static std::uint32_t GetBlockOrder(const size_t byteSize) noexcept;
+
+    // In the first page that has room, other than "excludedPage" (and the empty pages unless "bUseEmptyPages"), std::nullopt when none has
+    std::optional<MeshArenaLocation> AllocateBlock(const std::uint32_t order, const std::uint32_t excludedPage, const bool bUseEmptyPages) noexcept;
+
+    void FreeBlock(const MeshArenaLocation& location) noexcept;
+
+    void Free(const Handle handle) noexcept;
+
+public:
+    explicit MeshArena(MeshArenaBackend& backend) noexcept;
+
+    MeshArena(const MeshArena&) = delete;
+    MeshArena& operator=(const MeshArena&) = delete;
+
+    // Copies "pData" into the arena, the allocation is invalid when "byteSize" is 0 or larger than a page
+    MeshArenaAllocation Allocate(const void* pData, const size_t byteSize) noexcept;
+
+    inline const MeshArenaLocation& GetLocation(const Handle handle) const noexcept { return this->m_locations[handle]; }
+
+    // Overwrites the allocation's data in place, "pData" holds as many bytes as it was allocated with
+    inline void Write(const Handle handle, const void* pData) noexcept {
+        const MeshArenaLocation& location = this->m_locations[handle];
+        this->m_backend.Write(location.page, location.byteOffset, pData, location.byteSize);
+    }
+
+    // Moves at most about "maxMovedBytes" out of the least occupied page, releases it once it is empty,
+    // along with the empty pages beyond a spare one. Returns the number of bytes moved
+    size_t Defragment(const size_t maxMovedBytes) noexcept;
+
+    MeshArenaStats GetStats() const noexcept;
+}; // class MeshArena
+
+#endif // __MINECRAFT__MESH_ARENA_HPP
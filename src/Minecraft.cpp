@@ -1,14 +1,14 @@
 #include "Minecraft.hpp"
 
 Minecraft::Minecraft() noexcept : m_window("Minecraft", 1920u, 1080u),
-                                  m_noise(std::random_device()),
-                                  m_camera(Camera(Vec4f32{0.f, 40, 0.01f, 1000.f}, M_PI_2, 9.f / 16.f, 0.1f, 1000.f))
+                                  m_camera(Camera(Vec4f32{0.f, 40, 0.01f, 1000.f}, M_PI_2, 9.f / 16.f, 0.1f, 1000.f)),
+                                  m_worldGenerator(1234u),
+                                  m_chunkStorage("world"),
+                                  m_lastSaveTime(std::chrono::steady_clock::now())
 {
     this->m_window.ClipCursor();
     this->m_window.HideCursor();
 
-    this->m_noise.reseed(1234);
-
     DXGI_SWAP_CHAIN_DESC scd = {};
     scd.BufferCount = 2u;
     scd.BufferDesc.Width  = this->m_window.GetWidth();
@@ -63,28 +63,14 @@ Minecraft::Minecraft() noexcept : m_window("Minecraft", 1920u, 1080u),
     if (this->m_pDevice->CreatePixelShader(pPShaderByteCode->GetBufferPointer(), pPShaderByteCode->GetBufferSize(), nullptr, &this->m_pPixelShader) != S_OK)
         FATAL_ERROR("Failed to create a vertex shader");
 
-    std::array<D3D11_INPUT_ELEMENT_DESC, 3u> ieds = {};
+    std::array<D3D11_INPUT_ELEMENT_DESC, 1u> ieds = {};
     ieds[0].AlignedByteOffset = 0;
-    ieds[0].Format = DXGI_FORMAT::DXGI_FORMAT_R32G32B32A32_FLOAT;
+    ieds[0].Format = DXGI_FORMAT::DXGI_FORMAT_R32G32_UINT;
     ieds[0].InputSlotClass = D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA;
-    ieds[0].SemanticName = "POSITION";
+    ieds[0].SemanticName = "PACKED_VERTEX";
     ieds[0].InputSlot = 0;
     ieds[0].InstanceDataStepRate = 0;
 
-    ieds[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-    ieds[1].Format = DXGI_FORMAT::DXGI_FORMAT_R32G32_FLOAT;
-    ieds[1].InputSlotClass = D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA;
-    ieds[1].SemanticName = "UV";
-    ieds[1].InputSlot = 0;
-    ieds[1].InstanceDataStepRate = 0;
-
-    ieds[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-    ieds[2].Format = DXGI_FORMAT::DXGI_FORMAT_R32_FLOAT;
-    ieds[2].InputSlotClass = D3D11_INPUT_CLASSIFICATION::D3D11_INPUT_PER_VERTEX_DATA;
-    ieds[2].SemanticName = "LIGHTING";
-    ieds[2].InputSlot = 0;
-    ieds[2].InstanceDataStepRate = 0;
-
     if (this->m_pDevice->CreateInputLayout(ieds.data(), static_cast<UINT>(ieds.size()), pVShaderByteCode->GetBufferPointer(), pVShaderByteCode->GetBufferSize(), &this->m_pInputLayout) != S_OK)
         FATAL_ERROR("Failed to create an input layout for a vertex shader");
 
@@ -99,7 +85,18 @@ Minecraft::Minecraft() noexcept : m_window("Minecraft", 1920u, 1080u),
     if (this->m_pDevice->CreateBuffer(&cbd, nullptr, &this->m_pConstantBuffer) != S_OK)
         FATAL_ERROR("Failed to create a constant buffer");
 
+    cbd.ByteWidth = sizeof(Vec4f32);
+
+    if (this->m_pDevice->CreateBuffer(&cbd, nullptr, &this->m_pChunkConstantBuffer) != S_OK)
+        FATAL_ERROR("Failed to create a constant buffer");
+
+    this->ReserveQuadIndexBuffer(CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT * 16u);
+
+    this->m_pMeshArenaBackend = std::make_unique<DXMeshArenaBackend>(this->m_pDevice, this->m_pDeviceContext);
+    this->m_pMeshArena        = std::make_unique<MeshArena>(*this->m_pMeshArenaBackend);
+
     this->CreateDepthBuffer();
+    this->CreateTranslucentPassStates();
     this->LoadAndCreateTextureAtlas();
 }
 
@@ -149,6 +146,72 @@ void Minecraft::CreateDepthBuffer() noexcept
         FATAL_ERROR("Failed to create a depth stencil view");
 }
 
+void Minecraft::CreateTranslucentPassStates() noexcept
+{
+    // the atlas has no alpha, the blend factor set by ExecuteDrawList stands for it
+    D3D11_BLEND_DESC bd{};
+    bd.RenderTarget[0].BlendEnable = true;
+    bd.RenderTarget[0].SrcBlend = D3D11_BLEND_BLEND_FACTOR;
+    bd.RenderTarget[0].DestBlend = D3D11_BLEND_INV_BLEND_FACTOR;
+    bd.RenderTarget[0].BlendOp = D3D11_BLEND_OP_ADD;
+    bd.RenderTarget[0].SrcBlendAlpha = D3D11_BLEND_ONE;
+    bd.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_ZERO;
+    bd.RenderTarget[0].BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    bd.RenderTarget[0].RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+
+    if (this->m_pDevice->CreateBlendState(&bd, &this->m_pTranslucentBlendState) != S_OK)
+        FATAL_ERROR("Failed to create the translucent blend state");
+
+    // the faces behind a translucent one still have to be drawn
+    D3D11_DEPTH_STENCIL_DESC dsd{};
+    dsd.DepthEnable = true;
+    dsd.DepthWriteMask = D3D11_DEPTH_WRITE_MASK_ZERO;
+    dsd.DepthFunc = D3D11_COMPARISON_LESS;
+    dsd.StencilEnable = false;
+
+    if (this->m_pDevice->CreateDepthStencilState(&dsd, &this->m_pTranslucentDepthStencilState) != S_OK)
+        FATAL_ERROR("Failed to create the translucent depth stencil state");
+}
+
+void Minecraft::ReserveQuadIndexBuffer(const size_t nQuads) noexcept
+{
+    if (nQuads <= this->m_nQuadIndexBufferQuads)
+        return;
+
+    // grow geometrically so that a few big chunks don't each trigger a reallocation
+    const size_t nNewQuads = std::max(nQuads, this->m_nQuadIndexBufferQuads * 2u);
+
+    std::vector<std::uint32_t> indices(nNewQuads * 6u);
+    for (size_t i = 0u; i < nNewQuads; ++i) {
+        const std::uint32_t baseVertex = static_cast<std::uint32_t>(i * 4u);
+
+        indices[i * 6u + 0u] = baseVertex + 0u;
+        indices[i * 6u + 1u] = baseVertex + 1u;
+        indices[i * 6u + 2u] = baseVertex + 2u;
+        indices[i * 6u + 3u] = baseVertex + 0u;
+        indices[i * 6u + 4u] = baseVertex + 2u;
+        indices[i * 6u + 5u] = baseVertex + 3u;
+    }
+
+    D3D11_BUFFER_DESC bufferDesc = {};
+    bufferDesc.BindFlags = D3D11_BIND_FLAG::D3D11_BIND_INDEX_BUFFER;
+    bufferDesc.ByteWidth = static_cast<UINT>(indices.size() * sizeof(std::uint32_t));
+    bufferDesc.CPUAccessFlags = 0;
+    bufferDesc.MiscFlags = 0;
+    bufferDesc.StructureByteStride = sizeof(std::uint32_t);
+    bufferDesc.Usage = D3D11_USAGE::D3D11_USAGE_IMMUTABLE;
+
+    D3D11_SUBRESOURCE_DATA sd = {};
+    sd.pSysMem = indices.data();
+    sd.SysMemPitch = 0;
+    sd.SysMemSlicePitch = 0;
+
+    if (this->m_pDevice->CreateBuffer(&bufferDesc, &sd, &this->m_pQuadIndexBuffer) != S_OK)
+        FATAL_ERROR("Failed to create the quad index buffer");
+
+    this->m_nQuadIndexBufferQuads = nNewQuads;
+}
+
 void Minecraft::LoadAndCreateTextureAtlas() noexcept
 {
     this->m_textureAtlasImage = Image(L"texture_atlas.png");
@@ -197,50 +260,398 @@ void Minecraft::LoadAndCreateTextureAtlas() noexcept
         FATAL_ERROR("Failed to create a sampler state");
 }
 
+// Offset to the neighbour on each CHUNK_SIDE, and the side of the neighbour that touches the chunk
+static constexpr std::array<std::array<std::int16_t, 2>, static_cast<size_t>(CHUNK_SIDE::_COUNT)> NEIGHBOUR_OFFSETS = {{ {{ -1, 0 }}, {{ 1, 0 }}, {{ 0, -1 }}, {{ 0, 1 }} }};
+static constexpr std::array<CHUNK_SIDE, static_cast<size_t>(CHUNK_SIDE::_COUNT)> OPPOSITE_SIDES = {
+    CHUNK_SIDE::CHUNK_SIDE_RIGHT, CHUNK_SIDE::CHUNK_SIDE_LEFT, CHUNK_SIDE::CHUNK_SIDE_BACK, CHUNK_SIDE::CHUNK_SIDE_FRONT
+};
+
+static inline ChunkCoord GetNeighbourLocation(const ChunkCoord& location, const size_t side) noexcept {
+    return ChunkCoord{ static_cast<std::int16_t>(location.idx + NEIGHBOUR_OFFSETS[side][0]), static_cast<std::int16_t>(location.idz + NEIGHBOUR_OFFSETS[side][1]) };
+}
+
+Chunk* Minecraft::FindNeighbourWithBlocks(const ChunkCoord& location, const size_t side) const noexcept
+{
+    Chunk* pNeighbour = this->m_chunkGrid.Find(GetNeighbourLocation(location, side));
+
+    if (!pNeighbour || pNeighbour->m_bHasPendingJob || !pNeighbour->IsGenerated() || pNeighbour->IsCompressed())
+        return nullptr;
+
+    return pNeighbour;
+}
+
+void Minecraft::SubmitChunkJob(Chunk* pChunk, const bool bGenerateTerrain) noexcept
+{
+    pChunk->m_bHasPendingJob = true;
+
+    const CHUNK_LOD lod = SelectChunkLod(pChunk->GetLocation(), this->m_camera.GetPosition(), this->m_chunkLodDistances);
+
+    // the neighbours' blocks are copied now, while no job is writing them. Coarser LODs don't look at them
+    const std::shared_ptr<ChunkNeighbourBlocks> pNeighbours = std::make_shared<ChunkNeighbourBlocks>();
+    for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT) && lod == CHUNK_LOD::CHUNK_LOD_FULL; ++side) {
+        if (const Chunk* pNeighbour = this->FindNeighbourWithBlocks(pChunk->GetLocation(), side)) {
+            pNeighbour->CopySideBlocks(OPPOSITE_SIDES[side], pNeighbours->sides[side]);
+            pNeighbour->CopySideLight(OPPOSITE_SIDES[side], pNeighbours->sideLights[side]);
+            pNeighbours->sideMask |= static_cast<std::uint8_t>(1u << side);
+        }
+    }
+
+    // a chunk that already has a mesh only rebuilds the sections touched by block edits
+    const std::uint16_t dirtyMeshSections = pChunk->TakeDirtyMeshSections(lod);
+    const std::uint16_t sectionMask       = pChunk->HasDXMesh(lod) ? dirtyMeshSections : ChunkMesh::ALL_SECTIONS;
+
+    const CHUNK_MESHING_MODE meshingMode = this->m_chunkMeshingMode;
+    const std::size_t textureAtlasWidth = this->m_textureAtlasImage.GetWidth();
+
+    this->m_jobSystem.Submit([this, pChunk, pNeighbours, bGenerateTerrain, lod, sectionMask, meshingMode, textureAtlasWidth]() {
+        if (bGenerateTerrain) {
+            PROFILE_SCOPE("LoadOrGenerateChunk");
+
+            if (!this->m_chunkStorage.LoadChunk(*pChunk))
+                this->m_worldGenerator.GenerateChunk(*pChunk);
+
+            // light isn't saved, the neighbours' light comes in later through StitchChunkLight
+            LightEngine lightEngine;
+            lightEngine.ComputeChunkLight(*pChunk);
+
+            // new blocks are meshed whole anyway
+            pChunk->TakeDirtyMeshSections(lod);
+        }
+
+        ChunkMesh mesh = pChunk->GenerateMesh(meshingMode, textureAtlasWidth, *pNeighbours, sectionMask, lod);
+        const ChunkColumnHeights columnHeights = pChunk->ComputeColumnHeights();
+        const ChunkSectionConnectivity sectionConnectivity = pChunk->UpdateSectionConnectivity();
+
+        std::lock_guard<std::mutex> lock(this->m_finishedChunkMeshesMutex);
+        this->m_finishedChunkMeshes.push_back(FinishedChunkMesh{ pChunk, std::move(mesh), columnHeights, sectionConnectivity });
+    });
+}
+
+void Minecraft::UploadFinishedChunkMeshes() noexcept
+{
+    PROFILE_SCOPE("UploadFinishedChunkMeshes");
+
+    std::vector<FinishedChunkMesh> finishedChunkMeshes;
+
+    {
+        std::lock_guard<std::mutex> lock(this->m_finishedChunkMeshesMutex);
+        finishedChunkMeshes.swap(this->m_finishedChunkMeshes);
+    }
+
+    for (const FinishedChunkMesh& finishedChunkMesh : finishedChunkMeshes) {
+        Chunk* pChunk = finishedChunkMesh.pChunk;
+        pChunk->m_bHasPendingJob = false;
+
+        // the camera went away while the mesh was being built, it will be rebuilt when it comes back
+        if (!IsChunkInRenderWindow(pChunk->GetLocation(), this->m_camera.GetPosition()))
+            continue;
+
+        // the mesh the sections were rebuilt for was unloaded in the meantime, the chunk is meshed whole again later
+        if (!pChunk->HasDXMesh(finishedChunkMesh.mesh.lod) && finishedChunkMesh.mesh.sectionMask != ChunkMesh::ALL_SECTIONS)
+            continue;
+
+        pChunk->UploadDXMesh(*this->m_pMeshArena, finishedChunkMesh.mesh);
+
+        if (finishedChunkMesh.mesh.lod == CHUNK_LOD::CHUNK_LOD_FULL)
+            pChunk->m_meshNeighbourMask = finishedChunkMesh.mesh.sectionMask == ChunkMesh::ALL_SECTIONS ? finishedChunkMesh.mesh.neighbourMask
+                                                                                                       : pChunk->m_meshNeighbourMask & finishedChunkMesh.mesh.neighbourMask;
+        pChunk->m_columnHeights = finishedChunkMesh.columnHeights;
+        pChunk->m_meshSectionConnectivity = finishedChunkMesh.sectionConnectivity;
+        this->m_bIsChunkCullingTreeDirty = true;
+
+        // sections are drawn one at a time, the translucent faces of the whole chunk at once. Reserved here rather than
+        // in BuildDrawList, since Render binds the index buffer before building the draw list
+        for (const std::vector<Vertex>& vertices : finishedChunkMesh.mesh.sectionVertices)
+            this->ReserveQuadIndexBuffer(vertices.size() / 4u);
+
+        this->ReserveQuadIndexBuffer(pChunk->m_translucentMesh.GetVertexCount() / 4u);
+
+        // the neighbours meshed without the chunk's blocks are rebuilt, their faces against it may be hidden now
+        for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT); ++side) {
+            Chunk* pNeighbour = this->m_chunkGrid.Find(GetNeighbourLocation(pChunk->GetLocation(), side));
+
+            if (pNeighbour && pNeighbour->HasDXMesh(CHUNK_LOD::CHUNK_LOD_FULL) && (pNeighbour->GetMeshNeighbourMask() & (1u << static_cast<size_t>(OPPOSITE_SIDES[side]))) == 0u)
+                pNeighbour->MarkMeshSectionsDirty(ChunkMesh::ALL_SECTIONS);
+        }
+    }
+}
+
+bool Minecraft::SetBlock(const ChunkCoord& chunkLocation, const size_t idx, const size_t idy, const size_t idz, const BLOCK_TYPE& type) noexcept
+{
+    Chunk* pChunk = this->m_chunkGrid.Find(chunkLocation);
+
+    if (!pChunk || idx >= CHUNK_X_BLOCK_COUNT || idy >= CHUNK_Y_BLOCK_COUNT || idz >= CHUNK_Z_BLOCK_COUNT)
+        return false;
+
+    if (!pChunk->m_bHasPendingJob && !pChunk->IsGenerated())
+        return false;
+
+    // the light of the block reaches into the chunks around it
+    std::optional<LightNeighbourhood> neighbourhood = this->GatherLightNeighbourhood(chunkLocation);
+
+    if (!neighbourhood.has_value()) {
+        this->m_deferredBlockEdits.push_back(BlockEdit{ chunkLocation, static_cast<std::uint8_t>(idx), static_cast<std::uint8_t>(idy), static_cast<std::uint8_t>(idz), type });
+        return true;
+    }
+
+    if (!pChunk->IsGenerated())
+        return false;
+
+    pChunk->SetBlock(idx, idy, idz, type);
+
+    this->m_lightEngine.UpdateBlock(neighbourhood.value(), idx, idy, idz);
+    this->MarkLightChanges(neighbourhood.value());
+
+    // the meshes of the neighbours touching the block see it too
+    const std::array<bool, static_cast<size_t>(CHUNK_SIDE::_COUNT)> bIsOnSide = {
+        idx == 0u, idx == CHUNK_X_BLOCK_COUNT - 1u, idz == 0u, idz == CHUNK_Z_BLOCK_COUNT - 1u
+    };
+
+    for (size_t side = 0u; side < bIsOnSide.size(); ++side) {
+        Chunk* pNeighbour = bIsOnSide[side] ? this->m_chunkGrid.Find(GetNeighbourLocation(chunkLocation, side)) : nullptr;
+
+        if (pNeighbour && pNeighbour->HasDXMesh(CHUNK_LOD::CHUNK_LOD_FULL))
+            pNeighbour->MarkMeshSectionsDirty(static_cast<std::uint16_t>(1u << (idy / CHUNK_SECTION_Y_BLOCK_COUNT)));
+    }
+
+    return true;
+}
+
+void Minecraft::ApplyDeferredBlockEdits() noexcept
+{
+    std::vector<BlockEdit> blockEdits;
+    blockEdits.swap(this->m_deferredBlockEdits);
+
+    for (const BlockEdit& blockEdit : blockEdits)
+        this->SetBlock(blockEdit.location, blockEdit.idx, blockEdit.idy, blockEdit.idz, blockEdit.type);
+}
+
+std::optional<LightNeighbourhood> Minecraft::GatherLightNeighbourhood(const ChunkCoord& location) noexcept
+{
+    std::array<Chunk*, 9u> pChunks{};
+
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            Chunk* pChunk = this->m_chunkGrid.Find(ChunkCoord{ static_cast<std::int16_t>(location.idx + dx), static_cast<std::int16_t>(location.idz + dz) });
+
+            if (pChunk && pChunk->m_bHasPendingJob)
+                return {  };
+
+            pChunks[LightNeighbourhood::GetIndex(dx, dz)] = pChunk;
+        }
+    }
+
+    // no job is writing the chunks, their blocks can be looked at
+    for (Chunk*& pChunk : pChunks) {
+        if (pChunk && !pChunk->IsGenerated())
+            pChunk = nullptr;
+
+        if (pChunk && pChunk->IsCompressed())
+            pChunk->Decompress();
+    }
+
+    return LightNeighbourhood(pChunks);
+}
+
+void Minecraft::MarkLightChanges(const LightNeighbourhood& neighbourhood) noexcept
+{
+    for (int dx = -1; dx <= 1; ++dx) {
+        for (int dz = -1; dz <= 1; ++dz) {
+            Chunk* pChunk = neighbourhood.GetChunk(dx, dz);
+            const std::uint16_t changedSections = neighbourhood.GetChangedSections(dx, dz);
+
+            if (pChunk && changedSections != 0u && pChunk->HasDXMesh(CHUNK_LOD::CHUNK_LOD_FULL))
+                pChunk->MarkMeshSectionsDirty(changedSections);
+        }
+    }
+}
+
+void Minecraft::StitchChunkLight() noexcept
+{
+    PROFILE_SCOPE("StitchChunkLight");
+
+    static constexpr std::uint8_t ALL_SIDES = static_cast<std::uint8_t>((1u << static_cast<size_t>(CHUNK_SIDE::_COUNT)) - 1u);
+
+    std::vector<Chunk*> pUnstitchedChunks;
+
+    this->m_chunkGrid.ForEach([&pUnstitchedChunks](Chunk* pChunk) {
+        if (!pChunk->m_bHasPendingJob && pChunk->IsGenerated() && pChunk->GetLitSideMask() != ALL_SIDES)
+            pUnstitchedChunks.push_back(pChunk);
+    });
+
+    for (Chunk* pChunk : pUnstitchedChunks) {
+        for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT); ++side) {
+            if (pChunk->m_litSideMask & (1u << side))
+                continue;
+
+            // the side is stitched once the neighbour there is lit too
+            Chunk* pNeighbour = this->m_chunkGrid.Find(GetNeighbourLocation(pChunk->GetLocation(), side));
+            if (!pNeighbour || pNeighbour->m_bHasPendingJob || !pNeighbour->IsGenerated())
+                continue;
+
+            std::optional<LightNeighbourhood> neighbourhood = this->GatherLightNeighbourhood(pChunk->GetLocation());
+            if (!neighbourhood.has_value())
+                break;
+
+            this->m_lightEngine.StitchSide(neighbourhood.value(), static_cast<CHUNK_SIDE>(side));
+            this->MarkLightChanges(neighbourhood.value());
+
+            pChunk->m_litSideMask     |= static_cast<std::uint8_t>(1u << side);
+            pNeighbour->m_litSideMask |= static_cast<std::uint8_t>(1u << static_cast<size_t>(OPPOSITE_SIDES[side]));
+        }
+    }
+}
+
+void Minecraft::SaveDirtyChunks(const bool bIncludePendingChunks) noexcept
+{
+    std::vector<Chunk*> pDirtyChunks;
+
+    // a job may be writing the flags of a pending chunk, so they are only read once it is known not to be
+    this->m_chunkGrid.ForEach([&pDirtyChunks, bIncludePendingChunks](Chunk* pChunk) {
+        if ((bIncludePendingChunks || !pChunk->m_bHasPendingJob) && pChunk->IsDirty() && pChunk->IsGenerated())
+            pDirtyChunks.push_back(pChunk);
+    });
+
+    if (!pDirtyChunks.empty())
+        this->m_chunkStorage.SaveChunks(pDirtyChunks);
+
+    this->m_lastSaveTime = std::chrono::steady_clock::now();
+}
+
 void Minecraft::UpdateWorld() noexcept
 {
+    PROFILE_SCOPE("UpdateWorld");
+
     const Vec4f32 cameraPosition = this->m_camera.GetPosition();
 
-    for (Chunk* pChunk : this->m_pChunksToRender) {
-        const ChunkCoord cc = pChunk->GetLocation();
+    this->m_chunkGrid.SetGridOrigin(ChunkGrid::GetGridOrigin(cameraPosition));
+
+    this->UploadFinishedChunkMeshes();
+    this->ApplyDeferredBlockEdits();
+    this->StitchChunkLight();
 
-        if (cc.idx <  (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT - RENDER_DISTANCE - 1 ||
-            cc.idx >= (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT + RENDER_DISTANCE     ||
-            cc.idz <  (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT - RENDER_DISTANCE - 1 ||
-            cc.idz >= (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT + RENDER_DISTANCE) {
+    if (std::chrono::steady_clock::now() - this->m_lastSaveTime >= SAVE_INTERVAL)
+        this->SaveDirtyChunks();
+
+    for (Chunk* pChunk : this->m_pChunksToRender) {
+        if (!IsChunkInRenderWindow(pChunk->GetLocation(), cameraPosition))
            pChunk->UnloadDXMesh();
-        }
     }
 
-    this->m_pChunksToRender.clear();
-
-    
-    // Since generating meshes takes quite a long time, we want to generate at most 1 chunk's mesh per frame
-    // this smooths out the generation and limits stutters caused by this operation
-    bool bStopGeneratingMeshes = false;
+    std::vector<Chunk*> pPreviousChunksToRender;
+    pPreviousChunksToRender.swap(this->m_pChunksToRender);
 
+    // Terrain generation and meshing are requested to the scheduler, which hands them to the job system,
+    // the main thread only uploads the finished meshes (see UploadFinishedChunkMeshes)
     ChunkCoord cc;
     for (cc.idx = (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idx < (cameraPosition.x / BLOCK_LENGTH) / CHUNK_X_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idx) {
         for (cc.idz = (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT - RENDER_DISTANCE - 1; cc.idz < (cameraPosition.z / BLOCK_LENGTH) / CHUNK_Z_BLOCK_COUNT + RENDER_DISTANCE; ++cc.idz) {
-            std::optional<Chunk *> pChunkOpt = this->GetChunk(cc);
-
-            if (!pChunkOpt.has_value()) {
-                this->m_pChunks.insert({cc, std::make_unique<Chunk>(cc)});
-                pChunkOpt = this->GetChunk(cc);
-                
-                pChunkOpt.value()->GenerateDefaultTerrain(this->m_noise);
-                bStopGeneratingMeshes = true;
+            Chunk* pChunk = this->m_chunkGrid.Find(cc);
+
+            if (!pChunk)
+                pChunk = this->m_chunkGrid.Insert(std::make_unique<Chunk>(cc));
+
+            pChunk->MarkUsed(this->m_frameIndex);
+
+            // a pending chunk is never compressed, and its job may be loading it
+            if (!pChunk->m_bHasPendingJob && pChunk->IsCompressed())
+                pChunk->Decompress();
+
+            const CHUNK_LOD lod = SelectChunkLod(cc, cameraPosition, this->m_chunkLodDistances);
+
+            // a generate job writes the dirty sections
+            if (!pChunk->m_bHasPendingJob && (!pChunk->HasDXMesh(lod) || pChunk->GetDirtyMeshSections(lod) != 0u)) {
+                this->m_chunkScheduler.Request(cc, pChunk->IsGenerated() ? CHUNK_REQUEST_TYPE::CHUNK_REQUEST_TYPE_MESH
+                                                                         : CHUNK_REQUEST_TYPE::CHUNK_REQUEST_TYPE_GENERATE);
             }
 
-            if (!pChunkOpt.value()->HasDXMesh() && !bStopGeneratingMeshes) {
-                pChunkOpt.value()->GenerateDXMesh(this->m_pDevice, this->m_textureAtlasImage.GetWidth(), this->m_textureAtlasImage.GetHeight());
-                bStopGeneratingMeshes = true;
+            // until the LOD's mesh is built, the closest one is drawn instead (see Render), then the LODs that are
+            // more than one step away are dropped
+            if (pChunk->HasDXMesh(lod)) {
+                for (size_t cachedLod = 0u; cachedLod < static_cast<size_t>(CHUNK_LOD::_COUNT); ++cachedLod)
+                    if (cachedLod + 1u < static_cast<size_t>(lod) || cachedLod > static_cast<size_t>(lod) + 1u)
+                        pChunk->UnloadDXMesh(static_cast<CHUNK_LOD>(cachedLod));
             }
-            
-            if (pChunkOpt.value()->HasDXMesh())
-                this->m_pChunksToRender.push_back(pChunkOpt.value());
+
+            if (pChunk->HasDXMesh())
+                this->m_pChunksToRender.push_back(pChunk);
+        }
+    }
+
+    // the culling tree only changes when a mesh is uploaded or unloaded
+    if (this->m_bIsChunkCullingTreeDirty || this->m_pChunksToRender != pPreviousChunksToRender) {
+        std::vector<ChunkColumnBounds> chunkColumns(this->m_pChunksToRender.size());
+        for (size_t i = 0u; i < this->m_pChunksToRender.size(); ++i) {
+            const Chunk* pChunk = this->m_pChunksToRender[i];
+            chunkColumns[i] = ChunkColumnBounds{ pChunk->GetLocation(), 0.f, pChunk->GetColumnHeights().top * BLOCK_LENGTH, static_cast<std::uint32_t>(i) };
         }
+
+        this->m_chunkCullingTree.Build(chunkColumns);
+        this->m_bIsChunkCullingTreeDirty = false;
     }
+
+    this->m_chunkScheduler.Update(cameraPosition, this->m_camera.GetForwardVector());
+
+    const size_t maxInFlightJobs = this->m_jobSystem.GetThreadCount() * MAX_IN_FLIGHT_JOBS_PER_THREAD;
+    while (this->m_jobSystem.GetUnfinishedJobCount() < maxInFlightJobs) {
+        const std::optional<ChunkRequest> requestOpt = this->m_chunkScheduler.PopNext();
+        if (!requestOpt.has_value())
+            break;
+
+        this->SubmitChunkJob(this->GetChunk(requestOpt.value().location).value(),
+                             requestOpt.value().type == CHUNK_REQUEST_TYPE::CHUNK_REQUEST_TYPE_GENERATE);
+    }
+
+    // chunks in the render window, or that the job system or the scheduler still refer to, are kept as they are
+    this->m_chunkMemoryBudget.Enforce(this->m_chunkGrid, this->m_chunkStorage, [](const Chunk& chunk) { return chunk.m_bHasPendingJob; },
+                                      [this, &cameraPosition](const Chunk& chunk) {
+        return !IsChunkInRenderWindow(chunk.GetLocation(), cameraPosition) && !chunk.HasDXMesh() && !this->m_chunkScheduler.IsRequested(chunk.GetLocation());
+    });
+
+    // after this frame's uploads and unloads, so that the arena's emptiest page is known
+    this->m_pMeshArena->Defragment(MESH_ARENA_DEFRAGMENT_BUDGET);
+
+    ++this->m_frameIndex;
+}
+
+std::optional<BlockRaycastHit> Minecraft::Raycast(const Vec4f32& origin, const Vec4f32& direction, const float maxDistance) const noexcept
+{
+    // a job may be writing the blocks of its chunk
+    return RaycastBlocks([this](const ChunkCoord& cc) -> const Chunk* {
+        const Chunk* pChunk = this->m_chunkGrid.Find(cc);
+        return (pChunk && !pChunk->m_bHasPendingJob && pChunk->IsGenerated() && !pChunk->IsCompressed()) ? pChunk : nullptr;
+    }, origin, direction, maxDistance);
+}
+
+void Minecraft::UpdateBlockInteraction() noexcept
+{
+    const bool bIsBreakButtonDown = this->m_window.IsKeyDown(VK_LBUTTON);
+    const bool bIsPlaceButtonDown = this->m_window.IsKeyDown(VK_RBUTTON);
+
+    const bool bBreak = bIsBreakButtonDown && !this->m_bWasBreakButtonDown;
+    const bool bPlace = bIsPlaceButtonDown && !this->m_bWasPlaceButtonDown && !bBreak;
+
+    this->m_bWasBreakButtonDown = bIsBreakButtonDown;
+    this->m_bWasPlaceButtonDown = bIsPlaceButtonDown;
+
+    if (!bBreak && !bPlace)
+        return;
+
+    const std::optional<BlockRaycastHit> hit = this->Raycast(this->m_camera.GetPosition(), this->m_camera.GetForwardVector(), BLOCK_REACH_DISTANCE);
+    if (!hit.has_value())
+        return;
+
+    // a block placed from inside the one hit would go where the camera is
+    if (bPlace && hit->distance == 0.f)
+        return;
+
+    const std::array<int, 3u> block = bBreak ? hit->block : hit->GetAdjacentBlock();
+    if (block[1] < 0 || block[1] >= CHUNK_Y_BLOCK_COUNT)
+        return;
+
+    const ChunkCoord cc = GetBlockChunkLocation(block[0], block[2]);
+    this->SetBlock(cc, static_cast<size_t>(block[0] - cc.idx * CHUNK_X_BLOCK_COUNT), static_cast<size_t>(block[1]),
+                   static_cast<size_t>(block[2] - cc.idz * CHUNK_Z_BLOCK_COUNT), bBreak ? BLOCK_TYPE::BLOCK_TYPE_AIR : this->m_placedBlockType);
 }
 
 void Minecraft::Update() noexcept
@@ -265,6 +676,7 @@ void Minecraft::Update() noexcept
         this->m_camera.Translate(-speed * this->m_camera.GetForwardVector());
 
     this->m_camera.Update();
+    this->UpdateBlockInteraction();
     this->UpdateWorld();
 
     D3D11_MAPPED_SUBRESOURCE resource;
@@ -277,6 +689,194 @@ void Minecraft::Update() noexcept
     this->m_pDeviceContext->Unmap(this->m_pConstantBuffer.Get(), 0u);
 }
 
+void Minecraft::CullChunks() noexcept
+{
+    PROFILE_SCOPE("CullChunks");
+
+    const Vec4f32 cameraPosition = this->m_camera.GetPosition();
+
+    // chunks of the render window that aren't meshed yet don't stop the search, they are seen through
+    static const ChunkSectionConnectivity openSectionConnectivity = MakeOpenSectionConnectivity();
+
+    this->m_caveCuller.Update(cameraPosition, this->m_camera.GetFrustum(), [this, &cameraPosition](const ChunkCoord& cc) -> const ChunkSectionConnectivity* {
+        if (!IsChunkInRenderWindow(cc, cameraPosition))
+            return nullptr;
+
+        const Chunk* pChunk = this->m_chunkGrid.Find(cc);
+        return (pChunk && pChunk->HasDXMesh()) ? &pChunk->GetSectionConnectivity() : &openSectionConnectivity;
+    });
+
+    this->m_visibleChunkIndices.clear();
+    this->m_chunkCullingTree.Cull(this->m_camera.GetFrustum(), this->m_visibleChunkIndices);
+
+    const auto IsChunkInCave = [this](const std::uint32_t chunkIndex) {
+        return !this->m_caveCuller.IsChunkVisible(this->m_pChunksToRender[chunkIndex]->GetLocation());
+    };
+
+    this->m_visibleChunkIndices.erase(std::remove_if(this->m_visibleChunkIndices.begin(), this->m_visibleChunkIndices.end(), IsChunkInCave),
+                                      this->m_visibleChunkIndices.end());
+    const ChunkCoord cameraChunk = {
+        static_cast<std::int16_t>(std::floor(cameraPosition.x / CHUNK_X_LENGTH)),
+        static_cast<std::int16_t>(std::floor(cameraPosition.z / CHUNK_Z_LENGTH))
+    };
+
+    // (squared distance to the camera's chunk, chunk index), occluders are rasterized front to back
+    std::vector<std::pair<int, std::uint32_t>> occluderChunks;
+    for (const std::uint32_t chunkIndex : this->m_visibleChunkIndices) {
+        const ChunkCoord cc = this->m_pChunksToRender[chunkIndex]->GetLocation();
+        const int dx = cc.idx - cameraChunk.idx;
+        const int dz = cc.idz - cameraChunk.idz;
+
+        if (std::abs(dx) <= OCCLUDER_CHUNK_DISTANCE && std::abs(dz) <= OCCLUDER_CHUNK_DISTANCE)
+            occluderChunks.emplace_back(dx * dx + dz * dz, chunkIndex);
+    }
+
+    std::sort(occluderChunks.begin(), occluderChunks.end());
+
+    this->m_occlusionCuller.BeginFrame(this->m_camera.GetTransform(), cameraPosition);
+
+    for (const auto& [distance, chunkIndex] : occluderChunks) {
+        const Chunk* pChunk = this->m_pChunksToRender[chunkIndex];
+        this->m_occlusionCuller.RasterizeChunkOccluder(pChunk->GetLocation(), pChunk->GetColumnHeights());
+    }
+
+    const auto IsChunkOccluded = [this](const std::uint32_t chunkIndex) {
+        const Chunk*     pChunk = this->m_pChunksToRender[chunkIndex];
+        const ChunkCoord cc     = pChunk->GetLocation();
+
+        const Vec4f32 boxMin = { static_cast<float>(cc.idx) * CHUNK_X_LENGTH, 0.f, static_cast<float>(cc.idz) * CHUNK_Z_LENGTH };
+        return !this->m_occlusionCuller.IsBoxVisible(boxMin, boxMin + Vec4f32{ CHUNK_X_LENGTH, pChunk->GetColumnHeights().top * BLOCK_LENGTH, CHUNK_Z_LENGTH });
+    };
+
+    this->m_visibleChunkIndices.erase(std::remove_if(this->m_visibleChunkIndices.begin(), this->m_visibleChunkIndices.end(), IsChunkOccluded),
+                                      this->m_visibleChunkIndices.end());
+}
+
+void Minecraft::BuildDrawList() noexcept
+{
+    PROFILE_SCOPE("BuildDrawList");
+
+    const Vec4f32 cameraPosition = this->m_camera.GetPosition();
+
+    this->m_drawList.Clear();
+
+    for (const std::uint32_t chunkIndex : this->m_visibleChunkIndices) {
+        Chunk* pChunk = this->m_pChunksToRender[chunkIndex];
+
+        const ChunkCoord cc = pChunk->GetLocation();
+        const CHUNK_LOD lod = pChunk->FindDXMeshLod(SelectChunkLod(cc, cameraPosition, this->m_chunkLodDistances)).value();
+
+        // sections the cave culler didn't reach aren't drawn either
+        const std::uint16_t visibleSections = this->m_caveCuller.GetVisibleSectionMask(cc);
+
+        for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+            const Chunk::Chunk_DX_Data::Section& section = pChunk->m_dxData[static_cast<size_t>(lod)].value().sections[sectionIndex];
+
+            if (section.nVertices == 0u || (visibleSections & (1u << sectionIndex)) == 0u)
+                continue;
+
+            const MeshArenaLocation& location = this->m_pMeshArena->GetLocation(section.allocation.GetHandle());
+
+            // the squared distance to the section's center orders the draws just as well as the distance
+            const float dx = (static_cast<float>(cc.idx) + 0.5f) * CHUNK_X_LENGTH - cameraPosition.x;
+            const float dy = (static_cast<float>(sectionIndex) + 0.5f) * CHUNK_SECTION_Y_BLOCK_COUNT * BLOCK_LENGTH - cameraPosition.y;
+            const float dz = (static_cast<float>(cc.idz) + 0.5f) * CHUNK_Z_LENGTH - cameraPosition.z;
+
+            DrawCommand command;
+            command.key        = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE, static_cast<std::uint16_t>(location.page), dx * dx + dy * dy + dz * dz);
+            command.object     = chunkIndex;
+            command.state      = location.page;
+            command.baseVertex = static_cast<std::uint32_t>(location.byteOffset / sizeof(Vertex));
+            command.nIndices   = static_cast<std::uint32_t>(section.nVertices / 4u * 6u);
+
+            this->m_drawList.Add(command);
+        }
+
+        if (lod != CHUNK_LOD::CHUNK_LOD_FULL)
+            continue;
+
+        pChunk->SortTranslucentDXMesh(*this->m_pMeshArena, cameraPosition);
+
+        const Chunk::Chunk_DX_Data::Section& translucent = pChunk->m_dxData[static_cast<size_t>(lod)].value().translucent;
+        if (translucent.nVertices == 0u)
+            continue;
+
+        const MeshArenaLocation& location = this->m_pMeshArena->GetLocation(translucent.allocation.GetHandle());
+
+        // the chunks' translucent faces don't overlap much vertically, they are ordered by their horizontal distance.
+        // The page is left out of the key so that the order only depends on the depth
+        const float dx = (static_cast<float>(cc.idx) + 0.5f) * CHUNK_X_LENGTH - cameraPosition.x;
+        const float dz = (static_cast<float>(cc.idz) + 0.5f) * CHUNK_Z_LENGTH - cameraPosition.z;
+
+        DrawCommand command;
+        command.key        = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 0u, dx * dx + dz * dz, true);
+        command.object     = chunkIndex;
+        command.state      = location.page;
+        command.baseVertex = static_cast<std::uint32_t>(location.byteOffset / sizeof(Vertex));
+        command.nIndices   = static_cast<std::uint32_t>(translucent.nVertices / 4u * 6u);
+
+        this->m_drawList.Add(command);
+    }
+
+    this->m_drawList.Sort();
+}
+
+void Minecraft::ExecuteDrawList() noexcept
+{
+    PROFILE_SCOPE("ExecuteDrawList");
+
+    const UINT stride = sizeof(Vertex);
+    const UINT offset = 0;
+
+    // the draws of a chunk may be split by the sort, the vertex buffer and the chunk's constants are only updated when they change
+    std::uint32_t boundState  = 0xFFFFFFFFu;
+    std::uint32_t boundObject = 0xFFFFFFFFu;
+
+    this->m_pDeviceContext->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFFu);
+    this->m_pDeviceContext->OMSetDepthStencilState(nullptr, 0u);
+    DRAW_PASS boundPass = DRAW_PASS::DRAW_PASS_OPAQUE;
+
+    for (const DrawCommand& command : this->m_drawList.GetCommands()) {
+        const DRAW_PASS pass = static_cast<DRAW_PASS>(command.key >> 56u);
+
+        // the passes come one after the other, only the translucent one has states of its own
+        if (pass != boundPass && pass == DRAW_PASS::DRAW_PASS_TRANSLUCENT) {
+            const float blendFactor[4] = { TRANSLUCENT_BLOCK_OPACITY, TRANSLUCENT_BLOCK_OPACITY, TRANSLUCENT_BLOCK_OPACITY, 1.f };
+
+            this->m_pDeviceContext->OMSetBlendState(this->m_pTranslucentBlendState.Get(), blendFactor, 0xFFFFFFFFu);
+            this->m_pDeviceContext->OMSetDepthStencilState(this->m_pTranslucentDepthStencilState.Get(), 0u);
+        }
+        boundPass = pass;
+
+        if (command.state != boundState) {
+            this->m_pDeviceContext->IASetVertexBuffers(0u, 1u, this->m_pMeshArenaBackend->GetPageBuffer(command.state).GetAddressOf(), &stride, &offset);
+            boundState = command.state;
+        }
+
+        if (command.object != boundObject) {
+            const ChunkCoord cc = this->m_pChunksToRender[command.object]->GetLocation();
+
+            const Vec4f32 chunkOrigin = {
+                static_cast<float>(cc.idx) * CHUNK_X_LENGTH,
+                0.f,
+                static_cast<float>(cc.idz) * CHUNK_Z_LENGTH,
+                BLOCK_LENGTH
+            };
+
+            D3D11_MAPPED_SUBRESOURCE resource;
+            if (this->m_pDeviceContext->Map(this->m_pChunkConstantBuffer.Get(), 0u, D3D11_MAP_WRITE_DISCARD, 0u, &resource) != S_OK)
+                FATAL_ERROR("Failed to map constant buffer memory");
+
+            std::memcpy(resource.pData, &chunkOrigin, sizeof(chunkOrigin));
+            this->m_pDeviceContext->Unmap(this->m_pChunkConstantBuffer.Get(), 0u);
+
+            boundObject = command.object;
+        }
+
+        this->m_pDeviceContext->DrawIndexed(command.nIndices, 0u, static_cast<INT>(command.baseVertex));
+    }
+}
+
 void Minecraft::Render() noexcept
 {
     float clearColor[4] = {0.2284f, 0.3486f, 0.4230f, 1.f};
@@ -285,31 +885,23 @@ void Minecraft::Render() noexcept
 
     this->m_pDeviceContext->OMSetRenderTargets(1u, this->m_pRenderTargetView.GetAddressOf(), this->m_pDepthStencilView.Get());
 
-    const UINT stride = sizeof(Vertex);
-    const UINT offset = 0;
-
     this->m_pDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY::D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
     this->m_pDeviceContext->IASetInputLayout(this->m_pInputLayout.Get());
+    this->m_pDeviceContext->IASetIndexBuffer(this->m_pQuadIndexBuffer.Get(), DXGI_FORMAT::DXGI_FORMAT_R32_UINT, 0u);
 
     this->m_pDeviceContext->VSSetShader(this->m_pVertexShader.Get(), nullptr, 0u);
     this->m_pDeviceContext->PSSetShader(this->m_pPixelShader.Get(), nullptr, 0u);
     this->m_pDeviceContext->VSSetConstantBuffers(0u, 1u, this->m_pConstantBuffer.GetAddressOf());
+    this->m_pDeviceContext->VSSetConstantBuffers(1u, 1u, this->m_pChunkConstantBuffer.GetAddressOf());
 
     this->m_pDeviceContext->PSSetSamplers(0u, 1u, this->m_pTextureAtlasSamplerState.GetAddressOf());
     this->m_pDeviceContext->PSSetShaderResources(0u, 1u, this->m_pTextureAtlasSRV.GetAddressOf());
 
-    size_t i = 0;
-    for (const Chunk* pChunk : this->m_pChunksToRender)
-    {
-        if (!this->m_camera.GetFrustum().IsChunkInFrustum(*pChunk))
-           continue;
-
-        this->m_pDeviceContext->IASetVertexBuffers(0u, 1u, pChunk->m_dxData.value().pVertexBuffer.GetAddressOf(), &stride, &offset);
-        this->m_pDeviceContext->Draw(static_cast<UINT>(pChunk->m_dxData.value().nVertices), 0u);
-        i++;
-    }
+    this->CullChunks();
 
-    std::cout << (static_cast<float>(i) / this->m_pChunksToRender.size()) * 100.f << '\n';
+    this->BuildDrawList();
+    this->ExecuteDrawList();
 
+    PROFILE_SCOPE("Present");
     this->m_pSwapChain->Present(0u, 0u);
 }
\ No newline at end of file
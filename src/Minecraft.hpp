@@ -11,6 +11,20 @@
 #include "Camera.hpp"
 #include "Shaders.hpp"
 #include "Constants.hpp"
+#include "JobSystem.hpp"
+#include "ChunkGrid.hpp"
+#include "ChunkCuller.hpp"
+#include "CaveCuller.hpp"
+#include "OcclusionCuller.hpp"
+#include "ChunkStorage.hpp"
+#include "ChunkScheduler.hpp"
+#include "ChunkMemoryBudget.hpp"
+#include "LightEngine.hpp"
+#include "WorldGenerator.hpp"
+#include "BlockRaycast.hpp"
+#include "DrawList.hpp"
+#include "Profiler.hpp"
+#include "DXMeshArenaBackend.hpp"
 #include "vendor/PerlinNoise.hpp"
 
 class Minecraft {
@@ -27,23 +41,115 @@ private:
     Microsoft::WRL::ComPtr<ID3D11PixelShader>  m_pPixelShader;
     Microsoft::WRL::ComPtr<ID3D11InputLayout>  m_pInputLayout;
     Microsoft::WRL::ComPtr<ID3D11Buffer>       m_pConstantBuffer;
+    Microsoft::WRL::ComPtr<ID3D11Buffer>       m_pChunkConstantBuffer;
+
+    // Shared by every chunk mesh: (0, 1, 2) (0, 2, 3) for each quad
+    Microsoft::WRL::ComPtr<ID3D11Buffer> m_pQuadIndexBuffer;
+    size_t m_nQuadIndexBufferQuads = 0u;
 
     Microsoft::WRL::ComPtr<ID3D11Texture2D>         m_pDepthStencilTexture;
     Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_pDepthStencilState;
     Microsoft::WRL::ComPtr<ID3D11DepthStencilView>  m_pDepthStencilView;
 
+    // DRAW_PASS_TRANSLUCENT: blended by TRANSLUCENT_BLOCK_OPACITY, depth tested but not written
+    Microsoft::WRL::ComPtr<ID3D11BlendState>        m_pTranslucentBlendState;
+    Microsoft::WRL::ComPtr<ID3D11DepthStencilState> m_pTranslucentDepthStencilState;
+
     Image m_textureAtlasImage;
     Microsoft::WRL::ComPtr<ID3D11Texture2D>          m_pTextureAtlas;
     Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> m_pTextureAtlasSRV;
     Microsoft::WRL::ComPtr<ID3D11SamplerState>       m_pTextureAtlasSamplerState;
 
-    // Contains all chunks that have been created since the beginning
-    ChunkCoordMap<std::unique_ptr<Chunk>> m_pChunks;
+    // Holds the vertices of every chunk mesh, declared before m_chunkGrid so that the chunks give their allocations back first
+    std::unique_ptr<DXMeshArenaBackend> m_pMeshArenaBackend;
+    std::unique_ptr<MeshArena>          m_pMeshArena;
+
+    // In bytes, copied between the arena's pages each frame to release the emptiest one
+    static constexpr size_t MESH_ARENA_DEFRAGMENT_BUDGET = 256u * 1024u;
+
+    // Contains the chunks in memory, those that went out of the render window
+    // are compressed then removed as needed by m_chunkMemoryBudget
+    ChunkGrid m_chunkGrid;
 
     // Contains all the chunks that are scheduled to be rendered
     std::vector<Chunk*> m_pChunksToRender;
 
-    siv::PerlinNoise m_noise;
+    // Built over m_pChunksToRender by UpdateWorld, culled against the camera's frustum by CullChunks
+    ChunkColumnQuadTree        m_chunkCullingTree;
+    bool                       m_bIsChunkCullingTreeDirty = true;
+    std::vector<std::uint32_t> m_visibleChunkIndices;
+
+    // The sections of the visible chunks, sorted by page then front to back, rebuilt every frame by BuildDrawList
+    DrawList m_drawList;
+
+    // Searches the sections that can be seen from the camera's, the chunks it doesn't reach are culled along with the frustum test
+    CaveCuller m_caveCuller;
+
+    // The visible chunks closer than OCCLUDER_CHUNK_DISTANCE (in chunks) hide the farther ones
+    OcclusionCuller      m_occlusionCuller;
+    static constexpr int OCCLUDER_CHUNK_DISTANCE = 3;
+
+    // Called by the jobs that generate chunks, see WorldGenerator
+    WorldGenerator m_worldGenerator;
+
+    CHUNK_MESHING_MODE m_chunkMeshingMode = CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY;
+
+    // Chunks are meshed at a coarser LOD past each of these distances, see SelectChunkLod.
+    // The meshes of the LODs next to the one a chunk needs are kept, so that moving back and forth doesn't rebuild them
+    ChunkLodDistances m_chunkLodDistances = { 8, 16, 32 };
+
+    // Chunk work waiting for the job system, most urgent first
+    ChunkScheduler m_chunkScheduler;
+
+    // Work is handed to the job system in small batches so that it stays in the
+    // scheduler, where it can still be reordered or cancelled, as long as possible
+    static constexpr size_t MAX_IN_FLIGHT_JOBS_PER_THREAD = 2u;
+
+    // Meshes built by the job system, waiting to be uploaded by the main thread
+    struct FinishedChunkMesh {
+        Chunk*                   pChunk;
+        ChunkMesh                mesh;
+        ChunkColumnHeights       columnHeights;
+        ChunkSectionConnectivity sectionConnectivity;
+    }; // struct FinishedChunkMesh
+
+    std::mutex                     m_finishedChunkMeshesMutex;
+    std::vector<FinishedChunkMesh> m_finishedChunkMeshes;
+
+    // Block edits of chunks that had a job running, they are applied once it finished
+    struct BlockEdit {
+        ChunkCoord   location;
+        std::uint8_t idx, idy, idz;
+        BLOCK_TYPE   type;
+    }; // struct BlockEdit
+
+    std::vector<BlockEdit> m_deferredBlockEdits;
+
+    // Chunks are loaded from there instead of being generated when they were saved before
+    ChunkStorage m_chunkStorage;
+
+    // Dirty chunks are saved together every SAVE_INTERVAL
+    static constexpr std::chrono::seconds SAVE_INTERVAL{ 5 };
+
+    std::chrono::steady_clock::time_point m_lastSaveTime;
+
+    ChunkMemoryBudget m_chunkMemoryBudget;
+
+    // Relights around block edits and between chunks, on the main thread. Jobs light the chunks they generate with their own
+    LightEngine m_lightEngine;
+
+    std::uint64_t m_frameIndex = 0u;
+
+    // Left click breaks the block under the crosshair, right click places one against the face it looks at, once per click
+    static constexpr float BLOCK_REACH_DISTANCE = 8.f * BLOCK_LENGTH;
+
+    BLOCK_TYPE m_placedBlockType = BLOCK_TYPE::BLOCK_TYPE_STONE;
+    bool       m_bWasBreakButtonDown = false;
+    bool       m_bWasPlaceButtonDown = false;
+
+    // Generates terrain and builds meshes, declared last so that its workers
+    // are stopped before the members they write to are destroyed
+    JobSystem m_jobSystem;
 
 public:
     Minecraft() noexcept;
@@ -51,25 +157,65 @@ public:
 private:
     void CreateDepthBuffer() noexcept;
 
+    void CreateTranslucentPassStates() noexcept;
+
     void LoadAndCreateTextureAtlas() noexcept;
 
+    void ReserveQuadIndexBuffer(const size_t nQuads) noexcept;
+
+    // The neighbour on "side" (a CHUNK_SIDE) if its blocks can be read, nullptr otherwise
+    Chunk* FindNeighbourWithBlocks(const ChunkCoord& location, const size_t side) const noexcept;
+
+    // Runs on the job system: generates the chunk's blocks if needed, then builds its mesh
+    void SubmitChunkJob(Chunk* pChunk, const bool bGenerateTerrain) noexcept;
+
+    void UploadFinishedChunkMeshes() noexcept;
+
+    void ApplyDeferredBlockEdits() noexcept;
+
+    // The chunk at "location" and the ones around it, std::nullopt while a job is working on any of them.
+    // Chunks whose blocks aren't generated are left out, compressed ones are decompressed
+    std::optional<LightNeighbourhood> GatherLightNeighbourhood(const ChunkCoord& location) noexcept;
+
+    // The CHUNK_LOD_FULL meshes of the sections whose light changed are rebuilt
+    void MarkLightChanges(const LightNeighbourhood& neighbourhood) noexcept;
+
+    // Lets the light through the sides between lit chunks that didn't exchange it yet, see LightEngine::StitchSide
+    void StitchChunkLight() noexcept;
+
+    // Chunks the job system is working on are skipped, unless "bIncludePendingChunks" is set
+    // because the job system is known to be idle
+    void SaveDirtyChunks(const bool bIncludePendingChunks = false) noexcept;
+
     void UpdateWorld() noexcept;
 
+    // Breaks or places a block where the camera looks, see BLOCK_REACH_DISTANCE
+    void UpdateBlockInteraction() noexcept;
+
     void Update() noexcept;
 
+    // Fills m_visibleChunkIndices with the chunks to render that are in the frustum, reached by m_caveCuller and not occluded
+    void CullChunks() noexcept;
+
+    // One draw per visible section of the chunks CullChunks kept, plus one for the translucent faces of each CHUNK_LOD_FULL chunk
+    // once sorted for the camera. ExecuteDrawList replays them on the device context
+    void BuildDrawList() noexcept;
+
+    void ExecuteDrawList() noexcept;
+
     void Render() noexcept;
 
 public:
     inline std::optional<Chunk*> GetChunk(const ChunkCoord& location) noexcept {
-        const auto pChunkIterator = this->m_pChunks.find(location);
-        if (pChunkIterator != this->m_pChunks.end()) {
-            return (*pChunkIterator).second.get();
+        Chunk* pChunk = this->m_chunkGrid.Find(location);
+        if (pChunk) {
+            return pChunk;
         }
 
         return {  };
     }
 
-    inline std::optional<BLOCK_TYPE*> GetBlock(const ChunkCoord& chunkLocation, const size_t idx, const size_t idy, const size_t idz) noexcept {
+    inline std::optional<BLOCK_TYPE> GetBlock(const ChunkCoord& chunkLocation, const size_t idx, const size_t idy, const size_t idz) noexcept {
         const std::optional<Chunk*>& chunkOpt = this->GetChunk(chunkLocation);
 
         if (!chunkOpt.has_value()) return {  };
@@ -77,7 +223,14 @@ public:
         return chunkOpt.value()->GetBlock(idx, idy, idz);
     }
 
-    inline std::optional<BLOCK_TYPE*> GetBlock(const std::int16_t worldX, const std::int16_t worldY, const std::int16_t worldZ) noexcept {
+    // The first opaque block along the ray (see RaycastBlocks), the chunks a job is working on are seen through
+    std::optional<BlockRaycastHit> Raycast(const Vec4f32& origin, const Vec4f32& direction, const float maxDistance) const noexcept;
+
+    // The light around the block is updated right away, the meshes by a later UpdateWorld. Edits whose light may reach chunks
+    // a job is working on are deferred until it finished, returns false when the chunk isn't in memory or its blocks aren't generated yet
+    bool SetBlock(const ChunkCoord& chunkLocation, const size_t idx, const size_t idy, const size_t idz, const BLOCK_TYPE& type) noexcept;
+
+    inline std::optional<BLOCK_TYPE> GetBlock(const std::int16_t worldX, const std::int16_t worldY, const std::int16_t worldZ) noexcept {
         ChunkCoord cc{
             worldX / CHUNK_X_BLOCK_COUNT,
             worldZ / CHUNK_Z_BLOCK_COUNT
@@ -86,11 +239,42 @@ public:
         return this->GetBlock(cc, std::abs(worldX) % CHUNK_X_BLOCK_COUNT, worldY, std::abs(worldZ) % CHUNK_Z_BLOCK_COUNT);
     }
 
+    inline void SetChunkLodDistances(const ChunkLodDistances& lodDistances) noexcept { this->m_chunkLodDistances = lodDistances; }
+
+    inline void SetChunkMemoryBudget(const size_t budget) noexcept { this->m_chunkMemoryBudget.SetBudget(budget); }
+
+    inline const ChunkMemoryStats& GetChunkMemoryStats() const noexcept { return this->m_chunkMemoryBudget.GetStats(); }
+
+    inline MeshArenaStats GetMeshArenaStats() const noexcept { return this->m_pMeshArena->GetStats(); }
+
+    // In bytes, for the blocks of every chunk in memory
+    inline size_t GetBlockMemoryUsage() const noexcept {
+        size_t memoryUsage = 0u;
+
+        this->m_chunkGrid.ForEach([&memoryUsage](const Chunk* pChunk) { memoryUsage += pChunk->GetBlockMemoryUsage(); });
+
+        return memoryUsage;
+    }
+
     inline void Run() noexcept {
         while (this->m_window.IsRunning()) {
-            this->Update();
-            this->Render();
+            {
+                PROFILE_SCOPE("Frame");
+                this->Update();
+                this->Render();
+            }
+
+            PROFILE_COLLECT();
         }
+
+        this->m_jobSystem.WaitIdle();
+        this->SaveDirtyChunks(true);
+
+#ifdef MINECRAFT_PROFILER
+        // the last frames, to open in chrome://tracing or ui.perfetto.dev
+        Profiler::Get().Collect();
+        Profiler::Get().WriteChromeTrace("trace.json");
+#endif // MINECRAFT_PROFILER
     }
 }; // class Minecraft
 
@@ -0,0 +1,275 @@
+#include "OcclusionCuller.hpp"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MINECRAFT_OCCLUSION_CULLER_SSE2
+    #include <emmintrin.h>
+#endif
+
+void OcclusionCuller::BeginFrame(const Mat4x4f32& transform, const Vec4f32& cameraPosition) noexcept {
+    this->m_transform      = transform;
+    this->m_cameraPosition = cameraPosition;
+
+    std::fill(this->m_depthBuffer.begin(), this->m_depthBuffer.end(), 1.f);
+}
+
+std::optional<Vec4f32> OcclusionCuller::Project(const Vec4f32& point) const noexcept {
+    // points are row vectors, like in vsBlockCode
+    const Vec4f32 clip = Vec4f32{ point.x, point.y, point.z, 1.f } * this->m_transform;
+
+    if (clip.z < 0.f || clip.w <= 0.f)
+        return {  };
+
+    return Vec4f32{
+        (clip.x / clip.w * 0.5f + 0.5f) * DEPTH_BUFFER_WIDTH,
+        (0.5f - clip.y / clip.w * 0.5f) * DEPTH_BUFFER_HEIGHT,
+        clip.z / clip.w
+    };
+}
+
+void OcclusionCuller::RasterizeQuad(const Vec4f32& a, const Vec4f32& b, const Vec4f32& c, const Vec4f32& d) noexcept {
+    const std::array<std::optional<Vec4f32>, 4u> projectedOpts = { this->Project(a), this->Project(b), this->Project(c), this->Project(d) };
+
+    // quads crossing the near plane are skipped, they only make the occluders smaller
+    std::array<Vec4f32, 4u> corners;
+    for (size_t i = 0u; i < corners.size(); ++i) {
+        if (!projectedOpts[i].has_value())
+            return;
+
+        corners[i] = projectedOpts[i].value();
+    }
+
+    const float minX = std::min({ corners[0].x, corners[1].x, corners[2].x, corners[3].x });
+    const float maxX = std::max({ corners[0].x, corners[1].x, corners[2].x, corners[3].x });
+    const float minY = std::min({ corners[0].y, corners[1].y, corners[2].y, corners[3].y });
+    const float maxY = std::max({ corners[0].y, corners[1].y, corners[2].y, corners[3].y });
+
+    // occluders are expected front to back, those that are already hidden are skipped
+    if (!this->IsRectVisible(minX, maxX, minY, maxY, std::min({ corners[0].z, corners[1].z, corners[2].z, corners[3].z })))
+        return;
+
+    // a planar quad stays convex once projected, twice its area is the sum of the cross products of its consecutive corners
+    float area = 0.f;
+    for (size_t i = 0u; i < corners.size(); ++i) {
+        const Vec4f32& from = corners[i];
+        const Vec4f32& to   = corners[(i + 1u) % corners.size()];
+        area += from.x * to.y - to.x * from.y;
+    }
+
+    if (area == 0.f)
+        return;
+
+    // counter clockwise on screen, whatever the face's orientation
+    if (area < 0.f)
+        std::swap(corners[1], corners[3]);
+
+    const int x0 = std::max(0,                                            static_cast<int>(std::floor(minX)));
+    const int x1 = std::min(static_cast<int>(DEPTH_BUFFER_WIDTH)  - 1, static_cast<int>(std::floor(maxX)));
+    const int y0 = std::max(0,                                            static_cast<int>(std::floor(minY)));
+    const int y1 = std::min(static_cast<int>(DEPTH_BUFFER_HEIGHT) - 1, static_cast<int>(std::floor(maxY)));
+
+    if (x0 > x1 || y0 > y1)
+        return;
+
+    const float depth = std::min(1.f, std::max({ corners[0].z, corners[1].z, corners[2].z, corners[3].z }));
+
+    // edge functions e(x, y) = dx * x + dy * y + offset, positive inside of the quad
+    struct Edge { float dx, dy, offset; };
+
+    std::array<Edge, 4u> edges;
+    for (size_t i = 0u; i < edges.size(); ++i) {
+        const Vec4f32& from = corners[i];
+        const Vec4f32& to   = corners[(i + 1u) % corners.size()];
+
+        edges[i].dx     = -(to.y - from.y);
+        edges[i].dy     = to.x - from.x;
+        edges[i].offset = -(edges[i].dx * from.x + edges[i].dy * from.y);
+    }
+
+    for (int y = y0; y <= y1; ++y) {
+        float* pRow = this->m_depthBuffer.data() + static_cast<size_t>(y) * DEPTH_BUFFER_WIDTH;
+        const float pixelY = static_cast<float>(y) + 0.5f;
+
+        int x = x0;
+
+#ifdef MINECRAFT_OCCLUSION_CULLER_SSE2
+        // rows are a multiple of 4 pixels wide, starting on a multiple of 4 keeps every group inside of the row
+        x &= ~3;
+
+        const __m128 depth4 = _mm_set1_ps(depth);
+        const __m128 zero   = _mm_setzero_ps();
+        const __m128 lanes  = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+        __m128 edgeDx[4], edgeRowOffsets[4];
+        for (size_t i = 0u; i < edges.size(); ++i) {
+            edgeDx[i]         = _mm_set1_ps(edges[i].dx);
+            edgeRowOffsets[i] = _mm_set1_ps(edges[i].dy * pixelY + edges[i].offset);
+        }
+
+        for (; x <= x1; x += 4) {
+            const __m128 pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lanes);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (size_t i = 0u; i < edges.size(); ++i)
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(pixelX, edgeDx[i]), edgeRowOffsets[i]), zero));
+
+            const __m128 previousDepth = _mm_loadu_ps(pRow + x);
+            const __m128 newDepth      = _mm_min_ps(previousDepth, depth4);
+
+            _mm_storeu_ps(pRow + x, _mm_or_ps(_mm_and_ps(inside, newDepth), _mm_andnot_ps(inside, previousDepth)));
+        }
+#endif // MINECRAFT_OCCLUSION_CULLER_SSE2
+
+        for (; x <= x1; ++x) {
+            const float pixelX = static_cast<float>(x) + 0.5f;
+
+            bool bIsInside = true;
+            for (const Edge& edge : edges)
+                bIsInside &= edge.dx * pixelX + (edge.dy * pixelY + edge.offset) >= 0.f;
+
+            if (bIsInside)
+                pRow[x] = std::min(pRow[x], depth);
+        }
+    }
+}
+
+void OcclusionCuller::RasterizeBoxOccluder(const Vec4f32& boxMin, const Vec4f32& boxMax) noexcept {
+    const Vec4f32& camera = this->m_cameraPosition;
+
+    if (camera.x < boxMin.x || camera.x > boxMax.x) {
+        const float x = camera.x < boxMin.x ? boxMin.x : boxMax.x;
+        this->RasterizeQuad({ x, boxMin.y, boxMin.z }, { x, boxMax.y, boxMin.z }, { x, boxMax.y, boxMax.z }, { x, boxMin.y, boxMax.z });
+    }
+
+    if (camera.y < boxMin.y || camera.y > boxMax.y) {
+        const float y = camera.y < boxMin.y ? boxMin.y : boxMax.y;
+        this->RasterizeQuad({ boxMin.x, y, boxMin.z }, { boxMax.x, y, boxMin.z }, { boxMax.x, y, boxMax.z }, { boxMin.x, y, boxMax.z });
+    }
+
+    if (camera.z < boxMin.z || camera.z > boxMax.z) {
+        const float z = camera.z < boxMin.z ? boxMin.z : boxMax.z;
+        this->RasterizeQuad({ boxMin.x, boxMin.y, z }, { boxMax.x, boxMin.y, z }, { boxMax.x, boxMax.y, z }, { boxMin.x, boxMax.y, z });
+    }
+}
+
+void OcclusionCuller::RasterizeChunkOccluder(const ChunkCoord& location, const ChunkColumnHeights& columnHeights) noexcept {
+    constexpr size_t CELL_X_COUNT = CHUNK_X_BLOCK_COUNT / OCCLUDER_COLUMN_COUNT;
+    constexpr size_t CELL_Z_COUNT = CHUNK_Z_BLOCK_COUNT / OCCLUDER_COLUMN_COUNT;
+
+    // the lowest solid height of every cell of OCCLUDER_COLUMN_COUNT x OCCLUDER_COLUMN_COUNT columns
+    std::array<float, CELL_X_COUNT * CELL_Z_COUNT> cellHeights;
+    for (size_t cellX = 0u; cellX < CELL_X_COUNT; ++cellX) {
+        for (size_t cellZ = 0u; cellZ < CELL_Z_COUNT; ++cellZ) {
+            std::uint8_t height = CHUNK_Y_BLOCK_COUNT;
+            for (size_t x = cellX * OCCLUDER_COLUMN_COUNT; x < (cellX + 1u) * OCCLUDER_COLUMN_COUNT; ++x)
+                for (size_t z = cellZ * OCCLUDER_COLUMN_COUNT; z < (cellZ + 1u) * OCCLUDER_COLUMN_COUNT; ++z)
+                    height = std::min(height, columnHeights.solid[x * CHUNK_Z_BLOCK_COUNT + z]);
+
+            cellHeights[cellX * CELL_Z_COUNT + cellZ] = height * BLOCK_LENGTH;
+        }
+    }
+
+    // the neighbouring chunks' heights aren't known, the cells on the chunk's edges step down to the ground
+    const auto GetCellHeight = [&cellHeights](const int cellX, const int cellZ) {
+        if (cellX < 0 || cellZ < 0 || cellX >= static_cast<int>(CELL_X_COUNT) || cellZ >= static_cast<int>(CELL_Z_COUNT))
+            return 0.f;
+
+        return cellHeights[cellX * CELL_Z_COUNT + cellZ];
+    };
+
+    const Vec4f32& camera   = this->m_cameraPosition;
+    const float    cellSide = OCCLUDER_COLUMN_COUNT * BLOCK_LENGTH;
+
+    // only the surface of the cells is rasterized: their tops, and the steps down to lower cells that face the camera
+    for (int cellX = 0; cellX < static_cast<int>(CELL_X_COUNT); ++cellX) {
+        for (int cellZ = 0; cellZ < static_cast<int>(CELL_Z_COUNT); ++cellZ) {
+            const float height = GetCellHeight(cellX, cellZ);
+            if (height <= 0.f)
+                continue;
+
+            const float x0 = static_cast<float>(location.idx) * CHUNK_X_LENGTH + cellX * cellSide, x1 = x0 + cellSide;
+            const float z0 = static_cast<float>(location.idz) * CHUNK_Z_LENGTH + cellZ * cellSide, z1 = z0 + cellSide;
+
+            if (camera.y > height)
+                this->RasterizeQuad({ x0, height, z0 }, { x1, height, z0 }, { x1, height, z1 }, { x0, height, z1 });
+
+            if (camera.x < x0 && GetCellHeight(cellX - 1, cellZ) < height) {
+                const float stepHeight = GetCellHeight(cellX - 1, cellZ);
+                this->RasterizeQuad({ x0, stepHeight, z0 }, { x0, height, z0 }, { x0, height, z1 }, { x0, stepHeight, z1 });
+            }
+
+            if (camera.x > x1 && GetCellHeight(cellX + 1, cellZ) < height) {
+                const float stepHeight = GetCellHeight(cellX + 1, cellZ);
+                this->RasterizeQuad({ x1, stepHeight, z0 }, { x1, height, z0 }, { x1, height, z1 }, { x1, stepHeight, z1 });
+            }
+
+            if (camera.z < z0 && GetCellHeight(cellX, cellZ - 1) < height) {
+                const float stepHeight = GetCellHeight(cellX, cellZ - 1);
+                this->RasterizeQuad({ x0, stepHeight, z0 }, { x1, stepHeight, z0 }, { x1, height, z0 }, { x0, height, z0 });
+            }
+
+            if (camera.z > z1 && GetCellHeight(cellX, cellZ + 1) < height) {
+                const float stepHeight = GetCellHeight(cellX, cellZ + 1);
+                this->RasterizeQuad({ x0, stepHeight, z1 }, { x1, stepHeight, z1 }, { x1, height, z1 }, { x0, height, z1 });
+            }
+        }
+    }
+}
+
+bool OcclusionCuller::IsBoxVisible(const Vec4f32& boxMin, const Vec4f32& boxMax) const noexcept {
+    float minX = +INFINITY, minY = +INFINITY, maxX = -INFINITY, maxY = -INFINITY;
+    float nearestDepth = +INFINITY;
+
+    for (size_t corner = 0u; corner < 8u; ++corner) {
+        const std::optional<Vec4f32> projectedOpt = this->Project(Vec4f32{
+            (corner & 1u) ? boxMax.x : boxMin.x,
+            (corner & 2u) ? boxMax.y : boxMin.y,
+            (corner & 4u) ? boxMax.z : boxMin.z
+        });
+
+        // the box reaches the camera
+        if (!projectedOpt.has_value())
+            return true;
+
+        const Vec4f32& projected = projectedOpt.value();
+
+        minX = std::min(minX, projected.x); maxX = std::max(maxX, projected.x);
+        minY = std::min(minY, projected.y); maxY = std::max(maxY, projected.y);
+        nearestDepth = std::min(nearestDepth, projected.z);
+    }
+
+    return this->IsRectVisible(minX, maxX, minY, maxY, nearestDepth);
+}
+
+bool OcclusionCuller::IsRectVisible(const float minX, const float maxX, const float minY, const float maxY, const float nearestDepth) const noexcept {
+    const int x0 = std::max(0,                                            static_cast<int>(std::floor(minX)));
+    const int x1 = std::min(static_cast<int>(DEPTH_BUFFER_WIDTH)  - 1, static_cast<int>(std::floor(maxX)));
+    const int y0 = std::max(0,                                            static_cast<int>(std::floor(minY)));
+    const int y1 = std::min(static_cast<int>(DEPTH_BUFFER_HEIGHT) - 1, static_cast<int>(std::floor(maxY)));
+
+    // off screen, that is left to the frustum culling
+    if (x0 > x1 || y0 > y1)
+        return true;
+
+    for (int y = y0; y <= y1; ++y) {
+        const float* pRow = this->m_depthBuffer.data() + static_cast<size_t>(y) * DEPTH_BUFFER_WIDTH;
+
+        int x = x0;
+
+#ifdef MINECRAFT_OCCLUSION_CULLER_SSE2
+        // testing a few more pixels around the box's rectangle only makes the result more conservative
+        x &= ~3;
+
+        const __m128 nearestDepth4 = _mm_set1_ps(nearestDepth);
+
+        for (; x <= x1; x += 4)
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(pRow + x), nearestDepth4)) != 0)
+                return true;
+#endif // MINECRAFT_OCCLUSION_CULLER_SSE2
+
+        for (; x <= x1; ++x)
+            if (pRow[x] >= nearestDepth)
+                return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,59 @@
+#ifndef __MINECRAFT__OCCLUSION_CULLER_HPP
+#define __MINECRAFT__OCCLUSION_CULLER_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "Vector.hpp"
+#include "Matrix.hpp"
+
+// Culls the boxes hidden behind the terrain with a small depth buffer rasterized on the CPU.
+// Occluders are boxes that are entirely solid, such as the bottom of the chunks' columns (see RasterizeChunkOccluder).
+// Every quad writes its farthest depth so that occluders never end up closer than they are,
+// coverage is sampled at the pixels' centers, so an occluder can overlap its real outline by half a pixel.
+class OcclusionCuller {
+public:
+    static constexpr size_t DEPTH_BUFFER_WIDTH  = 256u;
+    static constexpr size_t DEPTH_BUFFER_HEIGHT = 128u;
+
+    static_assert(DEPTH_BUFFER_WIDTH % 4u == 0u, "Rows are processed 4 pixels at a time");
+
+    // The chunks' occluders are boxes spanning OCCLUDER_COLUMN_COUNT x OCCLUDER_COLUMN_COUNT columns
+    static constexpr size_t OCCLUDER_COLUMN_COUNT = 4u;
+
+private:
+    // Normalized device depth, 1 being the far plane, row by row from the top of the screen
+    std::vector<float> m_depthBuffer = std::vector<float>(DEPTH_BUFFER_WIDTH * DEPTH_BUFFER_HEIGHT, 1.f);
+
+    Mat4x4f32 m_transform;
+    Vec4f32   m_cameraPosition;
+
+private:
+    // Screen space position (in pixels) and depth, std::nullopt when the point is behind the near plane
+    std::optional<Vec4f32> Project(const Vec4f32& point) const noexcept;
+
+    // False when every pixel of the screen space rectangle is closer than "nearestDepth"
+    bool IsRectVisible(const float minX, const float maxX, const float minY, const float maxY, const float nearestDepth) const noexcept;
+
+    // The corners are in order around a planar quad, quads crossing the near plane are skipped
+    void RasterizeQuad(const Vec4f32& a, const Vec4f32& b, const Vec4f32& c, const Vec4f32& d) noexcept;
+
+public:
+    inline OcclusionCuller() noexcept = default;
+
+    // Clears the depth buffer, "transform" is the camera's world to clip space transform
+    void BeginFrame(const Mat4x4f32& transform, const Vec4f32& cameraPosition) noexcept;
+
+    // Occluders should be rasterized front to back, the ones hidden by the previous ones are skipped.
+    // The box must be entirely opaque, only its faces that look toward the camera are rasterized
+    void RasterizeBoxOccluder(const Vec4f32& boxMin, const Vec4f32& boxMax) noexcept;
+
+    // Rasterizes the surface of the solid bottom of the chunk's columns, simplified to cells of OCCLUDER_COLUMN_COUNT x OCCLUDER_COLUMN_COUNT columns
+    void RasterizeChunkOccluder(const ChunkCoord& location, const ChunkColumnHeights& columnHeights) noexcept;
+
+    // False when the box is entirely behind the occluders rasterized so far
+    bool IsBoxVisible(const Vec4f32& boxMin, const Vec4f32& boxMax) const noexcept;
+
+    inline const std::vector<float>& GetDepthBuffer() const noexcept { return this->m_depthBuffer; }
+}; // class OcclusionCuller
+
+#endif // __MINECRAFT__OCCLUSION_CULLER_HPP
@@ -6,14 +6,28 @@
 
 #include <cmath>
 #include <array>
+#include <algorithm>
 #include <bitset>
 #include <chrono>
 #include <cctype>
+#include <cstring>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <thread>
 #include <vector>
+#include <utility>
 #include <cstdint>
 #include <optional>
+#include <random>
 #include <iostream>
+#include <functional>
 #include <unordered_map>
+#include <condition_variable>
 
 #undef _USE_MATH_DEFINES
 
@@ -33,6 +47,14 @@
     #pragma comment(lib, "d3dcompiler")
     #pragma comment(lib, "windowscodecs.lib")
 
+#else
+
+    // POSIX Includes
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+
 #endif // _WIN32
 
 #endif // __MINECRAFT__PCH_HPP
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "Profiler.hpp"
+
+#ifdef MINECRAFT_PROFILER
+
+Profiler::Profiler() noexcept
+    : m_origin(std::chrono::steady_clock::now())
+{  }
+
+Profiler& Profiler::Get() noexcept {
+    static Profiler profiler;
+    return profiler;
+}
+
+Profiler::ThreadRing& Profiler::RegisterThread() noexcept {
+    std::lock_guard<std::mutex> lock(this->m_ringsMutex);
+
+    this->m_pRings.push_back(std::make_unique<ThreadRing>());
+    this->m_pRings.back()->threadId = static_cast<std::uint32_t>(this->m_pRings.size() - 1u);
+
+    return *this->m_pRings.back();
+}
+
+void Profiler::Record(const ProfileEvent& event) noexcept {
+    // the ring is only looked up once per thread
+    thread_local ThreadRing* pRing = nullptr;
+    if (!pRing)
+        pRing = &this->RegisterThread();
+
+    const size_t writeIndex = pRing->writeIndex.load(std::memory_order_relaxed);
+
+    if (writeIndex - pRing->cachedReadIndex == THREAD_RING_SIZE) {
+        pRing->cachedReadIndex = pRing->readIndex.load(std::memory_order_acquire);
+
+        if (writeIndex - pRing->cachedReadIndex == THREAD_RING_SIZE) {
+            pRing->nDroppedEvents.fetch_add(1u, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    pRing->events[writeIndex & (THREAD_RING_SIZE - 1u)] = event;
+    pRing->writeIndex.store(writeIndex + 1u, std::memory_order_release);
+}
+
+void Profiler::Collect() noexcept {
+    std::lock_guard<std::mutex> lock(this->m_ringsMutex);
+
+    for (const std::unique_ptr<ThreadRing>& pRing : this->m_pRings) {
+        const size_t readIndex  = pRing->readIndex.load(std::memory_order_relaxed);
+        const size_t writeIndex = pRing->writeIndex.load(std::memory_order_acquire);
+
+        for (size_t index = readIndex; index < writeIndex; ++index) {
+            const ProfileEvent& event = pRing->events[index & (THREAD_RING_SIZE - 1u)];
+
+            const TraceEvent traceEvent{ event, pRing->threadId };
+            if (this->m_traceEvents.size() < MAX_TRACE_EVENTS)
+                this->m_traceEvents.push_back(traceEvent);
+            else
+                this->m_traceEvents[this->m_nTraceEvents % MAX_TRACE_EVENTS] = traceEvent;
+            ++this->m_nTraceEvents;
+
+            ZoneWindow& window = this->m_zoneWindows[event.zone];
+            window.durations[window.nDurations % ZONE_WINDOW_SIZE] = event.endTime - event.beginTime;
+            ++window.nDurations;
+        }
+
+        // the slots read are handed back to the producer
+        pRing->readIndex.store(writeIndex, std::memory_order_release);
+
+        this->m_nDroppedEvents += pRing->nDroppedEvents.exchange(0u, std::memory_order_relaxed);
+    }
+}
+
+ProfileZoneStats Profiler::GetZoneStats(const std::string_view zone) const noexcept {
+    ProfileZoneStats stats;
+
+    const auto it = this->m_zoneWindows.find(zone);
+    if (it == this->m_zoneWindows.end())
+        return stats;
+
+    const ZoneWindow& window = it->second;
+    stats.nSamples = std::min(window.nDurations, ZONE_WINDOW_SIZE);
+
+    std::array<std::uint64_t, ZONE_WINDOW_SIZE> durations;
+    std::copy_n(window.durations.begin(), stats.nSamples, durations.begin());
+    std::sort(durations.begin(), durations.begin() + stats.nSamples);
+
+    const auto percentile = [&durations, &stats](const size_t percent) { return durations[(stats.nSamples - 1u) * percent / 100u]; };
+
+    stats.p50 = percentile(50u);
+    stats.p95 = percentile(95u);
+    stats.p99 = percentile(99u);
+    stats.max = durations[stats.nSamples - 1u];
+
+    return stats;
+}
+
+bool Profiler::WriteChromeTrace(const std::filesystem::path& path) const noexcept {
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open())
+        return false;
+
+    // "X" events are complete (begin and duration), timestamps are in microseconds
+    file << std::fixed;
+    file.precision(3);
+    file << "{\"traceEvents\":[";
+
+    const size_t firstEvent = this->m_nTraceEvents > MAX_TRACE_EVENTS ? this->m_nTraceEvents % MAX_TRACE_EVENTS : 0u;
+
+    for (size_t i = 0u; i < this->m_traceEvents.size(); ++i) {
+        const TraceEvent& traceEvent = this->m_traceEvents[(firstEvent + i) % this->m_traceEvents.size()];
+
+        file << (i != 0u ? ",\n" : "\n")
+             << "{\"name\":\"" << traceEvent.event.zone << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << traceEvent.threadId
+             << ",\"ts\":"  << static_cast<double>(traceEvent.event.beginTime) / 1000.0
+             << ",\"dur\":" << static_cast<double>(traceEvent.event.endTime - traceEvent.event.beginTime) / 1000.0 << '}';
+    }
+
+    file << "\n]}\n";
+
+    return file.good();
+}
+
+#endif // MINECRAFT_PROFILER
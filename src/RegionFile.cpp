@@ -0,0 +1,150 @@
+#include "RegionFile.hpp"
+
+RegionFile::RegionFile(const std::filesystem::path& path) noexcept
+    : m_path(path)
+{
+    this->Map();
+}
+
+void RegionFile::Map() noexcept {
+    this->Unmap();
+
+    std::error_code errorCode;
+    const std::uintmax_t size = std::filesystem::file_size(this->m_path, errorCode);
+    if (errorCode || size < sizeof(Header))
+        return;
+
+#ifdef _WIN32
+    this->m_hFile = CreateFileW(this->m_path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (this->m_hFile == INVALID_HANDLE_VALUE)
+        return;
+
+    this->m_hMapping = CreateFileMappingW(this->m_hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (this->m_hMapping == NULL) {
+        this->Unmap();
+        return;
+    }
+
+    this->m_pData = static_cast<const std::uint8_t*>(MapViewOfFile(this->m_hMapping, FILE_MAP_READ, 0, 0, 0));
+#else
+    this->m_fileDescriptor = open(this->m_path.c_str(), O_RDONLY);
+    if (this->m_fileDescriptor < 0)
+        return;
+
+    void* pData = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, this->m_fileDescriptor, 0);
+    this->m_pData = (pData == MAP_FAILED) ? nullptr : static_cast<const std::uint8_t*>(pData);
+#endif // _WIN32
+
+    if (!this->m_pData) {
+        this->Unmap();
+        return;
+    }
+
+    this->m_size = static_cast<size_t>(size);
+}
+
+void RegionFile::Unmap() noexcept {
+#ifdef _WIN32
+    if (this->m_pData)                        UnmapViewOfFile(this->m_pData);
+    if (this->m_hMapping != NULL)             CloseHandle(this->m_hMapping);
+    if (this->m_hFile != INVALID_HANDLE_VALUE) CloseHandle(this->m_hFile);
+
+    this->m_hMapping = NULL;
+    this->m_hFile    = INVALID_HANDLE_VALUE;
+#else
+    if (this->m_pData)                munmap(const_cast<std::uint8_t*>(this->m_pData), this->m_size);
+    if (this->m_fileDescriptor >= 0) close(this->m_fileDescriptor);
+
+    this->m_fileDescriptor = -1;
+#endif // _WIN32
+
+    this->m_pData = nullptr;
+    this->m_size  = 0u;
+}
+
+const RegionFile::Header* RegionFile::GetHeader() const noexcept {
+    if (!this->m_pData)
+        return nullptr;
+
+    const Header* pHeader = reinterpret_cast<const Header*>(this->m_pData);
+    if (pHeader->magic != MAGIC || pHeader->version != VERSION)
+        return nullptr;
+
+    return pHeader;
+}
+
+bool RegionFile::ReadChunk(Chunk& chunk) const noexcept {
+    const Header* pHeader = this->GetHeader();
+    if (!pHeader)
+        return false;
+
+    const Entry& entry = pHeader->entries[GetChunkIndex(chunk.GetLocation())];
+    if (entry.size == 0u || static_cast<size_t>(entry.offset) + entry.size > this->m_size)
+        return false;
+
+    return chunk.Deserialize(this->m_pData + entry.offset, entry.size);
+}
+
+bool RegionFile::WriteChunks(const std::vector<const Chunk*>& pChunks) noexcept {
+    std::array<std::vector<std::uint8_t>, REGION_CHUNK_COUNT> newPayloads;
+    std::bitset<REGION_CHUNK_COUNT> bHasNewPayload;
+
+    for (const Chunk* pChunk : pChunks) {
+        const size_t chunkIndex = GetChunkIndex(pChunk->GetLocation());
+
+        newPayloads[chunkIndex] = pChunk->Serialize();
+        bHasNewPayload.set(chunkIndex);
+    }
+
+    // the payloads are laid out after the header in chunk order
+    const Header* pOldHeader = this->GetHeader();
+
+    Header header;
+    header.magic   = MAGIC;
+    header.version = VERSION;
+
+    std::vector<std::uint8_t> fileData(sizeof(Header));
+
+    for (size_t chunkIndex = 0u; chunkIndex < REGION_CHUNK_COUNT; ++chunkIndex) {
+        const std::uint8_t* pPayload   = nullptr;
+        size_t              payloadSize = 0u;
+
+        if (bHasNewPayload.test(chunkIndex)) {
+            pPayload    = newPayloads[chunkIndex].data();
+            payloadSize = newPayloads[chunkIndex].size();
+        } else if (pOldHeader) {
+            const Entry& oldEntry = pOldHeader->entries[chunkIndex];
+
+            if (oldEntry.size != 0u && static_cast<size_t>(oldEntry.offset) + oldEntry.size <= this->m_size) {
+                pPayload    = this->m_pData + oldEntry.offset;
+                payloadSize = oldEntry.size;
+            }
+        }
+
+        header.entries[chunkIndex] = Entry{ static_cast<std::uint32_t>(fileData.size()), static_cast<std::uint32_t>(payloadSize) };
+        fileData.insert(fileData.end(), pPayload, pPayload + payloadSize);
+    }
+
+    std::memcpy(fileData.data(), &header, sizeof(Header));
+
+    // the mapping has to be released before the file is replaced
+    this->Unmap();
+
+    std::filesystem::path temporaryPath = this->m_path;
+    temporaryPath += ".tmp";
+
+    bool bSucceeded = false;
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(fileData.data()), static_cast<std::streamsize>(fileData.size()));
+        bSucceeded = static_cast<bool>(file);
+    }
+
+    std::error_code errorCode;
+    if (bSucceeded)
+        std::filesystem::rename(temporaryPath, this->m_path, errorCode);
+
+    this->Map();
+
+    return bSucceeded && !errorCode;
+}
@@ -0,0 +1,91 @@
+#ifndef __MINECRAFT__REGION_FILE_HPP
+#define __MINECRAFT__REGION_FILE_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+
+// Stores REGION_CHUNK_COUNT_PER_SIDE x REGION_CHUNK_COUNT_PER_SIDE chunks in a single file:
+// a header with the offset and size of each chunk's payload (both 0 when the chunk was never saved),
+// followed by the payloads built by Chunk::Serialize.
+// The file is memory mapped, reading a chunk doesn't copy its payload.
+class RegionFile {
+public:
+    static constexpr size_t REGION_CHUNK_COUNT_PER_SIDE = 32u;
+    static constexpr size_t REGION_CHUNK_COUNT          = REGION_CHUNK_COUNT_PER_SIDE * REGION_CHUNK_COUNT_PER_SIDE;
+
+    static constexpr std::uint32_t MAGIC   = 0x4752434Du; // "MCRG"
+    static constexpr std::uint32_t VERSION = 1u;
+
+private:
+    struct Entry {
+        std::uint32_t offset;
+        std::uint32_t size;
+    }; // struct Entry
+
+    struct Header {
+        std::uint32_t                          magic;
+        std::uint32_t                          version;
+        std::array<Entry, REGION_CHUNK_COUNT> entries;
+    }; // struct Header
+
+    std::filesystem::path m_path;
+
+#ifdef _WIN32
+    HANDLE m_hFile    = INVALID_HANDLE_VALUE;
+    HANDLE m_hMapping = NULL;
+#else
+    int    m_fileDescriptor = -1;
+#endif // _WIN32
+
+    const std::uint8_t* m_pData = nullptr;
+    size_t              m_size  = 0u;
+
+private:
+    void Map() noexcept;
+
+    void Unmap() noexcept;
+
+    // nullptr when the file doesn't exist yet or isn't a region file
+    const Header* GetHeader() const noexcept;
+
+public:
+    explicit RegionFile(const std::filesystem::path& path) noexcept;
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    inline ~RegionFile() noexcept { this->Unmap(); }
+
+    // Location of the region that contains the chunk "cc"
+    static inline ChunkCoord GetRegionCoord(const ChunkCoord& cc) noexcept {
+        const auto FloorDiv = [](const std::int16_t a) {
+            return static_cast<std::int16_t>(a >= 0 ? a / static_cast<std::int16_t>(REGION_CHUNK_COUNT_PER_SIDE)
+                                                    : (a + 1) / static_cast<std::int16_t>(REGION_CHUNK_COUNT_PER_SIDE) - 1);
+        };
+
+        return ChunkCoord{ FloorDiv(cc.idx), FloorDiv(cc.idz) };
+    }
+
+    // Index of the chunk "cc" in its region
+    static inline size_t GetChunkIndex(const ChunkCoord& cc) noexcept {
+        const ChunkCoord regionCoord = GetRegionCoord(cc);
+
+        return static_cast<size_t>(cc.idx - regionCoord.idx * static_cast<std::int16_t>(REGION_CHUNK_COUNT_PER_SIDE)) * REGION_CHUNK_COUNT_PER_SIDE
+             + static_cast<size_t>(cc.idz - regionCoord.idz * static_cast<std::int16_t>(REGION_CHUNK_COUNT_PER_SIDE));
+    }
+
+    inline bool HasChunk(const ChunkCoord& cc) const noexcept {
+        const Header* pHeader = this->GetHeader();
+
+        return pHeader && pHeader->entries[GetChunkIndex(cc)].size != 0u;
+    }
+
+    // Returns false, leaving the chunk untouched, when it isn't stored in the file
+    bool ReadChunk(Chunk& chunk) const noexcept;
+
+    // Rewrites the file once with the payloads of "pChunks" (which must all belong to this region),
+    // the other chunks' payloads are kept as they were
+    bool WriteChunks(const std::vector<const Chunk*>& pChunks) noexcept;
+}; // class RegionFile
+
+#endif // __MINECRAFT__REGION_FILE_HPP
@@ -1,23 +1,33 @@
 #ifndef __MINECRAFT__SHADERS_HPP
 #define __MINECRAFT__SHADERS_HPP
 
+// Vertices are packed in two uints, see struct Vertex in Block.hpp
 inline const char* vsBlockCode = R"V0G0N(
     cbuffer VS_CONSTANT_BUFFER : register(b0) {
         matrix transform;
     };
 
+    cbuffer VS_CHUNK_CONSTANT_BUFFER : register(b1) {
+        float4 chunkOrigin; // w holds the length of a block
+    };
+
     struct VS_OUTPUT {
-        float4 position  : SV_POSITION;
-        float2 uv        : UV;
-        float  lighting  : LIGHTING;
-        float  fog       : FOG;
+        float4 position           : SV_POSITION;
+        nointerpolation uint tile : TILE;
+        float2 tiling             : TILING;
+        float  lighting           : LIGHTING;
+        float  fog                : FOG;
     };
 
-    VS_OUTPUT main(float4 position : POSITION, float2 uv : UV, float lighting : LIGHTING) {
+    VS_OUTPUT main(uint2 packedVertex : PACKED_VERTEX) {
+        const float3 localPosition = float3(packedVertex.x & 0x1F, (packedVertex.x >> 5) & 0x1FF, (packedVertex.x >> 14) & 0x1F);
+        const float4 position      = float4(chunkOrigin.xyz + localPosition * chunkOrigin.w, 1.f);
+
         VS_OUTPUT result;
         result.position = mul(transform, position);
-        result.uv       = uv;
-        result.lighting = lighting;
+        result.tile     = packedVertex.y & 0xFF;
+        result.tiling   = float2((packedVertex.y >> 8) & 0x1FF, (packedVertex.y >> 17) & 0x1FF);
+        result.lighting = ((packedVertex.x >> 22) & 0xF) / 15.f;
 
         result.fog      = 1.0 - 1.0/pow(2.71, 0.0025 * distance(position, float4(0.f, position.y, 0.f, 0.f)));
 
@@ -29,7 +39,16 @@ inline const char* psBlockCode = R"V0G0N(
     Texture2D    textureAtlas : register(t0);
     SamplerState samplerState : register(s0);
 
-    float4 main(float4 position : POSITION, float2 uv : UV, float lighting : LIGHTING, float fog : FOG) : SV_TARGET {
+    float4 main(float4 position : SV_POSITION, nointerpolation uint tile : TILE, float2 tiling : TILING, float lighting : LIGHTING, float fog : FOG) : SV_TARGET {
+        float atlasWidth, atlasHeight;
+        textureAtlas.GetDimensions(atlasWidth, atlasHeight);
+
+        const float2 textureUVSize    = float2(16.f / atlasWidth, 16.f / atlasHeight);
+        const uint   atlasTilesPerRow = (uint)(atlasWidth / 16.f);
+
+        // a face can span several blocks (greedy meshing): repeat its texture once per block
+        const float2 uv = (float2(tile % atlasTilesPerRow, tile / atlasTilesPerRow) + frac(tiling)) * textureUVSize;
+
         return float4(textureAtlas.Sample(samplerState, uv).xyz * lighting * (1 - fog) + fog * float3(1.f, 1.f, 1.f), 1.0f);
     }
 )V0G0N";
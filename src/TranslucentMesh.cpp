@@ -0,0 +1,112 @@
+#include "TranslucentMesh.hpp"
+
+void TranslucentMesh::GatherQuads() noexcept {
+    this->m_quadVertices.clear();
+    for (const std::vector<Vertex>& vertices : this->m_sectionVertices)
+        this->m_quadVertices.insert(this->m_quadVertices.end(), vertices.begin(), vertices.end());
+
+    const size_t nQuads = this->m_quadVertices.size() / 4u;
+
+    this->m_quadCenters.resize(nQuads);
+    this->m_order.resize(nQuads);
+
+    for (size_t quad = 0u; quad < nQuads; ++quad) {
+        // the quads are drawn as (a, b, c) (a, c, e), a and c are opposite corners
+        const UnpackedVertex a = UnpackVertex(this->m_quadVertices[quad * 4u]);
+        const UnpackedVertex c = UnpackVertex(this->m_quadVertices[quad * 4u + 2u]);
+
+        this->m_quadCenters[quad] = QuadCenter{
+            static_cast<std::uint16_t>(a.x + c.x), static_cast<std::uint16_t>(a.y + c.y), static_cast<std::uint16_t>(a.z + c.z)
+        };
+        this->m_order[quad] = static_cast<std::uint32_t>(quad);
+    }
+}
+
+void TranslucentMesh::SetSectionVertices(const size_t sectionIndex, const std::vector<Vertex>& vertices) noexcept {
+    // both are usually empty, the sections without translucent blocks don't change anything
+    if (vertices.empty() && this->m_sectionVertices[sectionIndex].empty())
+        return;
+
+    this->m_sectionVertices[sectionIndex] = vertices;
+    this->m_bAreQuadsDirty = true;
+}
+
+void TranslucentMesh::Clear() noexcept {
+    for (std::vector<Vertex>& vertices : this->m_sectionVertices) {
+        vertices.clear();
+        vertices.shrink_to_fit();
+    }
+
+    this->m_quadVertices.clear();
+    this->m_quadCenters.clear();
+    this->m_order.clear();
+    this->m_sortedVertices.clear();
+    this->m_bAreQuadsDirty = false;
+    this->m_nLastSortMoves = 0u;
+}
+
+bool TranslucentMesh::Sort(const Vec4f32& cameraPosition) noexcept {
+    PROFILE_SCOPE("TranslucentMesh::Sort");
+
+    const std::array<int, 3u> cameraBlock = {
+        static_cast<int>(std::floor(cameraPosition.x)), static_cast<int>(std::floor(cameraPosition.y)), static_cast<int>(std::floor(cameraPosition.z))
+    };
+
+    if (!this->m_bAreQuadsDirty && cameraBlock == this->m_sortedCameraBlock)
+        return false;
+
+    const bool bStartOver = this->m_bAreQuadsDirty;
+    if (bStartOver)
+        this->GatherQuads();
+
+    this->m_sortedCameraBlock = cameraBlock;
+    this->m_bAreQuadsDirty    = false;
+
+    const size_t nQuads = this->m_quadCenters.size();
+
+    this->m_depths.resize(nQuads);
+    for (size_t quad = 0u; quad < nQuads; ++quad) {
+        const QuadCenter& center = this->m_quadCenters[quad];
+
+        const float dx = center.x * 0.5f - cameraPosition.x;
+        const float dy = center.y * 0.5f - cameraPosition.y;
+        const float dz = center.z * 0.5f - cameraPosition.z;
+        this->m_depths[quad] = dx * dx + dy * dy + dz * dz;
+    }
+
+    const auto IsFarther = [this](const std::uint32_t lhs, const std::uint32_t rhs) { return this->m_depths[lhs] > this->m_depths[rhs]; };
+
+    // insertion sort from the previous order, given up on when the camera moved so far that most quads are out of place
+    bool bIsSorted = !bStartOver;
+    size_t nMoves  = 0u;
+
+    for (size_t i = 1u; i < nQuads && bIsSorted; ++i) {
+        const std::uint32_t quad = this->m_order[i];
+
+        size_t j = i;
+        for (; j > 0u && IsFarther(quad, this->m_order[j - 1u]); --j)
+            this->m_order[j] = this->m_order[j - 1u];
+
+        this->m_order[j] = quad;
+        nMoves += i - j;
+
+        bIsSorted = nMoves <= nQuads * MAX_INSERTION_MOVES_PER_QUAD;
+    }
+
+    // the order is still a permutation of the quads when the insertion sort stopped half way
+    if (!bIsSorted) {
+        std::stable_sort(this->m_order.begin(), this->m_order.end(), IsFarther);
+        nMoves = nQuads;
+    }
+
+    this->m_nLastSortMoves = nMoves;
+
+    if (nMoves == 0u && !bStartOver)
+        return false;
+
+    this->m_sortedVertices.resize(nQuads * 4u);
+    for (size_t i = 0u; i < nQuads; ++i)
+        std::copy_n(this->m_quadVertices.begin() + this->m_order[i] * 4u, 4u, this->m_sortedVertices.begin() + i * 4u);
+
+    return true;
+}
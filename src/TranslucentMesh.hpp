@@ -0,0 +1,75 @@
+#ifndef __MINECRAFT__TRANSLUCENT_MESH_HPP
+#define __MINECRAFT__TRANSLUCENT_MESH_HPP
+
+#include "Pch.hpp"
+#include "Block.hpp"
+#include "Vector.hpp"
+#include "Constants.hpp"
+#include "Profiler.hpp"
+
+// The translucent faces of a chunk, which are blended over what is behind them and so have to be drawn back to front.
+// The quads are kept on the CPU, with the order they were last sorted in, and are only sorted again once the camera
+// entered another block: from one block to the next few quads swap places, so an insertion sort starting from the
+// previous order is about linear. Vertices come 4 per quad, as for the opaque meshes
+class TranslucentMesh {
+private:
+    // As built by the mesher
+    std::array<std::vector<Vertex>, CHUNK_SECTION_COUNT> m_sectionVertices;
+
+    // The quads' centers, in half blocks relative to the chunk's origin so that they are integers
+    struct QuadCenter {
+        std::uint16_t x, y, z;
+    }; // struct QuadCenter
+
+    // Every section's quads one after the other, as indexed by m_order
+    std::vector<Vertex>        m_quadVertices;
+    std::vector<QuadCenter>    m_quadCenters;
+    std::vector<std::uint32_t> m_order;  // the quads, back to front as of the last sort
+    std::vector<float>         m_depths; // each quad's squared distance to the camera, for the sort in progress
+
+    std::vector<Vertex> m_sortedVertices;
+
+    // The block the camera was in for the last sort
+    std::array<int, 3u> m_sortedCameraBlock{};
+
+    // Set when a section's vertices changed since the last sort, which then starts over
+    bool m_bAreQuadsDirty = false;
+
+    // Past this many moves per quad the previous order is dropped, see Sort
+    static constexpr size_t MAX_INSERTION_MOVES_PER_QUAD = 8u;
+
+    size_t m_nLastSortMoves = 0u;
+
+private:
+    // Rebuilds the quads from every section's vertices, in section order
+    void GatherQuads() noexcept;
+
+public:
+    // "vertices" replaces the section's translucent faces, the next Sort then sorts every quad again
+    void SetSectionVertices(const size_t sectionIndex, const std::vector<Vertex>& vertices) noexcept;
+
+    void Clear() noexcept;
+
+    // Every section's vertices, the ones set since the last sort included
+    inline size_t GetVertexCount() const noexcept {
+        size_t nVertices = 0u;
+        for (const std::vector<Vertex>& vertices : this->m_sectionVertices)
+            nVertices += vertices.size();
+
+        return nVertices;
+    }
+
+    // As of the last sort
+    inline size_t GetQuadCount() const noexcept { return this->m_sortedVertices.size() / 4u; }
+
+    // Orders the quads back to front as seen from "cameraPosition" (in blocks, relative to the chunk's origin), unless the camera
+    // is in the same block as for the last sort and the quads didn't change. Returns true when GetSortedVertices changed
+    bool Sort(const Vec4f32& cameraPosition) noexcept;
+
+    inline const std::vector<Vertex>& GetSortedVertices() const noexcept { return this->m_sortedVertices; }
+
+    // How many places the last sort moved the quads by in total, the number of quads when it started over
+    inline size_t GetLastSortMoveCount() const noexcept { return this->m_nLastSortMoves; }
+}; // class TranslucentMesh
+
+#endif // __MINECRAFT__TRANSLUCENT_MESH_HPP
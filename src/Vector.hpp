@@ -3,13 +3,37 @@
 
 #include "Pch.hpp"
 
-struct Vec4f32 {
+// Vec4f32 and Mat4x4f32 are 16-byte aligned so that they are loaded into SSE registers whole
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define MINECRAFT_MATH_SSE2
+    #include <emmintrin.h>
+#endif
+
+// Multiply-adds are fused when the target has FMA, which rounds once instead of twice
+#if defined(MINECRAFT_MATH_SSE2) && defined(__FMA__)
+    #define MINECRAFT_MATH_FMA
+#endif
+
+// for FMA and the 256-bit batch transforms
+#if defined(MINECRAFT_MATH_SSE2) && (defined(__FMA__) || defined(__AVX__))
+    #include <immintrin.h>
+#endif
+
+// The component-wise operators are left scalar: compilers emit them as single SSE instructions
+// anyway, and can still vectorize the loops they are in, which intrinsics prevent
+struct alignas(16) Vec4f32 {
     float x, y, z, w;
 
     inline Vec4f32(const float x = 0.f, const float y = 0.f, const float z = 0.f, const float w = 0.f) noexcept {
         this->x = x; this->y = y; this->z = z; this->w = w;
     }
 
+#ifdef MINECRAFT_MATH_SSE2
+    inline explicit Vec4f32(const __m128 v) noexcept { _mm_store_ps(&this->x, v); }
+
+    inline __m128 Load() const noexcept { return _mm_load_ps(&this->x); }
+#endif // MINECRAFT_MATH_SSE2
+
     inline Vec4f32& operator+=(const Vec4f32& rhs) noexcept { this->x += rhs.x; this->y += rhs.y; this->z += rhs.z; this->w += rhs.w; return *this; }
     inline Vec4f32& operator-=(const Vec4f32& rhs) noexcept { this->x -= rhs.x; this->y -= rhs.y; this->z -= rhs.z; this->w -= rhs.w; return *this; }
     inline Vec4f32& operator*=(const Vec4f32& rhs) noexcept { this->x *= rhs.x; this->y *= rhs.y; this->z *= rhs.z; this->w *= rhs.w; return *this; }
@@ -44,6 +68,26 @@ inline Vec4f32 operator-(const float& lhs, const Vec4f32& rhs) noexcept { return
 inline Vec4f32 operator*(const float& lhs, const Vec4f32& rhs) noexcept { return rhs * lhs; }
 inline Vec4f32 operator/(const float& lhs, const Vec4f32& rhs) noexcept { return rhs / lhs; }
 
+#ifdef MINECRAFT_MATH_SSE2
+
+// a * b + c
+inline __m128 MultiplyAdd(const __m128 a, const __m128 b, const __m128 c) noexcept {
+#ifdef MINECRAFT_MATH_FMA
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif // MINECRAFT_MATH_FMA
+}
+
+inline Vec4f32 MultiplyAdd(const Vec4f32& a, const Vec4f32& b, const Vec4f32& c) noexcept { return Vec4f32(MultiplyAdd(a.Load(), b.Load(), c.Load())); }
+
+#else
+
+// a * b + c
+inline Vec4f32 MultiplyAdd(const Vec4f32& a, const Vec4f32& b, const Vec4f32& c) noexcept { return a * b + c; }
+
+#endif // MINECRAFT_MATH_SSE2
+
 inline float DotProduct3D(const Vec4f32& lhs, const Vec4f32& rhs) noexcept {
     return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
 }
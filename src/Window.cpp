@@ -88,6 +88,19 @@ LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) n
         case WM_KEYUP:
             pWindow->m_bDownKeys[wParam] = false;
             return 0;
+        // the mouse buttons are kept with the keys, under their virtual key codes
+        case WM_LBUTTONDOWN:
+            pWindow->m_bDownKeys[VK_LBUTTON] = true;
+            return 0;
+        case WM_LBUTTONUP:
+            pWindow->m_bDownKeys[VK_LBUTTON] = false;
+            return 0;
+        case WM_RBUTTONDOWN:
+            pWindow->m_bDownKeys[VK_RBUTTON] = true;
+            return 0;
+        case WM_RBUTTONUP:
+            pWindow->m_bDownKeys[VK_RBUTTON] = false;
+            return 0;
         case WM_INPUT:
             UINT dwSize;
 
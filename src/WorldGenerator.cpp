@@ -0,0 +1,394 @@
+#include "WorldGenerator.hpp"
+
+// noise scales (in blocks) and octaves of the region fields
+constexpr float TEMPERATURE_NOISE_SCALE   = 768.f;
+constexpr int   TEMPERATURE_NOISE_OCTAVES = 2;
+constexpr float HUMIDITY_NOISE_SCALE      = 640.f;
+constexpr int   HUMIDITY_NOISE_OCTAVES    = 2;
+constexpr float ELEVATION_NOISE_SCALE     = 512.f;
+constexpr int   ELEVATION_NOISE_OCTAVES   = 3;
+
+// below SEA_LEVEL + SHORE_HEIGHT the surface is sand whatever the biome
+constexpr int SHORE_HEIGHT = 1;
+
+// the mountains are only bare stone from this high up
+constexpr int MOUNTAIN_ROCK_HEIGHT = SEA_LEVEL + 40;
+
+static inline float Lerp(const float t, const float a, const float b) noexcept { return a + t * (b - a); }
+
+static inline float SmoothStep(const float edge0, const float edge1, const float x) noexcept {
+    const float t = std::clamp((x - edge0) / (edge1 - edge0), 0.f, 1.f);
+    return t * t * (3.f - 2.f * t);
+}
+
+// each field has a noise of its own, seeded from the world's seed
+static BatchedPerlinNoise MakeNoise(const std::uint32_t seed) noexcept {
+    siv::PerlinNoise noise;
+    noise.reseed(seed);
+    return BatchedPerlinNoise(noise);
+}
+
+// the tunnels of a region are drawn from a generator seeded with this, mt19937 and the mixing below are the same everywhere
+static std::uint32_t HashRegion(const std::uint32_t seed, const ChunkCoord& regionCoord) noexcept {
+    std::uint32_t hash = seed * 0x9E3779B9u;
+    hash ^= static_cast<std::uint32_t>(static_cast<std::uint16_t>(regionCoord.idx)) * 0x85EBCA6Bu;
+    hash ^= static_cast<std::uint32_t>(static_cast<std::uint16_t>(regionCoord.idz)) * 0xC2B2AE35u;
+
+    hash ^= hash >> 16u;
+    hash *= 0x7FEB352Du;
+    hash ^= hash >> 15u;
+    hash *= 0x846CA68Bu;
+    hash ^= hash >> 16u;
+
+    return hash;
+}
+
+// the blocks whose center is in [min, max] along an axis are [FirstBlock(min, lo), EndBlock(max, hi)), clamped to [lo, hi)
+static inline size_t FirstBlock(const float min, const size_t lo) noexcept {
+    return static_cast<size_t>(std::max(static_cast<float>(lo), std::ceil(min - 0.5f)));
+}
+
+static inline size_t EndBlock(const float max, const size_t hi) noexcept {
+    return static_cast<size_t>(std::clamp(std::floor(max - 0.5f) + 1.f, 0.f, static_cast<float>(hi)));
+}
+
+// the elevation at which the land rises out of the sea, and then into mountains
+static inline float GetLandFactor    (const float elevation) noexcept { return SmoothStep(0.36f, 0.48f, elevation); }
+static inline float GetMountainFactor(const float elevation) noexcept { return SmoothStep(0.60f, 0.70f, elevation); }
+
+static BIOME SelectBiome(const float temperature, const float humidity, const float elevation) noexcept {
+    if (GetMountainFactor(elevation) > 0.5f)
+        return BIOME::BIOME_MOUNTAINS;
+
+    if (temperature > 0.55f && humidity < 0.48f)
+        return BIOME::BIOME_DESERT;
+
+    return BIOME::BIOME_PLAINS;
+}
+
+WorldGenerator::WorldGenerator(const std::uint32_t seed, const size_t regionCacheCapacity) noexcept
+    : m_seed(seed),
+      m_temperatureNoise(MakeNoise(seed + 1u)),
+      m_humidityNoise(MakeNoise(seed + 2u)),
+      m_elevationNoise(MakeNoise(seed + 3u)),
+      m_detailNoise(MakeNoise(seed)),
+      m_regionCacheCapacity(std::max<size_t>(regionCacheCapacity, 1u))
+{  }
+
+ChunkCoord WorldGenerator::GetRegionCoord(const ChunkCoord& cc) noexcept {
+    const auto FloorDiv = [](const std::int16_t a) {
+        return static_cast<std::int16_t>(a >= 0 ? a / REGION_CHUNK_COUNT_PER_SIDE : (a + 1) / REGION_CHUNK_COUNT_PER_SIDE - 1);
+    };
+
+    return ChunkCoord{ FloorDiv(cc.idx), FloorDiv(cc.idz) };
+}
+
+std::shared_ptr<const WorldGenerator::RegionFields> WorldGenerator::ComputeRegionFields(const ChunkCoord& regionCoord) const noexcept {
+    PROFILE_SCOPE("WorldGenerator::ComputeRegionFields");
+
+    std::shared_ptr<RegionFields> pFields = std::make_shared<RegionFields>();
+
+    // the samples are the noise at whole multiples of REGION_SAMPLE_SPACING blocks: the grid and the scale are both divided by it
+    const std::int32_t x0 = static_cast<std::int32_t>(regionCoord.idx) * (REGION_BLOCK_COUNT_PER_SIDE / REGION_SAMPLE_SPACING);
+    const std::int32_t z0 = static_cast<std::int32_t>(regionCoord.idz) * (REGION_BLOCK_COUNT_PER_SIDE / REGION_SAMPLE_SPACING);
+
+    this->m_temperatureNoise.NormalizedOctaveNoise2D_0_1(x0, z0, REGION_SAMPLE_COUNT_PER_SIDE, REGION_SAMPLE_COUNT_PER_SIDE, TEMPERATURE_NOISE_SCALE / REGION_SAMPLE_SPACING,
+                                                         TEMPERATURE_NOISE_OCTAVES, pFields->temperature.data());
+    this->m_humidityNoise.NormalizedOctaveNoise2D_0_1   (x0, z0, REGION_SAMPLE_COUNT_PER_SIDE, REGION_SAMPLE_COUNT_PER_SIDE, HUMIDITY_NOISE_SCALE / REGION_SAMPLE_SPACING,
+                                                         HUMIDITY_NOISE_OCTAVES, pFields->humidity.data());
+    this->m_elevationNoise.NormalizedOctaveNoise2D_0_1  (x0, z0, REGION_SAMPLE_COUNT_PER_SIDE, REGION_SAMPLE_COUNT_PER_SIDE, ELEVATION_NOISE_SCALE / REGION_SAMPLE_SPACING,
+                                                         ELEVATION_NOISE_OCTAVES, pFields->elevation.data());
+
+    std::mt19937 random(HashRegion(this->m_seed, regionCoord));
+    const auto Random01 = [&random]() { return static_cast<float>(random() >> 8u) / 16777216.f; };
+
+    for (int tunnel = 0; tunnel < CAVE_TUNNEL_COUNT_PER_REGION; ++tunnel) {
+        float x = Random01() * REGION_BLOCK_COUNT_PER_SIDE;
+        float z = Random01() * REGION_BLOCK_COUNT_PER_SIDE;
+        float y = Lerp(Random01(), 12.f, SEA_LEVEL + 24.f);
+
+        float yaw   = Random01() * 2.f * static_cast<float>(M_PI);
+        float pitch = (Random01() - 0.5f) * 0.5f;
+
+        const int   nSteps     = CAVE_TUNNEL_MIN_STEP_COUNT + static_cast<int>(random() % (CAVE_TUNNEL_MAX_STEP_COUNT - CAVE_TUNNEL_MIN_STEP_COUNT + 1));
+        const float baseRadius = Lerp(Random01(), 1.2f, 2.5f);
+
+        for (int step = 0; step < nSteps; ++step) {
+            // wider half way through
+            const float radius = baseRadius * (1.f + 0.5f * std::sin(static_cast<float>(M_PI) * step / nSteps));
+            pFields->caveSpheres.push_back(CaveSphere{ x, y, z, std::min(radius, CAVE_TUNNEL_MAX_RADIUS) });
+
+            x += std::cos(pitch) * std::cos(yaw);
+            z += std::cos(pitch) * std::sin(yaw);
+            y += std::sin(pitch);
+
+            yaw  += (Random01() - 0.5f) * 0.6f;
+            pitch = std::clamp(pitch * 0.8f + (Random01() - 0.5f) * 0.4f, -0.6f, 0.6f);
+        }
+    }
+
+    return pFields;
+}
+
+std::shared_ptr<const WorldGenerator::RegionFields> WorldGenerator::GetRegionFields(const ChunkCoord& regionCoord) noexcept {
+    {
+        std::lock_guard<std::mutex> lock(this->m_regionCacheMutex);
+
+        const auto it = this->m_regionCache.find(regionCoord);
+        if (it != this->m_regionCache.end()) {
+            it->second.lastUse = ++this->m_regionCacheClock;
+            ++this->m_stats.nRegionCacheHits;
+            return it->second.pFields;
+        }
+
+        ++this->m_stats.nRegionCacheMisses;
+    }
+
+    // computed unlocked, another thread may compute the same region meanwhile and get the same fields
+    std::shared_ptr<const RegionFields> pFields = this->ComputeRegionFields(regionCoord);
+
+    std::lock_guard<std::mutex> lock(this->m_regionCacheMutex);
+
+    const auto [it, bInserted] = this->m_regionCache.emplace(regionCoord, CachedRegion{ pFields, 0u });
+    it->second.lastUse = ++this->m_regionCacheClock;
+
+    // the chunks being generated hold on to the fields they use, evicting them only drops the cache's reference
+    if (bInserted && this->m_regionCache.size() > this->m_regionCacheCapacity) {
+        const auto lru = std::min_element(this->m_regionCache.begin(), this->m_regionCache.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.second.lastUse < rhs.second.lastUse;
+        });
+
+        this->m_regionCache.erase(lru);
+    }
+
+    return pFields;
+}
+
+WorldGenerator::ChunkColumns WorldGenerator::ComputeColumns(const ChunkCoord& cc) noexcept {
+    const ChunkCoord regionCoord = GetRegionCoord(cc);
+    const std::shared_ptr<const RegionFields> pFields = this->GetRegionFields(regionCoord);
+
+    std::array<float, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT> detail;
+    this->m_detailNoise.NormalizedOctaveNoise2D_0_1(cc.idx * CHUNK_X_BLOCK_COUNT, cc.idz * CHUNK_Z_BLOCK_COUNT, CHUNK_X_BLOCK_COUNT, CHUNK_Z_BLOCK_COUNT, 50.f, 3, detail.data());
+
+    // the chunk's columns relative to its region
+    const int x0 = (cc.idx - regionCoord.idx * REGION_CHUNK_COUNT_PER_SIDE) * CHUNK_X_BLOCK_COUNT;
+    const int z0 = (cc.idz - regionCoord.idz * REGION_CHUNK_COUNT_PER_SIDE) * CHUNK_Z_BLOCK_COUNT;
+
+    ChunkColumns columns;
+
+    for (int x = 0; x < CHUNK_X_BLOCK_COUNT; ++x) {
+        for (int z = 0; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+            const int i = (x0 + x) / REGION_SAMPLE_SPACING;
+            const int j = (z0 + z) / REGION_SAMPLE_SPACING;
+
+            const float u = static_cast<float>((x0 + x) % REGION_SAMPLE_SPACING) / REGION_SAMPLE_SPACING;
+            const float v = static_cast<float>((z0 + z) % REGION_SAMPLE_SPACING) / REGION_SAMPLE_SPACING;
+
+            const auto Sample = [&](const auto& field) {
+                const size_t sample = static_cast<size_t>(i * REGION_SAMPLE_COUNT_PER_SIDE + j);
+                return Lerp(u, Lerp(v, field[sample],                                field[sample + 1u]),
+                               Lerp(v, field[sample + REGION_SAMPLE_COUNT_PER_SIDE], field[sample + REGION_SAMPLE_COUNT_PER_SIDE + 1u]));
+            };
+
+            const float elevation = Sample(pFields->elevation);
+            const size_t column   = static_cast<size_t>(x * CHUNK_Z_BLOCK_COUNT + z);
+
+            // stage 1: climate
+            columns.biomes[column] = SelectBiome(Sample(pFields->temperature), Sample(pFields->humidity), elevation);
+
+            // stage 2: height, from the continuous factors rather than the biome so that the biomes' borders don't make cliffs
+            const float land      = GetLandFactor(elevation);
+            const float mountains = GetMountainFactor(elevation);
+
+            const float base      = Lerp(land, SEA_LEVEL - 20.f, SEA_LEVEL + 8.f) + mountains * 60.f;
+            const float amplitude = 10.f + 14.f * land + 60.f * mountains;
+            const float height    = base + (detail[column] - 0.5f) * 2.f * amplitude;
+
+            columns.heights[column] = static_cast<std::uint8_t>(std::clamp(height, 1.f, CHUNK_Y_BLOCK_COUNT - 2.f));
+        }
+    }
+
+    return columns;
+}
+
+std::vector<WorldGenerator::CaveSphere> WorldGenerator::GatherCaveSpheres(const ChunkCoord& cc) noexcept {
+    constexpr int REACH_CHUNK_COUNT = (CAVE_TUNNEL_MAX_REACH + CHUNK_X_BLOCK_COUNT - 1) / CHUNK_X_BLOCK_COUNT;
+
+    const ChunkCoord firstRegion = GetRegionCoord(ChunkCoord{ static_cast<std::int16_t>(cc.idx - REACH_CHUNK_COUNT), static_cast<std::int16_t>(cc.idz - REACH_CHUNK_COUNT) });
+    const ChunkCoord lastRegion  = GetRegionCoord(ChunkCoord{ static_cast<std::int16_t>(cc.idx + REACH_CHUNK_COUNT), static_cast<std::int16_t>(cc.idz + REACH_CHUNK_COUNT) });
+
+    std::vector<CaveSphere> spheres;
+
+    for (int rx = firstRegion.idx; rx <= lastRegion.idx; ++rx) {
+        for (int rz = firstRegion.idz; rz <= lastRegion.idz; ++rz) {
+            const std::shared_ptr<const RegionFields> pFields = this->GetRegionFields(ChunkCoord{ static_cast<std::int16_t>(rx), static_cast<std::int16_t>(rz) });
+
+            // from the region's origin to the chunk's
+            const float dx = static_cast<float>((rx * REGION_CHUNK_COUNT_PER_SIDE - cc.idx) * CHUNK_X_BLOCK_COUNT);
+            const float dz = static_cast<float>((rz * REGION_CHUNK_COUNT_PER_SIDE - cc.idz) * CHUNK_Z_BLOCK_COUNT);
+
+            for (const CaveSphere& sphere : pFields->caveSpheres) {
+                const CaveSphere local = { sphere.x + dx, sphere.y, sphere.z + dz, sphere.radius };
+
+                if (local.x + local.radius >= 0.f && local.x - local.radius < CHUNK_X_BLOCK_COUNT &&
+                    local.z + local.radius >= 0.f && local.z - local.radius < CHUNK_Z_BLOCK_COUNT)
+                    spheres.push_back(local);
+            }
+        }
+    }
+
+    return spheres;
+}
+
+void WorldGenerator::GenerateChunk(Chunk& chunk) noexcept {
+    PROFILE_SCOPE("WorldGenerator::GenerateChunk");
+
+    const ChunkColumns            columns = this->ComputeColumns(chunk.m_location);
+    const std::vector<CaveSphere> spheres = this->GatherCaveSpheres(chunk.m_location);
+
+    // stage 3: surface, from the top of each column down
+    struct ColumnLayers {
+        BLOCK_TYPE top;
+        BLOCK_TYPE filler;
+        size_t     stoneEnd;  // stone below, then the filler up to the top block
+        size_t     surface;   // the top block
+        size_t     carveEnd;  // the tunnels don't dig at or above it, so that the sea keeps a floor
+    }; // struct ColumnLayers
+
+    std::array<ColumnLayers, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT> layers;
+
+    size_t lowestStone = CHUNK_Y_BLOCK_COUNT;
+    size_t highestTop  = SEA_LEVEL;
+
+    for (size_t column = 0u; column < layers.size(); ++column) {
+        const size_t height = columns.heights[column];
+
+        ColumnLayers& layer = layers[column];
+        layer.surface  = height;
+        layer.carveEnd = height > SEA_LEVEL ? height + 1u : (height >= 3u ? height - 2u : 0u);
+
+        size_t fillerDepth = 3u;
+        if (height <= SEA_LEVEL + SHORE_HEIGHT) {
+            layer.top = layer.filler = BLOCK_TYPE::BLOCK_TYPE_SAND;
+        } else if (columns.biomes[column] == BIOME::BIOME_DESERT) {
+            layer.top = layer.filler = BLOCK_TYPE::BLOCK_TYPE_SAND;
+            fillerDepth = 4u;
+        } else if (columns.biomes[column] == BIOME::BIOME_MOUNTAINS && height >= MOUNTAIN_ROCK_HEIGHT) {
+            layer.top = layer.filler = BLOCK_TYPE::BLOCK_TYPE_STONE;
+        } else {
+            layer.top    = BLOCK_TYPE::BLOCK_TYPE_GRASS;
+            layer.filler = BLOCK_TYPE::BLOCK_TYPE_DIRT;
+        }
+
+        layer.stoneEnd = height >= fillerDepth ? height - fillerDepth : 0u;
+
+        lowestStone = std::min(lowestStone, layer.stoneEnd);
+        highestTop  = std::max(highestTop, height);
+    }
+
+    for (std::unique_ptr<ChunkSection>& pSection : chunk.m_pSections)
+        pSection.reset();
+
+    chunk.MarkAllSectionsDirty();
+
+    std::array<BLOCK_TYPE, CHUNK_SECTION_BLOCK_COUNT> blocks;
+
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        const size_t yBegin = sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT;
+        const size_t yEnd   = std::min(yBegin + CHUNK_SECTION_Y_BLOCK_COUNT, static_cast<size_t>(CHUNK_Y_BLOCK_COUNT));
+
+        // carving only ever removes blocks, the sections above the ground and the sea stay empty
+        if (yBegin > highestTop)
+            break;
+
+        const auto IsSphereInSection = [yBegin, yEnd](const CaveSphere& sphere) {
+            return sphere.y + sphere.radius >= static_cast<float>(yBegin) && sphere.y - sphere.radius < static_cast<float>(yEnd);
+        };
+
+        const bool bIsCarved = std::any_of(spheres.begin(), spheres.end(), IsSphereInSection);
+
+        // sections of stone only don't need a palette
+        if (yEnd <= lowestStone && !bIsCarved) {
+            chunk.m_pSections[sectionIndex] = std::make_unique<ChunkSection>(BLOCK_TYPE::BLOCK_TYPE_STONE);
+            continue;
+        }
+
+        for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x) {
+            for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z) {
+                const ColumnLayers& layer = layers[x * CHUNK_Z_BLOCK_COUNT + z];
+
+                // a column's blocks are contiguous in a section
+                BLOCK_TYPE* pColumn = blocks.data() + ChunkSection::GetBlockIndex(x, 0u, z);
+
+                const auto FillLayer = [&](const size_t layerBegin, const size_t layerEnd, const BLOCK_TYPE type) {
+                    const size_t begin = std::clamp(layerBegin, yBegin, yBegin + CHUNK_SECTION_Y_BLOCK_COUNT);
+                    const size_t end   = std::clamp(layerEnd,   yBegin, yBegin + CHUNK_SECTION_Y_BLOCK_COUNT);
+
+                    std::fill(pColumn + (begin - yBegin), pColumn + (end - yBegin), type);
+                };
+
+                const size_t waterEnd = std::max(layer.surface + 1u, static_cast<size_t>(SEA_LEVEL + 1));
+
+                FillLayer(0u,                 layer.stoneEnd,                       BLOCK_TYPE::BLOCK_TYPE_STONE);
+                FillLayer(layer.stoneEnd,     layer.surface,                        layer.filler);
+                FillLayer(layer.surface,      layer.surface + 1u,                   layer.top);
+                FillLayer(layer.surface + 1u, waterEnd,                             BLOCK_TYPE::BLOCK_TYPE_WATER);
+                FillLayer(waterEnd,           yBegin + CHUNK_SECTION_Y_BLOCK_COUNT, BLOCK_TYPE::BLOCK_TYPE_AIR);
+            }
+        }
+
+        // stage 4: carving, the lowest layer of the world is kept
+        for (const CaveSphere& sphere : spheres) {
+            if (!IsSphereInSection(sphere))
+                continue;
+
+            const size_t xBegin = FirstBlock(sphere.x - sphere.radius, 0u), xEnd = EndBlock(sphere.x + sphere.radius, CHUNK_X_BLOCK_COUNT);
+            const size_t zBegin = FirstBlock(sphere.z - sphere.radius, 0u), zEnd = EndBlock(sphere.z + sphere.radius, CHUNK_Z_BLOCK_COUNT);
+            const size_t yFirst = FirstBlock(sphere.y - sphere.radius, std::max<size_t>(yBegin, 1u));
+            const size_t yLast  = EndBlock(sphere.y + sphere.radius, yEnd);
+
+            const float radiusSquared = sphere.radius * sphere.radius;
+
+            for (size_t x = xBegin; x < xEnd; ++x) {
+                for (size_t z = zBegin; z < zEnd; ++z) {
+                    const ColumnLayers& layer = layers[x * CHUNK_Z_BLOCK_COUNT + z];
+
+                    // the blocks' centers
+                    const float dx = static_cast<float>(x) + 0.5f - sphere.x;
+                    const float dz = static_cast<float>(z) + 0.5f - sphere.z;
+
+                    for (size_t y = yFirst; y < std::min(yLast, layer.carveEnd); ++y) {
+                        const float dy = static_cast<float>(y) + 0.5f - sphere.y;
+
+                        if (dx * dx + dy * dy + dz * dz <= radiusSquared)
+                            blocks[ChunkSection::GetBlockIndex(x, y - yBegin, z)] = BLOCK_TYPE::BLOCK_TYPE_AIR;
+                    }
+                }
+            }
+        }
+
+        std::unique_ptr<ChunkSection> pSection = std::make_unique<ChunkSection>();
+        pSection->Assign(blocks);
+
+        if (!pSection->IsEmpty())
+            chunk.m_pSections[sectionIndex] = std::move(pSection);
+    }
+
+    chunk.m_bIsGenerated = true;
+    chunk.m_bIsDirty     = true;
+}
+
+void WorldGenerator::ClearRegionCache() noexcept {
+    std::lock_guard<std::mutex> lock(this->m_regionCacheMutex);
+
+    this->m_regionCache.clear();
+}
+
+WorldGeneratorStats WorldGenerator::GetStats() noexcept {
+    std::lock_guard<std::mutex> lock(this->m_regionCacheMutex);
+
+    WorldGeneratorStats stats = this->m_stats;
+    stats.nCachedRegions = this->m_regionCache.size();
+    return stats;
+}
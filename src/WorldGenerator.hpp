@@ -0,0 +1,129 @@
+#ifndef __MINECRAFT__WORLD_GENERATOR_HPP
+#define __MINECRAFT__WORLD_GENERATOR_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "Profiler.hpp"
+#include "BatchedPerlinNoise.hpp"
+#include "vendor/PerlinNoise.hpp"
+
+enum class BIOME : std::uint8_t {
+    BIOME_PLAINS = 0u, // grass over a few blocks of dirt
+    BIOME_DESERT,      // hot and dry, sand down to the stone
+    BIOME_MOUNTAINS,   // high and rough, bare stone
+
+    _COUNT
+}; // enum class BIOME
+
+struct WorldGeneratorStats {
+    size_t nRegionCacheHits   = 0u;
+    size_t nRegionCacheMisses = 0u; // the regions computed, again when they were evicted in between
+    size_t nCachedRegions     = 0u;
+}; // struct WorldGeneratorStats
+
+// Generates the chunks' blocks in stages:
+//  1. climate: the temperature, humidity and elevation fields, which pick each column's biome
+//  2. height:  the elevation plus detail noise, rougher as the elevation rises into mountains
+//  3. surface: the biome's blocks on top of the stone, sand on the shores and water up to SEA_LEVEL
+//  4. carving: tunnels dug through the ground
+// The fields of stage 1 and the tunnels only vary over hundreds of blocks, they are computed once per region of
+// REGION_CHUNK_COUNT_PER_SIDE x REGION_CHUNK_COUNT_PER_SIDE chunks, on a coarse grid that the chunks interpolate,
+// and kept in a bounded LRU cache. A region only depends on the seed and on its location, so a chunk's blocks
+// don't depend on the order the chunks are generated in nor on what the cache holds.
+// GenerateChunk can be called from several threads at once
+class WorldGenerator {
+public:
+    // Unrelated to the region files'
+    static constexpr int REGION_CHUNK_COUNT_PER_SIDE = 8;
+
+    // The fields are sampled every REGION_SAMPLE_SPACING blocks, up to and including the region's far sides so that two
+    // regions agree on the samples they share
+    static constexpr int REGION_SAMPLE_SPACING        = 8; // in blocks
+    static constexpr int REGION_BLOCK_COUNT_PER_SIDE  = REGION_CHUNK_COUNT_PER_SIDE * CHUNK_X_BLOCK_COUNT;
+    static constexpr int REGION_SAMPLE_COUNT_PER_SIDE = REGION_BLOCK_COUNT_PER_SIDE / REGION_SAMPLE_SPACING + 1;
+
+    // Enough for the chunks a few threads work on at once, and the regions around them that their tunnels come from
+    static constexpr size_t DEFAULT_REGION_CACHE_CAPACITY = 32u;
+
+    // Tunnels wind from a random point of their region, the farthest they go from it bounds the regions a chunk looks at
+    static constexpr int   CAVE_TUNNEL_COUNT_PER_REGION = 8;
+    static constexpr int   CAVE_TUNNEL_MIN_STEP_COUNT   = 48;
+    static constexpr int   CAVE_TUNNEL_MAX_STEP_COUNT   = 96;  // one block each
+    static constexpr float CAVE_TUNNEL_MAX_RADIUS       = 4.f; // in blocks
+    static constexpr int   CAVE_TUNNEL_MAX_REACH        = CAVE_TUNNEL_MAX_STEP_COUNT + static_cast<int>(CAVE_TUNNEL_MAX_RADIUS) + 1;
+
+    static_assert(CHUNK_X_BLOCK_COUNT == CHUNK_Z_BLOCK_COUNT, "Regions are square");
+    static_assert(REGION_BLOCK_COUNT_PER_SIDE % REGION_SAMPLE_SPACING == 0 && CHUNK_X_BLOCK_COUNT % REGION_SAMPLE_SPACING == 0,
+                  "Chunks and regions are made of whole sample cells");
+    static_assert(CAVE_TUNNEL_MAX_REACH < REGION_BLOCK_COUNT_PER_SIDE, "Tunnels never go past the regions next to theirs");
+
+private:
+    // One ball of a tunnel, in blocks relative to the region's origin
+    struct CaveSphere {
+        float x, y, z;
+        float radius;
+    }; // struct CaveSphere
+
+    struct RegionFields {
+        // Indexed by i * REGION_SAMPLE_COUNT_PER_SIDE + j for the sample i along x and j along z, in [0, 1]
+        std::array<float, REGION_SAMPLE_COUNT_PER_SIDE * REGION_SAMPLE_COUNT_PER_SIDE> temperature;
+        std::array<float, REGION_SAMPLE_COUNT_PER_SIDE * REGION_SAMPLE_COUNT_PER_SIDE> humidity;
+        std::array<float, REGION_SAMPLE_COUNT_PER_SIDE * REGION_SAMPLE_COUNT_PER_SIDE> elevation;
+
+        std::vector<CaveSphere> caveSpheres;
+    }; // struct RegionFields
+
+    struct CachedRegion {
+        std::shared_ptr<const RegionFields> pFields;
+        std::uint64_t                       lastUse;
+    }; // struct CachedRegion
+
+    // Stages 1 and 2 for each of a chunk's columns, indexed by x * CHUNK_Z_BLOCK_COUNT + z
+    struct ChunkColumns {
+        ChunkHeightMap                                               heights;
+        std::array<BIOME, CHUNK_X_BLOCK_COUNT * CHUNK_Z_BLOCK_COUNT> biomes;
+    }; // struct ChunkColumns
+
+    std::uint32_t m_seed;
+
+    BatchedPerlinNoise m_temperatureNoise;
+    BatchedPerlinNoise m_humidityNoise;
+    BatchedPerlinNoise m_elevationNoise;
+    BatchedPerlinNoise m_detailNoise; // the same as ComputeDefaultHeightMap's for the seed
+
+    size_t m_regionCacheCapacity;
+
+    std::mutex                  m_regionCacheMutex;
+    ChunkCoordMap<CachedRegion> m_regionCache;
+    std::uint64_t               m_regionCacheClock = 0u;
+    WorldGeneratorStats         m_stats;
+
+private:
+    static ChunkCoord GetRegionCoord(const ChunkCoord& cc) noexcept;
+
+    // Only depends on the seed and "regionCoord"
+    std::shared_ptr<const RegionFields> ComputeRegionFields(const ChunkCoord& regionCoord) const noexcept;
+
+    // Through the cache
+    std::shared_ptr<const RegionFields> GetRegionFields(const ChunkCoord& regionCoord) noexcept;
+
+    ChunkColumns ComputeColumns(const ChunkCoord& cc) noexcept;
+
+    // The tunnels' spheres that reach into the chunk, relative to its origin
+    std::vector<CaveSphere> GatherCaveSpheres(const ChunkCoord& cc) noexcept;
+
+public:
+    explicit WorldGenerator(const std::uint32_t seed, const size_t regionCacheCapacity = DEFAULT_REGION_CACHE_CAPACITY) noexcept;
+
+    inline std::uint32_t GetSeed() const noexcept { return this->m_seed; }
+
+    // Replaces the chunk's blocks
+    void GenerateChunk(Chunk& chunk) noexcept;
+
+    // Forgets every region, the next chunks are generated as if the cache was cold
+    void ClearRegionCache() noexcept;
+
+    WorldGeneratorStats GetStats() noexcept;
+}; // class WorldGenerator
+
+#endif // __MINECRAFT__WORLD_GENERATOR_HPP
@@ -0,0 +1,361 @@
+#include "Test.hpp"
+#include "TestWorld.hpp"
+#include "BlockRaycast.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+constexpr int RAY_COUNT = 2000;
+
+// The reference walks the ray by steps of this many blocks. It misses the blocks the ray only clips for less than a step,
+// and is allowed to find the others up to a step late
+constexpr double REFERENCE_STEP = 1.0 / 64.0;
+
+// In blocks, for the rounding of the float ray against the double one
+constexpr double DISTANCE_TOLERANCE = 1e-3;
+
+struct TestRay {
+    Vec4f32 origin;
+    Vec4f32 direction;
+    float   maxDistance;
+}; // struct TestRay
+
+static bool IsOpaqueAt(const BlockRaycastChunkLookup& getChunk, const std::array<int, 3u>& block) noexcept {
+    if (block[1] < 0 || block[1] >= CHUNK_Y_BLOCK_COUNT)
+        return false;
+
+    const ChunkCoord location = GetBlockChunkLocation(block[0], block[2]);
+    const Chunk* pChunk = getChunk(location);
+    if (!pChunk)
+        return false;
+
+    const std::optional<BLOCK_TYPE> type = pChunk->GetBlock(static_cast<size_t>(block[0] - location.idx * CHUNK_X_BLOCK_COUNT), static_cast<size_t>(block[1]),
+                                                            static_cast<size_t>(block[2] - location.idz * CHUNK_Z_BLOCK_COUNT));
+    return type.has_value() && IsBlockOpaque(type.value());
+}
+
+// The ray in blocks and in double, its direction normalized
+static void GetReferenceRay(const TestRay& ray, std::array<double, 3u>& origin, std::array<double, 3u>& direction) noexcept {
+    origin    = { ray.origin.x / BLOCK_LENGTH, ray.origin.y / BLOCK_LENGTH, ray.origin.z / BLOCK_LENGTH };
+    direction = { ray.direction.x, ray.direction.y, ray.direction.z };
+
+    const double length = std::sqrt(direction[0] * direction[0] + direction[1] * direction[1] + direction[2] * direction[2]);
+    for (double& component : direction)
+        component /= length;
+}
+
+// The distance in blocks of the first point of the ray, a step apart from the previous one, that is in an opaque block
+static std::optional<double> FindFirstOpaqueSample(const BlockRaycastChunkLookup& getChunk, const TestRay& ray) noexcept {
+    std::array<double, 3u> origin, direction;
+    GetReferenceRay(ray, origin, direction);
+
+    const double maxTime = ray.maxDistance / BLOCK_LENGTH;
+    for (double time = 0.0; time <= maxTime; time += REFERENCE_STEP) {
+        std::array<int, 3u> block;
+        for (size_t axis = 0u; axis < 3u; ++axis)
+            block[axis] = static_cast<int>(std::floor(origin[axis] + direction[axis] * time));
+
+        if (IsOpaqueAt(getChunk, block))
+            return time;
+    }
+
+    return {  };
+}
+
+// When the ray goes in "block" and leaves it, in blocks from its origin, nullopt when it misses the block
+static std::optional<std::array<double, 2u>> GetBlockCrossing(const TestRay& ray, const std::array<int, 3u>& block) noexcept {
+    std::array<double, 3u> origin, direction;
+    GetReferenceRay(ray, origin, direction);
+
+    std::array<double, 2u> crossing = { -std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity() };
+    for (size_t axis = 0u; axis < 3u; ++axis) {
+        const double planes[2] = { static_cast<double>(block[axis]), static_cast<double>(block[axis] + 1) };
+
+        if (direction[axis] == 0.0) {
+            if (origin[axis] < planes[0] || origin[axis] >= planes[1])
+                return {  };
+
+            continue;
+        }
+
+        const double t0 = (planes[0] - origin[axis]) / direction[axis];
+        const double t1 = (planes[1] - origin[axis]) / direction[axis];
+        crossing[0] = std::max(crossing[0], std::min(t0, t1));
+        crossing[1] = std::min(crossing[1], std::max(t0, t1));
+    }
+
+    if (crossing[1] < crossing[0] - DISTANCE_TOLERANCE)
+        return {  };
+
+    return crossing;
+}
+
+// Both modes give the same hit, bit for bit, and it agrees with the fixed step walk
+static bool RaycastMatchesReference(const BlockRaycastChunkLookup& getChunk, const TestRay& ray) noexcept {
+    const std::optional<BlockRaycastHit> naiveHit = RaycastBlocks(getChunk, ray.origin, ray.direction, ray.maxDistance, BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE);
+    const std::optional<BlockRaycastHit> hit      = RaycastBlocks(getChunk, ray.origin, ray.direction, ray.maxDistance, BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_SKIP_EMPTY);
+
+    if (naiveHit.has_value() != hit.has_value())
+        return false;
+
+    if (hit.has_value() && (naiveHit->block != hit->block || naiveHit->type != hit->type || naiveHit->face != hit->face
+                            || std::memcmp(&naiveHit->distance, &hit->distance, sizeof(float)) != 0))
+        return false;
+
+    const std::optional<double> sampleTime = FindFirstOpaqueSample(getChunk, ray);
+
+    // every point the reference saw in an opaque block is at or past the hit
+    if (!hit.has_value())
+        return !sampleTime.has_value();
+
+    const double hitTime = hit->distance / BLOCK_LENGTH;
+    if (sampleTime.has_value() && sampleTime.value() < hitTime - DISTANCE_TOLERANCE)
+        return false;
+
+    // the hit is an opaque block of the world, that the ray goes in at that distance
+    if (!IsOpaqueAt(getChunk, hit->block) || !IsBlockOpaque(hit->type))
+        return false;
+
+    const std::optional<std::array<double, 2u>> crossing = GetBlockCrossing(ray, hit->block);
+    if (!crossing.has_value() || std::abs(std::max(crossing.value()[0], 0.0) - hitTime) > DISTANCE_TOLERANCE)
+        return false;
+
+    // unless the origin is inside it, the ray came from the block in front of the face, which it went through
+    if (hitTime > 0.0 && IsOpaqueAt(getChunk, hit->GetAdjacentBlock()))
+        return false;
+
+    // the reference finds it too, unless the ray only clips it or it is at the end of the ray
+    const bool bIsClipped  = crossing.value()[1] - std::max(crossing.value()[0], 0.0) < 2.0 * REFERENCE_STEP;
+    const bool bIsAtTheEnd = hitTime > ray.maxDistance / BLOCK_LENGTH - 2.0 * REFERENCE_STEP;
+    if (!sampleTime.has_value())
+        return bIsClipped || bIsAtTheEnd;
+
+    return sampleTime.value() <= hitTime + 2.0 * REFERENCE_STEP || bIsClipped;
+}
+
+static Vec4f32 MakeRandomDirection(std::mt19937& random) noexcept {
+    std::normal_distribution<float> directions(0.f, 1.f);
+    return Vec4f32{ directions(random), directions(random), directions(random), 0.f };
+}
+
+static BlockRaycastChunkLookup MakeLookup(const ChunkCoordMap<const Chunk*>& chunks) noexcept {
+    return [&chunks](const ChunkCoord& location) -> const Chunk* {
+        const auto it = chunks.find(location);
+        return it != chunks.end() ? it->second : nullptr;
+    };
+}
+
+// A few chunks on both sides of 0: floating blocks and pillars of every type, water to see through, an empty chunk,
+// and blocks on the bottom and top layers of the world. The chunks next to them are left out, their lookups give nullptr
+static std::vector<std::unique_ptr<Chunk>> MakeHandBuiltChunks(std::mt19937& random) noexcept {
+    std::vector<std::unique_ptr<Chunk>> pChunks;
+
+    for (int idx = -2; idx < 2; ++idx) {
+        for (int idz = -2; idz < 2; ++idz) {
+            pChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }));
+            Chunk& chunk = *pChunks.back();
+
+            if (idx == -1 && idz == 0)
+                continue;
+
+            for (int i = 0; i < 400; ++i)
+                chunk.SetBlock(random() % CHUNK_X_BLOCK_COUNT, random() % CHUNK_Y_BLOCK_COUNT, random() % CHUNK_Z_BLOCK_COUNT,
+                               static_cast<BLOCK_TYPE>(random() % static_cast<size_t>(BLOCK_TYPE::_COUNT)));
+
+            for (int i = 0; i < 12; ++i) {
+                const size_t idyBegin = random() % CHUNK_Y_BLOCK_COUNT;
+                chunk.FillColumn(random() % CHUNK_X_BLOCK_COUNT, random() % CHUNK_Z_BLOCK_COUNT, idyBegin, std::min<size_t>(idyBegin + random() % 32u, CHUNK_Y_BLOCK_COUNT),
+                                 static_cast<BLOCK_TYPE>(random() % static_cast<size_t>(BLOCK_TYPE::_COUNT)));
+            }
+
+            chunk.SetBlock(random() % CHUNK_X_BLOCK_COUNT, 0u,                      random() % CHUNK_Z_BLOCK_COUNT, BLOCK_TYPE::BLOCK_TYPE_STONE);
+            chunk.SetBlock(random() % CHUNK_X_BLOCK_COUNT, CHUNK_Y_BLOCK_COUNT - 1u, random() % CHUNK_Z_BLOCK_COUNT, BLOCK_TYPE::BLOCK_TYPE_STONE);
+        }
+    }
+
+    pChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ 3, -3 }));
+    for (size_t idx = 0u; idx < CHUNK_X_BLOCK_COUNT; ++idx)
+        for (size_t idz = 0u; idz < CHUNK_Z_BLOCK_COUNT; ++idz)
+            pChunks.back()->FillColumn(idx, idz, 40u, 80u, BLOCK_TYPE::BLOCK_TYPE_WATER);
+    pChunks.back()->SetBlock(5u, 60u, 7u, BLOCK_TYPE::BLOCK_TYPE_LAMP);
+
+    return pChunks;
+}
+
+// From the air over the generated chunks, and from past their border, in every direction
+static void TestGeneratedChunks() noexcept {
+    const TestWorld world(RANDOM_SEED, 4, 20000u);
+
+    ChunkCoordMap<const Chunk*> chunks;
+    for (int idx = 0; idx < world.GetSideChunkCount(); ++idx)
+        for (int idz = 0; idz < world.GetSideChunkCount(); ++idz)
+            chunks[ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }] = &world.GetChunk(idx, idz);
+
+    const BlockRaycastChunkLookup getChunk = MakeLookup(chunks);
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> xzs(-CHUNK_X_LENGTH, 5.f * CHUNK_X_LENGTH);
+    std::uniform_real_distribution<float> ys(SEA_LEVEL * BLOCK_LENGTH, CHUNK_Y_LENGTH);
+
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        const TestRay ray = { Vec4f32{ xzs(random), ys(random), xzs(random), 0.f }, MakeRandomDirection(random), 100.f * BLOCK_LENGTH };
+
+        if (!CHECK(RaycastMatchesReference(getChunk, ray)))
+            return;
+    }
+}
+
+// The hand-built chunks around negative coordinates, from inside blocks too
+static void TestHandBuiltChunks() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    const std::vector<std::unique_ptr<Chunk>> pChunks = MakeHandBuiltChunks(random);
+
+    ChunkCoordMap<const Chunk*> chunks;
+    for (const std::unique_ptr<Chunk>& pChunk : pChunks)
+        chunks[pChunk->GetLocation()] = pChunk.get();
+
+    const BlockRaycastChunkLookup getChunk = MakeLookup(chunks);
+
+    std::uniform_real_distribution<float> xzs(-3.f * CHUNK_X_LENGTH, 3.f * CHUNK_X_LENGTH);
+    std::uniform_real_distribution<float> ys(-8.f * BLOCK_LENGTH, CHUNK_Y_LENGTH + 8.f * BLOCK_LENGTH);
+
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        const TestRay ray = { Vec4f32{ xzs(random), ys(random), xzs(random), 0.f }, MakeRandomDirection(random), 150.f * BLOCK_LENGTH };
+
+        if (!CHECK(RaycastMatchesReference(getChunk, ray)))
+            return;
+    }
+
+    // through the water, onto the lamp in it
+    const TestRay waterRay = { Vec4f32{ 3.f * CHUNK_X_LENGTH + 5.5f, 90.f, -3.f * CHUNK_Z_LENGTH + 7.5f, 0.f }, Vec4f32{ 0.f, -1.f, 0.f, 0.f }, 100.f };
+    const std::optional<BlockRaycastHit> hit = RaycastBlocks(getChunk, waterRay.origin, waterRay.direction, waterRay.maxDistance);
+    CHECK(hit.has_value() && hit->type == BLOCK_TYPE::BLOCK_TYPE_LAMP && hit->face == BLOCK_FACE::BLOCK_FACE_TOP && hit->distance == 29.f * BLOCK_LENGTH);
+    CHECK(RaycastMatchesReference(getChunk, waterRay));
+}
+
+// Along each axis, and along diagonals that cross several planes at once (the lowest axis is stepped first), from origins
+// on block and chunk planes, with the other coordinates on planes or not
+static void TestStraightRaysFromPlanes() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    const std::vector<std::unique_ptr<Chunk>> pChunks = MakeHandBuiltChunks(random);
+
+    ChunkCoordMap<const Chunk*> chunks;
+    for (const std::unique_ptr<Chunk>& pChunk : pChunks)
+        chunks[pChunk->GetLocation()] = pChunk.get();
+
+    const BlockRaycastChunkLookup getChunk = MakeLookup(chunks);
+
+    std::uniform_int_distribution<int> xzs(-3 * CHUNK_X_BLOCK_COUNT, 3 * CHUNK_X_BLOCK_COUNT);
+    std::uniform_int_distribution<int> ys(-4, CHUNK_Y_BLOCK_COUNT + 4);
+    std::uniform_real_distribution<float> fractions(0.f, 1.f);
+
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        std::array<float, 3u> origin = { static_cast<float>(xzs(random)), static_cast<float>(ys(random)), static_cast<float>(xzs(random)) };
+
+        // on a chunk's corner, on block planes only, or on some of them
+        const int onPlanes = static_cast<int>(random() % 3u);
+        if (onPlanes == 0) {
+            origin[0] = std::round(origin[0] / CHUNK_X_BLOCK_COUNT) * CHUNK_X_BLOCK_COUNT;
+            origin[2] = std::round(origin[2] / CHUNK_Z_BLOCK_COUNT) * CHUNK_Z_BLOCK_COUNT;
+        } else if (onPlanes == 2) {
+            for (float& component : origin)
+                if (random() % 2u == 0u)
+                    component += fractions(random);
+        }
+
+        std::array<float, 3u> direction = { 0.f, 0.f, 0.f };
+        if (random() % 2u == 0u) {
+            direction[random() % 3u] = (random() % 2u == 0u) ? 1.f : -1.f;
+        } else {
+            while (std::count(direction.begin(), direction.end(), 0.f) > 1)
+                for (float& component : direction)
+                    component = static_cast<float>(static_cast<int>(random() % 3u) - 1);
+        }
+
+        const float scale = 0.25f + fractions(random) * 4.f; // the direction doesn't have to be normalized
+
+        const TestRay ray = { Vec4f32{ origin[0] * BLOCK_LENGTH, origin[1] * BLOCK_LENGTH, origin[2] * BLOCK_LENGTH, 0.f },
+                              Vec4f32{ direction[0] * scale, direction[1] * scale, direction[2] * scale, 0.f }, 120.f * BLOCK_LENGTH };
+
+        if (!CHECK(RaycastMatchesReference(getChunk, ray)))
+            return;
+    }
+
+    // the distance of a hit straight ahead is a whole number of blocks, from the origin on the plane it starts on
+    const TestRay downRay = { Vec4f32{ 0.5f, 10.f, 0.5f, 0.f }, Vec4f32{ 0.f, -1.f, 0.f, 0.f }, 20.f };
+    const std::optional<BlockRaycastHit> downHit = RaycastBlocks(getChunk, downRay.origin, downRay.direction, downRay.maxDistance);
+    const std::optional<double> sampleTime = FindFirstOpaqueSample(getChunk, downRay);
+    CHECK(downHit.has_value() == sampleTime.has_value());
+    if (downHit.has_value())
+        CHECK(downHit->distance == std::floor(downHit->distance) && downHit->face == BLOCK_FACE::BLOCK_FACE_TOP);
+}
+
+// Rays that go up out of the top of the world, or down out of its bottom, hit nothing there, whatever their length.
+// The ones that come back in from above or below hit the top or bottom layer
+static void TestRaysLeavingTheWorld() noexcept {
+    Chunk chunk(ChunkCoord{ -1, -1 });
+    for (size_t idx = 0u; idx < CHUNK_X_BLOCK_COUNT; ++idx) {
+        for (size_t idz = 0u; idz < CHUNK_Z_BLOCK_COUNT; ++idz) {
+            chunk.SetBlock(idx, 0u,                      idz, BLOCK_TYPE::BLOCK_TYPE_STONE);
+            chunk.SetBlock(idx, CHUNK_Y_BLOCK_COUNT - 1u, idz, BLOCK_TYPE::BLOCK_TYPE_DIRT);
+        }
+    }
+
+    const BlockRaycastChunkLookup getChunk = [&chunk](const ChunkCoord& location) { return location == chunk.GetLocation() ? &chunk : nullptr; };
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> xzs(-CHUNK_X_LENGTH, 0.f);
+    std::uniform_real_distribution<float> slopes(-0.5f, 0.5f);
+
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        const bool bUp = random() % 2u == 0u;
+
+        const Vec4f32 origin    = { xzs(random), bUp ? CHUNK_Y_LENGTH + 2.f * BLOCK_LENGTH : -2.f * BLOCK_LENGTH, xzs(random), 0.f };
+        const Vec4f32 direction = { slopes(random), bUp ? 1.f : -1.f, slopes(random), 0.f };
+
+        const TestRay leavingRay = { origin, direction, 1e6f };
+        if (!CHECK(!RaycastBlocks(getChunk, leavingRay.origin, leavingRay.direction, leavingRay.maxDistance, BLOCK_RAYCAST_MODE::BLOCK_RAYCAST_MODE_NAIVE).has_value()
+                   && !RaycastBlocks(getChunk, leavingRay.origin, leavingRay.direction, leavingRay.maxDistance).has_value()))
+            return;
+
+        const TestRay enteringRay = { origin, Vec4f32{ direction.x, -direction.y, direction.z, 0.f }, 10.f * BLOCK_LENGTH };
+        if (!CHECK(RaycastMatchesReference(getChunk, enteringRay)))
+            return;
+    }
+}
+
+// Chunks whose lookup gives nullptr are seen through, even when they have blocks
+static void TestMissingChunks() noexcept {
+    const TestWorld world(RANDOM_SEED, 3, 0u);
+
+    // every other chunk can't be read
+    const BlockRaycastChunkLookup getChunk = [&world](const ChunkCoord& location) -> const Chunk* {
+        if (location.idx < 0 || location.idz < 0 || location.idx >= world.GetSideChunkCount() || location.idz >= world.GetSideChunkCount()
+            || (location.idx + location.idz) % 2 != 0)
+            return nullptr;
+
+        return &world.GetChunk(location.idx, location.idz);
+    };
+
+    const BlockRaycastChunkLookup getNoChunk = [](const ChunkCoord&) -> const Chunk* { return nullptr; };
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> xzs(0.f, 3.f * CHUNK_X_LENGTH);
+    std::uniform_real_distribution<float> ys(0.f, CHUNK_Y_LENGTH);
+
+    for (int i = 0; i < RAY_COUNT; ++i) {
+        const TestRay ray = { Vec4f32{ xzs(random), ys(random), xzs(random), 0.f }, MakeRandomDirection(random), 80.f * BLOCK_LENGTH };
+
+        if (!CHECK(RaycastMatchesReference(getChunk, ray) && !RaycastBlocks(getNoChunk, ray.origin, ray.direction, ray.maxDistance).has_value()))
+            return;
+    }
+}
+
+int main() {
+    return RunTests({
+        { "random rays over generated chunks",          TestGeneratedChunks            },
+        { "random rays over hand-built chunks",         TestHandBuiltChunks            },
+        { "axis-parallel and diagonal rays",            TestStraightRaysFromPlanes     },
+        { "rays leaving above or below the world",      TestRaysLeavingTheWorld        },
+        { "chunks that can't be read are seen through", TestMissingChunks              }
+    });
+}
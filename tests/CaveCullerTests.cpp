@@ -0,0 +1,179 @@
+#include "Test.hpp"
+#include "Camera.hpp"
+#include "CaveCuller.hpp"
+
+// Chunks are stone up to SURFACE_HEIGHT and air above it
+constexpr int WORLD_CHUNK_RADIUS = 3;
+constexpr int SURFACE_HEIGHT     = 8 * CHUNK_SECTION_Y_BLOCK_COUNT;
+
+// The camera is in the middle of the section CAMERA_SECTION_INDEX of chunk (0, 0), in a room carved out of the stone
+constexpr size_t CAMERA_SECTION_INDEX = 2u;
+constexpr size_t ROOM_BEGIN           = 4u; // along the 3 axes, relative to the camera's section
+constexpr size_t ROOM_END             = 12u;
+
+// A flat world of hand-built chunks, whose section connectivity is computed as for a mesh upload
+class CaveWorld {
+private:
+    ChunkCoordMap<std::unique_ptr<Chunk>> m_pChunks;
+
+public:
+    CaveWorld() noexcept {
+        for (std::int16_t idx = -WORLD_CHUNK_RADIUS; idx <= WORLD_CHUNK_RADIUS; ++idx) {
+            for (std::int16_t idz = -WORLD_CHUNK_RADIUS; idz <= WORLD_CHUNK_RADIUS; ++idz) {
+                std::unique_ptr<Chunk> pChunk = std::make_unique<Chunk>(ChunkCoord{ idx, idz });
+
+                for (size_t x = 0u; x < CHUNK_X_BLOCK_COUNT; ++x)
+                    for (size_t z = 0u; z < CHUNK_Z_BLOCK_COUNT; ++z)
+                        pChunk->FillColumn(x, z, 0u, SURFACE_HEIGHT, BLOCK_TYPE::BLOCK_TYPE_STONE);
+
+                this->m_pChunks[ChunkCoord{ idx, idz }] = std::move(pChunk);
+            }
+        }
+
+        const size_t roomY = CAMERA_SECTION_INDEX * CHUNK_SECTION_Y_BLOCK_COUNT;
+        for (size_t x = ROOM_BEGIN; x < ROOM_END; ++x)
+            for (size_t z = ROOM_BEGIN; z < ROOM_END; ++z)
+                this->GetChunk(ChunkCoord{ 0, 0 }).FillColumn(x, z, roomY + ROOM_BEGIN, roomY + ROOM_END, BLOCK_TYPE::BLOCK_TYPE_AIR);
+    }
+
+    inline Chunk& GetChunk(const ChunkCoord& cc) noexcept { return *this->m_pChunks.at(cc); }
+
+    // From the room's ceiling up to the surface
+    void DigShaft() noexcept {
+        const size_t roomY = CAMERA_SECTION_INDEX * CHUNK_SECTION_Y_BLOCK_COUNT;
+        for (size_t x = 7u; x < 9u; ++x)
+            for (size_t z = 7u; z < 9u; ++z)
+                this->GetChunk(ChunkCoord{ 0, 0 }).FillColumn(x, z, roomY + ROOM_END, SURFACE_HEIGHT, BLOCK_TYPE::BLOCK_TYPE_AIR);
+    }
+
+    // As the mesh jobs hand it over, the chunks outside of the world aren't rendered
+    CaveCuller::SectionConnectivityLookup GetSectionConnectivityLookup() noexcept {
+        auto pConnectivities = std::make_shared<ChunkCoordMap<ChunkSectionConnectivity>>();
+        for (auto& [cc, pChunk] : this->m_pChunks)
+            (*pConnectivities)[cc] = pChunk->UpdateSectionConnectivity();
+
+        return [pConnectivities](const ChunkCoord& cc) -> const ChunkSectionConnectivity* {
+            const auto it = pConnectivities->find(cc);
+            return it != pConnectivities->end() ? &it->second : nullptr;
+        };
+    }
+}; // class CaveWorld
+
+static Vec4f32 GetCameraPosition() noexcept {
+    return Vec4f32{ 8.f * BLOCK_LENGTH, (CAMERA_SECTION_INDEX * CHUNK_SECTION_Y_BLOCK_COUNT + 8.f) * BLOCK_LENGTH, 8.f * BLOCK_LENGTH, 1.f };
+}
+
+// Looking around level with the room, then up toward the surface
+static std::vector<CameraFrustum> MakeFrusta() noexcept {
+    std::vector<CameraFrustum> frusta;
+
+    for (const float pitch : { 0.f, -1.2f }) {
+        for (int heading = 0; heading < 8; ++heading) {
+            Camera camera(GetCameraPosition(), static_cast<float>(M_PI_2), 9.f / 16.f, 0.1f, 1000.f);
+            camera.SetRotation(Vec4f32{ pitch, static_cast<float>(heading) * static_cast<float>(M_PI) / 4.f, 0.f, 0.f });
+            camera.Update();
+
+            frusta.push_back(camera.GetFrustum());
+        }
+    }
+
+    return frusta;
+}
+
+static bool IsSectionInFrustum(const CameraFrustum& frustum, const ChunkCoord& cc, const size_t sectionIndex) noexcept {
+    const Vec4f32 sectionMin = {
+        static_cast<float>(cc.idx) * CHUNK_X_LENGTH, static_cast<float>(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT) * BLOCK_LENGTH, static_cast<float>(cc.idz) * CHUNK_Z_LENGTH
+    };
+
+    return frustum.ClassifyBox(sectionMin, sectionMin + Vec4f32{ CHUNK_X_LENGTH, CHUNK_SECTION_Y_BLOCK_COUNT * BLOCK_LENGTH, CHUNK_Z_LENGTH })
+        != FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE;
+}
+
+// The camera sees through every face of its own section (see CaveCuller::Update), so the sections next to it are visible whatever they hold
+static std::uint16_t GetCameraAdjacentSectionMask(const ChunkCoord& cc) noexcept {
+    if (cc == ChunkCoord{ 0, 0 })
+        return static_cast<std::uint16_t>(0b111u << (CAMERA_SECTION_INDEX - 1u));
+
+    return std::abs(cc.idx) + std::abs(cc.idz) == 1 ? static_cast<std::uint16_t>(1u << CAMERA_SECTION_INDEX) : 0u;
+}
+
+// From a room sealed in stone, nothing past the sections next to the camera's is visible, whichever way the camera looks
+static void TestSealedCaveIsCulled() noexcept {
+    CaveWorld world;
+    const CaveCuller::SectionConnectivityLookup getSectionConnectivity = world.GetSectionConnectivityLookup();
+
+    size_t nCulledSectionsInFrustum = 0u;
+
+    CaveCuller caveCuller;
+    for (const CameraFrustum& frustum : MakeFrusta()) {
+        caveCuller.Update(GetCameraPosition(), frustum, getSectionConnectivity);
+
+        CHECK(caveCuller.IsEnabled());
+        CHECK(caveCuller.GetVisibleSectionMask(ChunkCoord{ 0, 0 }) & (1u << CAMERA_SECTION_INDEX));
+
+        for (std::int16_t idx = -WORLD_CHUNK_RADIUS; idx <= WORLD_CHUNK_RADIUS; ++idx) {
+            for (std::int16_t idz = -WORLD_CHUNK_RADIUS; idz <= WORLD_CHUNK_RADIUS; ++idz) {
+                const ChunkCoord cc = { idx, idz };
+                CHECK((caveCuller.GetVisibleSectionMask(cc) & ~GetCameraAdjacentSectionMask(cc)) == 0u);
+
+                for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+                    if (!(GetCameraAdjacentSectionMask(cc) & (1u << sectionIndex)) && IsSectionInFrustum(frustum, cc, sectionIndex))
+                        ++nCulledSectionsInFrustum;
+            }
+        }
+    }
+
+    // the frustum alone would have kept them
+    CHECK(nCulledSectionsInFrustum > 0u);
+}
+
+// With a shaft from the room to the surface, the sky above the surrounding chunks is seen through it when looking up.
+// The stone around the room and the shaft still hides the sections below the surface
+static void TestOpenShaftIsNotCulled() noexcept {
+    CaveWorld world;
+    world.DigShaft();
+    const CaveCuller::SectionConnectivityLookup getSectionConnectivity = world.GetSectionConnectivityLookup();
+
+    constexpr std::uint16_t UNDERGROUND_SECTIONS = static_cast<std::uint16_t>((1u << (SURFACE_HEIGHT / CHUNK_SECTION_Y_BLOCK_COUNT)) - 1u);
+    constexpr size_t        SKY_SECTION_INDEX    = SURFACE_HEIGHT / CHUNK_SECTION_Y_BLOCK_COUNT;
+
+    size_t nVisibleSkyChunks = 0u;
+
+    CaveCuller caveCuller;
+    for (const CameraFrustum& frustum : MakeFrusta()) {
+        caveCuller.Update(GetCameraPosition(), frustum, getSectionConnectivity);
+
+        // the shaft, from the camera's section to the surface, whenever it is in view
+        const std::uint16_t cameraChunkMask = caveCuller.GetVisibleSectionMask(ChunkCoord{ 0, 0 });
+        CHECK((cameraChunkMask & ((1u << CAMERA_SECTION_INDEX) - 1u)) == 0u);
+
+        for (size_t sectionIndex = CAMERA_SECTION_INDEX; sectionIndex <= SKY_SECTION_INDEX; ++sectionIndex) {
+            if (!IsSectionInFrustum(frustum, ChunkCoord{ 0, 0 }, sectionIndex))
+                break;
+
+            CHECK(cameraChunkMask & (1u << sectionIndex));
+        }
+
+        for (std::int16_t idx = -WORLD_CHUNK_RADIUS; idx <= WORLD_CHUNK_RADIUS; ++idx) {
+            for (std::int16_t idz = -WORLD_CHUNK_RADIUS; idz <= WORLD_CHUNK_RADIUS; ++idz) {
+                const ChunkCoord cc = { idx, idz };
+                if (cc == ChunkCoord{ 0, 0 })
+                    continue;
+
+                CHECK((caveCuller.GetVisibleSectionMask(cc) & UNDERGROUND_SECTIONS & ~GetCameraAdjacentSectionMask(cc)) == 0u);
+
+                if (caveCuller.GetVisibleSectionMask(cc) & (1u << SKY_SECTION_INDEX))
+                    ++nVisibleSkyChunks;
+            }
+        }
+    }
+
+    CHECK(nVisibleSkyChunks > 0u);
+}
+
+int main() {
+    return RunTests({
+        { "sealed cave is culled",    TestSealedCaveIsCulled   },
+        { "open shaft is not culled", TestOpenShaftIsNotCulled }
+    });
+}
@@ -0,0 +1,115 @@
+#include "Test.hpp"
+#include "Camera.hpp"
+#include "ChunkCuller.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+constexpr int FRUSTUM_COUNT = 200;
+
+// Cameras all around the origin, looking in every direction, from below the ground to above the highest blocks
+static std::vector<CameraFrustum> MakeFrusta() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> unit(-1.f, 1.f);
+
+    std::vector<CameraFrustum> frusta;
+    for (int i = 0; i < FRUSTUM_COUNT; ++i) {
+        const Vec4f32 position = { unit(random) * 200.f * BLOCK_LENGTH, (128.f + unit(random) * 160.f) * BLOCK_LENGTH, unit(random) * 200.f * BLOCK_LENGTH, 1.f };
+
+        Camera camera(position, static_cast<float>(M_PI_2), 9.f / 16.f, 0.1f, 1000.f);
+        camera.SetRotation(Vec4f32{ unit(random) * 1.5f, unit(random) * static_cast<float>(M_PI), 0.f, 0.f });
+        camera.Update();
+
+        frusta.push_back(camera.GetFrustum());
+    }
+
+    return frusta;
+}
+
+static Vec4f32 GetColumnMin(const ChunkColumnBounds& column) noexcept {
+    return Vec4f32{ static_cast<float>(column.location.idx) * CHUNK_X_LENGTH, column.minY, static_cast<float>(column.location.idz) * CHUNK_Z_LENGTH };
+}
+
+static Vec4f32 GetColumnMax(const ChunkColumnBounds& column) noexcept {
+    return GetColumnMin(column) + Vec4f32{ CHUNK_X_LENGTH, column.maxY - column.minY, CHUNK_Z_LENGTH };
+}
+
+// CullBoxes reports, in order and once each, the boxes of the range that CameraFrustum::ClassifyBox doesn't find outside,
+// whatever the range's alignment to the SIMD width
+static void TestCullBoxesMatchesClassifyBox() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> coordinates(-300.f * BLOCK_LENGTH, 300.f * BLOCK_LENGTH);
+    std::uniform_real_distribution<float> sizes(0.f, 64.f * BLOCK_LENGTH);
+
+    BoxesSoA boxes;
+    std::vector<Vec4f32> boxMins, boxMaxs;
+    for (int i = 0; i < 1027; ++i) {
+        boxMins.push_back(Vec4f32{ coordinates(random), coordinates(random) * 0.5f, coordinates(random) });
+        boxMaxs.push_back(boxMins.back() + Vec4f32{ sizes(random), sizes(random), sizes(random) });
+        boxes.PushBack(boxMins.back(), boxMaxs.back());
+    }
+
+    std::vector<std::uint32_t> visibleIndices;
+    for (const CameraFrustum& frustum : MakeFrusta()) {
+        for (const std::array<size_t, 2> range : { std::array<size_t, 2>{ 0u, boxes.GetSize() }, std::array<size_t, 2>{ 3u, boxes.GetSize() - 5u }, std::array<size_t, 2>{ 9u, 14u } }) {
+            std::vector<std::uint32_t> expectedIndices;
+            for (size_t i = range[0]; i < range[1]; ++i)
+                if (frustum.ClassifyBox(boxMins[i], boxMaxs[i]) != FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE)
+                    expectedIndices.push_back(static_cast<std::uint32_t>(i));
+
+            visibleIndices.clear();
+            CullBoxes(frustum, boxes, range[0], range[1], visibleIndices);
+
+            if (!CHECK(visibleIndices == expectedIndices))
+                return;
+        }
+    }
+}
+
+// The quadtree finds the same columns as testing every one of them with CameraFrustum::ClassifyBox, each once.
+// Windows of several sizes, on both sides of 0, with holes and columns of various heights
+static void TestQuadTreeMatchesClassifyBox() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    const std::vector<CameraFrustum> frusta = MakeFrusta();
+
+    for (const int renderDistance : { 1, 10, 32 }) {
+        std::vector<ChunkColumnBounds> columns;
+        for (int idx = -renderDistance - 3; idx <= renderDistance; ++idx) {
+            for (int idz = -renderDistance; idz <= renderDistance + 5; ++idz) {
+                // not generated yet
+                if (random() % 8u == 0u)
+                    continue;
+
+                const float minY = static_cast<float>(random() % 64u) * BLOCK_LENGTH;
+                const float maxY = minY + static_cast<float>(1u + random() % 192u) * BLOCK_LENGTH;
+                columns.push_back(ChunkColumnBounds{ ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }, minY, maxY,
+                                                     static_cast<std::uint32_t>(columns.size()) * 3u + 1u });
+            }
+        }
+
+        ChunkColumnQuadTree tree;
+        tree.Build(columns);
+        CHECK(tree.GetColumnCount() == columns.size());
+
+        std::vector<std::uint32_t> visibleIndices;
+        for (const CameraFrustum& frustum : frusta) {
+            std::vector<std::uint32_t> expectedIndices;
+            for (const ChunkColumnBounds& column : columns)
+                if (frustum.ClassifyBox(GetColumnMin(column), GetColumnMax(column)) != FRUSTUM_INTERSECTION::FRUSTUM_INTERSECTION_OUTSIDE)
+                    expectedIndices.push_back(column.index);
+
+            visibleIndices.clear();
+            tree.Cull(frustum, visibleIndices);
+            std::sort(visibleIndices.begin(), visibleIndices.end());
+
+            if (!CHECK(visibleIndices == expectedIndices))
+                return;
+        }
+    }
+}
+
+int main() {
+    return RunTests({
+        { "CullBoxes matches ClassifyBox",     TestCullBoxesMatchesClassifyBox },
+        { "quadtree cull matches ClassifyBox", TestQuadTreeMatchesClassifyBox  }
+    });
+}
@@ -0,0 +1,214 @@
+#include "Test.hpp"
+#include "Chunk.hpp"
+#include "ChunkGrid.hpp"
+#include "ChunkStorage.hpp"
+#include "ChunkMemoryBudget.hpp"
+#include "JobSystem.hpp"
+#include "LightEngine.hpp"
+#include "WorldGenerator.hpp"
+
+constexpr std::uint32_t WORLD_SEED = 1234u;
+
+// Chunks this close to the camera's chunk are in use, as the render window is in UpdateWorld
+constexpr int VISIT_RADIUS = 2;
+
+constexpr int FLIGHT_LENGTH = 48; // in chunks, there and back
+
+static size_t ComputeMemoryUsage(const ChunkGrid& chunkGrid) noexcept {
+    size_t memoryUsage = 0u;
+    chunkGrid.ForEach([&memoryUsage](const Chunk* pChunk) { memoryUsage += sizeof(Chunk) + pChunk->GetBlockMemoryUsage(); });
+
+    return memoryUsage;
+}
+
+// The camera flies one chunk per frame along x and back. Every chunk gets edited the first time it is visited,
+// so that the ones the budget removes are dirty. The budget has room for a few windows only: the memory in use
+// never goes over it, and every chunk comes back on the way back with the blocks it was edited to
+static void TestFlightStaysUnderBudget() noexcept {
+    constexpr size_t BUDGET = 3u * 1024u * 1024u / 2u;
+
+    const TemporaryDirectory directory("ChunkMemoryBudgetTests");
+    ChunkStorage storage(directory.GetPath());
+    WorldGenerator worldGenerator(WORLD_SEED);
+    ChunkGrid chunkGrid;
+    ChunkMemoryBudget memoryBudget(BUDGET);
+
+    ChunkCoordMap<std::vector<std::uint8_t>> editedBlocks;
+    std::mt19937 random(WORLD_SEED);
+
+    size_t nReloadedChunks     = 0u;
+    size_t nDecompressedChunks = 0u;
+
+    for (int frameIndex = 0; frameIndex <= 2 * FLIGHT_LENGTH; ++frameIndex) {
+        const ChunkCoord cameraChunk = { static_cast<std::int16_t>(FLIGHT_LENGTH - std::abs(FLIGHT_LENGTH - frameIndex)), 0 };
+        chunkGrid.SetGridOrigin(ChunkCoord{ static_cast<std::int16_t>(cameraChunk.idx - RENDER_DISTANCE - 1), static_cast<std::int16_t>(cameraChunk.idz - RENDER_DISTANCE - 1) });
+
+        for (int dx = -VISIT_RADIUS; dx <= VISIT_RADIUS; ++dx) {
+            for (int dz = -VISIT_RADIUS; dz <= VISIT_RADIUS; ++dz) {
+                const ChunkCoord cc = { static_cast<std::int16_t>(cameraChunk.idx + dx), static_cast<std::int16_t>(cameraChunk.idz + dz) };
+
+                Chunk* pChunk = chunkGrid.Find(cc);
+                if (pChunk && pChunk->IsCompressed()) {
+                    pChunk->Decompress();
+                    ++nDecompressedChunks;
+                } else if (!pChunk) {
+                    pChunk = chunkGrid.Insert(std::make_unique<Chunk>(cc));
+
+                    if (storage.LoadChunk(*pChunk)) {
+                        ++nReloadedChunks;
+                    } else {
+                        CHECK(editedBlocks.find(cc) == editedBlocks.end());
+                        worldGenerator.GenerateChunk(*pChunk);
+                    }
+                }
+
+                pChunk->MarkUsed(static_cast<std::uint64_t>(frameIndex));
+
+                const auto editedBlocksIt = editedBlocks.find(cc);
+                if (editedBlocksIt != editedBlocks.end()) {
+                    CHECK(pChunk->Serialize() == editedBlocksIt->second);
+                    continue;
+                }
+
+                for (int i = 0; i < 200; ++i)
+                    pChunk->SetBlock(random() % CHUNK_X_BLOCK_COUNT, random() % CHUNK_Y_BLOCK_COUNT, random() % CHUNK_Z_BLOCK_COUNT,
+                                     static_cast<BLOCK_TYPE>(random() % static_cast<size_t>(BLOCK_TYPE::_COUNT)));
+
+                CHECK(pChunk->IsDirty());
+                editedBlocks[cc] = pChunk->Serialize();
+            }
+        }
+
+        memoryBudget.Enforce(chunkGrid, storage, [](const Chunk&) { return false; }, [&cameraChunk](const Chunk& chunk) {
+            return std::abs(chunk.GetLocation().idx - cameraChunk.idx) > VISIT_RADIUS || std::abs(chunk.GetLocation().idz - cameraChunk.idz) > VISIT_RADIUS;
+        });
+
+        const ChunkMemoryStats& stats = memoryBudget.GetStats();
+        CHECK(stats.memoryUsage <= BUDGET);
+        CHECK(stats.memoryUsage == ComputeMemoryUsage(chunkGrid));
+        CHECK(stats.nResidentChunks + stats.nCompressedChunks == chunkGrid.GetSize());
+        CHECK(stats.nPendingChunks == 0u);
+    }
+
+    // the budget did remove dirty chunks, and the way back reloaded them
+    CHECK(memoryBudget.GetStats().nEvictedChunks > 0u);
+    CHECK(nReloadedChunks > 0u);
+    CHECK(nDecompressedChunks > 0u);
+}
+
+// The same flight, with the chunks generated and lit by jobs as Minecraft::SubmitChunkJob does. The budget is enforced
+// every frame while jobs are still writing chunks: those are neither handed to "isEvictable" nor touched, and are found
+// generated and uncompressed once their job is done. Run under a thread sanitizer, reading them would be reported
+static void TestEnforceDuringGenerateJobs() noexcept {
+    constexpr size_t BUDGET = 3u * 1024u * 1024u / 2u;
+
+    const TemporaryDirectory directory("ChunkMemoryBudgetJobTests");
+    ChunkStorage storage(directory.GetPath());
+    WorldGenerator worldGenerator(WORLD_SEED);
+    ChunkGrid chunkGrid;
+    ChunkMemoryBudget memoryBudget(BUDGET);
+    JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 4u));
+
+    // as m_bHasPendingJob, only read and written on this thread. The jobs raise their flag when they are done
+    struct PendingJob {
+        std::shared_ptr<std::atomic<bool>> pbIsDone;
+        int                                frameIndex; // submitted in
+    }; // struct PendingJob
+    ChunkCoordMap<PendingJob> pendingJobs;
+    const auto HasPendingJob = [&pendingJobs](const Chunk& chunk) { return pendingJobs.find(chunk.GetLocation()) != pendingJobs.end(); };
+
+    size_t nGeneratedChunks         = 0u;
+    size_t nFramesWithPendingChunks = 0u;
+
+    for (int frameIndex = 0; frameIndex <= 2 * FLIGHT_LENGTH; ++frameIndex) {
+        const ChunkCoord cameraChunk = { static_cast<std::int16_t>(FLIGHT_LENGTH - std::abs(FLIGHT_LENGTH - frameIndex)), 0 };
+        chunkGrid.SetGridOrigin(ChunkCoord{ static_cast<std::int16_t>(cameraChunk.idx - RENDER_DISTANCE - 1), static_cast<std::int16_t>(cameraChunk.idz - RENDER_DISTANCE - 1) });
+
+        // as UploadFinishedChunkMeshes: the chunks whose job is done are the main thread's again. The jobs of the last two
+        // frames may still be running, the older ones are waited for as a frame's worth of rendering would have
+        for (auto it = pendingJobs.begin(); it != pendingJobs.end(); ) {
+            while (it->second.frameIndex + 2 <= frameIndex && !it->second.pbIsDone->load())
+                std::this_thread::yield();
+
+            if (!it->second.pbIsDone->load()) {
+                ++it;
+                continue;
+            }
+
+            const Chunk* pChunk = chunkGrid.Find(it->first);
+            CHECK(pChunk && pChunk->IsGenerated() && !pChunk->IsCompressed());
+
+            ++nGeneratedChunks;
+            it = pendingJobs.erase(it);
+        }
+
+        for (int dx = -VISIT_RADIUS; dx <= VISIT_RADIUS; ++dx) {
+            for (int dz = -VISIT_RADIUS; dz <= VISIT_RADIUS; ++dz) {
+                const ChunkCoord cc = { static_cast<std::int16_t>(cameraChunk.idx + dx), static_cast<std::int16_t>(cameraChunk.idz + dz) };
+
+                Chunk* pChunk = chunkGrid.Find(cc);
+                if (pChunk && HasPendingJob(*pChunk))
+                    continue;
+
+                if (pChunk) {
+                    if (pChunk->IsCompressed())
+                        pChunk->Decompress();
+
+                    continue;
+                }
+
+                pChunk = chunkGrid.Insert(std::make_unique<Chunk>(cc));
+
+                const std::shared_ptr<std::atomic<bool>> pbIsDone = std::make_shared<std::atomic<bool>>(false);
+                pendingJobs[cc] = PendingJob{ pbIsDone, frameIndex };
+
+                jobSystem.Submit([&storage, &worldGenerator, pChunk, pbIsDone]() {
+                    if (!storage.LoadChunk(*pChunk))
+                        worldGenerator.GenerateChunk(*pChunk);
+
+                    LightEngine lightEngine;
+                    lightEngine.ComputeChunkLight(*pChunk);
+
+                    pbIsDone->store(true);
+                });
+            }
+        }
+
+        memoryBudget.Enforce(chunkGrid, storage, HasPendingJob, [&](const Chunk& chunk) {
+            CHECK(!HasPendingJob(chunk));
+            return std::abs(chunk.GetLocation().idx - cameraChunk.idx) > VISIT_RADIUS || std::abs(chunk.GetLocation().idz - cameraChunk.idz) > VISIT_RADIUS;
+        });
+
+        const ChunkMemoryStats& stats = memoryBudget.GetStats();
+        CHECK(stats.nPendingChunks == pendingJobs.size());
+        CHECK(stats.nResidentChunks + stats.nCompressedChunks + stats.nPendingChunks == chunkGrid.GetSize());
+
+        for (const auto& [cc, pendingJob] : pendingJobs)
+            CHECK(chunkGrid.Find(cc) != nullptr);
+
+        if (stats.nPendingChunks != 0u)
+            ++nFramesWithPendingChunks;
+    }
+
+    jobSystem.WaitIdle();
+    for (const auto& [cc, pendingJob] : pendingJobs) {
+        const Chunk* pChunk = chunkGrid.Find(cc);
+        CHECK(pendingJob.pbIsDone->load() && pChunk && pChunk->IsGenerated() && !pChunk->IsCompressed());
+    }
+    pendingJobs.clear();
+
+    // with nothing pending, every chunk is counted in full again
+    memoryBudget.Enforce(chunkGrid, storage, HasPendingJob, [](const Chunk&) { return false; });
+    CHECK(memoryBudget.GetStats().memoryUsage == ComputeMemoryUsage(chunkGrid));
+
+    CHECK(nGeneratedChunks > 0u);
+    CHECK(nFramesWithPendingChunks > 0u);
+    CHECK(memoryBudget.GetStats().nEvictedChunks > 0u);
+}
+
+int main() {
+    return RunTests({
+        { "flight stays under the memory budget",          TestFlightStaysUnderBudget    },
+        { "enforced while jobs are generating the chunks", TestEnforceDuringGenerateJobs }
+    });
+}
@@ -0,0 +1,223 @@
+#include "Test.hpp"
+#include "TestWorld.hpp"
+#include "Chunk.hpp"
+
+// texture_atlas.png
+constexpr std::size_t TEXTURE_ATLAS_WIDTH = 256u;
+
+// One block face of the surface a mesh covers: face, the cell's lowest corner, light and atlas tile
+using UnitFace = std::array<int, 6u>;
+
+// Splits every quad of "vertices" into the block faces it covers, sorted so that two meshes covering the same surface give the same list
+static std::vector<UnitFace> GetUnitFaces(const std::vector<Vertex>& vertices) noexcept {
+    std::vector<UnitFace> unitFaces;
+
+    for (size_t i = 0u; i + 4u <= vertices.size(); i += 4u) {
+        std::array<int, 3u> quadMin;
+        std::array<int, 3u> quadMax;
+        quadMin.fill(std::numeric_limits<int>::max());
+        quadMax.fill(std::numeric_limits<int>::min());
+
+        const UnpackedVertex first = UnpackVertex(vertices[i]);
+        for (size_t corner = 0u; corner < 4u; ++corner) {
+            const UnpackedVertex v = UnpackVertex(vertices[i + corner]);
+            const std::array<int, 3u> position = { v.x, v.y, v.z };
+
+            for (size_t axis = 0u; axis < 3u; ++axis) {
+                quadMin[axis] = std::min(quadMin[axis], position[axis]);
+                quadMax[axis] = std::max(quadMax[axis], position[axis]);
+            }
+        }
+
+        // the axis the quad is flat along counts one cell
+        for (size_t axis = 0u; axis < 3u; ++axis)
+            if (quadMax[axis] == quadMin[axis])
+                ++quadMax[axis];
+
+        for (int x = quadMin[0]; x < quadMax[0]; ++x)
+            for (int y = quadMin[1]; y < quadMax[1]; ++y)
+                for (int z = quadMin[2]; z < quadMax[2]; ++z)
+                    unitFaces.push_back(UnitFace{ static_cast<int>(first.face), x, y, z, first.light, first.tile });
+    }
+
+    std::sort(unitFaces.begin(), unitFaces.end());
+    return unitFaces;
+}
+
+// Every field keeps its value through PackVertex and UnpackVertex over its whole range, without spilling into the others
+static void TestVertexPackingRoundTrip() noexcept {
+    const auto AreEqual = [](const UnpackedVertex& a, const UnpackedVertex& b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.face == b.face && a.light == b.light && a.tile == b.tile && a.tilingU == b.tilingU && a.tilingV == b.tilingV;
+    };
+
+    // the largest value of every field, see struct Vertex
+    const UnpackedVertex maxVertex = { 0x1Fu, 0x1FFu, 0x1Fu, BLOCK_FACE::BLOCK_FACE_BOTTOM, static_cast<std::uint8_t>(MAX_LIGHT_LEVEL), 0xFFu, 0x1FFu, 0x1FFu };
+    CHECK(AreEqual(UnpackVertex(PackVertex(maxVertex)), maxVertex));
+    CHECK(AreEqual(UnpackVertex(PackVertex(UnpackedVertex{})), UnpackedVertex{}));
+
+    std::mt19937 random(1234u);
+    for (int i = 0; i < 100000; ++i) {
+        const UnpackedVertex v = {
+            static_cast<std::uint16_t>(random() & 0x1Fu), static_cast<std::uint16_t>(random() & 0x1FFu), static_cast<std::uint16_t>(random() & 0x1Fu),
+            static_cast<BLOCK_FACE>(random() % static_cast<size_t>(BLOCK_FACE::_COUNT)), static_cast<std::uint8_t>(random() % (MAX_LIGHT_LEVEL + 1)),
+            static_cast<std::uint8_t>(random() & 0xFFu), static_cast<std::uint16_t>(random() & 0x1FFu), static_cast<std::uint16_t>(random() & 0x1FFu)
+        };
+
+        if (!CHECK(AreEqual(UnpackVertex(PackVertex(v)), v)))
+            break;
+    }
+}
+
+// The greedy mesher only merges faces, it covers exactly the block faces the naive mesher emits, with the same light and textures
+static void TestGreedyMeshCoversNaiveMesh() noexcept {
+    const TestWorld world(355u, 3, 20000u);
+
+    for (int idx = 0; idx < world.GetSideChunkCount(); ++idx) {
+        for (int idz = 0; idz < world.GetSideChunkCount(); ++idz) {
+            const ChunkNeighbourBlocks neighbours = world.CopyNeighbourBlocks(idx, idz);
+
+            const ChunkMesh naiveMesh  = world.GetChunk(idx, idz).GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_NAIVE,  TEXTURE_ATLAS_WIDTH, neighbours);
+            const ChunkMesh greedyMesh = world.GetChunk(idx, idz).GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, TEXTURE_ATLAS_WIDTH, neighbours);
+
+            for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+                CHECK(GetUnitFaces(greedyMesh.sectionVertices[sectionIndex]) == GetUnitFaces(naiveMesh.sectionVertices[sectionIndex]));
+                CHECK(GetUnitFaces(greedyMesh.sectionTranslucentVertices[sectionIndex]) == GetUnitFaces(naiveMesh.sectionTranslucentVertices[sectionIndex]));
+                CHECK(greedyMesh.sectionVertices[sectionIndex].size() <= naiveMesh.sectionVertices[sectionIndex].size());
+            }
+        }
+    }
+}
+
+static bool AreSameVertices(const std::vector<Vertex>& a, const std::vector<Vertex>& b) noexcept {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Vertex& u, const Vertex& v) { return u.position == v.position && u.texture == v.texture; });
+}
+
+// The bitmask mesher only finds the faces another way, it emits the very vertices of the naive mesher, in the same order.
+// Water, next to water and to the other blocks, checks that translucent faces are hidden by their own type only
+static void TestBitmaskMeshMatchesNaiveMesh() noexcept {
+    const TestWorld world(4242u, 3, 20000u);
+
+    size_t nTranslucentVertices = 0u;
+
+    for (int idx = 0; idx < world.GetSideChunkCount(); ++idx) {
+        for (int idz = 0; idz < world.GetSideChunkCount(); ++idz) {
+            const ChunkNeighbourBlocks neighbours = world.CopyNeighbourBlocks(idx, idz);
+
+            const ChunkMesh naiveMesh   = world.GetChunk(idx, idz).GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_NAIVE,   TEXTURE_ATLAS_WIDTH, neighbours);
+            const ChunkMesh bitmaskMesh = world.GetChunk(idx, idz).GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_BITMASK, TEXTURE_ATLAS_WIDTH, neighbours);
+
+            for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+                CHECK(AreSameVertices(bitmaskMesh.sectionVertices[sectionIndex], naiveMesh.sectionVertices[sectionIndex]));
+                CHECK(AreSameVertices(bitmaskMesh.sectionTranslucentVertices[sectionIndex], naiveMesh.sectionTranslucentVertices[sectionIndex]));
+
+                nTranslucentVertices += naiveMesh.sectionTranslucentVertices[sectionIndex].size();
+            }
+        }
+    }
+
+    CHECK(nTranslucentVertices > 0u);
+}
+
+// The block at (x, y, z) relative to the chunk (idx, idz), air past the world's sides
+static BLOCK_TYPE GetWorldBlock(const TestWorld& world, int idx, int idz, int x, const int y, int z) noexcept {
+    idx += x < 0 ? -1 : (x >= CHUNK_X_BLOCK_COUNT ? 1 : 0);
+    idz += z < 0 ? -1 : (z >= CHUNK_Z_BLOCK_COUNT ? 1 : 0);
+    x = (x + CHUNK_X_BLOCK_COUNT) % CHUNK_X_BLOCK_COUNT;
+    z = (z + CHUNK_Z_BLOCK_COUNT) % CHUNK_Z_BLOCK_COUNT;
+
+    if (idx < 0 || idx >= world.GetSideChunkCount() || idz < 0 || idz >= world.GetSideChunkCount())
+        return BLOCK_TYPE::BLOCK_TYPE_AIR;
+
+    return world.GetChunk(idx, idz).GetBlock(static_cast<size_t>(x), static_cast<size_t>(y), static_cast<size_t>(z)).value();
+}
+
+// The faces of "vertices" on the chunk's four sides, as (face, x, y, z) in GetUnitFaces' coordinates. The back faces use the front face
+// (see NAIVE_BLOCK_FACES), they are the ones at z = CHUNK_Z_BLOCK_COUNT
+static std::vector<UnitFace> GetSideUnitFaces(const std::vector<Vertex>& vertices) noexcept {
+    std::vector<UnitFace> sideUnitFaces;
+
+    for (UnitFace unitFace : GetUnitFaces(vertices)) {
+        const BLOCK_FACE face = static_cast<BLOCK_FACE>(unitFace[0]);
+        const bool bIsOnSide = (face == BLOCK_FACE::BLOCK_FACE_LEFT && unitFace[1] == 0) || (face == BLOCK_FACE::BLOCK_FACE_RIGHT && unitFace[1] == CHUNK_X_BLOCK_COUNT)
+                            || (face == BLOCK_FACE::BLOCK_FACE_FRONT && (unitFace[3] == 0 || unitFace[3] == CHUNK_Z_BLOCK_COUNT));
+        if (!bIsOnSide)
+            continue;
+
+        unitFace[4] = unitFace[5] = 0;
+        sideUnitFaces.push_back(unitFace);
+    }
+
+    return sideUnitFaces;
+}
+
+// Along the chunks' sides, each mesher emits exactly the faces that the neighbouring chunk's blocks leave visible, the sides without
+// a known neighbour being open. Nothing is emitted for the bottom of the world
+static void TestSideFacesMatchNeighbours() noexcept {
+    const TestWorld world(2037u, 3, 20000u);
+
+    for (int idx = 0; idx < world.GetSideChunkCount(); ++idx) {
+        for (int idz = 0; idz < world.GetSideChunkCount(); ++idz) {
+            std::vector<UnitFace> expectedOpaqueFaces, expectedTranslucentFaces;
+
+            // (face, position of the block, position of its neighbour, position of the unit face)
+            const auto AddExpectedFace = [&](const BLOCK_FACE face, const int x, const int y, const int z, const int nx, const int nz, const int fx, const int fz) {
+                const BLOCK_TYPE blockType     = GetWorldBlock(world, idx, idz, x, y, z);
+                const BLOCK_TYPE neighbourType = GetWorldBlock(world, idx, idz, nx, y, nz);
+                if (IsBlockOpaque(neighbourType))
+                    return;
+
+                if (IsBlockOpaque(blockType))
+                    expectedOpaqueFaces.push_back(UnitFace{ static_cast<int>(face), fx, y, fz, 0, 0 });
+                else if (IsBlockTranslucent(blockType) && neighbourType != blockType)
+                    expectedTranslucentFaces.push_back(UnitFace{ static_cast<int>(face), fx, y, fz, 0, 0 });
+            };
+
+            for (int y = 0; y < CHUNK_Y_BLOCK_COUNT; ++y) {
+                for (int i = 0; i < CHUNK_Z_BLOCK_COUNT; ++i) {
+                    AddExpectedFace(BLOCK_FACE::BLOCK_FACE_LEFT,  0,                       y, i, -1,                  i, 0,                   i);
+                    AddExpectedFace(BLOCK_FACE::BLOCK_FACE_RIGHT, CHUNK_X_BLOCK_COUNT - 1, y, i, CHUNK_X_BLOCK_COUNT, i, CHUNK_X_BLOCK_COUNT, i);
+                }
+
+                for (int i = 0; i < CHUNK_X_BLOCK_COUNT; ++i) {
+                    AddExpectedFace(BLOCK_FACE::BLOCK_FACE_FRONT, i, y, 0,                       i, -1,                  i, 0);
+                    AddExpectedFace(BLOCK_FACE::BLOCK_FACE_FRONT, i, y, CHUNK_Z_BLOCK_COUNT - 1, i, CHUNK_Z_BLOCK_COUNT, i, CHUNK_Z_BLOCK_COUNT);
+                }
+            }
+
+            std::sort(expectedOpaqueFaces.begin(), expectedOpaqueFaces.end());
+            std::sort(expectedTranslucentFaces.begin(), expectedTranslucentFaces.end());
+
+            const ChunkNeighbourBlocks neighbours = world.CopyNeighbourBlocks(idx, idz);
+            for (const CHUNK_MESHING_MODE meshingMode : { CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_NAIVE, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_BITMASK }) {
+                const ChunkMesh mesh = world.GetChunk(idx, idz).GenerateMesh(meshingMode, TEXTURE_ATLAS_WIDTH, neighbours);
+
+                std::vector<Vertex> vertices, translucentVertices;
+                for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+                    vertices.insert(vertices.end(), mesh.sectionVertices[sectionIndex].begin(), mesh.sectionVertices[sectionIndex].end());
+                    translucentVertices.insert(translucentVertices.end(), mesh.sectionTranslucentVertices[sectionIndex].begin(), mesh.sectionTranslucentVertices[sectionIndex].end());
+                }
+
+                std::vector<UnitFace> sideFaces = GetSideUnitFaces(vertices);
+                std::vector<UnitFace> translucentSideFaces = GetSideUnitFaces(translucentVertices);
+                std::sort(sideFaces.begin(), sideFaces.end());
+                std::sort(translucentSideFaces.begin(), translucentSideFaces.end());
+
+                CHECK(sideFaces == expectedOpaqueFaces);
+                CHECK(translucentSideFaces == expectedTranslucentFaces);
+
+                for (const std::vector<Vertex>* pVertices : { &vertices, &translucentVertices })
+                    for (const UnitFace& unitFace : GetUnitFaces(*pVertices))
+                        CHECK(!(static_cast<BLOCK_FACE>(unitFace[0]) == BLOCK_FACE::BLOCK_FACE_BOTTOM && unitFace[2] == 0));
+            }
+        }
+    }
+}
+
+int main() {
+    return RunTests({
+        { "vertex packing round trip",          TestVertexPackingRoundTrip      },
+        { "greedy mesh covers the naive mesh",  TestGreedyMeshCoversNaiveMesh   },
+        { "bitmask mesh matches the naive mesh", TestBitmaskMeshMatchesNaiveMesh },
+        { "side faces match the neighbours",    TestSideFacesMatchNeighbours    }
+    });
+}
@@ -0,0 +1,126 @@
+#include "Test.hpp"
+#include "Chunk.hpp"
+#include "RegionFile.hpp"
+#include "ChunkStorage.hpp"
+#include "WorldGenerator.hpp"
+
+constexpr std::uint32_t WORLD_SEED = 1234u;
+
+static bool HaveSameBlocks(const Chunk& lhs, const Chunk& rhs) noexcept {
+    for (size_t idx = 0u; idx < CHUNK_X_BLOCK_COUNT; ++idx)
+        for (size_t idy = 0u; idy < CHUNK_Y_BLOCK_COUNT; ++idy)
+            for (size_t idz = 0u; idz < CHUNK_Z_BLOCK_COUNT; ++idz)
+                if (lhs.GetBlock(idx, idy, idz) != rhs.GetBlock(idx, idy, idz))
+                    return false;
+
+    return true;
+}
+
+// Generated, then edited at random so that the chunk is dirty and its sections aren't the generator's
+static std::unique_ptr<Chunk> MakeEditedChunk(WorldGenerator& worldGenerator, const ChunkCoord& location, std::mt19937& random) noexcept {
+    std::unique_ptr<Chunk> pChunk = std::make_unique<Chunk>(location);
+    worldGenerator.GenerateChunk(*pChunk);
+
+    for (int i = 0; i < 500; ++i)
+        pChunk->SetBlock(random() % CHUNK_X_BLOCK_COUNT, random() % CHUNK_Y_BLOCK_COUNT, random() % CHUNK_Z_BLOCK_COUNT,
+                         static_cast<BLOCK_TYPE>(random() % static_cast<size_t>(BLOCK_TYPE::_COUNT)));
+
+    return pChunk;
+}
+
+// Regions are REGION_CHUNK_COUNT_PER_SIDE chunks wide on both sides of 0, the negative ones included
+static void TestRegionCoordinates() noexcept {
+    constexpr std::int16_t SIDE = static_cast<std::int16_t>(RegionFile::REGION_CHUNK_COUNT_PER_SIDE);
+
+    CHECK(RegionFile::GetRegionCoord(ChunkCoord{ 0, 0 })                 == (ChunkCoord{ 0, 0 }));
+    CHECK(RegionFile::GetRegionCoord(ChunkCoord{ SIDE - 1, SIDE })       == (ChunkCoord{ 0, 1 }));
+    CHECK(RegionFile::GetRegionCoord(ChunkCoord{ -1, -SIDE })            == (ChunkCoord{ -1, -1 }));
+    CHECK(RegionFile::GetRegionCoord(ChunkCoord{ -SIDE - 1, -SIDE + 1 }) == (ChunkCoord{ -2, -1 }));
+
+    CHECK(RegionFile::GetChunkIndex(ChunkCoord{ 0, 0 })         == 0u);
+    CHECK(RegionFile::GetChunkIndex(ChunkCoord{ -SIDE, -SIDE }) == 0u);
+    CHECK(RegionFile::GetChunkIndex(ChunkCoord{ -1, -1 })       == RegionFile::REGION_CHUNK_COUNT - 1u);
+    CHECK(RegionFile::GetChunkIndex(ChunkCoord{ -SIDE - 1, 1 }) == (RegionFile::REGION_CHUNK_COUNT_PER_SIDE - 1u) * RegionFile::REGION_CHUNK_COUNT_PER_SIDE + 1u);
+
+    // every chunk of a region has its own index
+    std::vector<bool> bIsIndexUsed(RegionFile::REGION_CHUNK_COUNT, false);
+    for (std::int16_t idx = -2 * SIDE; idx < -SIDE; ++idx) {
+        for (std::int16_t idz = SIDE; idz < 2 * SIDE; ++idz) {
+            CHECK(RegionFile::GetRegionCoord(ChunkCoord{ idx, idz }) == (ChunkCoord{ -2, 1 }));
+
+            const size_t chunkIndex = RegionFile::GetChunkIndex(ChunkCoord{ idx, idz });
+            CHECK(chunkIndex < RegionFile::REGION_CHUNK_COUNT && !bIsIndexUsed[chunkIndex]);
+            bIsIndexUsed[chunkIndex] = true;
+        }
+    }
+}
+
+// Chunks saved on both sides of the region boundaries load back with the same blocks, from a storage that didn't save them.
+// Saving some chunks of a region again keeps the other chunks' payloads
+static void TestSaveLoadRoundTrip() noexcept {
+    constexpr std::int16_t SIDE = static_cast<std::int16_t>(RegionFile::REGION_CHUNK_COUNT_PER_SIDE);
+
+    const std::vector<ChunkCoord> locations = {
+        { 0, 0 }, { 1, 0 }, { SIDE - 1, SIDE - 1 }, { SIDE, 0 },
+        { -1, -1 }, { -1, 0 }, { 0, -1 }, { -SIDE, -SIDE }, { -SIDE - 1, 3 }, { 5, -2 * SIDE - 7 }
+    };
+
+    const TemporaryDirectory directory("MinecraftChunkStorageTests");
+    WorldGenerator worldGenerator(WORLD_SEED);
+    std::mt19937 random(WORLD_SEED);
+
+    std::vector<std::unique_ptr<Chunk>> pChunks;
+    for (const ChunkCoord& location : locations)
+        pChunks.push_back(MakeEditedChunk(worldGenerator, location, random));
+
+    {
+        ChunkStorage storage(directory.GetPath());
+
+        std::vector<Chunk*> pDirtyChunks;
+        for (const std::unique_ptr<Chunk>& pChunk : pChunks) {
+            CHECK(pChunk->IsDirty());
+            pDirtyChunks.push_back(pChunk.get());
+        }
+
+        storage.SaveChunks(pDirtyChunks);
+
+        for (const std::unique_ptr<Chunk>& pChunk : pChunks)
+            CHECK(!pChunk->IsDirty());
+
+        // one file per region
+        CHECK(std::filesystem::exists(directory.GetPath() / "r.-1.-1.mcr"));
+        CHECK(std::filesystem::exists(directory.GetPath() / "r.-2.0.mcr"));
+        CHECK(std::filesystem::exists(directory.GetPath() / "r.0.-3.mcr"));
+    }
+
+    // the first chunk of each region edited and saved again on its own
+    pChunks[0] = MakeEditedChunk(worldGenerator, locations[0], random);
+    pChunks[4] = MakeEditedChunk(worldGenerator, locations[4], random);
+    {
+        ChunkStorage storage(directory.GetPath());
+        storage.SaveChunks({ pChunks[0].get(), pChunks[4].get() });
+    }
+
+    ChunkStorage storage(directory.GetPath());
+    for (const std::unique_ptr<Chunk>& pChunk : pChunks) {
+        Chunk loadedChunk(pChunk->GetLocation());
+
+        CHECK(storage.LoadChunk(loadedChunk));
+        CHECK(loadedChunk.IsGenerated() && !loadedChunk.IsDirty());
+        CHECK(HaveSameBlocks(loadedChunk, *pChunk));
+    }
+
+    // neither in a saved region nor saved in one
+    Chunk unsavedChunk(ChunkCoord{ 100, -100 });
+    CHECK(!storage.LoadChunk(unsavedChunk) && !unsavedChunk.IsGenerated());
+
+    unsavedChunk = Chunk(ChunkCoord{ 2, 2 });
+    CHECK(!storage.LoadChunk(unsavedChunk) && !unsavedChunk.IsGenerated());
+}
+
+int main() {
+    return RunTests({
+        { "region coordinates",   TestRegionCoordinates },
+        { "save/load round trip", TestSaveLoadRoundTrip }
+    });
+}
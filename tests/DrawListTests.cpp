@@ -0,0 +1,169 @@
+#include "Test.hpp"
+#include "DrawList.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+constexpr int RANDOM_INPUT_COUNT = 10000;
+
+// Sizes on both sides of the switch from std::stable_sort to the radix sort
+constexpr std::array<size_t, 9u> LIST_SIZES = { 0u, 1u, 2u, 255u, 256u, 257u, 1000u, 4097u, 20000u };
+
+struct DrawKeyInput {
+    DRAW_PASS     pass;
+    std::uint16_t state;
+    float         depth;
+}; // struct DrawKeyInput
+
+static DrawKeyInput MakeRandomKeyInput(std::mt19937& random) noexcept {
+    std::uniform_real_distribution<float> depths(0.f, 1e6f);
+
+    // non-positive depths, equal depths and tiny ones too
+    float depth = depths(random);
+    switch (random() % 8u) {
+    case 0u: depth = -depth;                                                                              break;
+    case 1u: depth = 0.f;                                                                                 break;
+    case 2u: depth = static_cast<float>(random() % 4u);                                                   break;
+    case 3u: depth = std::numeric_limits<float>::denorm_min() * static_cast<float>(random() % 4u);        break;
+    default: break;
+    }
+
+    return DrawKeyInput{ static_cast<DRAW_PASS>(random() % static_cast<size_t>(DRAW_PASS::_COUNT)), static_cast<std::uint16_t>(random() % 4u == 0u ? random() : random() % 4u), depth };
+}
+
+// -1, 0 or 1 as "lhs" is drawn before, with or after "rhs": by pass, then state, then depth, with depths below 0 as 0
+static int CompareDrawOrder(const DrawKeyInput& lhs, const DrawKeyInput& rhs, const bool bBackToFront) noexcept {
+    if (lhs.pass  != rhs.pass)  return lhs.pass  < rhs.pass  ? -1 : 1;
+    if (lhs.state != rhs.state) return lhs.state < rhs.state ? -1 : 1;
+
+    const float lhsDepth = std::max(lhs.depth, 0.f);
+    const float rhsDepth = std::max(rhs.depth, 0.f);
+    if (lhsDepth == rhsDepth)
+        return 0;
+
+    return (lhsDepth < rhsDepth) != bBackToFront ? -1 : 1;
+}
+
+// MakeSortKey orders the keys as CompareDrawOrder does, front to back and back to front
+static void TestSortKeyOrder() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (int i = 0; i < RANDOM_INPUT_COUNT; ++i) {
+        const DrawKeyInput lhs = MakeRandomKeyInput(random);
+        const DrawKeyInput rhs = MakeRandomKeyInput(random);
+
+        for (const bool bBackToFront : { false, true }) {
+            const std::uint64_t lhsKey = DrawList::MakeSortKey(lhs.pass, lhs.state, lhs.depth, bBackToFront);
+            const std::uint64_t rhsKey = DrawList::MakeSortKey(rhs.pass, rhs.state, rhs.depth, bBackToFront);
+
+            const int keyOrder = lhsKey < rhsKey ? -1 : (lhsKey > rhsKey ? 1 : 0);
+            if (!CHECK(keyOrder == CompareDrawOrder(lhs, rhs, bBackToFront)))
+                return;
+        }
+    }
+
+    // the pass comes first, then the state, then the depth
+    const std::uint64_t opaqueFar       = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE,      65535u, 1e9f);
+    const std::uint64_t translucentNear = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 0u,     0.f, true);
+    const std::uint64_t lowStateFar     = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE,      1u,     1e9f);
+    const std::uint64_t highStateNear   = DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE,      2u,     0.f);
+    CHECK(opaqueFar < translucentNear && lowStateFar < highStateNear);
+
+    // back to front is the reverse depth order, within a pass and state
+    CHECK(DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 3u, 10.f, true) < DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 3u, 2.f, true));
+    CHECK(DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 3u, 2.f) < DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_TRANSLUCENT, 3u, 10.f));
+}
+
+// Sort gives the order std::stable_sort gives on the keys, equal keys in the order they were added
+static bool SortMatchesStableSort(std::vector<DrawCommand> commands) noexcept {
+    for (size_t i = 0u; i < commands.size(); ++i)
+        commands[i].object = static_cast<std::uint32_t>(i);
+
+    DrawList drawList;
+    for (const DrawCommand& command : commands)
+        drawList.Add(command);
+
+    drawList.Sort();
+
+    std::stable_sort(commands.begin(), commands.end(), [](const DrawCommand& lhs, const DrawCommand& rhs) { return lhs.key < rhs.key; });
+
+    const std::vector<DrawCommand>& sortedCommands = drawList.GetCommands();
+    if (sortedCommands.size() != commands.size())
+        return false;
+
+    for (size_t i = 0u; i < commands.size(); ++i)
+        if (sortedCommands[i].key != commands[i].key || sortedCommands[i].object != commands[i].object)
+            return false;
+
+    return true;
+}
+
+// Keys from MakeSortKey, with few states and depths so that many are equal
+static void TestSortMatchesStableSort() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (const size_t size : LIST_SIZES) {
+        for (int i = 0; i < 4; ++i) {
+            std::vector<DrawCommand> commands(size);
+            for (DrawCommand& command : commands) {
+                const DrawKeyInput input = MakeRandomKeyInput(random);
+                command.key = DrawList::MakeSortKey(input.pass, input.state, input.depth, input.pass == DRAW_PASS::DRAW_PASS_TRANSLUCENT);
+            }
+
+            if (!CHECK(SortMatchesStableSort(commands)))
+                return;
+        }
+    }
+}
+
+// Keys that share some of their digits, down to all of them, so that the radix sort skips these digits.
+// The low 8 bits of the keys of MakeSortKey are always 0, the pass and state often are
+static void TestSortWithSharedDigits() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (const size_t size : LIST_SIZES) {
+        for (std::uint32_t sharedDigitMask = 0u; sharedDigitMask < 256u; sharedDigitMask += 1u + random() % 16u) {
+            const std::uint64_t sharedKey = (static_cast<std::uint64_t>(random()) << 32u) | random();
+
+            std::vector<DrawCommand> commands(size);
+            for (DrawCommand& command : commands) {
+                // a few values per digit, so that equal keys are common
+                command.key = 0u;
+                for (size_t digit = 0u; digit < 8u; ++digit) {
+                    const std::uint64_t value = (sharedDigitMask & (1u << digit)) ? (sharedKey >> (digit * 8u)) & 0xFFu : random() % 3u * 100u;
+                    command.key |= value << (digit * 8u);
+                }
+            }
+
+            if (!CHECK(SortMatchesStableSort(commands)))
+                return;
+        }
+
+        // every key the same
+        if (!CHECK(SortMatchesStableSort(std::vector<DrawCommand>(size, DrawCommand{ 0x0123456789ABCDEFu, 0u, 0u, 0u, 0u }))))
+            return;
+    }
+
+    // sorting again keeps the order, and a cleared list is reused
+    DrawList drawList;
+    for (int pass = 0; pass < 2; ++pass) {
+        drawList.Clear();
+        for (size_t i = 0u; i < 1000u; ++i)
+            drawList.Add(DrawCommand{ DrawList::MakeSortKey(DRAW_PASS::DRAW_PASS_OPAQUE, static_cast<std::uint16_t>(random() % 8u), static_cast<float>(random() % 64u)),
+                                      static_cast<std::uint32_t>(i), 0u, 0u, 0u });
+
+        drawList.Sort();
+        const std::vector<DrawCommand> sortedCommands = drawList.GetCommands();
+
+        drawList.Sort();
+        CHECK(std::equal(sortedCommands.begin(), sortedCommands.end(), drawList.GetCommands().begin(), drawList.GetCommands().end(),
+                         [](const DrawCommand& lhs, const DrawCommand& rhs) { return lhs.key == rhs.key && lhs.object == rhs.object; }));
+    }
+}
+
+int main() {
+    return RunTests({
+        { "sort keys order by pass, state then depth", TestSortKeyOrder          },
+        { "Sort matches std::stable_sort",              TestSortMatchesStableSort },
+        { "Sort skips the digits every key shares",     TestSortWithSharedDigits  }
+    });
+}
@@ -0,0 +1,80 @@
+#include "Test.hpp"
+#include "Chunk.hpp"
+#include "BatchedPerlinNoise.hpp"
+
+constexpr std::array<std::uint32_t, 3u> SEEDS = { 1234u, 0u, 987654321u };
+
+// Chunks on both sides of 0, where the noise's lattice wraps too
+constexpr int CHUNK_RANGE = 40;
+
+// The batched heights are within one block of the scalar ones, and only differ where float rounding lands on a boundary
+static void TestBatchedHeightMapMatchesScalar() noexcept {
+    for (const std::uint32_t seed : SEEDS) {
+        siv::PerlinNoise noise;
+        noise.reseed(seed);
+        const BatchedPerlinNoise batchedNoise(noise);
+
+        size_t nHeights          = 0u;
+        size_t nDifferentHeights = 0u;
+
+        for (std::int16_t idx = -CHUNK_RANGE; idx <= CHUNK_RANGE; ++idx) {
+            for (std::int16_t idz = -CHUNK_RANGE; idz <= CHUNK_RANGE; ++idz) {
+                const ChunkHeightMap heightMap        = ComputeDefaultHeightMap(ChunkCoord{ idx, idz }, noise);
+                const ChunkHeightMap batchedHeightMap = ComputeDefaultHeightMap(ChunkCoord{ idx, idz }, batchedNoise);
+
+                for (size_t i = 0u; i < heightMap.size(); ++i) {
+                    const int difference = static_cast<int>(batchedHeightMap[i]) - static_cast<int>(heightMap[i]);
+                    if (!CHECK(std::abs(difference) <= 1))
+                        return;
+
+                    nDifferentHeights += difference != 0 ? 1u : 0u;
+                }
+
+                nHeights += heightMap.size();
+            }
+        }
+
+        CHECK(nDifferentHeights * 1000u < nHeights);
+    }
+}
+
+// The noise itself, on grids that don't start on a chunk or match its size
+static void TestBatchedNoiseMatchesScalar() noexcept {
+    std::mt19937 random(SEEDS[0]);
+
+    for (const std::uint32_t seed : SEEDS) {
+        siv::PerlinNoise noise;
+        noise.reseed(seed);
+        const BatchedPerlinNoise batchedNoise(noise);
+
+        for (int i = 0; i < 200; ++i) {
+            const std::int32_t x0      = static_cast<std::int32_t>(random() % 4000u) - 2000;
+            const std::int32_t y0      = static_cast<std::int32_t>(random() % 4000u) - 2000;
+            const size_t       width   = 1u + random() % 19u;
+            const size_t       height  = 1u + random() % 19u;
+            const std::int32_t octaves = static_cast<std::int32_t>(1u + random() % 4u);
+            const float        scale   = 10.f + static_cast<float>(random() % 100u);
+
+            std::vector<float> values(width * height);
+            batchedNoise.NormalizedOctaveNoise2D_0_1(x0, y0, width, height, scale, octaves, values.data());
+
+            bool bIsClose = true;
+            for (size_t x = 0u; x < width; ++x) {
+                for (size_t y = 0u; y < height; ++y) {
+                    const double expected = noise.normalizedOctaveNoise2D_0_1((x0 + static_cast<std::int32_t>(x)) / scale, (y0 + static_cast<std::int32_t>(y)) / scale, octaves);
+                    bIsClose = bIsClose && std::abs(values[x * height + y] - expected) < 1e-4;
+                }
+            }
+
+            if (!CHECK(bIsClose))
+                return;
+        }
+    }
+}
+
+int main() {
+    return RunTests({
+        { "batched height map matches the scalar one", TestBatchedHeightMapMatchesScalar },
+        { "batched noise matches the scalar one",      TestBatchedNoiseMatchesScalar     }
+    });
+}
@@ -0,0 +1,146 @@
+#include "Test.hpp"
+#include "Chunk.hpp"
+#include "JobSystem.hpp"
+#include "LightEngine.hpp"
+#include "WorldGenerator.hpp"
+
+constexpr std::uint32_t WORLD_SEED = 1234u;
+
+// texture_atlas.png
+constexpr std::size_t TEXTURE_ATLAS_WIDTH = 256u;
+
+// The pools are tested from 1 thread up to this many, more than the machine has cores so that workers get preempted
+static size_t GetMaxThreadCount() noexcept {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 4u) + 1u;
+}
+
+// Every job runs exactly once, the jobs submitted by other jobs included, and the counters are back to 0 once the pool is idle.
+// The queued job count never goes past the number of jobs submitted, as it would if a thief could take it below 0
+static void TestEveryJobRunsOnce() noexcept {
+    constexpr size_t N_JOBS       = 4096u;
+    constexpr size_t N_CHILDREN   = 3u; // submitted by each job, from its worker thread
+    constexpr size_t N_TOTAL_JOBS = N_JOBS * (1u + N_CHILDREN);
+
+    for (size_t nThreads = 1u; nThreads <= GetMaxThreadCount(); ++nThreads) {
+        JobSystem jobSystem(nThreads);
+        CHECK(jobSystem.GetThreadCount() == nThreads);
+
+        std::vector<std::atomic<std::uint32_t>> runCounts(N_TOTAL_JOBS);
+        for (std::atomic<std::uint32_t>& runCount : runCounts)
+            runCount = 0u;
+
+        for (size_t i = 0u; i < N_JOBS; ++i) {
+            jobSystem.Submit([&jobSystem, &runCounts, i]() {
+                ++runCounts[i];
+
+                for (size_t child = 1u; child <= N_CHILDREN; ++child)
+                    jobSystem.Submit([&runCounts, index = child * N_JOBS + i]() { ++runCounts[index]; });
+            });
+        }
+
+        size_t maxQueuedJobCount = 0u;
+        while (jobSystem.GetUnfinishedJobCount() > 0u)
+            maxQueuedJobCount = std::max(maxQueuedJobCount, jobSystem.GetQueuedJobCount());
+
+        jobSystem.WaitIdle();
+
+        CHECK(maxQueuedJobCount <= N_TOTAL_JOBS);
+        CHECK(jobSystem.GetQueuedJobCount() == 0u);
+        CHECK(jobSystem.GetUnfinishedJobCount() == 0u);
+        CHECK(std::all_of(runCounts.begin(), runCounts.end(), [](const std::atomic<std::uint32_t>& runCount) { return runCount == 1u; }));
+    }
+}
+
+// Destroying the job system runs the jobs still queued, and the ones they submit, as Minecraft's m_jobSystem relies on
+static void TestDestructorRunsQueuedJobs() noexcept {
+    constexpr size_t N_JOBS = 256u;
+
+    for (size_t nThreads = 1u; nThreads <= GetMaxThreadCount(); ++nThreads) {
+        std::atomic<size_t> nRunJobs = 0u;
+        {
+            JobSystem jobSystem(nThreads);
+
+            for (size_t i = 0u; i < N_JOBS; ++i) {
+                jobSystem.Submit([&jobSystem, &nRunJobs]() {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    ++nRunJobs;
+
+                    jobSystem.Submit([&nRunJobs]() { ++nRunJobs; });
+                });
+            }
+        }
+
+        if (!CHECK(nRunJobs == 2u * N_JOBS))
+            return;
+    }
+}
+
+// What a chunk job leaves behind: the chunk's blocks, as saved, and its mesh
+struct ChunkJobResult {
+    std::vector<std::uint8_t> blocks;
+    std::vector<Vertex>       vertices;
+}; // struct ChunkJobResult
+
+// As Minecraft's chunk jobs do, without the neighbours: generate, light, then mesh
+static ChunkJobResult RunChunkJob(WorldGenerator& worldGenerator, const ChunkCoord& location) noexcept {
+    Chunk chunk(location);
+    worldGenerator.GenerateChunk(chunk);
+
+    LightEngine lightEngine;
+    lightEngine.ComputeChunkLight(chunk);
+
+    const ChunkMesh mesh = chunk.GenerateMesh(CHUNK_MESHING_MODE::CHUNK_MESHING_MODE_GREEDY, TEXTURE_ATLAS_WIDTH, ChunkNeighbourBlocks{});
+
+    ChunkJobResult result;
+    result.blocks = chunk.Serialize();
+    for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex) {
+        result.vertices.insert(result.vertices.end(), mesh.sectionVertices[sectionIndex].begin(), mesh.sectionVertices[sectionIndex].end());
+        result.vertices.insert(result.vertices.end(), mesh.sectionTranslucentVertices[sectionIndex].begin(), mesh.sectionTranslucentVertices[sectionIndex].end());
+    }
+
+    return result;
+}
+
+// Chunks generated and meshed by jobs on any number of threads are bit for bit the ones of the single threaded path,
+// with one world generator (and its region cache) shared by every job as in Minecraft
+static void TestChunkJobsMatchSingleThreaded() noexcept {
+    constexpr int SIDE_CHUNK_COUNT = 6;
+
+    std::vector<ChunkCoord> locations;
+    for (std::int16_t idx = -SIDE_CHUNK_COUNT / 2; idx < SIDE_CHUNK_COUNT / 2; ++idx)
+        for (std::int16_t idz = -SIDE_CHUNK_COUNT / 2; idz < SIDE_CHUNK_COUNT / 2; ++idz)
+            locations.push_back(ChunkCoord{ idx, idz });
+
+    std::vector<ChunkJobResult> expectedResults;
+    {
+        WorldGenerator worldGenerator(WORLD_SEED);
+        for (const ChunkCoord& location : locations)
+            expectedResults.push_back(RunChunkJob(worldGenerator, location));
+    }
+
+    for (size_t nThreads = 1u; nThreads <= GetMaxThreadCount(); ++nThreads) {
+        // a small cache, so that regions are evicted and computed again while other jobs use them
+        WorldGenerator worldGenerator(WORLD_SEED, 2u);
+        std::vector<ChunkJobResult> results(locations.size());
+
+        JobSystem jobSystem(nThreads);
+        for (size_t i = 0u; i < locations.size(); ++i)
+            jobSystem.Submit([&worldGenerator, &results, &locations, i]() { results[i] = RunChunkJob(worldGenerator, locations[i]); });
+
+        jobSystem.WaitIdle();
+
+        for (size_t i = 0u; i < locations.size(); ++i) {
+            CHECK(results[i].blocks == expectedResults[i].blocks);
+            CHECK(results[i].vertices.size() == expectedResults[i].vertices.size() &&
+                  std::memcmp(results[i].vertices.data(), expectedResults[i].vertices.data(), results[i].vertices.size() * sizeof(Vertex)) == 0);
+        }
+    }
+}
+
+int main() {
+    return RunTests({
+        { "every job runs once",                       TestEveryJobRunsOnce             },
+        { "destructor runs the queued jobs",           TestDestructorRunsQueuedJobs     },
+        { "chunk jobs match the single threaded path", TestChunkJobsMatchSingleThreaded }
+    });
+}
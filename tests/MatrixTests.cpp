@@ -0,0 +1,272 @@
+#include "Test.hpp"
+#include "Matrix.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+constexpr int RANDOM_INPUT_COUNT = 10000;
+
+// The results are checked against a scalar triple loop in double. Each float result may be off by a few roundings
+// of the terms it sums, with or without FMA, so the tolerance scales with the sum of their magnitudes
+constexpr double TOLERANCE = 8.0 * std::numeric_limits<float>::epsilon();
+
+static bool IsClose(const float value, const double expected, const double magnitude) noexcept {
+    return std::abs(static_cast<double>(value) - expected) <= TOLERANCE * (magnitude + 1e-30);
+}
+
+static Mat4x4f32 MakeRandomMatrix(std::mt19937& random) noexcept {
+    std::uniform_real_distribution<float> values(-100.f, 100.f);
+
+    Mat4x4f32 m;
+    for (float& value : m.m)
+        value = values(random);
+
+    return m;
+}
+
+// Rotation, scale and translation: the last column is (0, 0, 0, 1)
+static Mat4x4f32 MakeRandomAffineMatrix(std::mt19937& random) noexcept {
+    std::uniform_real_distribution<float> angles(-3.f, 3.f);
+    std::uniform_real_distribution<float> scales(0.1f, 10.f);
+    std::uniform_real_distribution<float> translations(-1000.f, 1000.f);
+
+    Mat4x4f32 scale = Mat4x4f32::Identity;
+    scale(0) = scales(random); scale(5) = scales(random); scale(10) = scales(random);
+
+    return scale * MakeRotationMatrix(Vec4f32{ angles(random), angles(random), angles(random) })
+                 * MakeTranslationMatrix(Vec4f32{ translations(random), translations(random), translations(random) });
+}
+
+static Vec4f32 MakeRandomPoint(std::mt19937& random) noexcept {
+    std::uniform_real_distribution<float> values(-100.f, 100.f);
+    return Vec4f32{ values(random), values(random), values(random), values(random) };
+}
+
+// The element (r, c) of "lhs * rhs" as the triple loop computes it, and the sum of the magnitudes of its terms
+static std::array<double, 2> MultiplyScalar(const Mat4x4f32& lhs, const Mat4x4f32& rhs, const size_t r, const size_t c) noexcept {
+    std::array<double, 2> result = { 0.0, 0.0 };
+    for (size_t k = 0u; k < 4u; ++k) {
+        const double term = static_cast<double>(lhs.m[r * 4u + k]) * static_cast<double>(rhs.m[k * 4u + c]);
+        result[0] += term;
+        result[1] += std::abs(term);
+    }
+
+    return result;
+}
+
+// "point" as a row vector, the component c of "point * m"
+static std::array<double, 2> MultiplyScalar(const Vec4f32& point, const Mat4x4f32& m, const size_t c) noexcept {
+    const std::array<float, 4u> components = { point.x, point.y, point.z, point.w };
+
+    std::array<double, 2> result = { 0.0, 0.0 };
+    for (size_t k = 0u; k < 4u; ++k) {
+        const double term = static_cast<double>(components[k]) * static_cast<double>(m.m[k * 4u + c]);
+        result[0] += term;
+        result[1] += std::abs(term);
+    }
+
+    return result;
+}
+
+static bool IsCloseToScalar(const Vec4f32& result, const Vec4f32& point, const Mat4x4f32& m) noexcept {
+    const std::array<float, 4u> components = { result.x, result.y, result.z, result.w };
+
+    for (size_t c = 0u; c < 4u; ++c) {
+        const std::array<double, 2> expected = MultiplyScalar(point, m, c);
+        if (!IsClose(components[c], expected[0], expected[1]))
+            return false;
+    }
+
+    return true;
+}
+
+static void TestMatrixProductMatchesScalar() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (int i = 0; i < RANDOM_INPUT_COUNT; ++i) {
+        const Mat4x4f32 lhs = MakeRandomMatrix(random);
+        const Mat4x4f32 rhs = MakeRandomMatrix(random);
+        const Mat4x4f32 product = lhs * rhs;
+
+        bool bIsClose = true;
+        for (size_t r = 0u; r < 4u; ++r) {
+            for (size_t c = 0u; c < 4u; ++c) {
+                const std::array<double, 2> expected = MultiplyScalar(lhs, rhs, r, c);
+                bIsClose = bIsClose && IsClose(product.m[r * 4u + c], expected[0], expected[1]);
+            }
+        }
+
+        if (!CHECK(bIsClose))
+            break;
+    }
+
+    // exactly, for the identity
+    const Mat4x4f32 m = MakeRandomMatrix(random);
+    CHECK((m * Mat4x4f32::Identity).m == m.m);
+    CHECK((Mat4x4f32::Identity * m).m == m.m);
+}
+
+static void TestVectorProductMatchesScalar() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (int i = 0; i < RANDOM_INPUT_COUNT; ++i) {
+        const Mat4x4f32 m     = MakeRandomMatrix(random);
+        const Vec4f32   point = MakeRandomPoint(random);
+
+        if (!CHECK(IsCloseToScalar(point * m, point, m)))
+            break;
+    }
+}
+
+// Every count from 0 to a few past the 2 points of the AVX path, so that its remainder goes through the SSE path,
+// into a separate array and in place
+static void TestTransformPointsMatchesScalar() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    for (size_t count = 0u; count <= 1001u; count = count < 9u ? count + 1u : count * 10u + 1u) {
+        for (int i = 0; i < 20; ++i) {
+            const Mat4x4f32 m = MakeRandomMatrix(random);
+
+            std::vector<Vec4f32> points(count);
+            for (Vec4f32& point : points)
+                point = MakeRandomPoint(random);
+
+            std::vector<Vec4f32> results(count);
+            TransformPoints(m, points.data(), results.data(), count);
+
+            std::vector<Vec4f32> inPlaceResults = points;
+            TransformPoints(m, inPlaceResults.data(), inPlaceResults.data(), count);
+
+            bool bIsClose = true;
+            for (size_t j = 0u; j < count; ++j) {
+                bIsClose = bIsClose && IsCloseToScalar(results[j], points[j], m);
+                bIsClose = bIsClose && IsCloseToScalar(inPlaceResults[j], points[j], m);
+            }
+
+            if (!CHECK(bIsClose))
+                return;
+        }
+    }
+}
+
+// The bounds of the 8 corners of each box once transformed, for affine matrices
+static void TestTransformAABBsMatchesCorners() noexcept {
+    constexpr size_t BOX_COUNT = 64u;
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> coordinates(-100.f, 100.f);
+    std::uniform_real_distribution<float> sizes(0.f, 50.f);
+
+    for (int i = 0; i < RANDOM_INPUT_COUNT / static_cast<int>(BOX_COUNT); ++i) {
+        const Mat4x4f32 m = MakeRandomAffineMatrix(random);
+
+        std::vector<Vec4f32> boxMins(BOX_COUNT), boxMaxs(BOX_COUNT);
+        for (size_t j = 0u; j < BOX_COUNT; ++j) {
+            boxMins[j] = Vec4f32{ coordinates(random), coordinates(random), coordinates(random), 1.f };
+            boxMaxs[j] = boxMins[j] + Vec4f32{ sizes(random), sizes(random), sizes(random), 0.f };
+        }
+
+        std::vector<Vec4f32> resultMins(BOX_COUNT), resultMaxs(BOX_COUNT);
+        TransformAABBs(m, boxMins.data(), boxMaxs.data(), resultMins.data(), resultMaxs.data(), BOX_COUNT);
+
+        bool bIsClose = true;
+        for (size_t j = 0u; j < BOX_COUNT; ++j) {
+            std::array<double, 3> expectedMin, expectedMax, magnitude;
+            expectedMin.fill(std::numeric_limits<double>::max());
+            expectedMax.fill(std::numeric_limits<double>::lowest());
+            magnitude.fill(0.0);
+
+            for (size_t corner = 0u; corner < 8u; ++corner) {
+                const Vec4f32 point = {
+                    (corner & 1u) ? boxMaxs[j].x : boxMins[j].x, (corner & 2u) ? boxMaxs[j].y : boxMins[j].y, (corner & 4u) ? boxMaxs[j].z : boxMins[j].z, 1.f
+                };
+
+                for (size_t c = 0u; c < 3u; ++c) {
+                    const std::array<double, 2> transformed = MultiplyScalar(point, m, c);
+                    expectedMin[c] = std::min(expectedMin[c], transformed[0]);
+                    expectedMax[c] = std::max(expectedMax[c], transformed[0]);
+                    magnitude[c]   = std::max(magnitude[c], transformed[1]);
+                }
+            }
+
+            const std::array<float, 3u> resultMin = { resultMins[j].x, resultMins[j].y, resultMins[j].z };
+            const std::array<float, 3u> resultMax = { resultMaxs[j].x, resultMaxs[j].y, resultMaxs[j].z };
+            for (size_t c = 0u; c < 3u; ++c)
+                bIsClose = bIsClose && IsClose(resultMin[c], expectedMin[c], magnitude[c]) && IsClose(resultMax[c], expectedMax[c], magnitude[c]);
+        }
+
+        if (!CHECK(bIsClose))
+            break;
+    }
+}
+
+// M * M^-1 is the identity, for random matrices kept away from singular and for the camera's view projection
+static void TestInvertedGivesIdentity() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    // relative to the magnitude of the terms of each element, as large ones cancel out on the way to 0 or 1
+    const auto IsIdentity = [](const Mat4x4f32& lhs, const Mat4x4f32& rhs) {
+        const Mat4x4f32 product = lhs * rhs;
+
+        for (size_t r = 0u; r < 4u; ++r) {
+            for (size_t c = 0u; c < 4u; ++c) {
+                const double magnitude = MultiplyScalar(lhs, rhs, r, c)[1];
+                if (std::abs(product.m[r * 4u + c] - Mat4x4f32::Identity.m[r * 4u + c]) > 1e-4 * magnitude)
+                    return false;
+            }
+        }
+
+        return true;
+    };
+
+    for (int i = 0; i < RANDOM_INPUT_COUNT; ++i) {
+        // diagonally dominant, so invertible and well conditioned
+        Mat4x4f32 m = MakeRandomMatrix(random);
+        for (size_t d = 0u; d < 4u; ++d)
+            m.m[d * 5u] += (m.m[d * 5u] < 0.f ? -400.f : 400.f);
+
+        const std::optional<Mat4x4f32> inverse = Inverted(m);
+        if (!CHECK(inverse.has_value() && IsIdentity(m, inverse.value()) && IsIdentity(inverse.value(), m)))
+            break;
+    }
+
+    const Mat4x4f32 viewProjection = MakeTranslationMatrix(Vec4f32{ -123.f, -80.f, 456.f }) * MakeLookAtMatrix(Vec4f32{ 0.3f, -0.2f, 1.f }, Vec4f32{ 0.f, 1.f, 0.f })
+                                   * MakePerspectiveMatrix(1.f, 9.f / 16.f, 0.1f, 1000.f);
+    const std::optional<Mat4x4f32> inverseViewProjection = Inverted(viewProjection);
+    CHECK(inverseViewProjection.has_value() && IsIdentity(viewProjection, inverseViewProjection.value()) && IsIdentity(inverseViewProjection.value(), viewProjection));
+}
+
+// The determinant of these comes out exactly 0 in float, or isn't finite
+static void TestInvertedRejectsSingular() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+
+    CHECK(!Inverted(Mat4x4f32::Zeroes).has_value());
+
+    for (int i = 0; i < 1000; ++i) {
+        const Mat4x4f32 m = MakeRandomMatrix(random);
+        const size_t line = static_cast<size_t>(random() % 4u);
+
+        Mat4x4f32 zeroRow = m, zeroColumn = m, sameRows = m, sameTopRows = m, infinite = m;
+        for (size_t k = 0u; k < 4u; ++k) {
+            zeroRow.m[line * 4u + k]    = 0.f;
+            zeroColumn.m[k * 4u + line] = 0.f;
+            sameRows.m[3u * 4u + k]     = sameRows.m[2u * 4u + k];
+            sameTopRows.m[1u * 4u + k]  = sameTopRows.m[0u * 4u + k];
+        }
+        infinite.m[line * 5u] = std::numeric_limits<float>::infinity();
+
+        if (!CHECK(!Inverted(zeroRow).has_value() && !Inverted(zeroColumn).has_value() && !Inverted(sameRows).has_value()
+                   && !Inverted(sameTopRows).has_value() && !Inverted(infinite).has_value()))
+            break;
+    }
+}
+
+int main() {
+    return RunTests({
+        { "matrix product matches the scalar loop", TestMatrixProductMatchesScalar   },
+        { "vector product matches the scalar loop", TestVectorProductMatchesScalar   },
+        { "TransformPoints matches the scalar loop", TestTransformPointsMatchesScalar },
+        { "TransformAABBs bounds the corners",       TestTransformAABBsMatchesCorners },
+        { "Inverted gives the identity",             TestInvertedGivesIdentity        },
+        { "Inverted rejects singular matrices",      TestInvertedRejectsSingular      }
+    });
+}
@@ -0,0 +1,276 @@
+#include "Test.hpp"
+#include "MeshArena.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+// Random blocks are allocated and freed, each block must be aligned to its size and apart from the others.
+// Once everything is freed, the buddies have merged back into a single free block
+static void TestBuddyAllocatorSplitsAndMerges() noexcept {
+    constexpr std::uint32_t ORDER_COUNT = 7u;
+
+    BuddyAllocator allocator(ORDER_COUNT);
+    const size_t unitCount = allocator.GetUnitCount();
+    CHECK(unitCount == 64u && allocator.GetFreeUnitCount() == unitCount && allocator.GetLargestFreeBlockSize() == unitCount);
+
+    // the first block of a unit splits the whole range in halves down to it
+    const std::optional<std::uint32_t> firstUnit = allocator.Allocate(0u);
+    CHECK(firstUnit == 0u && allocator.GetBlockOrder(0u) == 0u);
+    CHECK(allocator.GetFreeUnitCount() == unitCount - 1u && allocator.GetLargestFreeBlockSize() == unitCount / 2u);
+
+    allocator.Free(firstUnit.value());
+    CHECK(allocator.GetFreeUnitCount() == unitCount && allocator.GetLargestFreeBlockSize() == unitCount);
+
+    std::mt19937 random(RANDOM_SEED);
+    std::vector<std::uint32_t> owners(unitCount, 0xFFFFFFFFu); // the first unit of the block each unit is in
+    std::vector<std::uint32_t> units;
+
+    for (int i = 0; i < 20000; ++i) {
+        if (units.empty() || random() % 2u == 0u) {
+            const std::uint32_t order = static_cast<std::uint32_t>(random() % 4u);
+            const size_t nFreeUnits = allocator.GetFreeUnitCount();
+            const std::optional<std::uint32_t> unit = allocator.Allocate(order);
+
+            // only fails when no free block is large enough
+            if (!unit.has_value()) {
+                if (!CHECK(allocator.GetLargestFreeBlockSize() < (static_cast<size_t>(1u) << order)))
+                    return;
+
+                continue;
+            }
+
+            const size_t blockSize = static_cast<size_t>(1u) << order;
+            bool bIsApart = unit.value() % blockSize == 0u && unit.value() + blockSize <= unitCount && allocator.GetBlockOrder(unit.value()) == order;
+            for (size_t u = unit.value(); bIsApart && u < unit.value() + blockSize; ++u) {
+                bIsApart = owners[u] == 0xFFFFFFFFu;
+                owners[u] = unit.value();
+            }
+
+            if (!CHECK(bIsApart && allocator.GetFreeUnitCount() == nFreeUnits - blockSize))
+                return;
+
+            units.push_back(unit.value());
+        } else {
+            const size_t index = random() % units.size();
+            const std::uint32_t unit = units[index];
+            units[index] = units.back();
+            units.pop_back();
+
+            const size_t blockSize = static_cast<size_t>(1u) << allocator.GetBlockOrder(unit);
+            std::fill(owners.begin() + unit, owners.begin() + unit + blockSize, 0xFFFFFFFFu);
+
+            const size_t nFreeUnits = allocator.GetFreeUnitCount();
+            allocator.Free(unit);
+
+            if (!CHECK(allocator.GetFreeUnitCount() == nFreeUnits + blockSize))
+                return;
+        }
+    }
+
+    for (const std::uint32_t unit : units)
+        allocator.Free(unit);
+
+    CHECK(allocator.GetFreeUnitCount() == unitCount && allocator.GetLargestFreeBlockSize() == unitCount);
+
+    // so the whole range can be allocated in one block again
+    CHECK(allocator.Allocate(ORDER_COUNT - 1u) == 0u && allocator.GetFreeUnitCount() == 0u && allocator.GetLargestFreeBlockSize() == 0u);
+    CHECK(!allocator.Allocate(0u).has_value());
+}
+
+struct TestAllocation {
+    MeshArenaAllocation       allocation;
+    std::vector<std::uint8_t> bytes;
+}; // struct TestAllocation
+
+static std::vector<std::uint8_t> MakeRandomBytes(std::mt19937& random, const size_t byteSize) noexcept {
+    std::vector<std::uint8_t> bytes(byteSize);
+    for (std::uint8_t& byte : bytes)
+        byte = static_cast<std::uint8_t>(random());
+
+    return bytes;
+}
+
+// The bytes each allocation was made with are where the arena says they are, and no two allocations overlap
+static bool HasAllocationBytes(const MeshArena& arena, const CpuMeshArenaBackend& backend, const std::vector<TestAllocation>& allocations) noexcept {
+    std::vector<std::array<size_t, 3u>> ranges;
+
+    for (const TestAllocation& allocation : allocations) {
+        const MeshArenaLocation& location = arena.GetLocation(allocation.allocation.GetHandle());
+        if (location.byteSize != allocation.bytes.size() || location.byteOffset + location.byteSize > MeshArena::PAGE_BYTE_SIZE)
+            return false;
+
+        if (std::memcmp(backend.GetPageData(location.page) + location.byteOffset, allocation.bytes.data(), allocation.bytes.size()) != 0)
+            return false;
+
+        ranges.push_back({ location.page, location.byteOffset, location.byteOffset + location.byteSize });
+    }
+
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1u; i < ranges.size(); ++i)
+        if (ranges[i][0] == ranges[i - 1u][0] && ranges[i][1] < ranges[i - 1u][2])
+            return false;
+
+    return true;
+}
+
+// Defragment moves the allocations out of the least occupied pages, a few at a time, without changing their bytes,
+// until the pages it emptied are released
+static void TestDefragmentPreservesBytes() noexcept {
+    CpuMeshArenaBackend backend;
+    MeshArena arena(backend);
+
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_int_distribution<size_t> byteSizes(1u, 64u * 1024u);
+
+    std::vector<TestAllocation> allocations;
+    while (arena.GetStats().nPages < 4u) {
+        std::vector<std::uint8_t> bytes = MakeRandomBytes(random, byteSizes(random));
+        MeshArenaAllocation allocation = arena.Allocate(bytes.data(), bytes.size());
+        allocations.push_back(TestAllocation{ std::move(allocation), std::move(bytes) });
+    }
+
+    CHECK(HasAllocationBytes(arena, backend, allocations));
+
+    // most of the allocations go, from every page
+    for (size_t i = 0u; i < allocations.size(); ) {
+        if (random() % 4u != 0u) {
+            allocations[i] = std::move(allocations.back());
+            allocations.pop_back();
+        } else {
+            ++i;
+        }
+    }
+
+    const MeshArenaStats statsBefore = arena.GetStats();
+    CHECK(HasAllocationBytes(arena, backend, allocations));
+
+    std::vector<MeshArenaLocation> locationsBefore;
+    for (const TestAllocation& allocation : allocations)
+        locationsBefore.push_back(arena.GetLocation(allocation.allocation.GetHandle()));
+
+    constexpr size_t MAX_MOVED_BYTES = 256u * 1024u;
+
+    size_t nMovedBytes = 0u;
+    for (int i = 0; i < 1000; ++i) {
+        const size_t movedBytes = arena.Defragment(MAX_MOVED_BYTES);
+
+        // it stops once past the limit, an allocation is at most 64 KiB
+        if (!CHECK(movedBytes < MAX_MOVED_BYTES + 64u * 1024u && HasAllocationBytes(arena, backend, allocations)))
+            return;
+
+        nMovedBytes += movedBytes;
+    }
+
+    size_t nMovedAllocations = 0u;
+    for (size_t i = 0u; i < allocations.size(); ++i) {
+        const MeshArenaLocation& location = arena.GetLocation(allocations[i].allocation.GetHandle());
+        if (location.page != locationsBefore[i].page || location.byteOffset != locationsBefore[i].byteOffset)
+            ++nMovedAllocations;
+    }
+
+    const MeshArenaStats statsAfter = arena.GetStats();
+    CHECK(nMovedBytes > 0u && nMovedAllocations > 0u);
+    CHECK(statsAfter.nPages < statsBefore.nPages && statsAfter.nAllocations == statsBefore.nAllocations && statsAfter.requestedBytes == statsBefore.requestedBytes);
+    CHECK(statsAfter.GetOccupancy() > statsBefore.GetOccupancy());
+
+    // the allocations that were moved can still be overwritten, then freed
+    for (TestAllocation& allocation : allocations) {
+        allocation.bytes = MakeRandomBytes(random, allocation.bytes.size());
+        arena.Write(allocation.allocation.GetHandle(), allocation.bytes.data());
+    }
+
+    CHECK(HasAllocationBytes(arena, backend, allocations));
+
+    allocations.clear();
+    CHECK(arena.GetStats().nAllocations == 0u && arena.GetStats().requestedBytes == 0u && arena.GetStats().allocatedBytes == 0u);
+}
+
+// The pages left empty are released by Defragment, except for a spare one that the next allocations go to
+static void TestPageReleaseKeepsASparePage() noexcept {
+    CpuMeshArenaBackend backend;
+    MeshArena arena(backend);
+
+    std::vector<std::uint8_t> bytes(MeshArena::PAGE_BYTE_SIZE / 2u, 0x5Au);
+
+    std::vector<MeshArenaAllocation> allocations;
+    for (int i = 0; i < 6; ++i)
+        allocations.push_back(arena.Allocate(bytes.data(), bytes.size()));
+
+    CHECK(arena.GetStats().nPages == 3u);
+
+    // nothing is released while every page is used
+    arena.Defragment(0u);
+    CHECK(arena.GetStats().nPages == 3u);
+
+    allocations.clear();
+    CHECK(arena.GetStats().nPages == 3u && arena.GetStats().nAllocations == 0u);
+
+    arena.Defragment(0u);
+    CHECK(arena.GetStats().nPages == 1u);
+
+    // the spare page is used before creating another
+    allocations.push_back(arena.Allocate(bytes.data(), bytes.size()));
+    CHECK(arena.GetStats().nPages == 1u);
+
+    // a page is created again once it is full, in the slot a released page left
+    allocations.push_back(arena.Allocate(bytes.data(), bytes.size()));
+    allocations.push_back(arena.Allocate(bytes.data(), bytes.size()));
+    CHECK(arena.GetStats().nPages == 2u);
+
+    const MeshArenaLocation& location = arena.GetLocation(allocations.back().GetHandle());
+    CHECK(location.page < 2u && std::memcmp(backend.GetPageData(location.page) + location.byteOffset, bytes.data(), bytes.size()) == 0);
+
+    // empty or larger than a page, there is nothing to allocate
+    CHECK(!arena.Allocate(bytes.data(), 0u).IsValid());
+    CHECK(!arena.Allocate(bytes.data(), MeshArena::PAGE_BYTE_SIZE + 1u).IsValid());
+}
+
+// Occupancy is the part of the pages the requested bytes use, fragmentation how scattered the free space is
+static void TestStatsOccupancyAndFragmentation() noexcept {
+    CpuMeshArenaBackend backend;
+    MeshArena arena(backend);
+
+    const MeshArenaStats emptyStats = arena.GetStats();
+    CHECK(emptyStats.nPages == 0u && emptyStats.GetOccupancy() == 0.f && emptyStats.GetFragmentation() == 0.f);
+
+    std::vector<std::uint8_t> bytes(MeshArena::PAGE_BYTE_SIZE, 0x33u);
+
+    // 100 bytes in a block of 256, the rest of the page in halves, quarters... of it
+    MeshArenaAllocation small = arena.Allocate(bytes.data(), 100u);
+    const MeshArenaStats smallStats = arena.GetStats();
+    CHECK(smallStats.nPages == 1u && smallStats.nAllocations == 1u && smallStats.capacity == MeshArena::PAGE_BYTE_SIZE);
+    CHECK(smallStats.requestedBytes == 100u && smallStats.allocatedBytes == MeshArena::MIN_BLOCK_BYTE_SIZE);
+    CHECK(smallStats.largestFreeBlock == MeshArena::PAGE_BYTE_SIZE / 2u);
+    CHECK(smallStats.GetOccupancy() == 100.f / MeshArena::PAGE_BYTE_SIZE);
+    CHECK(std::abs(smallStats.GetFragmentation() - (1.f - (MeshArena::PAGE_BYTE_SIZE / 2u) / static_cast<float>(MeshArena::PAGE_BYTE_SIZE - MeshArena::MIN_BLOCK_BYTE_SIZE))) < 1e-6f);
+
+    // every other block of 256 bytes, the free space is as scattered as can be
+    small.Reset();
+    std::vector<MeshArenaAllocation> allocations;
+    for (size_t i = 0u; i < MeshArena::PAGE_BYTE_SIZE / MeshArena::MIN_BLOCK_BYTE_SIZE; ++i)
+        allocations.push_back(arena.Allocate(bytes.data(), MeshArena::MIN_BLOCK_BYTE_SIZE));
+
+    const MeshArenaStats fullStats = arena.GetStats();
+    CHECK(fullStats.nPages == 1u && fullStats.GetOccupancy() == 1.f && fullStats.GetFragmentation() == 0.f && fullStats.largestFreeBlock == 0u);
+
+    for (size_t i = 0u; i < allocations.size(); i += 2u)
+        allocations[i].Reset();
+
+    const MeshArenaStats scatteredStats = arena.GetStats();
+    CHECK(scatteredStats.allocatedBytes == MeshArena::PAGE_BYTE_SIZE / 2u && scatteredStats.largestFreeBlock == MeshArena::MIN_BLOCK_BYTE_SIZE);
+    CHECK(scatteredStats.GetOccupancy() == 0.5f);
+    CHECK(std::abs(scatteredStats.GetFragmentation() - (1.f - 2.f * MeshArena::MIN_BLOCK_BYTE_SIZE / MeshArena::PAGE_BYTE_SIZE)) < 1e-6f);
+
+    // freeing the rest merges everything back
+    allocations.clear();
+    const MeshArenaStats mergedStats = arena.GetStats();
+    CHECK(mergedStats.nAllocations == 0u && mergedStats.largestFreeBlock == MeshArena::PAGE_BYTE_SIZE && mergedStats.GetFragmentation() == 0.f);
+}
+
+int main() {
+    return RunTests({
+        { "buddy allocator splits and merges",    TestBuddyAllocatorSplitsAndMerges  },
+        { "Defragment preserves the bytes",       TestDefragmentPreservesBytes       },
+        { "page release keeps a spare page",      TestPageReleaseKeepsASparePage     },
+        { "stats occupancy and fragmentation",    TestStatsOccupancyAndFragmentation }
+    });
+}
@@ -0,0 +1,76 @@
+#ifndef __MINECRAFT__TEST_HPP
+#define __MINECRAFT__TEST_HPP
+
+#include "Pch.hpp"
+
+// Each tests/*Tests.cpp is an executable registered with CTest: its main returns RunTests(...),
+// which runs every test case and fails when any CHECK of any of them failed.
+// A failed CHECK doesn't stop its test case, so that one run reports every difference
+
+struct TestCase {
+    const char*           name;
+    std::function<void()> run;
+}; // struct TestCase
+
+inline size_t& GetFailedCheckCount() noexcept {
+    static size_t nFailedChecks = 0u;
+    return nFailedChecks;
+}
+
+inline bool Check(const bool bCondition, const char* expression, const char* file, const int line) noexcept {
+    if (!bCondition) {
+        std::cerr << file << ':' << line << ": CHECK(" << expression << ") failed\n";
+        ++GetFailedCheckCount();
+    }
+
+    return bCondition;
+}
+
+#define CHECK(condition) Check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+// A directory of its own under the system's temporary directory, removed with everything in it on destruction
+class TemporaryDirectory {
+private:
+    std::filesystem::path m_path;
+
+public:
+    explicit TemporaryDirectory(const std::string& name) noexcept {
+        std::random_device randomDevice;
+
+        std::error_code errorCode;
+        this->m_path = std::filesystem::temp_directory_path(errorCode) / (name + '-' + std::to_string(randomDevice()));
+        std::filesystem::create_directories(this->m_path, errorCode);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    inline ~TemporaryDirectory() noexcept {
+        std::error_code errorCode;
+        std::filesystem::remove_all(this->m_path, errorCode);
+    }
+
+    inline const std::filesystem::path& GetPath() const noexcept { return this->m_path; }
+}; // class TemporaryDirectory
+
+inline int RunTests(const std::vector<TestCase>& testCases) noexcept {
+    size_t nFailedTestCases = 0u;
+
+    for (const TestCase& testCase : testCases) {
+        const size_t nFailedChecks = GetFailedCheckCount();
+        testCase.run();
+
+        const bool bSucceeded = GetFailedCheckCount() == nFailedChecks;
+        std::cerr << (bSucceeded ? "  ok     " : "  FAILED ") << testCase.name << '\n';
+
+        if (!bSucceeded)
+            ++nFailedTestCases;
+    }
+
+    if (nFailedTestCases != 0u)
+        std::cerr << nFailedTestCases << " of " << testCases.size() << " test case(s) failed\n";
+
+    return nFailedTestCases == 0u ? 0 : 1;
+}
+
+#endif // __MINECRAFT__TEST_HPP
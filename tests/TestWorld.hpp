@@ -0,0 +1,70 @@
+#ifndef __MINECRAFT__TEST_WORLD_HPP
+#define __MINECRAFT__TEST_WORLD_HPP
+
+#include "Pch.hpp"
+#include "Chunk.hpp"
+#include "LightEngine.hpp"
+#include "WorldGenerator.hpp"
+
+// A square of generated chunks starting at (0, 0), each lit on its own. Blocks are then set at random
+// (water and lamps included) so that the meshers see more than the generator's shapes
+class TestWorld {
+private:
+    std::vector<std::unique_ptr<Chunk>> m_pChunks;
+    int m_sideChunkCount;
+
+public:
+    TestWorld(const std::uint32_t seed, const int sideChunkCount, const size_t nRandomBlocks) noexcept
+        : m_sideChunkCount(sideChunkCount)
+    {
+        WorldGenerator worldGenerator(seed);
+
+        for (int idx = 0; idx < sideChunkCount; ++idx) {
+            for (int idz = 0; idz < sideChunkCount; ++idz) {
+                this->m_pChunks.push_back(std::make_unique<Chunk>(ChunkCoord{ static_cast<std::int16_t>(idx), static_cast<std::int16_t>(idz) }));
+                worldGenerator.GenerateChunk(*this->m_pChunks.back());
+            }
+        }
+
+        std::mt19937 random(seed);
+        for (size_t i = 0u; i < nRandomBlocks; ++i) {
+            Chunk& chunk = *this->m_pChunks[random() % this->m_pChunks.size()];
+            chunk.SetBlock(random() % CHUNK_X_BLOCK_COUNT, random() % CHUNK_Y_BLOCK_COUNT, random() % CHUNK_Z_BLOCK_COUNT,
+                           static_cast<BLOCK_TYPE>(random() % static_cast<size_t>(BLOCK_TYPE::_COUNT)));
+        }
+
+        LightEngine lightEngine;
+        for (const std::unique_ptr<Chunk>& pChunk : this->m_pChunks)
+            lightEngine.ComputeChunkLight(*pChunk);
+    }
+
+    inline int GetSideChunkCount() const noexcept { return this->m_sideChunkCount; }
+
+    inline Chunk& GetChunk(const int idx, const int idz) noexcept { return *this->m_pChunks[idx * this->m_sideChunkCount + idz]; }
+
+    inline const Chunk& GetChunk(const int idx, const int idz) const noexcept { return *this->m_pChunks[idx * this->m_sideChunkCount + idz]; }
+
+    // The sides along the world's border are left unknown
+    ChunkNeighbourBlocks CopyNeighbourBlocks(const int idx, const int idz) const noexcept {
+        static constexpr std::array<std::array<int, 2>, static_cast<size_t>(CHUNK_SIDE::_COUNT)> offsets = {{ {{ -1, 0 }}, {{ 1, 0 }}, {{ 0, -1 }}, {{ 0, 1 }} }};
+        static constexpr std::array<CHUNK_SIDE, static_cast<size_t>(CHUNK_SIDE::_COUNT)> oppositeSides = {
+            CHUNK_SIDE::CHUNK_SIDE_RIGHT, CHUNK_SIDE::CHUNK_SIDE_LEFT, CHUNK_SIDE::CHUNK_SIDE_BACK, CHUNK_SIDE::CHUNK_SIDE_FRONT
+        };
+
+        ChunkNeighbourBlocks neighbours;
+        for (size_t side = 0u; side < static_cast<size_t>(CHUNK_SIDE::_COUNT); ++side) {
+            const int neighbourX = idx + offsets[side][0];
+            const int neighbourZ = idz + offsets[side][1];
+            if (neighbourX < 0 || neighbourX >= this->m_sideChunkCount || neighbourZ < 0 || neighbourZ >= this->m_sideChunkCount)
+                continue;
+
+            this->GetChunk(neighbourX, neighbourZ).CopySideBlocks(oppositeSides[side], neighbours.sides[side]);
+            this->GetChunk(neighbourX, neighbourZ).CopySideLight(oppositeSides[side], neighbours.sideLights[side]);
+            neighbours.sideMask |= static_cast<std::uint8_t>(1u << side);
+        }
+
+        return neighbours;
+    }
+}; // class TestWorld
+
+#endif // __MINECRAFT__TEST_WORLD_HPP
@@ -0,0 +1,221 @@
+#include "Test.hpp"
+#include "TranslucentMesh.hpp"
+
+constexpr std::uint32_t RANDOM_SEED = 1234u;
+
+constexpr int CAMERA_STEP_COUNT = 2000;
+
+// A unit quad on the face of block (x, y, z), corners a and c opposite as the mesher emits them.
+// The quad's id is stored in its texture, so that the quads can be told apart once sorted
+static void AddQuad(std::vector<Vertex>& vertices, const int x, const int y, const int z, const BLOCK_FACE face, const std::uint32_t id) noexcept {
+    std::array<std::array<int, 3>, 4u> corners;
+    switch (face) {
+    case BLOCK_FACE::BLOCK_FACE_TOP:  corners = {{ {{ x, y + 1, z }}, {{ x + 1, y + 1, z }}, {{ x + 1, y + 1, z + 1 }}, {{ x, y + 1, z + 1 }} }}; break;
+    case BLOCK_FACE::BLOCK_FACE_LEFT: corners = {{ {{ x, y, z }},     {{ x, y + 1, z }},     {{ x, y + 1, z + 1 }},     {{ x, y, z + 1 }}     }}; break;
+    default:                          corners = {{ {{ x, y, z }},     {{ x + 1, y, z }},     {{ x + 1, y + 1, z }},     {{ x, y + 1, z }}     }}; break;
+    }
+
+    for (const std::array<int, 3>& corner : corners)
+        vertices.push_back(PackVertex(UnpackedVertex{
+            static_cast<std::uint16_t>(corner[0]), static_cast<std::uint16_t>(corner[1]), static_cast<std::uint16_t>(corner[2]),
+            face, 15u, static_cast<std::uint8_t>(id & 0xFFu), static_cast<std::uint16_t>(id >> 8u), 0u
+        }));
+}
+
+// Quads of the blocks of section "sectionIndex", many on the same planes so that some are as far as others
+static std::vector<Vertex> MakeRandomSectionQuads(std::mt19937& random, const size_t sectionIndex, const size_t nQuads, std::uint32_t& nextId) noexcept {
+    static constexpr std::array<BLOCK_FACE, 3u> faces = { BLOCK_FACE::BLOCK_FACE_TOP, BLOCK_FACE::BLOCK_FACE_LEFT, BLOCK_FACE::BLOCK_FACE_FRONT };
+
+    std::vector<Vertex> vertices;
+    for (size_t i = 0u; i < nQuads; ++i) {
+        const int x = static_cast<int>(random() % CHUNK_X_BLOCK_COUNT);
+        const int y = static_cast<int>(sectionIndex * CHUNK_SECTION_Y_BLOCK_COUNT + random() % CHUNK_SECTION_Y_BLOCK_COUNT);
+        const int z = static_cast<int>(random() % CHUNK_Z_BLOCK_COUNT);
+
+        AddQuad(vertices, x, y, z, faces[random() % faces.size()], nextId++);
+    }
+
+    return vertices;
+}
+
+// Each quad's squared distance to the camera, in the order of "vertices", as Sort computes it
+static std::vector<float> GetQuadDepths(const std::vector<Vertex>& vertices, const Vec4f32& cameraPosition) noexcept {
+    std::vector<float> depths;
+    for (size_t i = 0u; i + 4u <= vertices.size(); i += 4u) {
+        const UnpackedVertex a = UnpackVertex(vertices[i]);
+        const UnpackedVertex c = UnpackVertex(vertices[i + 2u]);
+
+        const float dx = static_cast<std::uint16_t>(a.x + c.x) * 0.5f - cameraPosition.x;
+        const float dy = static_cast<std::uint16_t>(a.y + c.y) * 0.5f - cameraPosition.y;
+        const float dz = static_cast<std::uint16_t>(a.z + c.z) * 0.5f - cameraPosition.z;
+        depths.push_back(dx * dx + dy * dy + dz * dz);
+    }
+
+    return depths;
+}
+
+// The quads' ids, sorted, to check that sorting neither lost nor duplicated a quad
+static std::vector<std::uint32_t> GetSortedQuadIds(const std::vector<Vertex>& vertices) noexcept {
+    std::vector<std::uint32_t> ids;
+    for (size_t i = 0u; i + 4u <= vertices.size(); i += 4u)
+        for (size_t corner = 0u; corner < 4u; ++corner)
+            ids.push_back(vertices[i + corner].texture);
+
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+static bool AreVerticesEqual(const std::vector<Vertex>& lhs, const std::vector<Vertex>& rhs) noexcept {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                      [](const Vertex& l, const Vertex& r) { return l.position == r.position && l.texture == r.texture; });
+}
+
+static bool IsBackToFront(const std::vector<Vertex>& vertices, const Vec4f32& cameraPosition) noexcept {
+    const std::vector<float> depths = GetQuadDepths(vertices, cameraPosition);
+    return std::is_sorted(depths.begin(), depths.end(), std::greater<float>());
+}
+
+// Sort orders every quad back to front, from inside the chunk and from far outside of it
+static void TestSortIsBackToFront() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> positions(-40.f, 300.f);
+
+    for (int i = 0; i < 50; ++i) {
+        TranslucentMesh mesh;
+
+        std::uint32_t nextId = 0u;
+        std::vector<Vertex> vertices;
+        for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; sectionIndex += 1u + random() % 4u) {
+            const std::vector<Vertex> sectionVertices = MakeRandomSectionQuads(random, sectionIndex, random() % 200u, nextId);
+            mesh.SetSectionVertices(sectionIndex, sectionVertices);
+            vertices.insert(vertices.end(), sectionVertices.begin(), sectionVertices.end());
+        }
+
+        const Vec4f32 cameraPosition(positions(random) * 0.1f, positions(random), positions(random) * 0.1f, 1.f);
+
+        CHECK(mesh.Sort(cameraPosition) || vertices.empty());
+        CHECK(mesh.GetQuadCount() * 4u == vertices.size() && mesh.GetVertexCount() == vertices.size());
+        CHECK(GetSortedQuadIds(mesh.GetSortedVertices()) == GetSortedQuadIds(vertices));
+        if (!CHECK(IsBackToFront(mesh.GetSortedVertices(), cameraPosition)))
+            return;
+    }
+}
+
+// A camera walking through the chunk, now and then jumping away or having a section remeshed: the insertion sort from the
+// previous order and the std::stable_sort it falls back to, or starts over with, give the order a new mesh sorted from scratch gives
+static void TestInsertionSortMatchesFullSort() noexcept {
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> steps(-1.5f, 1.5f);
+    std::uniform_real_distribution<float> jumps(-30.f, 30.f);
+
+    std::uint32_t nextId = 0u;
+    std::array<std::vector<Vertex>, CHUNK_SECTION_COUNT> sectionVertices;
+
+    TranslucentMesh mesh;
+    for (size_t sectionIndex = 2u; sectionIndex < 6u; ++sectionIndex) {
+        sectionVertices[sectionIndex] = MakeRandomSectionQuads(random, sectionIndex, 500u, nextId);
+        mesh.SetSectionVertices(sectionIndex, sectionVertices[sectionIndex]);
+    }
+
+    Vec4f32 cameraPosition(8.5f, 64.5f, 8.5f, 1.f);
+    mesh.Sort(cameraPosition);
+
+    // where the camera was for the last sort, the sort is skipped while it stays in that block
+    Vec4f32 sortedCameraPosition = cameraPosition;
+    const auto GetCameraBlock = [](const Vec4f32& position) {
+        return std::array<float, 3u>{ std::floor(position.x), std::floor(position.y), std::floor(position.z) };
+    };
+
+    size_t nInsertionSorts = 0u;
+    size_t nFullSorts      = 0u;
+
+    for (int step = 0; step < CAMERA_STEP_COUNT; ++step) {
+        const std::vector<Vertex> previousVertices = mesh.GetSortedVertices();
+
+        const bool bRemesh = step % 97 == 0;
+        if (bRemesh) {
+            const size_t sectionIndex = 2u + random() % 4u;
+            sectionVertices[sectionIndex] = MakeRandomSectionQuads(random, sectionIndex, random() % 600u, nextId);
+            mesh.SetSectionVertices(sectionIndex, sectionVertices[sectionIndex]);
+        }
+
+        if (step % 50 == 0) {
+            cameraPosition.x = 8.f + jumps(random);
+            cameraPosition.y = 64.f + jumps(random);
+            cameraPosition.z = 8.f + jumps(random);
+        } else {
+            cameraPosition.x += steps(random);
+            cameraPosition.y += steps(random);
+            cameraPosition.z += steps(random);
+        }
+
+        const bool bChanged = mesh.Sort(cameraPosition);
+        if (!CHECK(bChanged || AreVerticesEqual(mesh.GetSortedVertices(), previousVertices)))
+            return;
+
+        const bool bSorted = bRemesh || GetCameraBlock(cameraPosition) != GetCameraBlock(sortedCameraPosition);
+        if (bSorted)
+            sortedCameraPosition = cameraPosition;
+
+        TranslucentMesh fullySortedMesh;
+        for (size_t sectionIndex = 0u; sectionIndex < CHUNK_SECTION_COUNT; ++sectionIndex)
+            fullySortedMesh.SetSectionVertices(sectionIndex, sectionVertices[sectionIndex]);
+        fullySortedMesh.Sort(sortedCameraPosition);
+
+        // quads as far as each other may be in either order
+        if (!CHECK(GetQuadDepths(mesh.GetSortedVertices(), sortedCameraPosition) == GetQuadDepths(fullySortedMesh.GetSortedVertices(), sortedCameraPosition)))
+            return;
+        if (!CHECK(GetSortedQuadIds(mesh.GetSortedVertices()) == GetSortedQuadIds(fullySortedMesh.GetSortedVertices())))
+            return;
+
+        if (bSorted && mesh.GetLastSortMoveCount() == mesh.GetQuadCount())
+            ++nFullSorts;
+        else if (bSorted && mesh.GetLastSortMoveCount() > 0u)
+            ++nInsertionSorts;
+    }
+
+    // both paths ran
+    CHECK(nInsertionSorts > 0u && nFullSorts > 0u);
+}
+
+// Two quads on either side of the camera's block, whose order flips as the camera crosses the block: the sort is skipped until it leaves the block
+static void TestSortIsSkippedInTheSameBlock() noexcept {
+    std::vector<Vertex> vertices;
+    AddQuad(vertices, 3, 64, 8, BLOCK_FACE::BLOCK_FACE_LEFT, 0u); // x = 3
+    AddQuad(vertices, 4, 64, 8, BLOCK_FACE::BLOCK_FACE_LEFT, 1u); // x = 4
+
+    TranslucentMesh mesh;
+    mesh.SetSectionVertices(4u, vertices);
+
+    // nearer to x = 3, so the quad at x = 4 first
+    CHECK(mesh.Sort(Vec4f32(3.2f, 64.5f, 8.5f, 1.f)));
+    CHECK(UnpackVertex(mesh.GetSortedVertices()[0]).x == 4u);
+
+    // nearer to x = 4 but in the same block
+    CHECK(!mesh.Sort(Vec4f32(3.8f, 64.9f, 8.1f, 1.f)));
+    CHECK(UnpackVertex(mesh.GetSortedVertices()[0]).x == 4u);
+
+    // new vertices are sorted in the same block too
+    mesh.SetSectionVertices(4u, std::vector<Vertex>(vertices.rbegin(), vertices.rend()));
+    CHECK(mesh.Sort(Vec4f32(3.8f, 64.9f, 8.1f, 1.f)));
+    CHECK(UnpackVertex(mesh.GetSortedVertices()[0]).x == 3u);
+
+    // the next block over sorts again, and doesn't report a change when the order stays
+    CHECK(!mesh.Sort(Vec4f32(4.2f, 64.5f, 8.5f, 1.f)));
+    CHECK(UnpackVertex(mesh.GetSortedVertices()[0]).x == 3u);
+    CHECK(mesh.Sort(Vec4f32(2.5f, 64.5f, 8.5f, 1.f)));
+    CHECK(UnpackVertex(mesh.GetSortedVertices()[0]).x == 4u);
+
+    // removing every quad is a change too
+    mesh.SetSectionVertices(4u, {});
+    CHECK(mesh.Sort(Vec4f32(2.5f, 64.5f, 8.5f, 1.f)));
+    CHECK(mesh.GetQuadCount() == 0u && mesh.GetSortedVertices().empty());
+}
+
+int main() {
+    return RunTests({
+        { "Sort orders the quads back to front",        TestSortIsBackToFront             },
+        { "insertion sort matches sorting from scratch", TestInsertionSortMatchesFullSort  },
+        { "Sort is skipped in the same block",           TestSortIsSkippedInTheSameBlock   }
+    });
+}